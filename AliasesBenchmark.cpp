@@ -0,0 +1,124 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <string>
+
+module Benchmark;
+
+import OpenGL;
+
+// Checks that the loader falls back to the aliases gl.xml gives for core functions the driver only
+// exposes under suffixed names.
+//
+//     -benchmark aliases [-library path]
+//
+// The library is glStubDriver.dll by default, built by glStubDriver.vcxproj next to this executable,
+// which exports only suffixed names (see StubDriver.cpp). Each core function below is looked up with
+// the library's loader, and the check fails unless the pointer returned is the one the library exports
+// under the expected alias and the loader report records that alias, where it was found and whether
+// the driver returned an invalid pointer along the way.
+
+namespace
+{
+	struct ExpectedAlias
+	{
+		const char *pszName;
+		const char *pszAlias;
+		SymbolSource source;
+		bool invalidDriverResult;
+	};
+
+	const ExpectedAlias kExpected[]
+	{
+		{"glActiveTexture", "glActiveTextureARB", SymbolSource::Driver, false},
+		{"glBindBuffer", "glBindBufferARB", SymbolSource::Driver, false},
+		{"glBufferSubData", "glBufferSubDataARB", SymbolSource::Driver, false},
+		{"glGenBuffers", "glGenBuffersARB", SymbolSource::Driver, true},
+		{"glBlendFuncSeparate", "glBlendFuncSeparateINGR", SymbolSource::Library, false},
+		{"glDrawBuffers", "glDrawBuffersATI", SymbolSource::Library, false},
+		{"glBlendColor", "", SymbolSource::Missing, false},
+	};
+
+	const SymbolResolution *findResolution(const LoaderReport &loaderReport, const char *pszName)
+	{
+		for (const SymbolResolution &resolution : loaderReport.symbols)
+		{
+			if (resolution.name == pszName)
+				return &resolution;
+		}
+
+		return nullptr;
+	}
+}
+
+int runAliasesBenchmark(const BenchmarkArguments &args, BenchmarkReport &report)
+{
+	const wchar_t *pszLibrary{args.value(L"-library", L"glStubDriver.dll")};
+	HMODULE hLibrary{LoadLibraryW(pszLibrary)};
+
+	if (!hLibrary)
+	{
+		std::fwprintf(stderr, L"Couldn't load %ls\n", pszLibrary);
+		return EXIT_FAILURE;
+	}
+
+	PROC pfns[std::size(kExpected)]{};
+
+	for (std::size_t i = 0; i < std::size(kExpected); ++i)
+		pfns[i] = OpenGLContext::getProcAddress(kExpected[i].pszName, pszLibrary);
+
+	LoaderReport loaderReport{OpenGLContext::loaderReport(pszLibrary)};
+	bool failed{false};
+
+	report.setProperty("library", loaderReport.library);
+
+	for (std::size_t i = 0; i < std::size(kExpected); ++i)
+	{
+		const ExpectedAlias &expected{kExpected[i]};
+		const SymbolResolution *pResolution{findResolution(loaderReport, expected.pszName)};
+		PROC pfnExpected{*expected.pszAlias ? GetProcAddress(hLibrary, expected.pszAlias) : nullptr};
+
+		bool ok{pResolution && pfns[i] == pfnExpected && pResolution->alias == expected.pszAlias &&
+			pResolution->source == expected.source && pResolution->invalidDriverResult == expected.invalidDriverResult};
+
+		report.beginResult();
+		report.set("symbol", expected.pszName);
+		report.set("alias", pResolution ? pResolution->alias : "");
+		report.set("source", LoaderReport::sourceName(pResolution ? pResolution->source : SymbolSource::Missing));
+		report.set("invalidDriverResult", pResolution && pResolution->invalidDriverResult ? "yes" : "no");
+		report.set("ok", ok ? "yes" : "no");
+
+		if (!ok)
+		{
+			std::fprintf(stderr, "%s should resolve to %s from the %s\n", expected.pszName, *expected.pszAlias ? expected.pszAlias : "nothing",
+				LoaderReport::sourceName(expected.source));
+			failed = true;
+		}
+	}
+
+	FreeLibrary(hLibrary);
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
\ No newline at end of file
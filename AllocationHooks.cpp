@@ -0,0 +1,163 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+// Replacements for the global operator new and operator delete that report every allocation to
+// the AllocationTracker. They must be defined outside any named module, so they live in their own
+// translation unit. Memory comes from the CRT's malloc() and _aligned_malloc() as before.
+//
+// Debug builds also install a CRT allocation hook, which sees malloc(), calloc(), realloc() and
+// _aligned_malloc() as well as operator new, so there the hook does the reporting instead. Release
+// builds have no such hook, and only see operator new.
+
+#include <crtdbg.h>
+#include <malloc.h>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+import AllocationTracker;
+
+namespace
+{
+#ifdef _DEBUG
+	int __cdecl crtAllocationHook(int allocationType, void *pUserData, std::size_t size, int blockType, long request, const unsigned char *pszFile, int line);
+
+	const _CRT_ALLOC_HOOK g_previousAllocationHook{_CrtSetAllocHook(crtAllocationHook)};
+
+	// The CRT's own blocks, such as stdio buffers, are left out as the CRT documentation recommends.
+
+	int __cdecl crtAllocationHook(int allocationType, void *pUserData, std::size_t size, int blockType, long request, const unsigned char *pszFile, int line)
+	{
+		if ((allocationType == _HOOK_ALLOC || allocationType == _HOOK_REALLOC) && blockType != _CRT_BLOCK)
+			AllocationTracker::onAllocation(size);
+
+		if (g_previousAllocationHook)
+			return g_previousAllocationHook(allocationType, pUserData, size, blockType, request, pszFile, line);
+
+		return TRUE;
+	}
+
+	void reportAllocation(std::size_t)
+	{
+	}
+#else
+	void reportAllocation(std::size_t size)
+	{
+		AllocationTracker::onAllocation(size);
+	}
+#endif
+
+	void *allocate(std::size_t size)
+	{
+		reportAllocation(size);
+
+		while (true)
+		{
+			if (void *p{std::malloc(size ? size : 1)})
+				return p;
+
+			std::new_handler handler{std::get_new_handler()};
+
+			if (!handler)
+				throw std::bad_alloc{};
+
+			handler();
+		}
+	}
+
+	void *allocateAligned(std::size_t size, std::align_val_t alignment)
+	{
+		reportAllocation(size);
+
+		while (true)
+		{
+			if (void *p{_aligned_malloc(size ? size : 1, static_cast<std::size_t>(alignment))})
+				return p;
+
+			std::new_handler handler{std::get_new_handler()};
+
+			if (!handler)
+				throw std::bad_alloc{};
+
+			handler();
+		}
+	}
+}
+
+void *operator new(std::size_t size)
+{
+	return allocate(size);
+}
+
+void *operator new[](std::size_t size)
+{
+	return allocate(size);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+	return allocateAligned(size, alignment);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+	return allocateAligned(size, alignment);
+}
+
+void operator delete(void *p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void *p, std::align_val_t) noexcept
+{
+	_aligned_free(p);
+}
+
+void operator delete[](void *p, std::align_val_t) noexcept
+{
+	_aligned_free(p);
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept
+{
+	_aligned_free(p);
+}
+
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept
+{
+	_aligned_free(p);
+}
\ No newline at end of file
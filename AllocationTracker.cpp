@@ -0,0 +1,169 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+module;
+
+#include <windows.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+module AllocationTracker;
+
+namespace
+{
+	// Everything onAllocation() touches is preallocated, since it runs inside operator new or the CRT's
+	// allocation hook.
+
+	std::atomic<bool> g_active{false};
+	std::atomic<std::uint64_t> g_frame{0};
+	std::atomic<std::uint64_t> g_steadyStateFrame{0};
+	std::atomic<std::uint64_t> g_frameAllocations{0};
+	std::atomic<std::uint64_t> g_allocations{0};
+	std::atomic<std::uint64_t> g_bytes{0};
+	std::atomic<std::uint64_t> g_maxFrameAllocations{0};
+	std::atomic<std::uint64_t> g_steadyStateAllocations{0};
+	std::atomic<unsigned> g_recordCount{0};
+	AllocationRecord g_records[AllocationTracker::kMaxRecords];
+}
+
+void AllocationTracker::start(std::uint64_t steadyStateFrame)
+{
+	g_active = false;
+	g_frame = 0;
+	g_steadyStateFrame = steadyStateFrame;
+	g_frameAllocations = 0;
+	g_allocations = 0;
+	g_bytes = 0;
+	g_maxFrameAllocations = 0;
+	g_steadyStateAllocations = 0;
+	g_recordCount = 0;
+	g_active = true;
+}
+
+void AllocationTracker::stop()
+{
+	g_active = false;
+}
+
+bool AllocationTracker::active()
+{
+	return g_active;
+}
+
+void AllocationTracker::endFrame()
+{
+	if (!g_active)
+		return;
+
+	std::uint64_t frameAllocations{g_frameAllocations.exchange(0)};
+
+	if (frameAllocations > g_maxFrameAllocations)
+		g_maxFrameAllocations = frameAllocations;
+
+	++g_frame;
+}
+
+void AllocationTracker::onAllocation(std::size_t bytes)
+{
+	if (!g_active.load(std::memory_order_relaxed))
+		return;
+
+	std::uint64_t frame{g_frame.load(std::memory_order_relaxed)};
+
+	g_frameAllocations.fetch_add(1, std::memory_order_relaxed);
+	g_allocations.fetch_add(1, std::memory_order_relaxed);
+	g_bytes.fetch_add(bytes, std::memory_order_relaxed);
+
+	if (frame < g_steadyStateFrame.load(std::memory_order_relaxed))
+		return;
+
+	g_steadyStateAllocations.fetch_add(1, std::memory_order_relaxed);
+
+	unsigned index{g_recordCount.fetch_add(1)};
+
+	if (index >= kMaxRecords)
+		return;
+
+	// Skip this function and the operator new replacement that called it.
+
+	AllocationRecord &record{g_records[index]};
+
+	record.frame = frame;
+	record.bytes = bytes;
+	record.threadId = GetCurrentThreadId();
+	record.stackDepth = CaptureStackBackTrace(2, AllocationRecord::kMaxStackDepth, record.stack, nullptr);
+}
+
+AllocationStats AllocationTracker::stats()
+{
+	AllocationStats stats{};
+
+	stats.frames = g_frame;
+	stats.allocations = g_allocations;
+	stats.bytes = g_bytes;
+	stats.maxFrameAllocations = g_maxFrameAllocations;
+	stats.steadyStateAllocations = g_steadyStateAllocations;
+	return stats;
+}
+
+std::vector<AllocationRecord> AllocationTracker::violations()
+{
+	unsigned count{std::min(g_recordCount.load(), kMaxRecords)};
+	return std::vector<AllocationRecord>(g_records, g_records + count);
+}
+
+std::string AllocationTracker::describe(const AllocationRecord &record)
+{
+	char buffer[MAX_PATH + 32]{};
+
+	std::snprintf(buffer, sizeof(buffer), "frame %llu, %zu bytes, thread %lu:", static_cast<unsigned long long>(record.frame), record.bytes, record.threadId);
+
+	std::string description{buffer};
+
+	for (unsigned i = 0; i < record.stackDepth; ++i)
+	{
+		HMODULE hModule{nullptr};
+		char path[MAX_PATH]{};
+
+		if (GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, static_cast<LPCSTR>(record.stack[i]), &hModule) &&
+			GetModuleFileNameA(hModule, path, MAX_PATH))
+		{
+			const char *pszName{std::strrchr(path, '\\') ? std::strrchr(path, '\\') + 1 : path};
+			std::uintptr_t offset{reinterpret_cast<std::uintptr_t>(record.stack[i]) - reinterpret_cast<std::uintptr_t>(hModule)};
+
+			std::snprintf(buffer, sizeof(buffer), "%s%s+0x%llx", i ? " <- " : " ", pszName, static_cast<unsigned long long>(offset));
+		}
+		else
+		{
+			std::snprintf(buffer, sizeof(buffer), "%s%p", i ? " <- " : " ", record.stack[i]);
+		}
+
+		description += buffer;
+	}
+
+	return description;
+}
\ No newline at end of file
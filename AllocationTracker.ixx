@@ -0,0 +1,90 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+module;
+
+#include <windows.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+export module AllocationTracker;
+
+// The AllocationTracker class counts heap allocations per frame so that a frame loop can be
+// checked for allocations once it has warmed up. It's fed by replacements for the global
+// operator new and operator delete (see AllocationHooks.cpp), which forward to the CRT and cost a
+// single atomic load per allocation while tracking is off. Debug builds feed it from a CRT
+// allocation hook instead, which also sees malloc(), calloc() and realloc().
+//
+// Release builds only see allocations made through this executable's operator new, so a release
+// run can pass the check while the CRT heap is still used directly; run the check on a debug build
+// to cover it. The OpenGL driver and other DLLs have their own allocators and are never seen.
+//
+// Frames are numbered from zero when tracking starts. Any allocation made in or after the steady
+// state frame is a violation and the first few are recorded with their call stacks.
+
+export struct AllocationStats
+{
+	std::uint64_t frames{};
+	std::uint64_t allocations{};
+	std::uint64_t bytes{};
+	std::uint64_t maxFrameAllocations{};
+	std::uint64_t steadyStateAllocations{};
+};
+
+export struct AllocationRecord
+{
+	static constexpr unsigned kMaxStackDepth{16};
+
+	std::uint64_t frame{};
+	std::size_t bytes{};
+	DWORD threadId{};
+	unsigned stackDepth{};
+	void *stack[kMaxStackDepth]{};
+};
+
+export class AllocationTracker
+{
+public:
+	static constexpr unsigned kMaxRecords{32};
+
+	static void start(std::uint64_t steadyStateFrame);
+	static void stop();
+	static bool active();
+
+	// Called by the frame loop once at the end of every frame.
+
+	static void endFrame();
+
+	// Called by the operator new replacements and the CRT allocation hook. This mustn't allocate.
+
+	static void onAllocation(std::size_t bytes);
+
+	static AllocationStats stats();
+
+	// The recorded violations, and a one line description of one of them with each return address
+	// given as module+offset, for example "frame 120, 24 bytes, thread 4242: glLoader.exe+0x1a2b <- ...".
+	// These allocate, so call them after stop().
+
+	static std::vector<AllocationRecord> violations();
+	static std::string describe(const AllocationRecord &record);
+};
\ No newline at end of file
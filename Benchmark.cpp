@@ -0,0 +1,204 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cwchar>
+#include <memory>
+#include <string>
+
+module Benchmark;
+
+import HeadlessContext;
+import OpenGL;
+
+namespace
+{
+	using BenchmarkFunction = int (*)(const BenchmarkArguments &, BenchmarkReport &);
+
+	struct BenchmarkEntry
+	{
+		const wchar_t *pszName;
+		const char *pszReportName;
+		BenchmarkFunction function;
+	};
+
+	const BenchmarkEntry kBenchmarks[]
+	{
+		{L"aliases", "aliases", runAliasesBenchmark},
+		{L"contextpool", "contextpool", runContextPoolBenchmark},
+		{L"contexts", "contexts", runContextBenchmark},
+		{L"dispatchlayout", "dispatchlayout", runDispatchLayoutBenchmark},
+		{L"draws", "draws", runDrawBenchmark},
+		{L"edits", "edits", runEditsBenchmark},
+		{L"formats", "formats", runFormatBenchmark},
+		{L"framearena", "framearena", runFrameArenaBenchmark},
+		{L"implementations", "implementations", runImplementationsBenchmark},
+		{L"layers", "layers", runLayersBenchmark},
+		{L"makecurrent", "makecurrent", runMakeCurrentBenchmark},
+		{L"materials", "materials", runMaterialsBenchmark},
+		{L"multiwindow", "multiwindow", runMultiWindowBenchmark},
+		{L"paths", "paths", runPathsBenchmark},
+		{L"pinning", "pinning", runPinningBenchmark},
+		{L"scheduler", "scheduler", runSchedulerBenchmark},
+		{L"symbols", "symbols", runSymbolsBenchmark},
+		{L"texturebinds", "texturebinds", runTextureBindsBenchmark},
+		{L"upload", "upload", runUploadBenchmark},
+		{L"zeroalloc", "zeroalloc", runZeroAllocBenchmark},
+	};
+}
+
+bool runBenchmarkFromCommandLine(int argc, wchar_t *argv[], int &status)
+{
+	BenchmarkArguments args{argc, argv};
+	const wchar_t *pszName{args.value(L"-benchmark")};
+
+	if (!pszName)
+		return false;
+
+	for (const BenchmarkEntry &entry : kBenchmarks)
+	{
+		if (wcscmp(entry.pszName, pszName) != 0)
+			continue;
+
+		BenchmarkReport report{entry.pszReportName};
+
+		status = entry.function(args, report);
+
+		// A failed run still writes its report, which may say why it failed.
+
+		if (!report.write(args.value(L"-report")))
+			status = EXIT_FAILURE;
+
+		return true;
+	}
+
+	std::fwprintf(stderr, L"Unknown benchmark: %ls\n", pszName);
+	status = EXIT_FAILURE;
+	return true;
+}
+
+void reportDriverProperties(BenchmarkReport &report)
+{
+	auto property = [&](const char *pszKey, GLenum name)
+	{
+		const GLubyte *pszValue{glGetString(name)};
+		report.setProperty(pszKey, pszValue ? reinterpret_cast<const char *>(pszValue) : "");
+	};
+
+	property("vendor", GL_VENDOR);
+	property("renderer", GL_RENDERER);
+	property("version", GL_VERSION);
+
+	// Missing symbols explain results that would otherwise look like driver bugs.
+
+	std::string missing;
+
+	for (const std::string &name : OpenGLContext::loaderReport().missing())
+		missing += (missing.empty() ? "" : " ") + name;
+
+	if (!missing.empty())
+		report.setProperty("missingSymbols", missing);
+}
+
+int runChildProcess(const std::wstring &arguments)
+{
+	wchar_t path[MAX_PATH]{};
+
+	if (GetModuleFileNameW(nullptr, path, MAX_PATH) == 0)
+		return -1;
+
+	std::wstring commandLine{L"\"" + std::wstring{path} + L"\" " + arguments};
+	STARTUPINFOW startup{sizeof(startup)};
+	PROCESS_INFORMATION process{};
+
+	if (!CreateProcessW(path, commandLine.data(), nullptr, nullptr, FALSE, 0, nullptr, nullptr, &startup, &process))
+		return -1;
+
+	DWORD exitCode{static_cast<DWORD>(-1)};
+
+	WaitForSingleObject(process.hProcess, INFINITE);
+	GetExitCodeProcess(process.hProcess, &exitCode);
+	CloseHandle(process.hThread);
+	CloseHandle(process.hProcess);
+
+	return static_cast<int>(exitCode);
+}
+
+int runTextureCacheModes(std::span<const TextureCacheMode> modes, const std::function<bool(const TextureCacheMode &mode, HeadlessContext &context)> &runMode)
+{
+	bool ok{true};
+
+	for (const TextureCacheMode &mode : modes)
+	{
+		OpenGLContext::setTextureCache(mode.mode);
+
+		std::unique_ptr<HeadlessContext> pContext{HeadlessContext::create(64, 64)};
+
+		if (!pContext || !pContext->makeCurrent())
+		{
+			std::fprintf(stderr, "Couldn't create a context for the %s texture cache mode\n", mode.pszName);
+			ok = false;
+			break;
+		}
+
+		ok = runMode(mode, *pContext) && ok;
+		pContext->doneCurrent();
+	}
+
+	OpenGLContext::setTextureCache(OpenGLContext::TextureCache::Off);
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//
+// BenchmarkArguments methods
+//
+
+bool BenchmarkArguments::has(const wchar_t *pszName) const
+{
+	for (int i = 1; i < m_argc; ++i)
+	{
+		if (_wcsicmp(m_argv[i], pszName) == 0)
+			return true;
+	}
+
+	return false;
+}
+
+const wchar_t *BenchmarkArguments::value(const wchar_t *pszName, const wchar_t *pszDefault) const
+{
+	for (int i = 1; i < m_argc - 1; ++i)
+	{
+		if (_wcsicmp(m_argv[i], pszName) == 0)
+			return m_argv[i + 1];
+	}
+
+	return pszDefault;
+}
+
+int BenchmarkArguments::intValue(const wchar_t *pszName, int defaultValue) const
+{
+	const wchar_t *pszValue{value(pszName)};
+	return pszValue ? _wtoi(pszValue) : defaultValue;
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <functional>
+#include <span>
+#include <string>
+
+export module Benchmark;
+
+export import BenchmarkReport;
+import HeadlessContext;
+import OpenGL;
+
+// Standalone benchmarks are selected on the command line:
+//
+//     glLoader.exe -benchmark <name> [-report <file>] [benchmark specific options]
+//
+// Each benchmark writes a single JSON document to the report file, or to stdout if no report file
+// is given, and the process exit code is zero on success.
+
+// Runs the benchmark named on the command line. Returns false if the command line doesn't
+// select a benchmark, in which case status is left unchanged.
+
+export bool runBenchmarkFromCommandLine(int argc, wchar_t *argv[], int &status);
+
+// Read-only access to the benchmark options on the command line.
+
+export class BenchmarkArguments
+{
+public:
+	BenchmarkArguments(int argc, wchar_t *argv[]) : m_argc(argc), m_argv(argv) {}
+
+	bool has(const wchar_t *pszName) const;
+	const wchar_t *value(const wchar_t *pszName, const wchar_t *pszDefault = nullptr) const;
+	int intValue(const wchar_t *pszName, int defaultValue) const;
+
+private:
+	int m_argc{};
+	wchar_t **m_argv{nullptr};
+};
+
+// Adds the current context's GL_VENDOR, GL_RENDERER and GL_VERSION strings to the report properties,
+// and the symbols the loader couldn't find, if there are any.
+
+export void reportDriverProperties(BenchmarkReport &report);
+
+// Runs another instance of this executable with the given command line arguments and waits for it.
+// Returns its exit code, or -1 if it couldn't be started. Child processes inherit the environment, so
+// a benchmark can set environment variables for a case before running it.
+
+int runChildProcess(const std::wstring &arguments);
+
+// A texture cache mode to measure, and its name in the report.
+
+struct TextureCacheMode
+{
+	OpenGLContext::TextureCache mode;
+	const char *pszName;
+};
+
+// Calls runMode once for each mode, with the mode set and a new 64x64 headless context current on the
+// calling thread, since a context keeps the mode it starts with. The mode is set back to off
+// afterwards. runMode returns whether the mode's checks passed. Returns EXIT_FAILURE if a context
+// can't be created or a mode fails.
+
+int runTextureCacheModes(std::span<const TextureCacheMode> modes, const std::function<bool(const TextureCacheMode &mode, HeadlessContext &context)> &runMode);
+
+// The individual benchmarks. Each one lives in its own module implementation unit.
+
+int runAliasesBenchmark(const BenchmarkArguments &args, BenchmarkReport &report);
+int runContextBenchmark(const BenchmarkArguments &args, BenchmarkReport &report);
+int runContextPoolBenchmark(const BenchmarkArguments &args, BenchmarkReport &report);
+int runDispatchLayoutBenchmark(const BenchmarkArguments &args, BenchmarkReport &report);
+int runDrawBenchmark(const BenchmarkArguments &args, BenchmarkReport &report);
+int runEditsBenchmark(const BenchmarkArguments &args, BenchmarkReport &report);
+int runFormatBenchmark(const BenchmarkArguments &args, BenchmarkReport &report);
+int runFrameArenaBenchmark(const BenchmarkArguments &args, BenchmarkReport &report);
+int runImplementationsBenchmark(const BenchmarkArguments &args, BenchmarkReport &report);
+int runLayersBenchmark(const BenchmarkArguments &args, BenchmarkReport &report);
+int runMakeCurrentBenchmark(const BenchmarkArguments &args, BenchmarkReport &report);
+int runMaterialsBenchmark(const BenchmarkArguments &args, BenchmarkReport &report);
+int runMultiWindowBenchmark(const BenchmarkArguments &args, BenchmarkReport &report);
+int runPathsBenchmark(const BenchmarkArguments &args, BenchmarkReport &report);
+int runPinningBenchmark(const BenchmarkArguments &args, BenchmarkReport &report);
+int runSchedulerBenchmark(const BenchmarkArguments &args, BenchmarkReport &report);
+int runSymbolsBenchmark(const BenchmarkArguments &args, BenchmarkReport &report);
+int runTextureBindsBenchmark(const BenchmarkArguments &args, BenchmarkReport &report);
+int runUploadBenchmark(const BenchmarkArguments &args, BenchmarkReport &report);
+int runZeroAllocBenchmark(const BenchmarkArguments &args, BenchmarkReport &report);
\ No newline at end of file
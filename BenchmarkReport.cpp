@@ -0,0 +1,189 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+module BenchmarkReport;
+
+double percentile(std::vector<double> samples, double fraction)
+{
+	if (samples.empty())
+		return 0.0;
+
+	std::sort(samples.begin(), samples.end());
+
+	double position{std::clamp(fraction, 0.0, 1.0) * static_cast<double>(samples.size() - 1)};
+	size_t lower{static_cast<size_t>(position)};
+	size_t upper{std::min(lower + 1, samples.size() - 1)};
+
+	return samples[lower] + (samples[upper] - samples[lower]) * (position - static_cast<double>(lower));
+}
+
+std::string narrow(const wchar_t *pszText)
+{
+	std::string result;
+
+	if (!pszText)
+		return result;
+
+	if (int length{WideCharToMultiByte(CP_UTF8, 0, pszText, -1, nullptr, 0, nullptr, nullptr)}; length > 1)
+	{
+		result.resize(static_cast<size_t>(length) - 1);
+		WideCharToMultiByte(CP_UTF8, 0, pszText, -1, result.data(), length, nullptr, nullptr);
+	}
+
+	return result;
+}
+
+//
+// BenchmarkReport methods
+//
+
+void BenchmarkReport::setProperty(const char *pszKey, const std::string &value)
+{
+	m_properties.emplace_back(pszKey, quote(value));
+}
+
+void BenchmarkReport::setProperty(const char *pszKey, double value)
+{
+	m_properties.emplace_back(pszKey, number(value));
+}
+
+void BenchmarkReport::beginResult()
+{
+	m_results.emplace_back();
+}
+
+void BenchmarkReport::set(const char *pszKey, const std::string &value)
+{
+	if (m_results.empty())
+		beginResult();
+
+	m_results.back().emplace_back(pszKey, quote(value));
+}
+
+void BenchmarkReport::set(const char *pszKey, double value)
+{
+	if (m_results.empty())
+		beginResult();
+
+	m_results.back().emplace_back(pszKey, number(value));
+}
+
+std::string BenchmarkReport::toJson() const
+{
+	std::string json{"{\"benchmark\": " + quote(m_name) + ", \"properties\": " + object(m_properties) + ", \"results\": ["};
+
+	for (size_t i = 0; i < m_results.size(); ++i)
+	{
+		json += i ? ",\n  " : "\n  ";
+		json += object(m_results[i]);
+	}
+
+	json += "\n]}\n";
+	return json;
+}
+
+bool BenchmarkReport::write(const wchar_t *pszPath) const
+{
+	std::string json{toJson()};
+	FILE *pFile{stdout};
+
+	if (pszPath && _wfopen_s(&pFile, pszPath, L"wb") != 0)
+		return false;
+
+	bool ok{std::fwrite(json.data(), 1, json.size(), pFile) == json.size()};
+
+	if (pFile != stdout)
+		ok = std::fclose(pFile) == 0 && ok;
+	else
+		std::fflush(pFile);
+
+	return ok;
+}
+
+std::string BenchmarkReport::quote(const std::string &value)
+{
+	std::string quoted{"\""};
+
+	for (char c : value)
+	{
+		switch (c)
+		{
+		case '"': quoted += "\\\""; break;
+		case '\\': quoted += "\\\\"; break;
+		case '\n': quoted += "\\n"; break;
+		case '\r': quoted += "\\r"; break;
+		case '\t': quoted += "\\t"; break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20)
+			{
+				char escape[8]{};
+				std::snprintf(escape, sizeof(escape), "\\u%04x", static_cast<unsigned>(c));
+				quoted += escape;
+			}
+			else
+			{
+				quoted += c;
+			}
+			break;
+		}
+	}
+
+	return quoted + "\"";
+}
+
+std::string BenchmarkReport::number(double value)
+{
+	if (!std::isfinite(value))
+		return "null";
+
+	// Counts are written in full, since nine significant digits would round a count of a billion or more.
+	// Doubles hold every integer up to 2^53 exactly.
+
+	char buffer[32]{};
+	bool integral{value == std::trunc(value) && std::fabs(value) < 9007199254740992.0};
+
+	std::snprintf(buffer, sizeof(buffer), integral ? "%.0f" : "%.9g", value);
+	return buffer;
+}
+
+std::string BenchmarkReport::object(const Fields &fields)
+{
+	std::string json{"{"};
+
+	for (size_t i = 0; i < fields.size(); ++i)
+	{
+		if (i)
+			json += ", ";
+
+		json += quote(fields[i].first) + ": " + fields[i].second;
+	}
+
+	return json + "}";
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+export module BenchmarkReport;
+
+// The pieces of the benchmarks that the interposer shares: the JSON report, a stopwatch,
+// percentiles and wide to UTF-8 conversion. Benchmark re-exports them.
+
+// BenchmarkReport accumulates the results of a benchmark and writes them as JSON:
+//
+//     {"benchmark": "<name>", "properties": {...}, "results": [{...}, ...]}
+//
+// Properties describe the run as a whole (driver, processor count). Each result is one row of
+// the benchmark's output table.
+
+export class BenchmarkReport
+{
+public:
+	explicit BenchmarkReport(const char *pszName) : m_name(pszName) {}
+
+	void setProperty(const char *pszKey, const std::string &value);
+	void setProperty(const char *pszKey, double value);
+
+	void beginResult();
+	void set(const char *pszKey, const std::string &value);
+	void set(const char *pszKey, double value);
+
+	std::string toJson() const;
+	bool write(const wchar_t *pszPath) const;
+
+	// Returns value as a JSON string literal.
+	static std::string quote(const std::string &value);
+
+private:
+	using Fields = std::vector<std::pair<std::string, std::string>>;
+
+	static std::string number(double value);
+	static std::string object(const Fields &fields);
+
+	std::string m_name;
+	Fields m_properties;
+	std::vector<Fields> m_results;
+};
+
+// Stopwatch measures elapsed wall clock time.
+
+export class Stopwatch
+{
+public:
+	Stopwatch() : m_start(std::chrono::steady_clock::now()) {}
+
+	void restart() { m_start = std::chrono::steady_clock::now(); }
+	double seconds() const { return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count(); }
+
+private:
+	std::chrono::steady_clock::time_point m_start;
+};
+
+// Returns the value below which the given fraction of the samples fall, interpolating between
+// the two nearest samples. Returns zero if there are no samples.
+
+export double percentile(std::vector<double> samples, double fraction);
+
+// Returns the UTF-8 encoding of a wide string for use as a report value. Returns an empty string
+// for null.
+
+export std::string narrow(const wchar_t *pszText);
\ No newline at end of file
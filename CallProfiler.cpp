@@ -0,0 +1,251 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+#include "GLEntryPoints.h"
+
+module CallProfiler;
+
+import BenchmarkReport;
+import OpenGL;
+
+namespace
+{
+	namespace Entry
+	{
+		enum : unsigned
+		{
+#define ENUMERATE_ENTRY_POINT(name) name,
+			GL_DISPATCH_ENTRY_POINTS(ENUMERATE_ENTRY_POINT)
+#undef ENUMERATE_ENTRY_POINT
+			Count
+		};
+	}
+
+	const char *const kEntryNames[Entry::Count]
+	{
+#define NAME_ENTRY_POINT(name) #name,
+		GL_DISPATCH_ENTRY_POINTS(NAME_ENTRY_POINT)
+#undef NAME_ENTRY_POINT
+	};
+
+	std::atomic<std::uint64_t> g_calls[Entry::Count]{};
+	std::atomic<std::uint64_t> g_ticks[Entry::Count]{};
+	std::atomic<bool> g_timing{false};
+
+	std::mutex g_framesMutex;
+	std::uint64_t g_frames{0};
+	LARGE_INTEGER g_lastFrame{};
+	std::vector<double> g_frameSeconds;
+
+	double ticksPerSecond()
+	{
+		static const double frequency{[]()
+		{
+			LARGE_INTEGER value{};
+			QueryPerformanceFrequency(&value);
+			return static_cast<double>(value.QuadPart);
+		}()};
+
+		return frequency;
+	}
+
+	void addTicks(unsigned index, const LARGE_INTEGER &start)
+	{
+		LARGE_INTEGER end{};
+
+		QueryPerformanceCounter(&end);
+		g_ticks[index].fetch_add(static_cast<std::uint64_t>(end.QuadPart - start.QuadPart), std::memory_order_relaxed);
+	}
+
+	// One hook per entry point, generated from the entry point's type in GLDispatch.
+
+	template <unsigned Index, auto Member, typename Pfn>
+	struct Hook;
+
+	template <unsigned Index, auto Member, typename R, typename... Args>
+	struct Hook<Index, Member, R(APIENTRY *)(Args...)>
+	{
+		static R APIENTRY call(Args... args)
+		{
+			g_calls[Index].fetch_add(1, std::memory_order_relaxed);
+
+			const GLDispatch &next{GLLayer::next()};
+
+			if (!g_timing.load(std::memory_order_relaxed))
+				return (next.*Member)(args...);
+
+			LARGE_INTEGER start{};
+			QueryPerformanceCounter(&start);
+
+			if constexpr (std::is_void_v<R>)
+			{
+				(next.*Member)(args...);
+				addTicks(Index, start);
+			}
+			else
+			{
+				R result{(next.*Member)(args...)};
+				addTicks(Index, start);
+				return result;
+			}
+		}
+	};
+}
+
+std::shared_ptr<CallProfiler> CallProfiler::instance()
+{
+	static std::shared_ptr<CallProfiler> theInstance{new CallProfiler()};
+	return theInstance;
+}
+
+void CallProfiler::intercept(GLDispatch &table)
+{
+#define HOOK_ENTRY_POINT(name) \
+    table.name = Hook<Entry::name, &GLDispatch::name, decltype(GLDispatch::name)>::call;
+
+	GL_DISPATCH_ENTRY_POINTS(HOOK_ENTRY_POINT)
+
+#undef HOOK_ENTRY_POINT
+}
+
+void CallProfiler::setTiming(bool enabled)
+{
+	g_timing = enabled;
+}
+
+bool CallProfiler::timing()
+{
+	return g_timing.load(std::memory_order_relaxed);
+}
+
+void CallProfiler::endFrame()
+{
+	LARGE_INTEGER now{};
+	QueryPerformanceCounter(&now);
+
+	std::lock_guard<std::mutex> lock{g_framesMutex};
+
+	if (g_frames++ > 0)
+		g_frameSeconds.push_back(static_cast<double>(now.QuadPart - g_lastFrame.QuadPart) / ticksPerSecond());
+
+	g_lastFrame = now;
+}
+
+std::vector<CallStats> CallProfiler::calls()
+{
+	std::vector<CallStats> result;
+
+	for (unsigned i = 0; i < Entry::Count; ++i)
+	{
+		std::uint64_t count{g_calls[i].load(std::memory_order_relaxed)};
+
+		if (count > 0)
+			result.push_back(CallStats{kEntryNames[i], count, static_cast<double>(g_ticks[i].load(std::memory_order_relaxed)) / ticksPerSecond()});
+	}
+
+	std::stable_sort(result.begin(), result.end(), [](const CallStats &a, const CallStats &b) { return a.calls > b.calls; });
+	return result;
+}
+
+FrameStats CallProfiler::frames()
+{
+	FrameStats stats{};
+
+	for (const std::atomic<std::uint64_t> &count : g_calls)
+		stats.calls += count.load(std::memory_order_relaxed);
+
+	std::lock_guard<std::mutex> lock{g_framesMutex};
+
+	stats.frames = g_frames;
+
+	if (!g_frameSeconds.empty())
+	{
+		double total{0.0};
+
+		for (double seconds : g_frameSeconds)
+			total += seconds;
+
+		stats.frameMsMean = total * 1e3 / static_cast<double>(g_frameSeconds.size());
+		stats.frameMsP50 = percentile(g_frameSeconds, 0.50) * 1e3;
+		stats.frameMsP99 = percentile(g_frameSeconds, 0.99) * 1e3;
+		stats.frameMsMax = *std::max_element(g_frameSeconds.begin(), g_frameSeconds.end()) * 1e3;
+	}
+
+	return stats;
+}
+
+void CallProfiler::reset()
+{
+	for (unsigned i = 0; i < Entry::Count; ++i)
+	{
+		g_calls[i] = 0;
+		g_ticks[i] = 0;
+	}
+
+	std::lock_guard<std::mutex> lock{g_framesMutex};
+
+	g_frames = 0;
+	g_lastFrame = LARGE_INTEGER{};
+	g_frameSeconds.clear();
+}
+
+bool CallProfiler::writeReport(const wchar_t *pszPath, const char *pszApplication)
+{
+	FrameStats stats{frames()};
+	double frameCount{static_cast<double>(std::max<std::uint64_t>(1, stats.frames))};
+	BenchmarkReport report{"interposer"};
+
+	report.setProperty("application", pszApplication ? pszApplication : "");
+	report.setProperty("timing", timing() ? "on" : "off");
+	report.setProperty("frames", static_cast<double>(stats.frames));
+	report.setProperty("calls", static_cast<double>(stats.calls));
+	report.setProperty("callsPerFrame", static_cast<double>(stats.calls) / frameCount);
+	report.setProperty("frameMsMean", stats.frameMsMean);
+	report.setProperty("frameMsP50", stats.frameMsP50);
+	report.setProperty("frameMsP99", stats.frameMsP99);
+	report.setProperty("frameMsMax", stats.frameMsMax);
+
+	for (const CallStats &entry : calls())
+	{
+		report.beginResult();
+		report.set("function", entry.pszName);
+		report.set("calls", static_cast<double>(entry.calls));
+		report.set("callsPerFrame", static_cast<double>(entry.calls) / frameCount);
+
+		if (timing())
+		{
+			report.set("msPerFrame", entry.seconds * 1e3 / frameCount);
+			report.set("nsPerCall", entry.seconds * 1e9 / static_cast<double>(entry.calls));
+		}
+	}
+
+	return report.write(pszPath);
+}
\ No newline at end of file
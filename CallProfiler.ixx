@@ -0,0 +1,85 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+export module CallProfiler;
+
+import OpenGL;
+
+// The CallProfiler layer counts the calls made to every GL function the loader exports, optionally
+// times them, and keeps frame statistics. The interposer (see Interposer.cpp) inserts it on every
+// context an application makes current, and -benchmark layers measures what it costs.
+//
+// Counting is one relaxed atomic increment per call. Timing adds two QueryPerformanceCounter() calls.
+// There's a single profiler per process, which sums the calls made with every context it's inserted
+// into, and each call carries on into whatever is below it in that context's chain.
+
+export struct CallStats
+{
+	const char *pszName{};
+	std::uint64_t calls{};
+	double seconds{};
+};
+
+export struct FrameStats
+{
+	std::uint64_t frames{};
+	std::uint64_t calls{};
+	double frameMsMean{};
+	double frameMsP50{};
+	double frameMsP99{};
+	double frameMsMax{};
+};
+
+export class CallProfiler : public GLLayer
+{
+public:
+	static std::shared_ptr<CallProfiler> instance();
+
+	const char *name() const override { return "profiler"; }
+	void intercept(GLDispatch &table) override;
+
+	static void setTiming(bool enabled);
+	static bool timing();
+
+	// Called once at the end of every frame, after the application's buffers have been swapped.
+
+	static void endFrame();
+
+	// The functions that have been called, most called first. seconds is zero unless timing was on.
+
+	static std::vector<CallStats> calls();
+	static FrameStats frames();
+	static void reset();
+
+	// Write the statistics as a JSON report shaped like the benchmarks' reports, so that profiles of
+	// several runs can be stored and compared with -results. Writes to stdout if pszPath is null.
+
+	static bool writeReport(const wchar_t *pszPath, const char *pszApplication);
+
+private:
+	CallProfiler() = default;
+};
\ No newline at end of file
@@ -0,0 +1,314 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <latch>
+#include <memory>
+#include <thread>
+#include <vector>
+
+module Benchmark;
+
+import HeadlessContext;
+import OpenGL;
+
+// Measures the cost of WGL context management and how rendering with one context per thread scales.
+//
+//     -benchmark contexts [-maxthreads n] [-iterations n] [-units n] [-size n]
+//
+// Three tables are reported. The first is the latency of wglMakeCurrent() when switching between
+// two contexts, rebinding the current context and binding after a release. The second is the time
+// to create and destroy a rendering context, on its own and together with the hidden window a
+// HeadlessContext needs. The third is the throughput of 1 to n threads each rendering with its own
+// context, with the latency of the wglMakeCurrent() each thread makes per unit of work. Where the
+// speedup stops growing with the thread count a lock inside the driver is being contended.
+//
+// User-space current context tracking is disabled throughout so that every call reaches the driver.
+
+namespace
+{
+	void reportLatencies(BenchmarkReport &report, const char *pszOperation, std::vector<double> &seconds)
+	{
+		double total{0.0};
+
+		for (double sample : seconds)
+			total += sample;
+
+		report.beginResult();
+		report.set("kind", "latency");
+		report.set("operation", pszOperation);
+		report.set("samples", static_cast<double>(seconds.size()));
+		report.set("usMean", seconds.empty() ? 0.0 : total * 1e6 / seconds.size());
+		report.set("usP50", percentile(seconds, 0.50) * 1e6);
+		report.set("usP99", percentile(seconds, 0.99) * 1e6);
+		report.set("usMax", percentile(seconds, 1.0) * 1e6);
+	}
+
+	// One unit of rendering work: clear a tile and read it back, so the driver has to finish it.
+
+	void renderUnit(unsigned unit, int size)
+	{
+		std::uint32_t pixels[16 * 16]{};
+
+		glViewport(0, 0, size, size);
+		glClearColor(static_cast<float>(unit & 0xff) / 255.0f, 0.25f, 0.5f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		glReadPixels(0, 0, 16, 16, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+	}
+
+	struct ScalingResults
+	{
+		double seconds{};
+		std::vector<double> makeCurrentSeconds;
+		bool failed{};
+	};
+
+	// Each thread creates, uses and destroys its own HeadlessContext, since the hidden window must be
+	// destroyed by the thread that created it. Only the rendering between the two latches is timed.
+
+	ScalingResults runThreads(unsigned threadCount, unsigned units, int size)
+	{
+		ScalingResults results;
+		std::vector<std::vector<double>> latencies(threadCount);
+		std::vector<std::thread> threads;
+		std::latch ready{static_cast<std::ptrdiff_t>(threadCount) + 1};
+		std::latch start{1};
+		std::latch finished{static_cast<std::ptrdiff_t>(threadCount)};
+		std::atomic<bool> failed{false};
+
+		for (unsigned t = 0; t < threadCount; ++t)
+		{
+			threads.emplace_back([&, t]()
+			{
+				std::unique_ptr<HeadlessContext> pContext{HeadlessContext::create(size, size)};
+
+				if (!pContext || !pContext->makeCurrent())
+					failed = true;
+
+				latencies[t].reserve(units);
+				ready.count_down();
+				start.wait();
+
+				for (unsigned unit = 0; unit < units && !failed; ++unit)
+				{
+					pContext->wgl().wglMakeCurrent(nullptr, nullptr);
+
+					Stopwatch bind;
+
+					if (!pContext->makeCurrent())
+						failed = true;
+
+					latencies[t].push_back(bind.seconds());
+					renderUnit(unit, size);
+				}
+
+				finished.count_down();
+
+				if (pContext)
+					pContext->doneCurrent();
+			});
+		}
+
+		ready.arrive_and_wait();
+
+		Stopwatch stopwatch;
+
+		start.count_down();
+		finished.wait();
+		results.seconds = stopwatch.seconds();
+
+		for (std::thread &thread : threads)
+			thread.join();
+
+		results.failed = failed;
+
+		for (const std::vector<double> &latency : latencies)
+			results.makeCurrentSeconds.insert(results.makeCurrentSeconds.end(), latency.begin(), latency.end());
+
+		return results;
+	}
+}
+
+int runContextBenchmark(const BenchmarkArguments &args, BenchmarkReport &report)
+{
+	unsigned hardwareThreads{std::max(1u, std::thread::hardware_concurrency())};
+	unsigned maxThreads{static_cast<unsigned>(std::clamp(args.intValue(L"-maxthreads", static_cast<int>(hardwareThreads)), 1, 256))};
+	int iterations{std::max(1, args.intValue(L"-iterations", 2000))};
+	unsigned units{static_cast<unsigned>(std::max(1, args.intValue(L"-units", 500)))};
+	int size{std::max(16, args.intValue(L"-size", 64))};
+
+	std::unique_ptr<HeadlessContext> pFirst{HeadlessContext::create(size, size)};
+	std::unique_ptr<HeadlessContext> pSecond{HeadlessContext::create(size, size)};
+
+	if (!pFirst || !pSecond || !pFirst->makeCurrent())
+		return EXIT_FAILURE;
+
+	bool tracking{OpenGLContext::currentTracking()};
+
+	OpenGLContext::setCurrentTracking(false);
+	reportDriverProperties(report);
+	report.setProperty("maxThreads", maxThreads);
+	report.setProperty("iterations", iterations);
+	report.setProperty("units", units);
+	report.setProperty("size", size);
+
+	OpenGLContext &wgl{pFirst->wgl()};
+	std::vector<double> switchSeconds, rebindSeconds, bindAfterReleaseSeconds;
+
+	// Make current latency. Each context draws something between calls so the driver has work to
+	// flush when it's switched away.
+
+	for (int i = 0; i < iterations; ++i)
+	{
+		HeadlessContext &next{(i & 1) ? *pFirst : *pSecond};
+
+		renderUnit(i, size);
+
+		Stopwatch stopwatch;
+
+		wgl.wglMakeCurrent(next.dc(), next.rc());
+		switchSeconds.push_back(stopwatch.seconds());
+	}
+
+	for (int i = 0; i < iterations; ++i)
+	{
+		HGLRC hRC{wgl.wglGetCurrentContext()};
+		HDC hDC{wgl.wglGetCurrentDC()};
+		Stopwatch stopwatch;
+
+		wgl.wglMakeCurrent(hDC, hRC);
+		rebindSeconds.push_back(stopwatch.seconds());
+	}
+
+	for (int i = 0; i < iterations; ++i)
+	{
+		wgl.wglMakeCurrent(nullptr, nullptr);
+
+		Stopwatch stopwatch;
+
+		wgl.wglMakeCurrent(pFirst->dc(), pFirst->rc());
+		bindAfterReleaseSeconds.push_back(stopwatch.seconds());
+	}
+
+	reportLatencies(report, "makeCurrentSwitch", switchSeconds);
+	reportLatencies(report, "makeCurrentRebind", rebindSeconds);
+	reportLatencies(report, "makeCurrentAfterRelease", bindAfterReleaseSeconds);
+
+	// Creation and destruction. Contexts are expensive to create, so fewer iterations are used.
+
+	int lifetimes{std::max(1, iterations / 20)};
+	std::vector<double> createSeconds, deleteSeconds, headlessCreateSeconds, headlessDestroySeconds;
+
+	for (int i = 0; i < lifetimes; ++i)
+	{
+		Stopwatch create;
+		HGLRC hRC{wgl.wglCreateContext(pSecond->dc())};
+
+		createSeconds.push_back(create.seconds());
+
+		if (!hRC)
+			break;
+
+		wgl.wglMakeCurrent(pSecond->dc(), hRC);
+		renderUnit(i, size);
+		wgl.wglMakeCurrent(pFirst->dc(), pFirst->rc());
+
+		Stopwatch destroy;
+
+		wgl.wglDeleteContext(hRC);
+		deleteSeconds.push_back(destroy.seconds());
+	}
+
+	for (int i = 0; i < lifetimes; ++i)
+	{
+		Stopwatch create;
+		std::unique_ptr<HeadlessContext> pContext{HeadlessContext::create(size, size)};
+
+		headlessCreateSeconds.push_back(create.seconds());
+
+		if (!pContext)
+			break;
+
+		Stopwatch destroy;
+
+		pContext.reset();
+		headlessDestroySeconds.push_back(destroy.seconds());
+	}
+
+	pFirst->makeCurrent();
+
+	reportLatencies(report, "wglCreateContext", createSeconds);
+	reportLatencies(report, "wglDeleteContext", deleteSeconds);
+	reportLatencies(report, "headlessContextCreate", headlessCreateSeconds);
+	reportLatencies(report, "headlessContextDestroy", headlessDestroySeconds);
+
+	// Scaling with one context per thread. Every thread does the same amount of work, so perfect
+	// scaling keeps the elapsed time constant as threads are added.
+
+	pFirst->doneCurrent();
+
+	std::vector<unsigned> threadCounts;
+	double singleThreadRate{0.0};
+	bool failed{false};
+
+	for (unsigned threadCount = 1; threadCount < maxThreads; threadCount = (threadCount < 4) ? threadCount + 1 : threadCount * 2)
+		threadCounts.push_back(threadCount);
+
+	threadCounts.push_back(maxThreads);
+
+	for (unsigned threadCount : threadCounts)
+	{
+		ScalingResults results{runThreads(threadCount, units, size)};
+
+		if (results.failed)
+		{
+			failed = true;
+			break;
+		}
+
+		double rate{static_cast<double>(threadCount) * units / results.seconds};
+
+		if (threadCount == 1)
+			singleThreadRate = rate;
+
+		report.beginResult();
+		report.set("kind", "scaling");
+		report.set("threads", threadCount);
+		report.set("unitsPerSecond", rate);
+		report.set("speedup", rate / singleThreadRate);
+		report.set("efficiency", rate / singleThreadRate / threadCount);
+		report.set("makeCurrentUsP50", percentile(results.makeCurrentSeconds, 0.50) * 1e6);
+		report.set("makeCurrentUsP99", percentile(results.makeCurrentSeconds, 0.99) * 1e6);
+	}
+
+	OpenGLContext::setCurrentTracking(tracking);
+	pSecond.reset();
+	pFirst.reset();
+
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,223 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+module ContextPool;
+
+namespace
+{
+	std::int64_t nowNanoseconds()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+}
+
+struct ContextLease::Entry
+{
+	std::unique_ptr<HeadlessContext> pContext;
+	GLStateTracker tracker;
+};
+
+//
+// ContextLease methods
+//
+
+ContextLease::ContextLease(ContextLease &&other) noexcept : m_pPool(other.m_pPool), m_pEntry(other.m_pEntry)
+{
+	other.m_pPool = nullptr;
+	other.m_pEntry = nullptr;
+}
+
+ContextLease &ContextLease::operator=(ContextLease &&other) noexcept
+{
+	if (this != &other)
+	{
+		release();
+		m_pPool = other.m_pPool;
+		m_pEntry = other.m_pEntry;
+		other.m_pPool = nullptr;
+		other.m_pEntry = nullptr;
+	}
+
+	return *this;
+}
+
+ContextLease::~ContextLease()
+{
+	release();
+}
+
+HeadlessContext &ContextLease::context() const
+{
+	return *m_pEntry->pContext;
+}
+
+void ContextLease::release()
+{
+	if (m_pPool && m_pEntry)
+		m_pPool->release(m_pEntry);
+
+	m_pPool = nullptr;
+	m_pEntry = nullptr;
+}
+
+//
+// ContextPool methods
+//
+
+std::unique_ptr<ContextPool> ContextPool::create(unsigned size, int width, int height, HGLRC hShareContext, const WarmUpFunction &warmUp)
+{
+	std::unique_ptr<ContextPool> pPool{new ContextPool()};
+
+	for (unsigned i = 0; i < size; ++i)
+	{
+		std::unique_ptr<ContextLease::Entry> pEntry{new ContextLease::Entry()};
+
+		if (!(pEntry->pContext = HeadlessContext::create(width, height, hShareContext)))
+			return std::unique_ptr<ContextPool>{};
+
+		if (!pEntry->pContext->makeCurrent())
+			return std::unique_ptr<ContextPool>{};
+
+		// Run the warm-up with the tracker current so that whatever state it leaves behind is reset.
+
+		GLStateTracker::makeCurrent(&pEntry->tracker);
+
+		if (warmUp)
+			warmUp(*pEntry->pContext);
+
+		pEntry->tracker.resetToDefaults(width, height);
+		GLStateTracker::makeCurrent(nullptr);
+		glFinish();
+		pEntry->pContext->doneCurrent();
+
+		pPool->m_free.push_back(pEntry.get());
+		pPool->m_entries.push_back(std::move(pEntry));
+	}
+
+	return pPool;
+}
+
+ContextPool::~ContextPool()
+{
+}
+
+ContextLease ContextPool::acquire()
+{
+	std::int64_t start{nowNanoseconds()};
+	std::unique_lock<std::mutex> lock{m_mutex};
+	bool waited{m_free.empty()};
+
+	m_available.wait(lock, [this]() { return !m_free.empty(); });
+
+	ContextLease::Entry *pEntry{m_free.back()};
+	m_free.pop_back();
+	lock.unlock();
+
+	return lease(pEntry, start, waited);
+}
+
+ContextLease ContextPool::tryAcquire()
+{
+	std::int64_t start{nowNanoseconds()};
+	std::unique_lock<std::mutex> lock{m_mutex};
+
+	if (m_free.empty())
+		return ContextLease{};
+
+	ContextLease::Entry *pEntry{m_free.back()};
+	m_free.pop_back();
+	lock.unlock();
+
+	return lease(pEntry, start, false);
+}
+
+void ContextPool::resetStats()
+{
+	m_acquisitions = 0;
+	m_waits = 0;
+	m_resetCalls = 0;
+	m_totalAcquireNanoseconds = 0;
+	m_maxAcquireNanoseconds = 0;
+}
+
+ContextPoolStats ContextPool::stats() const
+{
+	ContextPoolStats stats{};
+
+	stats.acquisitions = m_acquisitions.load();
+	stats.waits = m_waits.load();
+	stats.resetCalls = m_resetCalls.load();
+	stats.totalAcquireSeconds = static_cast<double>(m_totalAcquireNanoseconds.load()) * 1e-9;
+	stats.maxAcquireSeconds = static_cast<double>(m_maxAcquireNanoseconds.load()) * 1e-9;
+
+	return stats;
+}
+
+ContextLease ContextPool::lease(ContextLease::Entry *pEntry, std::int64_t startNanoseconds, bool waited)
+{
+	pEntry->pContext->makeCurrent();
+	GLStateTracker::makeCurrent(&pEntry->tracker);
+
+	std::int64_t elapsed{nowNanoseconds() - startNanoseconds};
+	std::int64_t previousMax{m_maxAcquireNanoseconds.load()};
+
+	while (elapsed > previousMax && !m_maxAcquireNanoseconds.compare_exchange_weak(previousMax, elapsed))
+	{
+	}
+
+	m_totalAcquireNanoseconds.fetch_add(elapsed, std::memory_order_relaxed);
+	m_acquisitions.fetch_add(1, std::memory_order_relaxed);
+
+	if (waited)
+		m_waits.fetch_add(1, std::memory_order_relaxed);
+
+	return ContextLease{this, pEntry};
+}
+
+void ContextPool::release(ContextLease::Entry *pEntry)
+{
+	HeadlessContext &context{*pEntry->pContext};
+
+	if (pEntry->tracker.dirty())
+		m_resetCalls.fetch_add(pEntry->tracker.resetToDefaults(context.width(), context.height()), std::memory_order_relaxed);
+
+	GLStateTracker::makeCurrent(nullptr);
+	context.doneCurrent();
+
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		m_free.push_back(pEntry);
+	}
+
+	m_available.notify_one();
+}
\ No newline at end of file
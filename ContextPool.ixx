@@ -0,0 +1,134 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+export module ContextPool;
+
+import HeadlessContext;
+import OpenGL;
+
+// The ContextPool class keeps a fixed number of pre-created headless rendering contexts ready for
+// short-lived rendering tasks, so a task doesn't pay for wglCreateContext and wglDeleteContext.
+// Each pooled context has a GLStateTracker that's current while the context is leased. When a lease
+// ends only the state the task changed is restored to its default value before the context goes back
+// into the pool, so the next task always starts from a known state.
+// The pool must be destroyed on the thread that created it.
+
+export class ContextPool;
+
+export struct ContextPoolStats
+{
+	std::uint64_t acquisitions{};
+	std::uint64_t waits{};
+	std::uint64_t resetCalls{};
+	double totalAcquireSeconds{};
+	double maxAcquireSeconds{};
+
+	double meanAcquireSeconds() const { return acquisitions ? totalAcquireSeconds / acquisitions : 0.0; }
+};
+
+// A ContextLease makes a pooled context current on the calling thread for as long as it exists.
+
+export class ContextLease
+{
+public:
+	ContextLease() = default;
+	ContextLease(ContextLease &&other) noexcept;
+	ContextLease &operator=(ContextLease &&other) noexcept;
+	~ContextLease();
+
+	ContextLease(const ContextLease &) = delete;
+	ContextLease &operator=(const ContextLease &) = delete;
+
+	explicit operator bool() const { return m_pEntry != nullptr; }
+	HeadlessContext &context() const;
+
+	// Return the context to the pool early.
+
+	void release();
+
+private:
+	friend class ContextPool;
+
+	struct Entry;
+
+	ContextLease(ContextPool *pPool, Entry *pEntry) : m_pPool(pPool), m_pEntry(pEntry) {}
+
+	ContextPool *m_pPool{nullptr};
+	Entry *m_pEntry{nullptr};
+};
+
+export class ContextPool
+{
+public:
+	using WarmUpFunction = std::function<void(HeadlessContext &)>;
+
+	// Create a pool of size contexts whose drawables are width by height pixels. If hShareContext isn't
+	// null every pooled context shares objects with it. warmUp, if given, is called once with each context
+	// current so that shaders, textures or driver-internal state can be created ahead of the first task.
+
+	static std::unique_ptr<ContextPool> create(unsigned size, int width, int height, HGLRC hShareContext = nullptr, const WarmUpFunction &warmUp = {});
+
+	~ContextPool();
+
+	ContextPool(const ContextPool &) = delete;
+	ContextPool &operator=(const ContextPool &) = delete;
+
+	// Lease a context, blocking until one is available. The context is current on return.
+
+	ContextLease acquire();
+
+	// Lease a context if one is available without blocking. Otherwise returns an empty lease.
+
+	ContextLease tryAcquire();
+
+	unsigned size() const { return static_cast<unsigned>(m_entries.size()); }
+
+	void resetStats();
+	ContextPoolStats stats() const;
+
+private:
+	friend class ContextLease;
+
+	ContextPool() = default;
+
+	ContextLease lease(ContextLease::Entry *pEntry, std::int64_t startNanoseconds, bool waited);
+	void release(ContextLease::Entry *pEntry);
+
+	std::vector<std::unique_ptr<ContextLease::Entry>> m_entries;
+	std::vector<ContextLease::Entry *> m_free;
+	std::mutex m_mutex;
+	std::condition_variable m_available;
+	std::atomic<std::uint64_t> m_acquisitions{0};
+	std::atomic<std::uint64_t> m_waits{0};
+	std::atomic<std::uint64_t> m_resetCalls{0};
+	std::atomic<std::int64_t> m_totalAcquireNanoseconds{0};
+	std::atomic<std::int64_t> m_maxAcquireNanoseconds{0};
+};
\ No newline at end of file
@@ -0,0 +1,180 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+module Benchmark;
+
+import ContextPool;
+import HeadlessContext;
+import OpenGL;
+
+// Compares short-lived rendering tasks that create and destroy their own context with tasks that
+// lease a context from a ContextPool.
+//
+//     -benchmark contextpool [-tasks n] [-threads n] [-size n]
+//
+// Each task changes some state, clears and reads back a small tile. The acquisition latency is
+// the time to create and make current a new context, or the time to lease one from the pool.
+
+namespace
+{
+	void renderTask(unsigned task, int size)
+	{
+		std::vector<std::uint32_t> tile(static_cast<size_t>(size) * size);
+
+		glViewport(0, 0, size, size);
+		glEnable(GL_SCISSOR_TEST);
+		glScissor(0, 0, size / 2, size / 2);
+		glClearColor(static_cast<float>(task & 0xff) / 255.0f, 0.0f, 1.0f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glReadPixels(0, 0, size, size, GL_RGBA, GL_UNSIGNED_BYTE, tile.data());
+	}
+
+	struct TaskResults
+	{
+		double seconds{};
+		std::vector<double> acquireSeconds;
+		bool failed{};
+	};
+
+	template <typename RunTask>
+	TaskResults runTasks(unsigned taskCount, unsigned threadCount, RunTask runTask)
+	{
+		TaskResults results;
+		std::vector<std::vector<double>> latencies(threadCount);
+		std::vector<std::thread> threads;
+		std::atomic<unsigned> nextTask{0};
+		std::atomic<bool> failed{false};
+		Stopwatch stopwatch;
+
+		for (unsigned t = 0; t < threadCount; ++t)
+		{
+			threads.emplace_back([&, t]()
+			{
+				for (unsigned task = nextTask++; task < taskCount; task = nextTask++)
+				{
+					if (!runTask(task, latencies[t]))
+						failed = true;
+				}
+			});
+		}
+
+		for (std::thread &thread : threads)
+			thread.join();
+
+		results.seconds = stopwatch.seconds();
+		results.failed = failed;
+
+		for (const std::vector<double> &latency : latencies)
+			results.acquireSeconds.insert(results.acquireSeconds.end(), latency.begin(), latency.end());
+
+		return results;
+	}
+
+	void reportResults(BenchmarkReport &report, const char *pszMode, unsigned taskCount, const TaskResults &results)
+	{
+		report.beginResult();
+		report.set("mode", pszMode);
+		report.set("tasks", taskCount);
+		report.set("seconds", results.seconds);
+		report.set("tasksPerSecond", static_cast<double>(taskCount) / results.seconds);
+		report.set("acquireMsP50", percentile(results.acquireSeconds, 0.50) * 1e3);
+		report.set("acquireMsP99", percentile(results.acquireSeconds, 0.99) * 1e3);
+		report.set("acquireMsMax", percentile(results.acquireSeconds, 1.0) * 1e3);
+	}
+}
+
+int runContextPoolBenchmark(const BenchmarkArguments &args, BenchmarkReport &report)
+{
+	unsigned taskCount{static_cast<unsigned>(std::max(1, args.intValue(L"-tasks", 512)))};
+	unsigned threadCount{static_cast<unsigned>(std::max(1, args.intValue(L"-threads", 4)))};
+	int size{std::max(16, args.intValue(L"-size", 64))};
+
+	report.setProperty("tasks", taskCount);
+	report.setProperty("threads", threadCount);
+	report.setProperty("size", size);
+
+	// Without pooling every task pays for a complete context lifetime.
+
+	TaskResults unpooled{runTasks(taskCount, threadCount, [size](unsigned task, std::vector<double> &latencies)
+	{
+		Stopwatch acquire;
+		std::unique_ptr<HeadlessContext> pContext{HeadlessContext::create(size, size)};
+
+		if (!pContext || !pContext->makeCurrent())
+			return false;
+
+		latencies.push_back(acquire.seconds());
+		renderTask(task, size);
+		pContext.reset();
+		return true;
+	})};
+
+	if (unpooled.failed)
+		return EXIT_FAILURE;
+
+	bool driverReported{false};
+	Stopwatch poolCreation;
+	std::unique_ptr<ContextPool> pPool{ContextPool::create(threadCount, size, size, nullptr, [&](HeadlessContext &)
+	{
+		if (!driverReported)
+			reportDriverProperties(report);
+
+		driverReported = true;
+		renderTask(0, size);
+	})};
+
+	if (!pPool)
+		return EXIT_FAILURE;
+
+	report.setProperty("poolCreationSeconds", poolCreation.seconds());
+
+	TaskResults pooled{runTasks(taskCount, threadCount, [&pPool, size](unsigned task, std::vector<double> &latencies)
+	{
+		Stopwatch acquire;
+		ContextLease lease{pPool->acquire()};
+
+		latencies.push_back(acquire.seconds());
+		renderTask(task, size);
+		return true;
+	})};
+
+	ContextPoolStats stats{pPool->stats()};
+
+	reportResults(report, "unpooled", taskCount, unpooled);
+	reportResults(report, "pooled", taskCount, pooled);
+	report.set("resetCallsPerTask", static_cast<double>(stats.resetCalls) / static_cast<double>(std::max<std::uint64_t>(1, stats.acquisitions)));
+	report.set("waits", static_cast<double>(stats.waits));
+	report.set("speedup", unpooled.seconds / pooled.seconds);
+
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,215 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+module Benchmark;
+
+import CallProfiler;
+import HeadlessContext;
+import OpenGL;
+
+// Measures a dispatch-heavy frame with the dispatch tables in declaration order and laid out from a
+// usage profile.
+//
+//     -benchmark dispatchlayout [-profile file] [-header file] [-frames n] [-evict kb]
+//
+// Each frame makes 24 cheap state calls spread over the whole table. The profile is read from -profile,
+// for example an interposer report, or recorded by running one frame under the CallProfiler layer.
+// Every layout is run warm and with the caches evicted before each frame, as they would be by the rest
+// of an application's frame. Hardware cache miss counters aren't readable from user mode on Windows,
+// so the report gives the number of table cache lines the frame touches, which is the number of L1d
+// misses dispatch adds to an evicted frame, along with the time. -header writes the profile's layout
+// as GLDispatchLayout.h for a GLLOADER_BAKED_DISPATCH_LAYOUT build.
+
+namespace
+{
+	const char *const kFrameFunctions[]
+	{
+		"glBindTexture", "glBlendFunc", "glClearColor", "glColorMask", "glCullFace", "glDepthFunc",
+		"glDepthMask", "glDepthRange", "glDisable", "glEnable", "glFrontFace", "glGetError",
+		"glGetIntegerv", "glHint", "glIsEnabled", "glLineWidth", "glPixelStorei", "glPolygonOffset",
+		"glScissor", "glStencilFunc", "glStencilMask", "glStencilOp", "glTexParameteri", "glViewport",
+	};
+
+	void renderFrame(GLuint texture, int frame)
+	{
+		GLint viewport[4]{};
+
+		glViewport(0, 0, 64, 64);
+		glScissor(0, 0, 32, 32);
+		glEnable(GL_SCISSOR_TEST);
+		glDisable(GL_SCISSOR_TEST);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		glClearColor(static_cast<float>(frame & 0xff) / 255.0f, 0.0f, 0.0f, 1.0f);
+		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+		glCullFace(GL_BACK);
+		glFrontFace(GL_CCW);
+		glDepthFunc(GL_LEQUAL);
+		glDepthMask(GL_TRUE);
+		glDepthRange(0.0, 1.0);
+		glHint(GL_LINE_SMOOTH_HINT, GL_DONT_CARE);
+		glLineWidth(1.0f);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glPolygonOffset(0.0f, 0.0f);
+		glStencilFunc(GL_ALWAYS, 0, ~0u);
+		glStencilMask(~0u);
+		glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glIsEnabled(GL_BLEND);
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		glGetError();
+	}
+
+	// The distinct cache lines of the packed table that the frame's functions occupy.
+
+	int linesTouched()
+	{
+		std::vector<std::string> layout{OpenGLContext::dispatchLayout()};
+		std::set<std::size_t> lines;
+
+		for (const char *pszName : kFrameFunctions)
+		{
+			auto it{std::find(layout.begin(), layout.end(), pszName)};
+			lines.insert(static_cast<std::size_t>(it - layout.begin()) * sizeof(void *) / 64);
+		}
+
+		return static_cast<int>(lines.size());
+	}
+
+	// Returns the seconds spent in the frames themselves, not evicting.
+
+	double runFrames(GLuint texture, int frames, std::vector<std::uint8_t> *pEvict)
+	{
+		double seconds{0.0};
+
+		for (int frame = 0; frame < frames; ++frame)
+		{
+			if (pEvict)
+			{
+				for (std::size_t i = 0; i < pEvict->size(); i += 64)
+					++(*pEvict)[i];
+			}
+
+			Stopwatch stopwatch;
+			renderFrame(texture, frame);
+			seconds += stopwatch.seconds();
+		}
+
+		return seconds;
+	}
+
+	std::vector<DispatchUsage> recordProfile(HGLRC hRC, GLuint texture)
+	{
+		std::shared_ptr<CallProfiler> pProfiler{CallProfiler::instance()};
+		std::vector<DispatchUsage> profile;
+
+		CallProfiler::reset();
+		OpenGLContext::insertLayer(hRC, pProfiler);
+		renderFrame(texture, 0);
+		OpenGLContext::removeLayer(hRC, pProfiler.get());
+
+		for (const CallStats &stats : CallProfiler::calls())
+			profile.push_back(DispatchUsage{stats.pszName, stats.calls});
+
+		CallProfiler::reset();
+		return profile;
+	}
+}
+
+int runDispatchLayoutBenchmark(const BenchmarkArguments &args, BenchmarkReport &report)
+{
+	int frames{std::max(1, args.intValue(L"-frames", 100000))};
+	std::size_t evictBytes{static_cast<std::size_t>(std::max(64, args.intValue(L"-evict", 1024))) * 1024};
+	const wchar_t *pszProfile{args.value(L"-profile")};
+	const wchar_t *pszHeader{args.value(L"-header")};
+
+	std::unique_ptr<HeadlessContext> pContext{HeadlessContext::create(64, 64)};
+
+	if (!pContext || !pContext->makeCurrent())
+		return EXIT_FAILURE;
+
+	reportDriverProperties(report);
+	report.setProperty("frames", frames);
+	report.setProperty("callsPerFrame", static_cast<double>(std::size(kFrameFunctions)));
+	report.setProperty("evictKB", static_cast<double>(evictBytes / 1024));
+
+	GLuint texture{};
+	glGenTextures(1, &texture);
+
+	std::vector<std::uint8_t> evict(evictBytes);
+	std::vector<DispatchUsage> profile{recordProfile(pContext->rc(), texture)};
+
+	// A baked layout can't be changed, so there's only the one to measure.
+
+	bool baked{!OpenGLContext::setDispatchProfile({})};
+
+	report.setProperty("profile", pszProfile ? "file" : "recorded");
+	report.setProperty("baked", baked ? "yes" : "no");
+
+	for (bool profiled : {false, true})
+	{
+		if (profiled && !baked)
+		{
+			if (pszProfile ? !OpenGLContext::loadDispatchProfile(pszProfile) : !OpenGLContext::setDispatchProfile(profile))
+				return EXIT_FAILURE;
+
+			if (pszHeader && !OpenGLContext::writeDispatchLayoutHeader(pszHeader))
+				return EXIT_FAILURE;
+		}
+
+		for (bool evicted : {false, true})
+		{
+			std::vector<std::uint8_t> *pEvict{evicted ? &evict : nullptr};
+
+			runFrames(texture, std::min(frames, 1000), pEvict);
+
+			double seconds{runFrames(texture, frames, pEvict)};
+
+			report.beginResult();
+			report.set("layout", baked ? "baked" : (profiled ? "profile" : "declaration"));
+			report.set("caches", evicted ? "evicted" : "warm");
+			report.set("linesTouched", linesTouched());
+			report.set("nsPerFrame", seconds * 1e9 / frames);
+			report.set("nsPerCall", seconds * 1e9 / (static_cast<double>(frames) * std::size(kFrameFunctions)));
+		}
+
+		if (baked)
+			break;
+	}
+
+	OpenGLContext::setDispatchProfile({});
+
+	glDeleteTextures(1, &texture);
+	pContext->doneCurrent();
+
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,216 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cwchar>
+#include <functional>
+#include <memory>
+#include <vector>
+
+module Benchmark;
+
+import HeadlessContext;
+import OpenGL;
+
+// Measures draw call throughput and the incremental cost of individual state changes, all made through
+// the loader's entry points.
+//
+//     -benchmark draws [-draws n] [-repeats n] [-size n]
+//
+// Draws use client-side vertex arrays in the compatibility profile, which works on any driver
+// including llvmpipe. Each draw is a batch of small triangles. A state change's cost is the time for
+// draws with that change made before every one, minus the time for the same draws without it.
+
+namespace
+{
+	const GLenum kVertexArray{0x8074};
+
+	struct VertexArrayFunctions
+	{
+		using PFNGLVERTEXPOINTERPROC = void(APIENTRY *)(GLint size, GLenum type, GLsizei stride, const void *pointer);
+		using PFNGLENABLECLIENTSTATEPROC = void(APIENTRY *)(GLenum array);
+
+		PFNGLVERTEXPOINTERPROC pfnVertexPointer{nullptr};
+		PFNGLENABLECLIENTSTATEPROC pfnEnableClientState{nullptr};
+		PFNGLENABLECLIENTSTATEPROC pfnDisableClientState{nullptr};
+
+		bool load(OpenGLContext &context)
+		{
+			pfnVertexPointer = reinterpret_cast<PFNGLVERTEXPOINTERPROC>(context.wglGetProcAddress("glVertexPointer"));
+			pfnEnableClientState = reinterpret_cast<PFNGLENABLECLIENTSTATEPROC>(context.wglGetProcAddress("glEnableClientState"));
+			pfnDisableClientState = reinterpret_cast<PFNGLENABLECLIENTSTATEPROC>(context.wglGetProcAddress("glDisableClientState"));
+			return pfnVertexPointer && pfnEnableClientState && pfnDisableClientState;
+		}
+	};
+
+	// The median over several repeats of the time per draw, in seconds.
+
+	double timeDraws(int draws, int repeats, const std::function<void(int)> &draw)
+	{
+		std::vector<double> samples;
+
+		draw(0);
+		glFinish();
+
+		for (int repeat = 0; repeat < repeats; ++repeat)
+		{
+			Stopwatch stopwatch;
+
+			for (int i = 0; i < draws; ++i)
+				draw(i);
+
+			glFinish();
+			samples.push_back(stopwatch.seconds() / draws);
+		}
+
+		return percentile(samples, 0.5);
+	}
+}
+
+int runDrawBenchmark(const BenchmarkArguments &args, BenchmarkReport &report)
+{
+	int draws{std::max(1, args.intValue(L"-draws", 20000))};
+	int repeats{std::max(1, args.intValue(L"-repeats", 5))};
+	int size{std::max(16, args.intValue(L"-size", 256))};
+	std::unique_ptr<HeadlessContext> pContext{HeadlessContext::create(size, size)};
+	VertexArrayFunctions arrays;
+
+	if (!pContext || !pContext->makeCurrent())
+		return EXIT_FAILURE;
+
+	if (!arrays.load(pContext->wgl()))
+	{
+		std::fwprintf(stderr, L"The draws benchmark needs client-side vertex arrays (a compatibility profile context).\n");
+		return EXIT_FAILURE;
+	}
+
+	reportDriverProperties(report);
+	report.setProperty("draws", draws);
+	report.setProperty("repeats", repeats);
+	report.setProperty("size", size);
+
+	// A strip of tiny triangles across the middle of the viewport, each covering a few pixels.
+
+	const int kMaxVertices{3000};
+	std::vector<GLfloat> vertices;
+	std::vector<GLushort> indices;
+
+	for (int i = 0; i < kMaxVertices / 3; ++i)
+	{
+		GLfloat x{-0.9f + 1.8f * static_cast<GLfloat>(i) / (kMaxVertices / 3)};
+		GLfloat corners[]{x, 0.0f, x + 0.01f, 0.0f, x, 0.01f};
+
+		vertices.insert(vertices.end(), std::begin(corners), std::end(corners));
+	}
+
+	for (int i = 0; i < kMaxVertices; ++i)
+		indices.push_back(static_cast<GLushort>(i));
+
+	glViewport(0, 0, size, size);
+	glClear(GL_COLOR_BUFFER_BIT);
+	arrays.pfnEnableClientState(kVertexArray);
+	arrays.pfnVertexPointer(2, GL_FLOAT, 0, vertices.data());
+
+	for (int vertexCount : {3, 30, 300, kMaxVertices})
+	{
+		for (bool elements : {false, true})
+		{
+			double seconds{timeDraws(draws, repeats, [&](int)
+			{
+				if (elements)
+					glDrawElements(GL_TRIANGLES, vertexCount, GL_UNSIGNED_SHORT, indices.data());
+				else
+					glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+			})};
+
+			report.beginResult();
+			report.set("kind", "draw");
+			report.set("call", elements ? "glDrawElements" : "glDrawArrays");
+			report.set("vertices", vertexCount);
+			report.set("drawsPerSecond", 1.0 / seconds);
+			report.set("verticesPerSecond", vertexCount / seconds);
+			report.set("nsPerDraw", seconds * 1e9);
+		}
+	}
+
+	// State changes alternate between two values so the driver can't discard them as redundant.
+
+	GLuint textures[2]{};
+
+	glGenTextures(2, textures);
+
+	for (GLuint texture : textures)
+	{
+		const std::uint32_t texel{0xffffffffu};
+
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, &texel);
+	}
+
+	glEnable(GL_TEXTURE_2D);
+
+	struct StateChange
+	{
+		const char *pszName;
+		std::function<void(int)> change;
+	};
+
+	const StateChange changes[]
+	{
+		{"glEnable/glDisable", [](int i) { if (i & 1) glEnable(GL_BLEND); else glDisable(GL_BLEND); }},
+		{"glBlendFunc", [](int i) { glBlendFunc(GL_SRC_ALPHA, (i & 1) ? GL_ONE : GL_ONE_MINUS_SRC_ALPHA); }},
+		{"glBindTexture", [&textures](int i) { glBindTexture(GL_TEXTURE_2D, textures[i & 1]); }},
+		{"glTexParameteri", [](int i) { glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, (i & 1) ? GL_LINEAR : GL_NEAREST); }},
+		{"glViewport", [size](int i) { glViewport(0, 0, size - (i & 1), size); }},
+	};
+
+	// The baseline is a single triangle draw with texturing enabled, as every state change is measured with.
+
+	double baseline{timeDraws(draws, repeats, [](int) { glDrawArrays(GL_TRIANGLES, 0, 3); })};
+
+	for (const StateChange &state : changes)
+	{
+		double seconds{timeDraws(draws, repeats, [&state](int i)
+		{
+			state.change(i);
+			glDrawArrays(GL_TRIANGLES, 0, 3);
+		})};
+
+		report.beginResult();
+		report.set("kind", "state");
+		report.set("state", state.pszName);
+		report.set("nsPerDrawWithChange", seconds * 1e9);
+		report.set("nsPerChange", std::max(0.0, seconds - baseline) * 1e9);
+		report.set("costRelativeToDraw", std::max(0.0, seconds - baseline) / baseline);
+	}
+
+	glDisable(GL_TEXTURE_2D);
+	glDeleteTextures(2, textures);
+	arrays.pfnDisableClientState(kVertexArray);
+
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
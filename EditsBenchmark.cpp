@@ -0,0 +1,262 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+module Benchmark;
+
+import HeadlessContext;
+import OpenGL;
+
+// Measures an edit-heavy frame made with bind-to-edit calls and with the direct state access ones.
+//
+//     -benchmark edits [-edits n] [-frames n]
+//
+// Every draw is preceded by an edit of one of the streamed textures and of one of the streamed
+// buffers, such as a dynamic texture or a block of per-object constants. The bind-to-edit code binds
+// each object, edits it and binds the draw's texture and vertex buffer back, while the direct state
+// access code edits the object by name and leaves the bindings alone. Without direct state access the
+// loader emulates it from the bindings it tracks, so both rows then make the same binds and the second
+// shows what the emulation costs. A few textures and buffers are edited in turn, each edit replacing
+// a whole 16x16 texture and 256 bytes of constants with the frame number and flipping the texture's
+// magnification filter, so the last frame's edits can be read back. Both ways run with the texture
+// binding cache off and on. Fails if an edit is lost or a binding is wrong afterwards.
+
+namespace
+{
+	struct BufferFunctions
+	{
+		PFNGLGENBUFFERSPROC glGenBuffers{nullptr};
+		PFNGLBUFFERDATAPROC glBufferData{nullptr};
+		PFNGLBUFFERSUBDATAPROC glBufferSubData{nullptr};
+		PFNGLGETBUFFERSUBDATAPROC glGetBufferSubData{nullptr};
+	};
+
+	struct Objects
+	{
+		GLuint drawTexture{};
+		GLuint drawBuffer{};
+		std::vector<GLuint> textures;
+		std::vector<GLuint> buffers;
+	};
+
+	constexpr int kTextureSize{16};
+
+	void renderFrame(const BufferFunctions &functions, const Objects &objects, int edits, int frame, bool directStateAccess)
+	{
+		std::uint32_t texels[kTextureSize * kTextureSize];
+		std::uint32_t constants[64];
+
+		std::fill(std::begin(texels), std::end(texels), static_cast<std::uint32_t>(frame));
+		std::fill(std::begin(constants), std::end(constants), static_cast<std::uint32_t>(frame));
+
+		GLint filter{(frame & 1) ? GL_LINEAR : GL_NEAREST};
+
+		for (int edit = 0; edit < edits; ++edit)
+		{
+			GLuint texture{objects.textures[edit % objects.textures.size()]};
+			GLuint buffer{objects.buffers[edit % objects.buffers.size()]};
+
+			if (directStateAccess)
+			{
+				glTextureSubImage2D(texture, 0, 0, 0, kTextureSize, kTextureSize, GL_RGBA, GL_UNSIGNED_BYTE, texels);
+				glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, filter);
+				glNamedBufferSubData(buffer, 0, sizeof(constants), constants);
+			}
+			else
+			{
+				glBindTexture(GL_TEXTURE_2D, texture);
+				glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, kTextureSize, kTextureSize, GL_RGBA, GL_UNSIGNED_BYTE, texels);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+				glBindTexture(GL_TEXTURE_2D, objects.drawTexture);
+
+				glBindBuffer(GL_ARRAY_BUFFER, buffer);
+				functions.glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(constants), constants);
+				glBindBuffer(GL_ARRAY_BUFFER, objects.drawBuffer);
+			}
+
+			glDrawArrays(GL_TRIANGLES, 0, 3);
+		}
+	}
+
+	// The last edit of each object must have landed, and the draw's texture and buffer must still be bound.
+
+	bool checkEdits(const BufferFunctions &functions, const Objects &objects, int edits, int lastFrame)
+	{
+		GLint texture{};
+		GLint buffer{};
+
+		glGetIntegerv(GL_TEXTURE_BINDING_2D, &texture);
+		glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &buffer);
+
+		bool ok{static_cast<GLuint>(texture) == objects.drawTexture && static_cast<GLuint>(buffer) == objects.drawBuffer};
+		std::vector<std::uint32_t> texels(kTextureSize * kTextureSize);
+		std::uint32_t constant{};
+		GLint filter{};
+
+		for (int edit = 0; edit < std::min(edits, static_cast<int>(objects.textures.size())); ++edit)
+		{
+			glBindTexture(GL_TEXTURE_2D, objects.textures[edit]);
+			glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+			glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, &filter);
+
+			ok = ok && texels.front() == static_cast<std::uint32_t>(lastFrame) && texels.back() == static_cast<std::uint32_t>(lastFrame);
+			ok = ok && filter == ((lastFrame & 1) ? GL_LINEAR : GL_NEAREST);
+		}
+
+		for (int edit = 0; edit < std::min(edits, static_cast<int>(objects.buffers.size())); ++edit)
+		{
+			glBindBuffer(GL_ARRAY_BUFFER, objects.buffers[edit]);
+			functions.glGetBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(constant), &constant);
+			ok = ok && constant == static_cast<std::uint32_t>(lastFrame);
+		}
+
+		glBindTexture(GL_TEXTURE_2D, objects.drawTexture);
+		glBindBuffer(GL_ARRAY_BUFFER, objects.drawBuffer);
+		return ok;
+	}
+}
+
+int runEditsBenchmark(const BenchmarkArguments &args, BenchmarkReport &report)
+{
+	int edits{std::max(1, args.intValue(L"-edits", 2000))};
+	int frames{std::max(1, args.intValue(L"-frames", 200))};
+	int status{EXIT_SUCCESS};
+
+	report.setProperty("edits", edits);
+	report.setProperty("frames", frames);
+
+	const TextureCacheMode modes[]
+	{
+		{OpenGLContext::TextureCache::Off, "off"},
+		{OpenGLContext::TextureCache::Shadow, "cached"},
+	};
+
+	// Both ways of editing run in each mode before the next mode.
+
+	for (const TextureCacheMode &cacheMode : modes)
+	{
+		for (bool directStateAccess : {false, true})
+		{
+			int modeStatus{runTextureCacheModes({&cacheMode, 1}, [&](const TextureCacheMode &mode, HeadlessContext &headless)
+			{
+				OpenGLContext &context{headless.wgl()};
+				const GLExtensions &extensions{context.extensions()};
+				BufferFunctions functions;
+
+				functions.glGenBuffers = reinterpret_cast<PFNGLGENBUFFERSPROC>(context.wglGetProcAddress("glGenBuffers"));
+				functions.glBufferData = reinterpret_cast<PFNGLBUFFERDATAPROC>(context.wglGetProcAddress("glBufferData"));
+				functions.glBufferSubData = reinterpret_cast<PFNGLBUFFERSUBDATAPROC>(context.wglGetProcAddress("glBufferSubData"));
+				functions.glGetBufferSubData = reinterpret_cast<PFNGLGETBUFFERSUBDATAPROC>(context.wglGetProcAddress("glGetBufferSubData"));
+
+				if (!extensions.version().atLeast(1, 5) || !functions.glGenBuffers || !functions.glBufferData || !functions.glBufferSubData || !functions.glGetBufferSubData)
+				{
+					std::fprintf(stderr, "The edits benchmark needs GL 1.5 buffer objects\n");
+					return false;
+				}
+
+				if (mode.mode == OpenGLContext::TextureCache::Off && !directStateAccess)
+				{
+					reportDriverProperties(report);
+					report.setProperty("directStateAccess", extensions.version().atLeast(4, 5) || extensions.has<GLExtensions::ARB_direct_state_access>() ? "yes" : "no");
+				}
+
+				// A few objects are edited in turn, as a ring of per-frame resources would be.
+
+				Objects objects;
+				const std::uint32_t texels[kTextureSize * kTextureSize]{};
+				const std::uint32_t constants[64]{};
+
+				objects.textures.resize(std::min(edits, 8));
+				objects.buffers.resize(objects.textures.size());
+				glGenTextures(static_cast<GLsizei>(objects.textures.size()), objects.textures.data());
+				glGenTextures(1, &objects.drawTexture);
+				functions.glGenBuffers(static_cast<GLsizei>(objects.buffers.size()), objects.buffers.data());
+				functions.glGenBuffers(1, &objects.drawBuffer);
+
+				for (GLuint texture : objects.textures)
+				{
+					glBindTexture(GL_TEXTURE_2D, texture);
+					glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, kTextureSize, kTextureSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels);
+				}
+
+				for (GLuint buffer : objects.buffers)
+				{
+					glBindBuffer(GL_ARRAY_BUFFER, buffer);
+					functions.glBufferData(GL_ARRAY_BUFFER, sizeof(constants), constants, GL_DYNAMIC_DRAW);
+				}
+
+				glBindTexture(GL_TEXTURE_2D, objects.drawTexture);
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, kTextureSize, kTextureSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels);
+				glBindBuffer(GL_ARRAY_BUFFER, objects.drawBuffer);
+				functions.glBufferData(GL_ARRAY_BUFFER, sizeof(constants), constants, GL_STATIC_DRAW);
+
+				renderFrame(functions, objects, edits, 0, directStateAccess);
+				glFinish();
+				OpenGLContext::resetTextureCacheStats();
+				OpenGLContext::resetDirectStateAccessStats();
+
+				Stopwatch stopwatch;
+
+				for (int frame = 1; frame <= frames; ++frame)
+					renderFrame(functions, objects, edits, frame, directStateAccess);
+
+				glFinish();
+
+				double seconds{stopwatch.seconds()};
+				OpenGLContext::TextureCacheStats textureStats{OpenGLContext::textureCacheStats()};
+				OpenGLContext::DirectStateAccessStats stats{OpenGLContext::directStateAccessStats()};
+				bool correct{checkEdits(functions, objects, edits, frames)};
+
+				report.beginResult();
+				report.set("cache", mode.pszName);
+				report.set("edit", directStateAccess ? "dsa" : "bind");
+				report.set("usPerFrame", seconds * 1e6 / frames);
+				report.set("dsaCallsPerFrame", static_cast<double>(stats.calls) / frames);
+				report.set("emulatedPerFrame", static_cast<double>(stats.emulated) / frames);
+				report.set("editBindsPerFrame", static_cast<double>(stats.editBinds) / frames);
+				report.set("bindCallsPerFrame", static_cast<double>(textureStats.bindCalls) / frames);
+				report.set("bindsForwardedPerFrame", static_cast<double>(textureStats.bindsForwarded) / frames);
+				report.set("correct", correct ? "yes" : "no");
+
+				glDeleteTextures(static_cast<GLsizei>(objects.textures.size()), objects.textures.data());
+				glDeleteTextures(1, &objects.drawTexture);
+				glDeleteBuffers(static_cast<GLsizei>(objects.buffers.size()), objects.buffers.data());
+				glDeleteBuffers(1, &objects.drawBuffer);
+
+				return correct;
+			})};
+
+			if (modeStatus != EXIT_SUCCESS)
+				status = EXIT_FAILURE;
+		}
+	}
+
+	return status;
+}
\ No newline at end of file
@@ -0,0 +1,360 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+module FastPaths;
+
+namespace
+{
+	// Streamed allocations are aligned for any vertex attribute type.
+
+	const std::size_t kStreamAlignment{16};
+
+	std::size_t alignUp(std::size_t value, std::size_t alignment = kStreamAlignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	// Creating a buffer is checked with glGetError(), so clear any errors left by earlier calls first.
+
+	void clearErrors()
+	{
+		for (int i = 0; i < 16 && glGetError() != GL_NO_ERROR; ++i)
+			;
+	}
+}
+
+CapabilityProfile CapabilityProfile::detect(OpenGLContext &context, CapabilityTier maxTier)
+{
+	const GLExtensions &extensions{context.extensions()};
+	const GLVersion &version{extensions.version()};
+	bool buffers{maxTier >= CapabilityTier::Buffers};
+	bool modern{maxTier >= CapabilityTier::Modern};
+	CapabilityProfile profile{};
+
+	profile.version = version;
+	profile.multiDraw = buffers && version.atLeast(1, 4);
+	profile.mapBufferRange = buffers && version.atLeast(1, 5) && (version.atLeast(3, 0) || extensions.has<GLExtensions::ARB_map_buffer_range>());
+	profile.directStateAccess = modern && (version.atLeast(4, 5) || extensions.has<GLExtensions::ARB_direct_state_access>());
+	profile.bufferStorage = modern && profile.mapBufferRange && (version.atLeast(4, 4) || extensions.has<GLExtensions::ARB_buffer_storage>()) &&
+		(version.atLeast(3, 2) || extensions.has<GLExtensions::ARB_sync>());
+	profile.multiDrawIndirect = modern && (version.atLeast(4, 3) || extensions.has<GLExtensions::ARB_multi_draw_indirect>());
+	profile.compressionS3tc = extensions.has<GLExtensions::EXT_texture_compression_s3tc>();
+	profile.compressionRgtc = buffers && (version.atLeast(3, 0) || extensions.has<GLExtensions::ARB_texture_compression_rgtc>());
+	profile.compressionBptc = modern && (version.atLeast(4, 2) || extensions.has<GLExtensions::ARB_texture_compression_bptc>());
+
+	if (profile.directStateAccess && profile.bufferStorage && profile.multiDrawIndirect)
+		profile.tier = CapabilityTier::Modern;
+	else if (profile.mapBufferRange && profile.multiDraw)
+		profile.tier = CapabilityTier::Buffers;
+
+	return profile;
+}
+
+const char *CapabilityProfile::tierName(CapabilityTier tier)
+{
+	switch (tier)
+	{
+	case CapabilityTier::Legacy: return "legacy";
+	case CapabilityTier::Buffers: return "buffers";
+	case CapabilityTier::Modern: return "modern";
+	}
+
+	return "unknown";
+}
+
+std::unique_ptr<FastPaths> FastPaths::create(OpenGLContext &context, CapabilityTier maxTier, std::size_t streamBytes)
+{
+	std::unique_ptr<FastPaths> pPaths{new FastPaths()};
+	const CapabilityProfile &profile{pPaths->m_profile = CapabilityProfile::detect(context, maxTier)};
+
+	auto load = [&context](auto &pfn, const char *pszName)
+	{
+		pfn = reinterpret_cast<std::remove_reference_t<decltype(pfn)>>(context.wglGetProcAddress(pszName));
+		return pfn != nullptr;
+	};
+
+	if (profile.directStateAccess && load(pPaths->m_pfnTextureSubImage2D, "glTextureSubImage2D"))
+	{
+		pPaths->m_pfnUpload = uploadDirect;
+		pPaths->m_pszUploadPath = "direct";
+	}
+
+	// BPTC is preferred for its quality at the same size. Compressed uploads need OpenGL 1.3 or later,
+	// whichever tier the rest of the paths are capped at.
+
+	if (profile.compressionBptc)
+		pPaths->m_compressedFormat = GL_COMPRESSED_RGBA_BPTC_UNORM;
+	else if (profile.compressionS3tc)
+		pPaths->m_compressedFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+
+	if (pPaths->m_compressedFormat && profile.directStateAccess && load(pPaths->m_pfnCompressedTextureSubImage2D, "glCompressedTextureSubImage2D"))
+	{
+		pPaths->m_pfnUploadCompressed = uploadCompressedDirect;
+		pPaths->m_pszCompressedUploadPath = "direct";
+	}
+	else if (pPaths->m_compressedFormat && profile.version.atLeast(1, 3) && load(pPaths->m_pfnCompressedTexSubImage2D, "glCompressedTexSubImage2D"))
+	{
+		pPaths->m_pfnUploadCompressed = uploadCompressedBind;
+		pPaths->m_pszCompressedUploadPath = "bind";
+	}
+	else
+	{
+		pPaths->m_compressedFormat = 0;
+	}
+
+	if (profile.multiDrawIndirect && load(pPaths->m_pfnMultiDrawArraysIndirect, "glMultiDrawArraysIndirect"))
+	{
+		pPaths->m_pfnDraw = drawIndirect;
+		pPaths->m_pszDrawPath = "indirect";
+	}
+	else if (profile.multiDraw && load(pPaths->m_pfnMultiDrawArrays, "glMultiDrawArrays"))
+	{
+		pPaths->m_pfnDraw = drawMulti;
+		pPaths->m_pszDrawPath = "multi";
+	}
+
+	bool bufferFunctions{profile.mapBufferRange &&
+		load(pPaths->m_pfnGenBuffers, "glGenBuffers") && load(pPaths->m_pfnDeleteBuffers, "glDeleteBuffers") &&
+		load(pPaths->m_pfnBindBuffer, "glBindBuffer") && load(pPaths->m_pfnBufferData, "glBufferData") &&
+		load(pPaths->m_pfnMapBufferRange, "glMapBufferRange") && load(pPaths->m_pfnUnmapBuffer, "glUnmapBuffer")};
+
+	bool storageFunctions{bufferFunctions && profile.bufferStorage &&
+		load(pPaths->m_pfnBufferStorage, "glBufferStorage") && load(pPaths->m_pfnFenceSync, "glFenceSync") &&
+		load(pPaths->m_pfnClientWaitSync, "glClientWaitSync") && load(pPaths->m_pfnDeleteSync, "glDeleteSync")};
+
+	pPaths->m_streamBytes = alignUp(std::max<std::size_t>(streamBytes, 1), kStreamRegions * kStreamAlignment);
+
+	if (storageFunctions && pPaths->createPersistentStream(pPaths->m_streamBytes))
+	{
+		pPaths->m_pfnStream = streamPersistent;
+		pPaths->m_pszStreamPath = "persistent";
+	}
+	else if (bufferFunctions && pPaths->createMappedStream(pPaths->m_streamBytes))
+	{
+		pPaths->m_pfnStream = streamMapped;
+		pPaths->m_pszStreamPath = "mapped";
+	}
+	else
+	{
+		pPaths->m_clientStream.resize(pPaths->m_streamBytes);
+	}
+
+	return pPaths;
+}
+
+FastPaths::~FastPaths()
+{
+	for (GLsync &fence : m_fences)
+	{
+		if (fence)
+			m_pfnDeleteSync(fence);
+
+		fence = nullptr;
+	}
+
+	if (m_buffer)
+	{
+		if (m_pMapped)
+		{
+			m_pfnBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+			m_pfnUnmapBuffer(GL_ARRAY_BUFFER);
+		}
+
+		m_pfnDeleteBuffers(1, &m_buffer);
+	}
+}
+
+bool FastPaths::createMappedStream(std::size_t streamBytes)
+{
+	clearErrors();
+	m_pfnGenBuffers(1, &m_buffer);
+	m_pfnBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+	m_pfnBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(streamBytes), nullptr, GL_STREAM_DRAW);
+	m_pfnBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	if (glGetError() == GL_NO_ERROR)
+		return true;
+
+	m_pfnDeleteBuffers(1, &m_buffer);
+	m_buffer = 0;
+	return false;
+}
+
+bool FastPaths::createPersistentStream(std::size_t streamBytes)
+{
+	const GLbitfield flags{GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT};
+
+	clearErrors();
+	m_pfnGenBuffers(1, &m_buffer);
+	m_pfnBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+	m_pfnBufferStorage(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(streamBytes), nullptr, flags);
+	m_pMapped = static_cast<unsigned char *>(m_pfnMapBufferRange(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(streamBytes), flags));
+	m_pfnBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	if (m_pMapped && glGetError() == GL_NO_ERROR)
+		return true;
+
+	m_pMapped = nullptr;
+	m_pfnDeleteBuffers(1, &m_buffer);
+	m_buffer = 0;
+	return false;
+}
+
+void FastPaths::uploadBind(FastPaths &, GLuint texture, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels)
+{
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, format, type, pixels);
+}
+
+void FastPaths::uploadDirect(FastPaths &paths, GLuint texture, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels)
+{
+	paths.m_pfnTextureSubImage2D(texture, 0, x, y, width, height, format, type, pixels);
+}
+
+void FastPaths::uploadCompressedNone(FastPaths &, GLuint, GLint, GLint, GLsizei, GLsizei, GLsizei, const void *)
+{
+}
+
+void FastPaths::uploadCompressedBind(FastPaths &paths, GLuint texture, GLint x, GLint y, GLsizei width, GLsizei height, GLsizei imageSize, const void *data)
+{
+	glBindTexture(GL_TEXTURE_2D, texture);
+	paths.m_pfnCompressedTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, paths.m_compressedFormat, imageSize, data);
+}
+
+void FastPaths::uploadCompressedDirect(FastPaths &paths, GLuint texture, GLint x, GLint y, GLsizei width, GLsizei height, GLsizei imageSize, const void *data)
+{
+	paths.m_pfnCompressedTextureSubImage2D(texture, 0, x, y, width, height, paths.m_compressedFormat, imageSize, data);
+}
+
+const void *FastPaths::streamClient(FastPaths &paths, const void *pData, std::size_t bytes)
+{
+	// Client arrays are read during the draw call, so the ring can wrap without any synchronisation.
+
+	if (paths.m_streamOffset + bytes > paths.m_streamBytes)
+		paths.m_streamOffset = 0;
+
+	unsigned char *pDestination{paths.m_clientStream.data() + paths.m_streamOffset};
+
+	std::memcpy(pDestination, pData, bytes);
+	paths.m_streamOffset = alignUp(paths.m_streamOffset + bytes);
+	return pDestination;
+}
+
+const void *FastPaths::streamMapped(FastPaths &paths, const void *pData, std::size_t bytes)
+{
+	paths.m_pfnBindBuffer(GL_ARRAY_BUFFER, paths.m_buffer);
+
+	// When the buffer is full orphan it, so the driver can hand out fresh storage while draws still
+	// read the old contents. Until then ranges are written unsynchronised, since they're never reused.
+
+	if (paths.m_streamOffset + bytes > paths.m_streamBytes)
+	{
+		paths.m_pfnBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(paths.m_streamBytes), nullptr, GL_STREAM_DRAW);
+		paths.m_streamOffset = 0;
+	}
+
+	std::size_t offset{paths.m_streamOffset};
+	void *pDestination{paths.m_pfnMapBufferRange(GL_ARRAY_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(bytes),
+		GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT)};
+
+	if (pDestination)
+	{
+		std::memcpy(pDestination, pData, bytes);
+		paths.m_pfnUnmapBuffer(GL_ARRAY_BUFFER);
+	}
+
+	paths.m_streamOffset = alignUp(offset + bytes);
+	return reinterpret_cast<const void *>(static_cast<std::uintptr_t>(offset));
+}
+
+const void *FastPaths::streamPersistent(FastPaths &paths, const void *pData, std::size_t bytes)
+{
+	// The ring is split into regions. Leaving a region fences the draws that read it, and entering one
+	// waits for its fence, which has normally long since signalled.
+
+	std::size_t regionBytes{paths.m_streamBytes / kStreamRegions};
+	std::size_t offset{paths.m_streamOffset};
+
+	assert(bytes <= regionBytes);
+
+	if (offset + bytes > (paths.m_streamRegion + 1) * regionBytes)
+	{
+		unsigned next{(paths.m_streamRegion + 1) % kStreamRegions};
+
+		paths.m_fences[paths.m_streamRegion] = paths.m_pfnFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+		if (GLsync fence{paths.m_fences[next]})
+		{
+			GLbitfield flags{GL_SYNC_FLUSH_COMMANDS_BIT};
+
+			while (paths.m_pfnClientWaitSync(fence, flags, 1000000) == GL_TIMEOUT_EXPIRED)
+				flags = 0;
+
+			paths.m_pfnDeleteSync(fence);
+			paths.m_fences[next] = nullptr;
+		}
+
+		paths.m_streamRegion = next;
+		offset = next * regionBytes;
+	}
+
+	std::memcpy(paths.m_pMapped + offset, pData, bytes);
+	paths.m_streamOffset = alignUp(offset + bytes);
+	paths.m_pfnBindBuffer(GL_ARRAY_BUFFER, paths.m_buffer);
+
+	return reinterpret_cast<const void *>(static_cast<std::uintptr_t>(offset));
+}
+
+void FastPaths::drawLoop(FastPaths &, GLenum mode, const GLint *pFirst, const GLsizei *pCount, GLsizei drawCount)
+{
+	for (GLsizei i = 0; i < drawCount; ++i)
+		glDrawArrays(mode, pFirst[i], pCount[i]);
+}
+
+void FastPaths::drawMulti(FastPaths &paths, GLenum mode, const GLint *pFirst, const GLsizei *pCount, GLsizei drawCount)
+{
+	paths.m_pfnMultiDrawArrays(mode, pFirst, pCount, drawCount);
+}
+
+void FastPaths::drawIndirect(FastPaths &paths, GLenum mode, const GLint *pFirst, const GLsizei *pCount, GLsizei drawCount)
+{
+	// The command array only grows, so steady-state frames don't allocate.
+
+	if (paths.m_commands.size() < static_cast<std::size_t>(drawCount))
+		paths.m_commands.resize(drawCount);
+
+	for (GLsizei i = 0; i < drawCount; ++i)
+		paths.m_commands[i] = DrawArraysIndirectCommand{static_cast<GLuint>(pCount[i]), 1, static_cast<GLuint>(pFirst[i]), 0};
+
+	paths.m_pfnMultiDrawArraysIndirect(mode, paths.m_commands.data(), drawCount, 0);
+}
\ No newline at end of file
@@ -0,0 +1,205 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+export module FastPaths;
+
+import OpenGL;
+
+// The FastPaths class picks the fastest implementation of a few higher-level operations that the
+// current context supports, once, when it's created. Each operation is then a call through a function
+// pointer, so call sites don't branch on versions or extensions.
+//
+//     uploadTexture()     glTextureSubImage2D() with direct state access, otherwise bind and glTexSubImage2D()
+//     uploadCompressedTexture()
+//                         the same for blocks of compressedFormat(), BPTC if it's supported, otherwise S3TC DXT5,
+//                         with glCompressedTextureSubImage2D() or glCompressedTexSubImage2D()
+//     stream()            a persistently mapped ring buffer with buffer storage, glMapBufferRange() into an
+//                         orphaned buffer with map buffer range, otherwise a ring of client memory
+//     multiDrawArrays()   glMultiDrawArraysIndirect(), glMultiDrawArrays(), otherwise a glDrawArrays() loop
+//
+// The capabilities are grouped into tiers, and a tier can be given to create() to cap the paths that
+// are used, so every path can be exercised on a single driver. Like the rest of the loader this assumes
+// a compatibility profile context: streamed data is drawn with client array pointers and indirect draw
+// commands are read from client memory.
+
+export enum class CapabilityTier
+{
+	Legacy,		// OpenGL 1.1
+	Buffers,	// OpenGL 3.0: buffer objects, glMapBufferRange() and glMultiDrawArrays()
+	Modern,		// OpenGL 4.5: direct state access, buffer storage and multi-draw indirect
+};
+
+export struct CapabilityProfile
+{
+	GLVersion version{};
+	CapabilityTier tier{CapabilityTier::Legacy};
+	bool multiDraw{};
+	bool mapBufferRange{};
+	bool directStateAccess{};
+	bool bufferStorage{};
+	bool multiDrawIndirect{};
+	bool compressionS3tc{};
+	bool compressionRgtc{};
+	bool compressionBptc{};
+
+	// Work out the current context's capabilities, ignoring any above maxTier.
+
+	static CapabilityProfile detect(OpenGLContext &context, CapabilityTier maxTier = CapabilityTier::Modern);
+
+	static const char *tierName(CapabilityTier tier);
+};
+
+export class FastPaths
+{
+public:
+	// Select the paths for the current context. streamBytes is the size of the stream ring. Paths fall back
+	// to a lower tier if their entry points or buffers can't be created, so this only fails if out of memory.
+	// The FastPaths must be destroyed with the same context current.
+
+	static std::unique_ptr<FastPaths> create(OpenGLContext &context, CapabilityTier maxTier = CapabilityTier::Modern, std::size_t streamBytes = 4 << 20);
+
+	~FastPaths();
+
+	FastPaths(const FastPaths &) = delete;
+	FastPaths &operator=(const FastPaths &) = delete;
+
+	const CapabilityProfile &profile() const { return m_profile; }
+
+	// Replace part of level 0 of a GL_TEXTURE_2D texture. The bind path leaves the texture bound.
+
+	void uploadTexture(GLuint texture, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels)
+	{
+		m_pfnUpload(*this, texture, x, y, width, height, format, type, pixels);
+	}
+
+	// Copy vertex data into the stream and return the pointer to give to glVertexPointer() and friends.
+	// The buffer paths leave the stream's buffer bound to GL_ARRAY_BUFFER and return an offset into it.
+	// The data stays valid for at least the rest of the frame; bytes mustn't exceed streamBytes / 4.
+
+	const void *stream(const void *pData, std::size_t bytes)
+	{
+		return m_pfnStream(*this, pData, bytes);
+	}
+
+	// Draw drawCount ranges of vertices from the enabled arrays.
+
+	void multiDrawArrays(GLenum mode, const GLint *pFirst, const GLsizei *pCount, GLsizei drawCount)
+	{
+		m_pfnDraw(*this, mode, pFirst, pCount, drawCount);
+	}
+
+	// The RGBA block-compressed internal format that uploadCompressedTexture() expects, or zero if the
+	// context supports neither BPTC nor S3TC. Both formats use 16 bytes per 4x4 block.
+
+	GLenum compressedFormat() const { return m_compressedFormat; }
+
+	// Replace part of level 0 of a GL_TEXTURE_2D texture in compressedFormat() with imageSize bytes of
+	// blocks. The bind path leaves the texture bound. Does nothing if there's no compressed format.
+
+	void uploadCompressedTexture(GLuint texture, GLint x, GLint y, GLsizei width, GLsizei height, GLsizei imageSize, const void *data)
+	{
+		m_pfnUploadCompressed(*this, texture, x, y, width, height, imageSize, data);
+	}
+
+	// The names of the selected paths, for reports.
+
+	const char *uploadPath() const { return m_pszUploadPath; }
+	const char *compressedUploadPath() const { return m_pszCompressedUploadPath; }
+	const char *streamPath() const { return m_pszStreamPath; }
+	const char *drawPath() const { return m_pszDrawPath; }
+
+private:
+	using UploadTextureFunction = void (*)(FastPaths &paths, GLuint texture, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels);
+	using UploadCompressedFunction = void (*)(FastPaths &paths, GLuint texture, GLint x, GLint y, GLsizei width, GLsizei height, GLsizei imageSize, const void *data);
+	using StreamFunction = const void *(*)(FastPaths &paths, const void *pData, std::size_t bytes);
+	using MultiDrawArraysFunction = void (*)(FastPaths &paths, GLenum mode, const GLint *pFirst, const GLsizei *pCount, GLsizei drawCount);
+
+	struct DrawArraysIndirectCommand
+	{
+		GLuint count;
+		GLuint instanceCount;
+		GLuint first;
+		GLuint baseInstance;
+	};
+
+	static const unsigned kStreamRegions{4};
+
+	FastPaths() = default;
+
+	bool createMappedStream(std::size_t streamBytes);
+	bool createPersistentStream(std::size_t streamBytes);
+
+	static void uploadBind(FastPaths &paths, GLuint texture, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels);
+	static void uploadDirect(FastPaths &paths, GLuint texture, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels);
+	static void uploadCompressedNone(FastPaths &paths, GLuint texture, GLint x, GLint y, GLsizei width, GLsizei height, GLsizei imageSize, const void *data);
+	static void uploadCompressedBind(FastPaths &paths, GLuint texture, GLint x, GLint y, GLsizei width, GLsizei height, GLsizei imageSize, const void *data);
+	static void uploadCompressedDirect(FastPaths &paths, GLuint texture, GLint x, GLint y, GLsizei width, GLsizei height, GLsizei imageSize, const void *data);
+	static const void *streamClient(FastPaths &paths, const void *pData, std::size_t bytes);
+	static const void *streamMapped(FastPaths &paths, const void *pData, std::size_t bytes);
+	static const void *streamPersistent(FastPaths &paths, const void *pData, std::size_t bytes);
+	static void drawLoop(FastPaths &paths, GLenum mode, const GLint *pFirst, const GLsizei *pCount, GLsizei drawCount);
+	static void drawMulti(FastPaths &paths, GLenum mode, const GLint *pFirst, const GLsizei *pCount, GLsizei drawCount);
+	static void drawIndirect(FastPaths &paths, GLenum mode, const GLint *pFirst, const GLsizei *pCount, GLsizei drawCount);
+
+	CapabilityProfile m_profile{};
+
+	UploadTextureFunction m_pfnUpload{uploadBind};
+	UploadCompressedFunction m_pfnUploadCompressed{uploadCompressedNone};
+	StreamFunction m_pfnStream{streamClient};
+	MultiDrawArraysFunction m_pfnDraw{drawLoop};
+	const char *m_pszUploadPath{"bind"};
+	const char *m_pszCompressedUploadPath{"none"};
+	const char *m_pszStreamPath{"client"};
+	const char *m_pszDrawPath{"loop"};
+
+	PFNGLGENBUFFERSPROC m_pfnGenBuffers{nullptr};
+	PFNGLDELETEBUFFERSPROC m_pfnDeleteBuffers{nullptr};
+	PFNGLBINDBUFFERPROC m_pfnBindBuffer{nullptr};
+	PFNGLBUFFERDATAPROC m_pfnBufferData{nullptr};
+	PFNGLBUFFERSTORAGEPROC m_pfnBufferStorage{nullptr};
+	PFNGLMAPBUFFERRANGEPROC m_pfnMapBufferRange{nullptr};
+	PFNGLUNMAPBUFFERPROC m_pfnUnmapBuffer{nullptr};
+	PFNGLFENCESYNCPROC m_pfnFenceSync{nullptr};
+	PFNGLCLIENTWAITSYNCPROC m_pfnClientWaitSync{nullptr};
+	PFNGLDELETESYNCPROC m_pfnDeleteSync{nullptr};
+	PFNGLTEXTURESUBIMAGE2DPROC m_pfnTextureSubImage2D{nullptr};
+	PFNGLCOMPRESSEDTEXSUBIMAGE2DPROC m_pfnCompressedTexSubImage2D{nullptr};
+	PFNGLCOMPRESSEDTEXTURESUBIMAGE2DPROC m_pfnCompressedTextureSubImage2D{nullptr};
+	PFNGLMULTIDRAWARRAYSPROC m_pfnMultiDrawArrays{nullptr};
+	PFNGLMULTIDRAWARRAYSINDIRECTPROC m_pfnMultiDrawArraysIndirect{nullptr};
+
+	GLenum m_compressedFormat{};
+	std::vector<unsigned char> m_clientStream;
+	std::vector<DrawArraysIndirectCommand> m_commands;
+	GLuint m_buffer{};
+	unsigned char *m_pMapped{nullptr};
+	GLsync m_fences[kStreamRegions]{};
+	std::size_t m_streamBytes{};
+	std::size_t m_streamOffset{};
+	unsigned m_streamRegion{};
+};
\ No newline at end of file
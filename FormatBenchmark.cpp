@@ -0,0 +1,88 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+module Benchmark;
+
+import HeadlessContext;
+import OpenGL;
+import TextureFormats;
+
+// Compares texture uploads using the naive client format and type with uploads using the internal
+// format, format and type chosen by a FormatNegotiator.
+//
+//     -benchmark formats [-size n] [-iterations n] [-cache file]
+//
+// With -cache the negotiated formats are read from, or written to, the given file, and the report's
+// negotiationSeconds shows how much startup time the cache saves.
+
+int runFormatBenchmark(const BenchmarkArguments &args, BenchmarkReport &report)
+{
+	int size{std::max(16, args.intValue(L"-size", 1024))};
+	int iterations{std::max(1, args.intValue(L"-iterations", 32))};
+	std::unique_ptr<HeadlessContext> pContext{HeadlessContext::create(64, 64)};
+
+	if (!pContext || !pContext->makeCurrent())
+		return EXIT_FAILURE;
+
+	reportDriverProperties(report);
+	report.setProperty("size", size);
+	report.setProperty("iterations", iterations);
+
+	Stopwatch negotiation;
+	std::unique_ptr<FormatNegotiator> pNegotiator{FormatNegotiator::create(pContext->wgl(), args.value(L"-cache"))};
+
+	report.setProperty("negotiationSeconds", negotiation.seconds());
+
+	for (GLenum internalFormat : FormatNegotiator::internalFormats())
+	{
+		PixelTransfer naive{pNegotiator->naive(internalFormat)};
+		PixelTransfer preferred{pNegotiator->preferred(internalFormat)};
+		GLenum preferredInternalFormat{pNegotiator->preferredInternalFormat(internalFormat)};
+		double naiveRate{FormatNegotiator::measureUploadRate(internalFormat, naive, size, iterations)};
+		double preferredRate{FormatNegotiator::measureUploadRate(preferredInternalFormat, preferred, size, iterations)};
+
+		// Rates are in pixels rather than bytes, since the candidates don't all have the same pixel size.
+
+		double naivePixels{naiveRate * 1e9 / naive.bytesPerPixel};
+		double preferredPixels{preferredRate * 1e9 / preferred.bytesPerPixel};
+
+		report.beginResult();
+		report.set("internalFormat", FormatNegotiator::enumName(internalFormat));
+		report.set("method", FormatNegotiator::methodName(pNegotiator->method(internalFormat)));
+		report.set("preferredInternalFormat", FormatNegotiator::enumName(preferredInternalFormat));
+		report.set("naiveTransfer", std::string{FormatNegotiator::enumName(naive.format)} + " " + FormatNegotiator::enumName(naive.type));
+		report.set("preferredTransfer", std::string{FormatNegotiator::enumName(preferred.format)} + " " + FormatNegotiator::enumName(preferred.type));
+		report.set("naiveMegapixelsPerSecond", naivePixels / 1e6);
+		report.set("preferredMegapixelsPerSecond", preferredPixels / 1e6);
+		report.set("speedup", naivePixels > 0.0 ? preferredPixels / naivePixels : 0.0);
+	}
+
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
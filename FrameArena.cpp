@@ -0,0 +1,125 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+module;
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+module FrameArena;
+
+namespace
+{
+	std::uintptr_t alignUp(std::uintptr_t address, std::size_t alignment)
+	{
+		return (address + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+	}
+}
+
+FrameArena::FrameArena(std::size_t bytesPerFrame, unsigned framesInFlight) : m_frames(std::max(1u, framesInFlight))
+{
+	for (Frame &frame : m_frames)
+		frame.blocks.push_back(Block{std::make_unique<std::byte[]>(bytesPerFrame), bytesPerFrame});
+}
+
+void *FrameArena::allocate(std::size_t bytes, std::size_t alignment)
+{
+	Frame &frame{m_frames[m_current]};
+	Block &block{frame.blocks[frame.block]};
+	std::uintptr_t base{reinterpret_cast<std::uintptr_t>(block.pMemory.get())};
+	std::size_t offset{static_cast<std::size_t>(alignUp(base + frame.offset, alignment) - base)};
+
+	if (offset + bytes > block.size)
+		return allocateSlow(bytes, alignment);
+
+	frame.offset = offset + bytes;
+	++frame.stats.allocations;
+	frame.stats.bytes += bytes;
+	return block.pMemory.get() + offset;
+}
+
+void *FrameArena::allocateSlow(std::size_t bytes, std::size_t alignment)
+{
+	// Move on to the next overflow block that's big enough, adding a new one at least twice the
+	// size of the last if this frame has used them all.
+
+	Frame &frame{m_frames[m_current]};
+	std::size_t required{bytes + alignment};
+
+	while (++frame.block < frame.blocks.size())
+	{
+		if (frame.blocks[frame.block].size >= required)
+			break;
+	}
+
+	if (frame.block == frame.blocks.size())
+	{
+		std::size_t size{std::max(required, frame.blocks.back().size * 2)};
+
+		frame.blocks.push_back(Block{std::make_unique<std::byte[]>(size), size});
+		++frame.stats.heapBlocks;
+	}
+
+	frame.offset = 0;
+	return allocate(bytes, alignment);
+}
+
+void FrameArena::nextFrame()
+{
+	m_lastFrameStats = m_frames[m_current].stats;
+	m_current = (m_current + 1) % static_cast<unsigned>(m_frames.size());
+	++m_frameIndex;
+
+	Frame &frame{m_frames[m_current]};
+
+	// Coalesce overflow blocks so this region fits a frame like the biggest one it has seen in one block.
+
+	if (frame.blocks.size() > 1)
+	{
+		std::size_t size{0};
+
+		for (const Block &block : frame.blocks)
+			size += block.size;
+
+		frame.blocks.clear();
+		frame.blocks.push_back(Block{std::make_unique<std::byte[]>(size), size});
+	}
+
+	frame.block = 0;
+	frame.offset = 0;
+	frame.stats = FrameArenaStats{};
+}
+
+std::size_t FrameArena::capacity() const
+{
+	std::size_t size{0};
+
+	for (const Frame &frame : m_frames)
+	{
+		for (const Block &block : frame.blocks)
+			size += block.size;
+	}
+
+	return size;
+}
\ No newline at end of file
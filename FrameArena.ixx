@@ -0,0 +1,129 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+export module FrameArena;
+
+// The FrameArena class is a linear allocator for data that only lives for one frame, such as
+// vertices, uniforms and command lists built during update() and render(). Allocating is a pointer
+// bump and nothing is freed individually; the whole frame is released at once by nextFrame().
+//
+// The arena keeps one region per frame in flight and cycles through them, so memory handed to GL
+// in frame n isn't overwritten until frame n + framesInFlight, by which time the driver has finished
+// with it. If a frame outgrows its region an overflow block is taken from the heap, and the next time
+// that region is reused it's replaced by a single block big enough for everything, so steady-state
+// frames don't touch the heap at all.
+
+export struct FrameArenaStats
+{
+	std::uint64_t allocations{};
+	std::uint64_t bytes{};
+	std::uint64_t heapBlocks{};
+};
+
+export class FrameArena
+{
+public:
+	explicit FrameArena(std::size_t bytesPerFrame = 1 << 20, unsigned framesInFlight = 3);
+
+	FrameArena(const FrameArena &) = delete;
+	FrameArena &operator=(const FrameArena &) = delete;
+
+	void *allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+
+	template <typename T>
+	T *allocateArray(std::size_t count) { return static_cast<T *>(allocate(sizeof(T) * count, alignof(T))); }
+
+	// Finish the current frame and start the next one. Everything allocated framesInFlight frames
+	// ago becomes invalid.
+
+	void nextFrame();
+
+	unsigned framesInFlight() const { return static_cast<unsigned>(m_frames.size()); }
+	std::uint64_t frameIndex() const { return m_frameIndex; }
+
+	// Statistics for the frame being built, and for the frame before it.
+
+	const FrameArenaStats &frameStats() const { return m_frames[m_current].stats; }
+	const FrameArenaStats &lastFrameStats() const { return m_lastFrameStats; }
+
+	// Bytes currently reserved from the heap across every frame region.
+
+	std::size_t capacity() const;
+
+private:
+	struct Block
+	{
+		std::unique_ptr<std::byte[]> pMemory;
+		std::size_t size{};
+	};
+
+	struct Frame
+	{
+		std::vector<Block> blocks;
+		std::size_t block{};
+		std::size_t offset{};
+		FrameArenaStats stats{};
+	};
+
+	void *allocateSlow(std::size_t bytes, std::size_t alignment);
+
+	std::vector<Frame> m_frames;
+	unsigned m_current{};
+	std::uint64_t m_frameIndex{};
+	FrameArenaStats m_lastFrameStats{};
+};
+
+// FrameAllocator lets standard containers allocate from a FrameArena. Deallocation does nothing, so
+// a container that grows leaves its old storage behind until the frame is released; reserve() the
+// expected size up front where it's known.
+
+export template <typename T>
+class FrameAllocator
+{
+public:
+	using value_type = T;
+
+	FrameAllocator(FrameArena &arena) noexcept : m_pArena{&arena} {}
+
+	template <typename U>
+	FrameAllocator(const FrameAllocator<U> &other) noexcept : m_pArena{other.arena()} {}
+
+	T *allocate(std::size_t count) { return m_pArena->allocateArray<T>(count); }
+	void deallocate(T *, std::size_t) noexcept {}
+
+	FrameArena *arena() const noexcept { return m_pArena; }
+
+	template <typename U>
+	bool operator==(const FrameAllocator<U> &other) const noexcept { return m_pArena == other.arena(); }
+
+private:
+	FrameArena *m_pArena{nullptr};
+};
+
+export template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
\ No newline at end of file
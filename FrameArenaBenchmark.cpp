@@ -0,0 +1,234 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+module;
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+module Benchmark;
+
+import FrameArena;
+
+// Compares per-frame transient allocations from the general heap with allocations from a FrameArena.
+//
+//     -benchmark framearena [-frames n] [-allocations n] [-maxsize n] [-batches n] [-vertices n]
+//
+// The "blocks" workload makes many small allocations of varying size each frame and frees them
+// all at the end of the frame. The "vectors" workload builds a handful of vertex arrays by
+// push_back() without reserving, the way most frame-local containers get filled in.
+
+namespace
+{
+	struct Vertex
+	{
+		float position[3];
+		float texCoord[2];
+		std::uint32_t color;
+	};
+
+	struct FrameResults
+	{
+		std::vector<double> frameSeconds;
+		std::uint64_t allocations{};
+		std::uint64_t bytes{};
+		std::uint64_t heapBlocks{};
+		bool fromArena{};
+	};
+
+	volatile std::uint32_t g_sink;
+
+	// A small xorshift generator so both modes see exactly the same sequence of sizes.
+
+	std::uint32_t nextRandom(std::uint32_t &state)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	template <typename Allocate, typename EndFrame>
+	FrameResults runBlocks(int frames, int allocations, int maxSize, Allocate allocate, EndFrame endFrame)
+	{
+		FrameResults results;
+		std::uint32_t state{2463534242u};
+
+		results.frameSeconds.reserve(frames);
+
+		for (int frame = 0; frame < frames; ++frame)
+		{
+			Stopwatch stopwatch;
+
+			for (int i = 0; i < allocations; ++i)
+			{
+				std::size_t size{16 + nextRandom(state) % static_cast<std::uint32_t>(maxSize)};
+				auto *pBytes{static_cast<std::uint8_t *>(allocate(size))};
+
+				std::memset(pBytes, i & 0xff, size);
+				g_sink = g_sink + pBytes[size - 1];
+				results.bytes += size;
+			}
+
+			endFrame();
+			results.frameSeconds.push_back(stopwatch.seconds());
+		}
+
+		results.allocations = static_cast<std::uint64_t>(frames) * allocations;
+		return results;
+	}
+
+	template <typename MakeVector, typename EndFrame>
+	FrameResults runVectors(int frames, int batches, int vertices, MakeVector makeVector, EndFrame endFrame)
+	{
+		FrameResults results;
+
+		results.frameSeconds.reserve(frames);
+
+		for (int frame = 0; frame < frames; ++frame)
+		{
+			Stopwatch stopwatch;
+
+			for (int batch = 0; batch < batches; ++batch)
+			{
+				auto batchVertices{makeVector()};
+
+				for (int i = 0; i < vertices; ++i)
+					batchVertices.push_back(Vertex{{static_cast<float>(i), 0.0f, 0.0f}, {0.0f, 1.0f}, static_cast<std::uint32_t>(batch)});
+
+				g_sink = g_sink + batchVertices.back().color;
+			}
+
+			endFrame();
+			results.frameSeconds.push_back(stopwatch.seconds());
+		}
+
+		return results;
+	}
+
+	void reportResults(BenchmarkReport &report, const char *pszWorkload, const char *pszAllocator, const FrameResults &results)
+	{
+		double totalSeconds{0.0};
+
+		for (double seconds : results.frameSeconds)
+			totalSeconds += seconds;
+
+		double frames{static_cast<double>(results.frameSeconds.size())};
+
+		report.beginResult();
+		report.set("workload", pszWorkload);
+		report.set("allocator", pszAllocator);
+		report.set("frameUsMean", totalSeconds * 1e6 / frames);
+		report.set("frameUsP50", percentile(results.frameSeconds, 0.50) * 1e6);
+		report.set("frameUsP99", percentile(results.frameSeconds, 0.99) * 1e6);
+
+		if (results.allocations)
+			report.set("nsPerAllocation", totalSeconds * 1e9 / static_cast<double>(results.allocations));
+
+		if (results.bytes)
+			report.set("bytesPerFrame", static_cast<double>(results.bytes) / frames);
+
+		if (results.fromArena)
+			report.set("heapBlocks", static_cast<double>(results.heapBlocks));
+	}
+}
+
+int runFrameArenaBenchmark(const BenchmarkArguments &args, BenchmarkReport &report)
+{
+	int frames{std::max(1, args.intValue(L"-frames", 1000))};
+	int allocations{std::max(1, args.intValue(L"-allocations", 2000))};
+	int maxSize{std::max(1, args.intValue(L"-maxsize", 256))};
+	int batches{std::max(1, args.intValue(L"-batches", 64))};
+	int vertices{std::max(1, args.intValue(L"-vertices", 256))};
+
+	report.setProperty("frames", frames);
+	report.setProperty("allocations", allocations);
+	report.setProperty("maxSize", maxSize);
+	report.setProperty("batches", batches);
+	report.setProperty("vertices", vertices);
+
+	// Heap allocations are freed at the end of each frame, just as the arena is reset.
+
+	std::vector<void *> heapBlocks;
+	heapBlocks.reserve(allocations);
+
+	FrameResults heap{runBlocks(frames, allocations, maxSize, [&heapBlocks](std::size_t size)
+	{
+		heapBlocks.push_back(std::malloc(size));
+		return heapBlocks.back();
+	}, [&heapBlocks]()
+	{
+		for (void *pBlock : heapBlocks)
+			std::free(pBlock);
+
+		heapBlocks.clear();
+	})};
+
+	// The arena starts deliberately small so its growth shows up in heapBlocks.
+
+	FrameArena arena{4096};
+	std::uint64_t arenaAllocations{0};
+	std::uint64_t arenaHeapBlocks{0};
+
+	FrameResults arenaBlocks{runBlocks(frames, allocations, maxSize, [&arena](std::size_t size)
+	{
+		return arena.allocate(size, 16);
+	}, [&]()
+	{
+		arenaHeapBlocks += arena.frameStats().heapBlocks;
+		arena.nextFrame();
+	})};
+
+	arenaBlocks.heapBlocks = arenaHeapBlocks;
+	arenaBlocks.fromArena = true;
+
+	FrameResults heapVectors{runVectors(frames, batches, vertices, []()
+	{
+		return std::vector<Vertex>{};
+	}, []() {})};
+
+	arenaHeapBlocks = 0;
+
+	FrameResults arenaVectors{runVectors(frames, batches, vertices, [&arena]()
+	{
+		return FrameVector<Vertex>{FrameAllocator<Vertex>{arena}};
+	}, [&]()
+	{
+		arenaAllocations += arena.frameStats().allocations;
+		arenaHeapBlocks += arena.frameStats().heapBlocks;
+		arena.nextFrame();
+	})};
+
+	arenaVectors.allocations = arenaAllocations;
+	arenaVectors.heapBlocks = arenaHeapBlocks;
+	arenaVectors.fromArena = true;
+
+	reportResults(report, "blocks", "heap", heap);
+	reportResults(report, "blocks", "arena", arenaBlocks);
+	reportResults(report, "vectors", "heap", heapVectors);
+	reportResults(report, "vectors", "arena", arenaVectors);
+	report.set("arenaCapacity", static_cast<double>(arena.capacity()));
+
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,134 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#pragma once
+
+// GL_DISPATCH_ENTRY_POINTS(X) expands X(name) for every entry point in GLDispatch, in declaration
+// order. It's a macro so that module units that need to visit each entry point by name can share it.
+
+#define GL_DISPATCH_ENTRY_POINTS(X) \
+    X(glBlendFunc) \
+    X(glClear) \
+    X(glClearColor) \
+    X(glClearDepth) \
+    X(glClearStencil) \
+    X(glColorMask) \
+    X(glCullFace) \
+    X(glDepthFunc) \
+    X(glDepthMask) \
+    X(glDepthRange) \
+    X(glDisable) \
+    X(glDrawBuffer) \
+    X(glEnable) \
+    X(glFinish) \
+    X(glFlush) \
+    X(glFrontFace) \
+    X(glGetBooleanv) \
+    X(glGetDoublev) \
+    X(glGetError) \
+    X(glGetFloatv) \
+    X(glGetIntegerv) \
+    X(glGetString) \
+    X(glGetTexImage) \
+    X(glGetTexLevelParameterfv) \
+    X(glGetTexLevelParameteriv) \
+    X(glGetTexParameterfv) \
+    X(glGetTexParameteriv) \
+    X(glHint) \
+    X(glIsEnabled) \
+    X(glLineWidth) \
+    X(glLogicOp) \
+    X(glPixelStoref) \
+    X(glPixelStorei) \
+    X(glPointSize) \
+    X(glPolygonMode) \
+    X(glReadBuffer) \
+    X(glReadPixels) \
+    X(glScissor) \
+    X(glStencilFunc) \
+    X(glStencilMask) \
+    X(glStencilOp) \
+    X(glTexImage1D) \
+    X(glTexImage2D) \
+    X(glTexParameterf) \
+    X(glTexParameterfv) \
+    X(glTexParameteri) \
+    X(glTexParameteriv) \
+    X(glViewport) \
+    X(glBindTexture) \
+    X(glCopyTexImage1D) \
+    X(glCopyTexImage2D) \
+    X(glCopyTexSubImage1D) \
+    X(glCopyTexSubImage2D) \
+    X(glDeleteTextures) \
+    X(glDrawArrays) \
+    X(glDrawElements) \
+    X(glGenTextures) \
+    X(glGetPointerv) \
+    X(glIsTexture) \
+    X(glPolygonOffset) \
+    X(glTexSubImage1D) \
+    X(glTexSubImage2D)
+
+// GL_LOADER_SYMBOLS(X) expands X(name) for the other functions the loader looks up by name: the WGL
+// functions OpenGLContext forwards to and the GL functions the loader uses itself.
+
+#define GL_LOADER_SYMBOLS(X) \
+    X(glActiveTexture) \
+    X(glBindBuffer) \
+    X(glBindSampler) \
+    X(glBindTextures) \
+    X(glBufferSubData) \
+    X(glCreateTextures) \
+    X(glDeleteBuffers) \
+    X(glGenSamplers) \
+    X(glGetStringi) \
+    X(glGetTextureParameterfv) \
+    X(glGetTextureParameteriv) \
+    X(glNamedBufferSubData) \
+    X(glSamplerParameterf) \
+    X(glSamplerParameteri) \
+    X(glTextureParameterf) \
+    X(glTextureParameterfv) \
+    X(glTextureParameteri) \
+    X(glTextureParameteriv) \
+    X(glTextureSubImage1D) \
+    X(glTextureSubImage2D) \
+    X(wglChoosePixelFormat) \
+    X(wglCopyContext) \
+    X(wglCreateContext) \
+    X(wglCreateLayerContext) \
+    X(wglDeleteContext) \
+    X(wglDescribeLayerPlane) \
+    X(wglGetCurrentContext) \
+    X(wglGetCurrentDC) \
+    X(wglGetLayerPaletteEntries) \
+    X(wglMakeCurrent) \
+    X(wglRealizeLayerPalette) \
+    X(wglSetLayerPaletteEntries) \
+    X(wglSetPixelFormat) \
+    X(wglShareLists) \
+    X(wglSwapBuffers) \
+    X(wglSwapLayerBuffers) \
+    X(wglSwapMultipleBuffers) \
+    X(wglUseFontBitmapsA) \
+    X(wglUseFontBitmapsW) \
+    X(wglUseFontOutlinesA) \
+    X(wglUseFontOutlinesW)
\ No newline at end of file
@@ -0,0 +1,102 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <cassert>
+#include <memory>
+
+module GpuTimer;
+
+std::unique_ptr<GpuTimer> GpuTimer::create(OpenGLContext &context)
+{
+	// Some drivers return entry points for functions the context doesn't support, so check first.
+
+	const GLExtensions &extensions{context.extensions()};
+
+	if (!extensions.version().atLeast(3, 3) && !extensions.has<GLExtensions::ARB_timer_query>())
+		return std::unique_ptr<GpuTimer>{};
+
+	std::unique_ptr<GpuTimer> pTimer{new GpuTimer()};
+
+	pTimer->m_pfnGenQueries = reinterpret_cast<PFNGLGENQUERIESPROC>(context.wglGetProcAddress("glGenQueries"));
+	pTimer->m_pfnDeleteQueries = reinterpret_cast<PFNGLDELETEQUERIESPROC>(context.wglGetProcAddress("glDeleteQueries"));
+	pTimer->m_pfnBeginQuery = reinterpret_cast<PFNGLBEGINQUERYPROC>(context.wglGetProcAddress("glBeginQuery"));
+	pTimer->m_pfnEndQuery = reinterpret_cast<PFNGLENDQUERYPROC>(context.wglGetProcAddress("glEndQuery"));
+	pTimer->m_pfnGetQueryObjectiv = reinterpret_cast<PFNGLGETQUERYOBJECTIVPROC>(context.wglGetProcAddress("glGetQueryObjectiv"));
+	pTimer->m_pfnGetQueryObjectui64v = reinterpret_cast<PFNGLGETQUERYOBJECTUI64VPROC>(context.wglGetProcAddress("glGetQueryObjectui64v"));
+
+	if (!pTimer->m_pfnGenQueries || !pTimer->m_pfnDeleteQueries || !pTimer->m_pfnBeginQuery ||
+		!pTimer->m_pfnEndQuery || !pTimer->m_pfnGetQueryObjectiv || !pTimer->m_pfnGetQueryObjectui64v)
+	{
+		return std::unique_ptr<GpuTimer>{};
+	}
+
+	pTimer->m_pfnGenQueries(kQueries, pTimer->m_queries);
+	return pTimer;
+}
+
+GpuTimer::~GpuTimer()
+{
+	if (m_pfnDeleteQueries)
+		m_pfnDeleteQueries(kQueries, m_queries);
+}
+
+void GpuTimer::begin()
+{
+	assert(!full());
+	m_pfnBeginQuery(GL_TIME_ELAPSED, m_queries[(m_oldest + m_pending) % kQueries]);
+}
+
+void GpuTimer::end()
+{
+	m_pfnEndQuery(GL_TIME_ELAPSED);
+	++m_pending;
+}
+
+bool GpuTimer::collect(double &seconds, bool wait)
+{
+	if (m_pending == 0)
+		return false;
+
+	GLuint query{m_queries[m_oldest]};
+
+	if (!wait)
+	{
+		GLint available{GL_FALSE};
+
+		m_pfnGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+
+		if (!available)
+			return false;
+	}
+
+	GLuint64 nanoseconds{};
+
+	m_pfnGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+	m_oldest = (m_oldest + 1) % kQueries;
+	--m_pending;
+
+	seconds = static_cast<double>(nanoseconds) * 1e-9;
+	return true;
+}
\ No newline at end of file
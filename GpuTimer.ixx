@@ -0,0 +1,78 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <memory>
+
+export module GpuTimer;
+
+import OpenGL;
+
+// The GpuTimer class measures how long the GPU spends on a span of GL commands with GL_TIME_ELAPSED
+// queries. Several queries are kept in flight so that reading a result doesn't stall the pipeline;
+// results are collected in the order they were issued, a few frames after they were measured.
+// Timer queries need OpenGL 3.3 or ARB_timer_query and their entry points are loaded through
+// wglGetProcAddress(), so a GpuTimer can only be used with the context that was current when it
+// was created, and must be destroyed with that context current.
+
+export class GpuTimer
+{
+public:
+	// Returns an empty pointer if the current context doesn't support timer queries.
+
+	static std::unique_ptr<GpuTimer> create(OpenGLContext &context);
+
+	~GpuTimer();
+
+	GpuTimer(const GpuTimer &) = delete;
+	GpuTimer &operator=(const GpuTimer &) = delete;
+
+	// Bracket the commands to be timed. begin() mustn't be called while full().
+
+	void begin();
+	void end();
+
+	// Retrieve the oldest outstanding measurement. Returns false if there isn't one, or if wait is
+	// false and it isn't available yet.
+
+	bool collect(double &seconds, bool wait = false);
+
+	bool full() const { return m_pending == kQueries; }
+
+private:
+	static const unsigned kQueries{4};
+
+	GpuTimer() = default;
+
+	PFNGLGENQUERIESPROC m_pfnGenQueries{nullptr};
+	PFNGLDELETEQUERIESPROC m_pfnDeleteQueries{nullptr};
+	PFNGLBEGINQUERYPROC m_pfnBeginQuery{nullptr};
+	PFNGLENDQUERYPROC m_pfnEndQuery{nullptr};
+	PFNGLGETQUERYOBJECTIVPROC m_pfnGetQueryObjectiv{nullptr};
+	PFNGLGETQUERYOBJECTUI64VPROC m_pfnGetQueryObjectui64v{nullptr};
+
+	GLuint m_queries[kQueries]{};
+	unsigned m_oldest{};
+	unsigned m_pending{};
+};
\ No newline at end of file
@@ -0,0 +1,128 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <memory>
+#include <mutex>
+
+module HeadlessContext;
+
+namespace
+{
+	const wchar_t *const kWindowClassName{L"HeadlessContextWindowClass"};
+
+	bool registerWindowClass()
+	{
+		static std::once_flag registered;
+		static bool result{false};
+
+		std::call_once(registered, []()
+		{
+			WNDCLASSEXW wcl{};
+
+			wcl.cbSize = sizeof(wcl);
+			wcl.style = CS_OWNDC;
+			wcl.lpfnWndProc = DefWindowProcW;
+			wcl.hInstance = GetModuleHandle(nullptr);
+			wcl.lpszClassName = kWindowClassName;
+
+			result = RegisterClassExW(&wcl) != 0 || GetLastError() == ERROR_CLASS_ALREADY_EXISTS;
+		});
+
+		return result;
+	}
+}
+
+std::unique_ptr<HeadlessContext> HeadlessContext::create(int width, int height, HGLRC hShareContext, const wchar_t *pszLibrary)
+{
+	if (!registerWindowClass())
+		return std::unique_ptr<HeadlessContext>{};
+
+	std::unique_ptr<HeadlessContext> pHeadless{new HeadlessContext()};
+
+	pHeadless->m_width = width;
+	pHeadless->m_height = height;
+	pHeadless->m_hWnd = CreateWindowExW(0, kWindowClassName, L"", WS_POPUP | WS_CLIPCHILDREN | WS_CLIPSIBLINGS,
+		0, 0, width, height, 0, 0, GetModuleHandle(nullptr), nullptr);
+
+	if (!pHeadless->m_hWnd)
+		return std::unique_ptr<HeadlessContext>{};
+
+	PIXELFORMATDESCRIPTOR pfd
+	{
+		.nSize = sizeof(pfd),
+		.nVersion = 1,
+		.dwFlags = PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL | PFD_DOUBLEBUFFER,
+		.iPixelType = PFD_TYPE_RGBA,
+		.cColorBits = 24,
+		.cDepthBits = 16,
+		.iLayerType = PFD_MAIN_PLANE,
+	};
+
+	if (!(pHeadless->m_pContext = OpenGLContext::createForWindow(pHeadless->m_hWnd, pfd, pszLibrary)))
+		return std::unique_ptr<HeadlessContext>{};
+
+	if (!(pHeadless->m_hDC = GetDC(pHeadless->m_hWnd)))
+		return std::unique_ptr<HeadlessContext>{};
+
+	if (!(pHeadless->m_hRC = pHeadless->m_pContext->wglCreateContext(pHeadless->m_hDC)))
+		return std::unique_ptr<HeadlessContext>{};
+
+	if (hShareContext && !pHeadless->m_pContext->wglShareLists(hShareContext, pHeadless->m_hRC))
+		return std::unique_ptr<HeadlessContext>{};
+
+	return pHeadless;
+}
+
+HeadlessContext::~HeadlessContext()
+{
+	if (m_pContext && m_hRC)
+	{
+		if (m_pContext->wglGetCurrentContext() == m_hRC)
+			m_pContext->wglMakeCurrent(nullptr, nullptr);
+
+		m_pContext->wglDeleteContext(m_hRC);
+		m_hRC = nullptr;
+	}
+
+	if (m_hDC)
+	{
+		ReleaseDC(m_hWnd, m_hDC);
+		m_hDC = nullptr;
+	}
+
+	if (m_hWnd)
+	{
+		DestroyWindow(m_hWnd);
+		m_hWnd = nullptr;
+	}
+}
+
+bool HeadlessContext::makeCurrent()
+{
+	return m_pContext->wglMakeCurrent(m_hDC, m_hRC) != FALSE;
+}
+
+void HeadlessContext::doneCurrent()
+{
+	m_pContext->wglMakeCurrent(nullptr, nullptr);
+}
\ No newline at end of file
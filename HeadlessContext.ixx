@@ -0,0 +1,69 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <memory>
+
+export module HeadlessContext;
+
+import OpenGL;
+
+// The HeadlessContext class owns an OpenGL rendering context that isn't attached to a visible window.
+// WGL can only create rendering contexts for device contexts, so each HeadlessContext creates a hidden
+// window of the requested size and renders into its back buffer.
+// The hidden window belongs to the thread that created the HeadlessContext, so a HeadlessContext
+// must be destroyed on the same thread that created it. It may be made current on any thread.
+
+export class HeadlessContext
+{
+public:
+	// Create a headless rendering context. If hShareContext isn't null then display lists and
+	// texture objects are shared with it. pszLibrary selects the OpenGL implementation, as it does for
+	// OpenGLContext::createForWindow().
+
+	static std::unique_ptr<HeadlessContext> create(int width, int height, HGLRC hShareContext = nullptr, const wchar_t *pszLibrary = nullptr);
+
+	~HeadlessContext();
+
+	HeadlessContext(const HeadlessContext &) = delete;
+	HeadlessContext &operator=(const HeadlessContext &) = delete;
+
+	bool makeCurrent();
+	void doneCurrent();
+
+	HWND window() const { return m_hWnd; }
+	HDC dc() const { return m_hDC; }
+	HGLRC rc() const { return m_hRC; }
+	int width() const { return m_width; }
+	int height() const { return m_height; }
+	OpenGLContext &wgl() const { return *m_pContext; }
+
+private:
+	HeadlessContext() = default;
+
+	HWND m_hWnd{nullptr};
+	HDC m_hDC{nullptr};
+	HGLRC m_hRC{nullptr};
+	int m_width{};
+	int m_height{};
+	std::shared_ptr<OpenGLContext> m_pContext{};
+};
\ No newline at end of file
@@ -0,0 +1,225 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+module Benchmark;
+
+import HeadlessContext;
+import OpenGL;
+
+// Runs the same workload once against each OpenGL implementation and reports them side by side, so
+// that a vendor driver, Mesa llvmpipe and a null driver can be compared from one binary.
+//
+//     -benchmark implementations [-libraries a;b;...] [-frames n] [-size n] [-calls n]
+//
+// The default library always comes first. The others are taken from -libraries or, if it isn't given,
+// from the GLLOADER_LIBRARIES environment variable, separated by semicolons.
+
+namespace
+{
+	std::vector<std::wstring> libraryList(const BenchmarkArguments &args)
+	{
+		std::wstring list;
+
+		if (const wchar_t *pszList{args.value(L"-libraries")})
+		{
+			list = pszList;
+		}
+		else
+		{
+			wchar_t value[4096]{};
+			DWORD length{GetEnvironmentVariableW(L"GLLOADER_LIBRARIES", value, 4096)};
+
+			if (length > 0 && length < 4096)
+				list = value;
+		}
+
+		// An empty entry stands for the default library.
+
+		std::vector<std::wstring> libraries{std::wstring{}};
+
+		for (size_t start = 0; start < list.size();)
+		{
+			size_t end{std::min(list.find(L';', start), list.size())};
+
+			if (end > start)
+				libraries.push_back(list.substr(start, end - start));
+
+			start = end + 1;
+		}
+
+		return libraries;
+	}
+
+	std::string glString(GLenum name)
+	{
+		const GLubyte *pszValue{glGetString(name)};
+		return pszValue ? reinterpret_cast<const char *>(pszValue) : "";
+	}
+
+	// The cost of a GL call that does no work, through the implementation's dispatch.
+
+	double nsPerCall(int calls)
+	{
+		for (int i = 0; i < calls / 10; ++i)
+			glGetError();
+
+		Stopwatch stopwatch;
+
+		for (int i = 0; i < calls; ++i)
+			glGetError();
+
+		return stopwatch.seconds() * 1e9 / calls;
+	}
+
+	// Each frame clears the drawable, clears a grid of scissored tiles and presents.
+
+	std::vector<double> runFrames(HeadlessContext &context, int frames)
+	{
+		const int kTiles{8};
+		int tile{std::max(1, context.width() / kTiles)};
+		std::vector<double> frameSeconds;
+
+		frameSeconds.reserve(frames);
+
+		for (int frame = 0; frame < frames; ++frame)
+		{
+			Stopwatch stopwatch;
+
+			glViewport(0, 0, context.width(), context.height());
+			glDisable(GL_SCISSOR_TEST);
+			glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			glEnable(GL_SCISSOR_TEST);
+
+			for (int y = 0; y < kTiles; ++y)
+			{
+				for (int x = 0; x < kTiles; ++x)
+				{
+					glScissor(x * tile, y * tile, tile, tile);
+					glClearColor(static_cast<float>(x) / kTiles, static_cast<float>(y) / kTiles, static_cast<float>(frame & 0xff) / 255.0f, 1.0f);
+					glClear(GL_COLOR_BUFFER_BIT);
+				}
+			}
+
+			context.wgl().SwapBuffers(context.dc());
+			frameSeconds.push_back(stopwatch.seconds());
+		}
+
+		glDisable(GL_SCISSOR_TEST);
+		glFinish();
+		return frameSeconds;
+	}
+
+	double readbackMegabytesPerSecond(HeadlessContext &context, int iterations)
+	{
+		std::vector<std::uint32_t> pixels(static_cast<size_t>(context.width()) * context.height());
+
+		glPixelStorei(GL_PACK_ALIGNMENT, 4);
+		glReadPixels(0, 0, context.width(), context.height(), GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+		Stopwatch stopwatch;
+
+		for (int i = 0; i < iterations; ++i)
+			glReadPixels(0, 0, context.width(), context.height(), GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+		return static_cast<double>(pixels.size() * sizeof(std::uint32_t)) * iterations / (stopwatch.seconds() * 1e6);
+	}
+}
+
+int runImplementationsBenchmark(const BenchmarkArguments &args, BenchmarkReport &report)
+{
+	int frames{std::max(1, args.intValue(L"-frames", 300))};
+	int size{std::max(16, args.intValue(L"-size", 256))};
+	int calls{std::max(1000, args.intValue(L"-calls", 1000000))};
+	std::vector<std::wstring> libraries{libraryList(args)};
+	double baselineFramesPerSecond{0.0};
+	int available{0};
+
+	report.setProperty("frames", frames);
+	report.setProperty("size", size);
+	report.setProperty("calls", calls);
+	report.setProperty("implementations", static_cast<double>(libraries.size()));
+
+	for (const std::wstring &library : libraries)
+	{
+		const wchar_t *pszLibrary{library.empty() ? nullptr : library.c_str()};
+		std::unique_ptr<HeadlessContext> pContext{HeadlessContext::create(size, size, nullptr, pszLibrary)};
+
+		report.beginResult();
+		report.set("library", library.empty() ? std::string{"default"} : narrow(pszLibrary));
+
+		if (!pContext || !pContext->makeCurrent())
+		{
+			report.set("available", "no");
+			continue;
+		}
+
+		LoaderReport loader{OpenGLContext::loaderReport(pszLibrary)};
+
+		report.set("available", "yes");
+		report.set("path", loader.library);
+		report.set("vendor", glString(GL_VENDOR));
+		report.set("renderer", glString(GL_RENDERER));
+		report.set("version", glString(GL_VERSION));
+		report.set("loadMs", loader.loadMilliseconds);
+		report.set("missingSymbols", static_cast<double>(loader.missing().size()));
+
+		report.set("nsPerCall", nsPerCall(calls));
+
+		runFrames(*pContext, std::min(frames, 10));
+
+		std::vector<double> frameSeconds{runFrames(*pContext, frames)};
+		double totalSeconds{0.0};
+
+		for (double seconds : frameSeconds)
+			totalSeconds += seconds;
+
+		double framesPerSecond{frames / totalSeconds};
+
+		if (baselineFramesPerSecond == 0.0)
+			baselineFramesPerSecond = framesPerSecond;
+
+		report.set("frameMsMean", totalSeconds * 1e3 / frames);
+		report.set("frameMsP50", percentile(frameSeconds, 0.50) * 1e3);
+		report.set("frameMsP99", percentile(frameSeconds, 0.99) * 1e3);
+		report.set("framesPerSecond", framesPerSecond);
+		report.set("relativeFramesPerSecond", framesPerSecond / baselineFramesPerSecond);
+		report.set("readbackMBps", readbackMegabytesPerSecond(*pContext, std::max(1, frames / 10)));
+
+		// Each library has its own current context, so release this one before moving on to the next.
+
+		pContext->doneCurrent();
+		pContext.reset();
+		++available;
+	}
+
+	return available > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
@@ -0,0 +1,230 @@
+import <windows.h>;
+import <memory>;
+import <mutex>;
+import <string>;
+import <vector>;
+import CallProfiler;
+import OpenGL;
+
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Note:
+// VS2022 (v17.11.2) has an IntelliSense bug that causes it to report false errors
+// if this copyright notice is placed at the top of the file before import statements.
+
+// glInterposer.vcxproj builds this file with the OpenGL and CallProfiler modules into a replacement
+// opengl32.dll for profiling applications that can't be rebuilt. Put it next to the application's
+// executable with a copy of the system library renamed to opengl32sys.dll:
+//
+//     copy %WINDIR%\System32\opengl32.dll <application folder>\opengl32sys.dll
+//
+// The GL functions the loader exports are profiled through a CallProfiler layer, which is inserted
+// on every context the application makes current. The WGL functions below keep the loader's current
+// context tracking in step with the application and count frames when it swaps buffers. Everything
+// else, including functions the application gets from wglGetProcAddress(), goes straight to the driver.
+//
+// When the application deletes the last context it profiled, the profile is written to the file named
+// by the GLINTERPOSER_REPORT environment variable, or to glinterposer-<process id>.json in the
+// temporary folder, and it's written again if more contexts are profiled and deleted later. An
+// application can also call the exported InterposerWriteReport() at any time. Nothing is written from
+// DllMain(), since it runs under the loader lock. Set GLINTERPOSER_TIMING=1 to time each function as
+// well as count it.
+
+namespace
+{
+	HMODULE g_hModule{nullptr};
+
+	OpenGLContext &wgl()
+	{
+		static OpenGLContext theContext;
+		return theContext;
+	}
+
+	// The contexts the profiler has been inserted on and not yet deleted.
+
+	std::mutex g_profiledMutex;
+	std::vector<HGLRC> g_profiled;
+
+	// Insert the profiler on a context the first time it's made current on this thread.
+
+	void profile(HGLRC hglrc)
+	{
+		thread_local HGLRC t_profiled{nullptr};
+
+		if (t_profiled == hglrc)
+			return;
+
+		if (OpenGLContext::layers(hglrc).empty() && OpenGLContext::insertLayer(hglrc, CallProfiler::instance()))
+		{
+			std::lock_guard<std::mutex> lock{g_profiledMutex};
+			g_profiled.push_back(hglrc);
+		}
+
+		t_profiled = hglrc;
+	}
+
+	// Whether hglrc was being profiled and was the last such context.
+
+	bool forgetProfiled(HGLRC hglrc)
+	{
+		std::lock_guard<std::mutex> lock{g_profiledMutex};
+		return std::erase(g_profiled, hglrc) > 0 && g_profiled.empty();
+	}
+
+	bool environmentFlag(const wchar_t *pszName)
+	{
+		wchar_t value[8]{};
+		DWORD length{GetEnvironmentVariableW(pszName, value, 8)};
+
+		return length > 0 && length < 8 && value[0] != L'0';
+	}
+
+	std::wstring reportPath()
+	{
+		wchar_t path[MAX_PATH]{};
+		DWORD length{GetEnvironmentVariableW(L"GLINTERPOSER_REPORT", path, MAX_PATH)};
+
+		if (length > 0 && length < MAX_PATH)
+			return path;
+
+		length = GetTempPathW(MAX_PATH, path);
+
+		if (length == 0 || length >= MAX_PATH)
+			path[0] = L'\0';
+
+		return std::wstring{path} + L"glinterposer-" + std::to_wstring(GetCurrentProcessId()) + L".json";
+	}
+
+	bool writeReport()
+	{
+		char application[MAX_PATH]{};
+
+		GetModuleFileNameA(nullptr, application, MAX_PATH);
+		return CallProfiler::writeReport(reportPath().c_str(), application);
+	}
+}
+
+//
+// The WGL functions the interposer implements. Interposer.def exports them under their WGL names.
+//
+
+extern "C"
+{
+	HGLRC WINAPI interposeWglCreateContext(HDC hdc)
+	{
+		return wgl().wglCreateContext(hdc);
+	}
+
+	BOOL WINAPI interposeWglDeleteContext(HGLRC hglrc)
+	{
+		BOOL result{wgl().wglDeleteContext(hglrc)};
+
+		if (result && forgetProfiled(hglrc))
+			writeReport();
+
+		return result;
+	}
+
+	HGLRC WINAPI interposeWglGetCurrentContext()
+	{
+		return wgl().wglGetCurrentContext();
+	}
+
+	HDC WINAPI interposeWglGetCurrentDC()
+	{
+		return wgl().wglGetCurrentDC();
+	}
+
+	PROC WINAPI interposeWglGetProcAddress(LPCSTR lpszProc)
+	{
+		// The interposer's own exports come first so that profiled functions are profiled however
+		// they're found. The driver's wglGetProcAddress() wouldn't return them anyway.
+
+		if (PROC pfn{lpszProc ? GetProcAddress(g_hModule, lpszProc) : nullptr})
+			return pfn;
+
+		return wgl().wglGetProcAddress(lpszProc);
+	}
+
+	BOOL WINAPI interposeWglMakeCurrent(HDC hdc, HGLRC hglrc)
+	{
+		if (!wgl().wglMakeCurrent(hdc, hglrc))
+			return FALSE;
+
+		if (hglrc)
+			profile(hglrc);
+
+		return TRUE;
+	}
+
+	// SwapBuffers() in gdi32.dll calls wglSwapBuffers() in whichever opengl32.dll is loaded, which is
+	// where frames end for most applications.
+
+	BOOL WINAPI interposeWglSwapBuffers(HDC hdc)
+	{
+		using PFNWGLSWAPBUFFERSPROC = BOOL(WINAPI*)(HDC hdc);
+		static PFNWGLSWAPBUFFERSPROC pfnWglSwapBuffers{reinterpret_cast<PFNWGLSWAPBUFFERSPROC>(wgl().wglGetProcAddress("wglSwapBuffers"))};
+
+		BOOL result{pfnWglSwapBuffers ? pfnWglSwapBuffers(hdc) : FALSE};
+
+		CallProfiler::endFrame();
+		return result;
+	}
+
+	BOOL WINAPI interposeWglSwapLayerBuffers(HDC hdc, UINT fuPlanes)
+	{
+		BOOL result{wgl().wglSwapLayerBuffers(hdc, fuPlanes)};
+
+		if (fuPlanes & WGL_SWAP_MAIN_PLANE)
+			CallProfiler::endFrame();
+
+		return result;
+	}
+
+	DWORD WINAPI interposeWglSwapMultipleBuffers(UINT count, const WGLSWAP *toSwap)
+	{
+		DWORD result{wgl().wglSwapMultipleBuffers(count, toSwap)};
+
+		CallProfiler::endFrame();
+		return result;
+	}
+
+	// Writes the profile so far. For applications that keep their contexts until they exit.
+
+	BOOL WINAPI InterposerWriteReport()
+	{
+		return writeReport() ? TRUE : FALSE;
+	}
+}
+
+BOOL WINAPI DllMain(HINSTANCE hInstance, DWORD reason, LPVOID)
+{
+	switch (reason)
+	{
+	case DLL_PROCESS_ATTACH:
+		g_hModule = hInstance;
+		DisableThreadLibraryCalls(hInstance);
+		CallProfiler::setTiming(environmentFlag(L"GLINTERPOSER_TIMING"));
+		break;
+	}
+
+	return TRUE;
+}
\ No newline at end of file
@@ -0,0 +1,238 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+module Benchmark;
+
+import CallProfiler;
+import HeadlessContext;
+import OpenGL;
+
+// Measures the cost of a GL call through interception layers.
+//
+//     -benchmark layers [-calls n] [-repeats n] [-budget ns]
+//
+// glGetError() is called through the driver's own function pointer, through the loader with no
+// layers, with a layer that intercepts a different function, and with one to four stacked instances of
+// a layer that counts glGetError() calls. The loader with no layers and with the unrelated layer should
+// cost the same, since calls no layer intercepts go straight to the driver, and nsOverDriver is what
+// the loader's dispatch adds to the driver's pointer. Then the CallProfiler layer the interposer uses
+// is timed counting and timing calls. Layers are inserted and removed between runs, as they would be
+// between frames, and each run checks that every layer saw every call. The benchmark fails if counting
+// with the profiler adds more than -budget nanoseconds a call, 20 by default, to the driver's own
+// pointer: the interposer replaces opengl32.dll, so its overhead is the loader's dispatch as well as
+// the profiler's. If the driver's pointer can't be found the loader's dispatch is the baseline.
+
+namespace
+{
+	class CountingLayer : public GLLayer
+	{
+	public:
+		const char *name() const override { return "count"; }
+
+		void intercept(GLDispatch &table) override
+		{
+			table.glGetError = getError;
+		}
+
+		std::uint64_t calls() const { return m_calls; }
+		void reset() { m_calls = 0; }
+
+	private:
+		static GLenum APIENTRY getError()
+		{
+			++self<CountingLayer>().m_calls;
+			return next().glGetError();
+		}
+
+		std::uint64_t m_calls{0};
+	};
+
+	class UnrelatedLayer : public GLLayer
+	{
+	public:
+		const char *name() const override { return "unrelated"; }
+
+		void intercept(GLDispatch &table) override
+		{
+			table.glClear = clear;
+		}
+
+	private:
+		static void APIENTRY clear(GLbitfield mask)
+		{
+			next().glClear(mask);
+		}
+	};
+
+	template <typename F>
+	double nsPerCall(int calls, int repeats, F call)
+	{
+		std::vector<double> samples;
+
+		for (int repeat = 0; repeat < repeats; ++repeat)
+		{
+			Stopwatch stopwatch;
+
+			for (int i = 0; i < calls; ++i)
+				call();
+
+			samples.push_back(stopwatch.seconds() * 1e9 / calls);
+		}
+
+		return percentile(samples, 0.5);
+	}
+
+	double nsPerCall(int calls, int repeats)
+	{
+		return nsPerCall(calls, repeats, []() { glGetError(); });
+	}
+}
+
+int runLayersBenchmark(const BenchmarkArguments &args, BenchmarkReport &report)
+{
+	int calls{std::max(1, args.intValue(L"-calls", 1000000))};
+	int repeats{std::max(1, args.intValue(L"-repeats", 5))};
+	int budget{std::max(0, args.intValue(L"-budget", 20))};
+	std::unique_ptr<HeadlessContext> pContext{HeadlessContext::create(64, 64)};
+
+	if (!pContext || !pContext->makeCurrent())
+		return EXIT_FAILURE;
+
+	reportDriverProperties(report);
+	report.setProperty("calls", calls);
+	report.setProperty("repeats", repeats);
+	report.setProperty("budgetNs", budget);
+
+	HGLRC hRC{pContext->rc()};
+	std::vector<std::shared_ptr<CountingLayer>> counters
+	{
+		std::make_shared<CountingLayer>(),
+		std::make_shared<CountingLayer>(),
+		std::make_shared<CountingLayer>(),
+		std::make_shared<CountingLayer>(),
+	};
+
+	auto resetCounts = [&counters]()
+	{
+		for (const std::shared_ptr<CountingLayer> &pCounter : counters)
+			pCounter->reset();
+	};
+
+	// The driver's glGetError(), called the way an application that loaded it itself would.
+
+	HMODULE hOpenGL{GetModuleHandleW(L"opengl32.dll")};
+	PFNGLGETERRORPROC pfnGetError{hOpenGL ? reinterpret_cast<PFNGLGETERRORPROC>(GetProcAddress(hOpenGL, "glGetError")) : nullptr};
+
+	bool failed{false};
+	double driver{pfnGetError ? nsPerCall(calls, repeats, [pfnGetError]() { pfnGetError(); }) : 0.0};
+	double direct{nsPerCall(calls, repeats)};
+
+	auto addResult = [&](const char *pszConfiguration, int layers, double ns, bool counted)
+	{
+		report.beginResult();
+		report.set("configuration", pszConfiguration);
+		report.set("layers", layers);
+		report.set("nsPerCall", ns);
+		report.set("nsAdded", ns - direct);
+
+		if (pfnGetError)
+			report.set("nsOverDriver", ns - driver);
+
+		report.set("counted", counted ? "yes" : "no");
+	};
+
+	if (pfnGetError)
+		addResult("driver", 0, driver, true);
+
+	addResult("none", 0, direct, true);
+
+	std::shared_ptr<GLLayer> pUnrelated{std::make_shared<UnrelatedLayer>()};
+
+	OpenGLContext::insertLayer(hRC, pUnrelated);
+	addResult("unrelated", 1, nsPerCall(calls, repeats), true);
+	OpenGLContext::removeLayer(hRC, pUnrelated.get());
+
+	for (int layerCount = 1; layerCount <= static_cast<int>(counters.size()); ++layerCount)
+	{
+		for (int i = 0; i < layerCount; ++i)
+			OpenGLContext::insertLayer(hRC, counters[i]);
+
+		resetCounts();
+
+		double ns{nsPerCall(calls, repeats)};
+		bool counted{true};
+
+		for (int i = 0; i < layerCount; ++i)
+			counted = counted && counters[i]->calls() == static_cast<std::uint64_t>(calls) * repeats;
+
+		for (int i = 0; i < layerCount; ++i)
+			OpenGLContext::removeLayer(hRC, counters[i].get());
+
+		addResult("counting", layerCount, ns, counted);
+		failed = failed || !counted;
+	}
+
+	std::shared_ptr<CallProfiler> pProfiler{CallProfiler::instance()};
+
+	OpenGLContext::insertLayer(hRC, pProfiler);
+
+	for (bool timing : {false, true})
+	{
+		CallProfiler::reset();
+		CallProfiler::setTiming(timing);
+
+		double ns{nsPerCall(calls, repeats)};
+		std::vector<CallStats> profiled{CallProfiler::calls()};
+		bool counted{!profiled.empty() && profiled.front().calls == static_cast<std::uint64_t>(calls) * repeats};
+
+		addResult(timing ? "profiler timing" : "profiler counting", 1, ns, counted);
+		failed = failed || !counted;
+
+		double added{ns - (pfnGetError ? driver : direct)};
+
+		if (!timing && added > budget)
+		{
+			std::fprintf(stderr, "Counting with the profiler added %.1f ns a call, over the %d ns budget\n", added, budget);
+			failed = true;
+		}
+	}
+
+	CallProfiler::setTiming(false);
+	OpenGLContext::removeLayer(hRC, pProfiler.get());
+
+	// With every layer removed calls go straight to the driver again.
+
+	resetCounts();
+	glGetError();
+	failed = failed || counters[0]->calls() != 0 || !OpenGLContext::layers(hRC).empty();
+
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
\ No newline at end of file
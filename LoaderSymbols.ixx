@@ -0,0 +1,67 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <cstddef>
+#include <string_view>
+#include "GLEntryPoints.h"
+
+export module LoaderSymbols;
+
+import PerfectHash;
+
+// Every name the loader looks up itself. The dispatch entry points come first, so an entry point's
+// index in GLDispatch is also its Symbol. The names are packed into one string pool rather than being
+// a literal at each call site, and findSymbol() maps a name back to its Symbol with a perfect hash
+// built at compile time. The loader and the symbols benchmark share this table.
+
+export namespace Symbol
+{
+	enum : unsigned
+	{
+#define ENUMERATE_SYMBOL(name) name,
+		GL_DISPATCH_ENTRY_POINTS(ENUMERATE_SYMBOL)
+		GL_LOADER_SYMBOLS(ENUMERATE_SYMBOL)
+#undef ENUMERATE_SYMBOL
+		Count
+	};
+}
+
+constexpr char kSymbolPool[]
+{
+#define POOL_SYMBOL(name) #name "\0"
+	GL_DISPATCH_ENTRY_POINTS(POOL_SYMBOL)
+	GL_LOADER_SYMBOLS(POOL_SYMBOL)
+#undef POOL_SYMBOL
+};
+
+export constexpr StringPool<Symbol::Count> kSymbolNames{kSymbolPool};
+
+export constexpr auto symbolName = [](std::size_t symbol) { return kSymbolNames[symbol]; };
+
+export constexpr PerfectHash<Symbol::Count> kSymbolHash{symbolName};
+
+// Returns Symbol::Count if the name isn't one of the loader's symbols.
+
+export inline unsigned findSymbol(std::string_view name)
+{
+	return static_cast<unsigned>(kSymbolHash.find(name, symbolName));
+}
\ No newline at end of file
@@ -1,325 +1,746 @@
-import <windows.h>;
-import <GL/glcorearb.h>;
-import <memory>;
-import <string>;
-import OpenGL;
-
-// Copyright (c) 2024 dhpoware. All Rights Reserved.
-//
-// Permission is hereby granted, free of charge, to any person obtaining a
-// copy of this software and associated documentation files (the "Software"),
-// to deal in the Software without restriction, including without limitation
-// the rights to use, copy, modify, merge, publish, distribute, sublicense,
-// and/or sell copies of the Software, and to permit persons to whom the
-// Software is furnished to do so, subject to the following conditions:
-//
-// The above copyright notice and this permission notice shall be included in
-// all copies or substantial portions of the Software.
-//
-// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
-// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
-// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
-// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
-// IN THE SOFTWARE.
-//
-// Note:
-// VS2022 (v17.11.2) has an IntelliSense bug that causes it to report false errors
-// if this copyright notice is placed at the top of the file before import statements.
-
-// This Windows OpenGL application demonstrates how to use the OpenGLContext class
-// to avoid having to statically link to OpenGL32.lib.
-class GLApplication
-{
-public:
-    // Unicode-based, general-purpose exception and error class.
-    class Error
-    {
-    public:
-        Error(const wchar_t *pszMessage) : m_message{pszMessage} {}
-        Error(const std::wstring &message) : m_message{message} {}
-        virtual ~Error() {}
-
-        const wchar_t *what() const { return m_message.c_str(); }
-
-    private:
-        std::wstring m_message;
-    };
-
-    GLApplication();
-    GLApplication(const wchar_t *pszWindowName);
-    ~GLApplication();
-
-    int run();
-
-private:
-    static LRESULT CALLBACK windowProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
-
-    bool create();
-    void destroy();
-    void init(int argc, wchar_t *argv[]);
-    void initApplication(const wchar_t *pszWindowName);
-    void initOpenGL();
-    int mainLoop();
-    void render() const;
-    void shutdown();
-    void update();
-    LRESULT windowProcImpl(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
-
-    WNDCLASSEXW m_wcl{};
-    HWND m_hWnd{nullptr};
-    HINSTANCE m_hInstance{GetModuleHandle(nullptr)};
-    HDC m_hDC{nullptr};
-    HGLRC m_hRC{nullptr};
-    const wchar_t *m_pszWindowName{L""};
-    int m_windowWidth{};
-    int m_windowHeight{};
-    std::shared_ptr<OpenGLContext> m_pContext{};
-};
-
-GLApplication::GLApplication()
-{
-    initApplication(L"");
-}
-
-GLApplication::GLApplication(const wchar_t *pszWindowName)
-{
-    initApplication(pszWindowName);
-}
-
-GLApplication::~GLApplication()
-{
-}
-
-int GLApplication::run()
-{
-    int status{};
- 
-    try
-    {
-        if (create())
-        {
-            try
-            {
-                initOpenGL();
-                init(__argc, __wargv);
-                status = mainLoop();
-		shutdown();
-            }
-            catch (...)
-            {
-		shutdown();
-                throw;
-            }
-            
-            destroy();
-        }
-    }
-    catch (const GLApplication::Error &e)
-    {
-        destroy();
-        status = EXIT_FAILURE;
-        MessageBox(0, e.what(), L"GLApplication Unhandled Exception", MB_ICONERROR);
-    }
-
-    return status;
-}
-
-bool GLApplication::create()
-{      
-    if (!RegisterClassExW(&m_wcl))
-        return false;
-
-    // Create a window that is centered on the desktop.
-    // It's exactly 1/4 the size of the desktop. Don't allow it to be resized.
-
-    DWORD wndExStyle{WS_EX_OVERLAPPEDWINDOW};
-    DWORD wndStyle{WS_OVERLAPPED | WS_CAPTION | WS_SYSMENU | WS_MINIMIZEBOX | WS_CLIPCHILDREN | WS_CLIPSIBLINGS};
-
-    m_hWnd = CreateWindowExW(wndExStyle, m_wcl.lpszClassName, m_pszWindowName, wndStyle, 0, 0, 0, 0, 0, 0, m_wcl.hInstance, this);
-
-    if (!m_hWnd)
-    {
-        UnregisterClassW(m_wcl.lpszClassName, m_hInstance);
-        return false;
-    }
-    else
-    {
-        int screenWidth{GetSystemMetrics(SM_CXSCREEN)};
-        int screenHeight{GetSystemMetrics(SM_CYSCREEN)};
-        int halfScreenWidth{screenWidth / 2};
-        int halfScreenHeight{screenHeight / 2};
-        int left{(screenWidth - halfScreenWidth) / 2};
-        int top{(screenHeight - halfScreenHeight) / 2};
-        RECT rc{};
-
-        SetRect(&rc, left, top, left + halfScreenWidth, top + halfScreenHeight);
-        AdjustWindowRectEx(&rc, wndStyle, FALSE, wndExStyle);
-        MoveWindow(m_hWnd, rc.left, rc.top, rc.right - rc.left, rc.bottom - rc.top, TRUE);
-
-        GetClientRect(m_hWnd, &rc);
-        m_windowWidth = rc.right - rc.left;
-        m_windowHeight = rc.bottom - rc.top;   
-
-        return true;
-    }
-}
-
-void GLApplication::destroy()
-{
-    if (m_pContext && m_hRC)
-    {
-	m_pContext->wglMakeCurrent(m_hDC, nullptr);
-	m_pContext->wglDeleteContext(m_hRC);
-	m_hRC = nullptr;
-    }
-	
-    if (m_hDC)
-    {
-	ReleaseDC(m_hWnd, m_hDC);
-	m_hDC = nullptr;
-    }
-    
-    UnregisterClassW(m_wcl.lpszClassName, m_hInstance);
-}
-
-void GLApplication::init(int argc, wchar_t *argv[])
-{
-}
-
-void GLApplication::initApplication(const wchar_t *pszWindowName)
-{
-    m_pszWindowName = pszWindowName;
-    
-    m_wcl.cbSize = sizeof(m_wcl);
-    m_wcl.style = CS_OWNDC | CS_HREDRAW | CS_VREDRAW;
-    m_wcl.lpfnWndProc = windowProc;
-    m_wcl.cbClsExtra = 0;
-    m_wcl.cbWndExtra = 0;
-    m_wcl.hInstance = m_hInstance;
-    m_wcl.hIcon = LoadIcon(0, IDI_APPLICATION);
-    m_wcl.hCursor = LoadCursor(0, IDC_ARROW);
-    m_wcl.hbrBackground = 0;
-    m_wcl.lpszMenuName = 0;
-    m_wcl.lpszClassName = L"GLApplicationWindowClass";
-    m_wcl.hIconSm = 0;
-}
-
-void GLApplication::initOpenGL()
-{
-    PIXELFORMATDESCRIPTOR pfd
-    {
-        .nSize = sizeof(pfd),
-        .nVersion = 1,
-        .dwFlags = PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL | PFD_DOUBLEBUFFER,
-        .iPixelType = PFD_TYPE_RGBA,
-        .cColorBits = 24,
-        .cDepthBits = 16,
-        .iLayerType = PFD_MAIN_PLANE,
-    };
-    	
-    if (!(m_pContext = OpenGLContext::createForWindow(m_hWnd, pfd)))
-        throw GLApplication::Error(L"GLContext::createForWindow() failed.");
-
-    if (!(m_hDC = GetDC(m_hWnd)))
-        throw GLApplication::Error(L"GetDC() failed.");
-
-    if (!(m_hRC = m_pContext->wglCreateContext(m_hDC)))
-	throw GLApplication::Error(L"GLContext::wglCreateContext() failed.");
-	
-    if (!m_pContext->wglMakeCurrent(m_hDC, m_hRC))
-	throw GLApplication::Error(L"GLContext::wglMakeCurrent() failed.");
-}
-
-int GLApplication::mainLoop()
-{
-    MSG msg{};
-    
-    memset(&msg, 0, sizeof(msg));
-    ShowWindow(m_hWnd, SW_SHOWDEFAULT);
-    UpdateWindow(m_hWnd);
-
-    while (true)
-    {
-        while (PeekMessage(&msg, 0, 0, 0, PM_REMOVE))
-        {
-            if (msg.message == WM_QUIT)
-                break;
-
-            TranslateMessage(&msg);
-            DispatchMessage(&msg);
-        }
-
-        if (msg.message == WM_QUIT)
-            break;
-
-        update();
-        render();
-        m_pContext->SwapBuffers(m_hDC);
-    }
-
-    return static_cast<int>(msg.wParam);
-}
-
-void GLApplication::render() const
-{
-    glViewport(0, 0, m_windowWidth, m_windowHeight);
-    glClearColor(0.3f, 0.5f, 0.9f, 0.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
-}
-
-void GLApplication::shutdown()
-{
-}
-
-void GLApplication::update()
-{
-}
-
-LRESULT CALLBACK GLApplication::windowProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
-{
-    GLApplication *pApplication{nullptr};
-
-    if (msg == WM_NCCREATE)
-    {
-        pApplication = reinterpret_cast<GLApplication *>((reinterpret_cast<LPCREATESTRUCT>(lParam))->lpCreateParams);
-        SetWindowLongPtr(hWnd, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(pApplication));
-    }
-    else
-    {
-        pApplication = reinterpret_cast<GLApplication *>(GetWindowLongPtr(hWnd, GWLP_USERDATA));
-    }
-
-    if (!pApplication)
-        return DefWindowProc(hWnd, msg, wParam, lParam);
-
-    pApplication->m_hWnd = hWnd;
-    return pApplication->windowProcImpl(hWnd, msg, wParam, lParam);
-}
-
-LRESULT GLApplication::windowProcImpl(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
-{
-    switch (msg)
-    {
-    case WM_DESTROY:
-        PostQuitMessage(0);
-	return 0;
-
-    case WM_SIZE:
-        m_windowWidth = static_cast<int>(LOWORD(lParam));
-        m_windowHeight = static_cast<int>(HIWORD(lParam));
-        break;
-
-    default:
-        break;
-    }
-
-    return DefWindowProc(hWnd, msg, wParam, lParam);
-}
-
-int WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _In_ LPWSTR lpCmdLine, _In_ int nShowCmd)
-{
-    GLApplication app{L"OpenGL Application"};
-    return app.run();
+import <windows.h>;
+import <GL/glcorearb.h>;
+import <algorithm>;
+import <cmath>;
+import <cstdint>;
+import <cstdio>;
+import <memory>;
+import <string>;
+import <vector>;
+import AllocationTracker;
+import Benchmark;
+import FrameArena;
+import GpuTimer;
+import OpenGL;
+import Results;
+import Scene;
+import Topology;
+
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Note:
+// VS2022 (v17.11.2) has an IntelliSense bug that causes it to report false errors
+// if this copyright notice is placed at the top of the file before import statements.
+
+// This Windows OpenGL application demonstrates how to use the OpenGLContext class
+// to avoid having to statically link to OpenGL32.lib.
+class GLApplication
+{
+public:
+    // Unicode-based, general-purpose exception and error class.
+    class Error
+    {
+    public:
+        Error(const wchar_t *pszMessage) : m_message{pszMessage} {}
+        Error(const std::wstring &message) : m_message{message} {}
+        virtual ~Error() {}
+
+        const wchar_t *what() const { return m_message.c_str(); }
+
+    private:
+        std::wstring m_message;
+    };
+
+    GLApplication();
+    GLApplication(const wchar_t *pszWindowName);
+    ~GLApplication();
+
+    int run();
+
+private:
+    // The application can render to several windows. Each window has its own drawable, viewport
+    // size and damage state. A single rendering context draws into every damaged window in turn
+    // and all of them are presented together with one batched swap at the end of the frame.
+    struct Window
+    {
+        HWND hWnd{nullptr};
+        HDC hDC{nullptr};
+        int width{};
+        int height{};
+        bool damaged{true};
+    };
+
+    static LRESULT CALLBACK windowProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
+
+    bool anyWindowDamaged() const;
+    bool create();
+    void destroy();
+    Window *findWindow(HWND hWnd);
+    void init(int argc, wchar_t *argv[]);
+    void initApplication(const wchar_t *pszWindowName);
+    void initOpenGL();
+    void initThread();
+    int mainLoop();
+    void parseCommandLine(int argc, wchar_t *argv[]);
+    void present(const FrameVector<HDC> &dcs);
+    void render(const Window &window) const;
+    void shutdown();
+    void update();
+    LRESULT windowProcImpl(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
+    void writeFrameReport() const;
+    void writeLoaderReport() const;
+
+    WNDCLASSEXW m_wcl{};
+    HINSTANCE m_hInstance{GetModuleHandle(nullptr)};
+    HGLRC m_hRC{nullptr};
+    const wchar_t *m_pszWindowName{L""};
+    std::vector<Window> m_windows;
+    std::shared_ptr<OpenGLContext> m_pContext{};
+
+    // Transient data built during update() and render() is allocated from the frame arena. It's
+    // released when the frame is presented, but its memory isn't reused until the frames that
+    // might still be in flight on the GPU have completed.
+    FrameArena m_frameArena;
+    FrameArenaStats m_frameArenaTotals{};
+    std::uint64_t m_frameArenaMaxBytes{};
+
+    // Command line options:
+    //  -windows n    number of windows to render to (1 to 64)
+    //  -ondemand     only redraw windows that have been damaged instead of every frame
+    //  -frames n     quit after n frames and report frame times
+    //  -report file  write the frame time report to file instead of stdout
+    //  -library path use the OpenGL implementation in the library at path instead of the default one
+    //  -loaderreport [file]
+    //                write how the loader resolved GL and WGL symbols to file or stdout once
+    //                the context and scene have been set up
+    //  -pin n        pin the GL thread to the logical processor Windows numbers n, or to the
+    //                first processor chosen by CpuTopology::placement() if n is "auto"
+    //  -pinnode n    restrict the GL thread to the logical processors of NUMA node number n
+    //  -priority p   set the GL thread's priority (low, normal, above, high or realtime)
+    //  -hidden       don't show the windows, so the frame loop can run unattended
+    //  -zeroalloc n  track heap allocations and fail if any are made from frame n onwards
+    //
+    // Benchmark options, parsed by init():
+    //  -scene name   the workload to render each frame (see Scene.ixx); implies -frames 1000
+    //  -seed n       seed for the scene's random choices
+    int m_windowCount{1};
+    bool m_redrawEveryFrame{true};
+    int m_frameLimit{};
+    const wchar_t *m_pszReportPath{nullptr};
+    const wchar_t *m_pszLibrary{nullptr};
+    bool m_loaderReport{false};
+    const wchar_t *m_pszLoaderReportPath{nullptr};
+    const wchar_t *m_pszPin{nullptr};
+    const wchar_t *m_pszPinNode{nullptr};
+    const wchar_t *m_pszPriority{nullptr};
+    int m_pinnedProcessor{-1};
+    bool m_hidden{false};
+    int m_steadyStateFrame{-1};
+    std::uint32_t m_seed{1};
+    std::unique_ptr<Scene> m_pScene;
+    std::unique_ptr<GpuTimer> m_pGpuTimer;
+    std::vector<double> m_frameSeconds;
+    std::vector<double> m_cpuSeconds;
+    std::vector<double> m_gpuSeconds;
+};
+
+GLApplication::GLApplication()
+{
+    initApplication(L"");
+}
+
+GLApplication::GLApplication(const wchar_t *pszWindowName)
+{
+    initApplication(pszWindowName);
+}
+
+GLApplication::~GLApplication()
+{
+}
+
+int GLApplication::run()
+{
+    int status{};
+ 
+    parseCommandLine(__argc, __wargv);
+
+    try
+    {
+        if (create())
+        {
+            try
+            {
+                initOpenGL();
+                initThread();
+                init(__argc, __wargv);
+                status = mainLoop();
+		shutdown();
+            }
+            catch (...)
+            {
+		shutdown();
+                throw;
+            }
+            
+            destroy();
+        }
+    }
+    catch (const GLApplication::Error &e)
+    {
+        destroy();
+        status = EXIT_FAILURE;
+        MessageBox(0, e.what(), L"GLApplication Unhandled Exception", MB_ICONERROR);
+    }
+
+    return status;
+}
+
+bool GLApplication::create()
+{      
+    if (!RegisterClassExW(&m_wcl))
+        return false;
+
+    // Create windows that together cover an area centered on the desktop.
+    // The area is exactly 1/4 the size of the desktop and is divided into a grid
+    // with one cell per window. Don't allow the windows to be resized.
+
+    DWORD wndExStyle{WS_EX_OVERLAPPEDWINDOW};
+    DWORD wndStyle{WS_OVERLAPPED | WS_CAPTION | WS_SYSMENU | WS_MINIMIZEBOX | WS_CLIPCHILDREN | WS_CLIPSIBLINGS};
+
+    int screenWidth{GetSystemMetrics(SM_CXSCREEN)};
+    int screenHeight{GetSystemMetrics(SM_CYSCREEN)};
+    int halfScreenWidth{screenWidth / 2};
+    int halfScreenHeight{screenHeight / 2};
+    int columns{static_cast<int>(std::ceil(std::sqrt(static_cast<double>(m_windowCount))))};
+    int rows{(m_windowCount + columns - 1) / columns};
+    int cellWidth{halfScreenWidth / columns};
+    int cellHeight{halfScreenHeight / rows};
+    int left{(screenWidth - halfScreenWidth) / 2};
+    int top{(screenHeight - halfScreenHeight) / 2};
+
+    for (int i = 0; i < m_windowCount; ++i)
+    {
+        std::wstring title{m_pszWindowName};
+
+        if (m_windowCount > 1)
+            title += L" (" + std::to_wstring(i + 1) + L")";
+
+        Window window{};
+        window.hWnd = CreateWindowExW(wndExStyle, m_wcl.lpszClassName, title.c_str(), wndStyle, 0, 0, 0, 0, 0, 0, m_wcl.hInstance, this);
+
+        if (!window.hWnd)
+        {
+            for (Window &created : m_windows)
+                DestroyWindow(created.hWnd);
+
+            m_windows.clear();
+            UnregisterClassW(m_wcl.lpszClassName, m_hInstance);
+            return false;
+        }
+
+        int x{left + (i % columns) * cellWidth};
+        int y{top + (i / columns) * cellHeight};
+        RECT rc{};
+
+        SetRect(&rc, x, y, x + cellWidth, y + cellHeight);
+        AdjustWindowRectEx(&rc, wndStyle, FALSE, wndExStyle);
+        MoveWindow(window.hWnd, rc.left, rc.top, rc.right - rc.left, rc.bottom - rc.top, TRUE);
+
+        GetClientRect(window.hWnd, &rc);
+        window.width = rc.right - rc.left;
+        window.height = rc.bottom - rc.top;
+
+        m_windows.push_back(window);
+    }
+
+    return true;
+}
+
+void GLApplication::destroy()
+{
+    if (m_pContext && m_hRC)
+    {
+	m_pContext->wglMakeCurrent(nullptr, nullptr);
+	m_pContext->wglDeleteContext(m_hRC);
+	m_hRC = nullptr;
+    }
+	
+    for (Window &window : m_windows)
+    {
+        if (window.hDC)
+        {
+            ReleaseDC(window.hWnd, window.hDC);
+            window.hDC = nullptr;
+        }
+
+        // Closing any one window ends the application, so the others may still exist.
+
+        if (IsWindow(window.hWnd))
+            DestroyWindow(window.hWnd);
+    }
+
+    m_windows.clear();
+    UnregisterClassW(m_wcl.lpszClassName, m_hInstance);
+}
+
+bool GLApplication::anyWindowDamaged() const
+{
+    for (const Window &window : m_windows)
+    {
+        if (window.damaged)
+            return true;
+    }
+
+    return false;
+}
+
+GLApplication::Window *GLApplication::findWindow(HWND hWnd)
+{
+    for (Window &window : m_windows)
+    {
+        if (window.hWnd == hWnd)
+            return &window;
+    }
+
+    return nullptr;
+}
+
+void GLApplication::init(int argc, wchar_t *argv[])
+{
+    BenchmarkArguments args{argc, argv};
+
+    m_seed = static_cast<std::uint32_t>(args.intValue(L"-seed", 1));
+
+    if (!(m_pScene = Scene::create(args.value(L"-scene", L"clear"), m_seed, *m_pContext, m_windows.front().hDC)))
+        throw GLApplication::Error(std::wstring{L"Unknown or unsupported scene: "} + args.value(L"-scene"));
+
+    // A scene run is a benchmark, so it always stops after a fixed number of frames.
+
+    if (args.has(L"-scene") && m_frameLimit == 0)
+        m_frameLimit = 1000;
+
+    // Frame times are recorded without allocating. GPU times are only measured when they'll be reported.
+
+    m_frameSeconds.reserve(m_frameLimit);
+    m_cpuSeconds.reserve(m_frameLimit);
+    m_gpuSeconds.reserve(m_frameLimit);
+
+    if (m_frameLimit > 0)
+        m_pGpuTimer = GpuTimer::create(*m_pContext);
+
+    if (m_loaderReport)
+        writeLoaderReport();
+}
+
+void GLApplication::initApplication(const wchar_t *pszWindowName)
+{
+    m_pszWindowName = pszWindowName;
+    
+    m_wcl.cbSize = sizeof(m_wcl);
+    m_wcl.style = CS_OWNDC | CS_HREDRAW | CS_VREDRAW;
+    m_wcl.lpfnWndProc = windowProc;
+    m_wcl.cbClsExtra = 0;
+    m_wcl.cbWndExtra = 0;
+    m_wcl.hInstance = m_hInstance;
+    m_wcl.hIcon = LoadIcon(0, IDI_APPLICATION);
+    m_wcl.hCursor = LoadCursor(0, IDC_ARROW);
+    m_wcl.hbrBackground = 0;
+    m_wcl.lpszMenuName = 0;
+    m_wcl.lpszClassName = L"GLApplicationWindowClass";
+    m_wcl.hIconSm = 0;
+}
+
+void GLApplication::initOpenGL()
+{
+    PIXELFORMATDESCRIPTOR pfd
+    {
+        .nSize = sizeof(pfd),
+        .nVersion = 1,
+        .dwFlags = PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL | PFD_DOUBLEBUFFER,
+        .iPixelType = PFD_TYPE_RGBA,
+        .cColorBits = 24,
+        .cDepthBits = 16,
+        .iLayerType = PFD_MAIN_PLANE,
+    };
+    	
+    // Every window gets the same pixel format so that one rendering context can draw into all of them.
+
+    for (Window &window : m_windows)
+    {
+        std::shared_ptr<OpenGLContext> pContext{OpenGLContext::createForWindow(window.hWnd, pfd, m_pszLibrary)};
+
+        if (!pContext)
+            throw GLApplication::Error(L"GLContext::createForWindow() failed.");
+
+        if (!m_pContext)
+            m_pContext = pContext;
+
+        if (!(window.hDC = GetDC(window.hWnd)))
+            throw GLApplication::Error(L"GetDC() failed.");
+    }
+
+    if (!(m_hRC = m_pContext->wglCreateContext(m_windows.front().hDC)))
+	throw GLApplication::Error(L"GLContext::wglCreateContext() failed.");
+	
+    if (!m_pContext->wglMakeCurrent(m_windows.front().hDC, m_hRC))
+	throw GLApplication::Error(L"GLContext::wglMakeCurrent() failed.");
+}
+
+void GLApplication::initThread()
+{
+    // This is done after the rendering context has been created because drivers such as
+    // Mesa llvmpipe create their worker threads with the context, and those threads would
+    // otherwise inherit the GL thread's affinity.
+
+    const CpuTopology &topology{CpuTopology::instance()};
+
+    if (m_pszPin)
+    {
+        bool automatic{_wcsicmp(m_pszPin, L"auto") == 0};
+        unsigned processor{automatic ? topology.placement(1).front() : static_cast<unsigned>(_wtoi(m_pszPin))};
+
+        if (!topology.pinCurrentThread(processor))
+            throw GLApplication::Error(L"CpuTopology::pinCurrentThread() failed.");
+
+        m_pinnedProcessor = static_cast<int>(processor);
+    }
+    else if (m_pszPinNode)
+    {
+        if (!topology.pinCurrentThreadToNode(static_cast<unsigned>(_wtoi(m_pszPinNode))))
+            throw GLApplication::Error(L"CpuTopology::pinCurrentThreadToNode() failed.");
+    }
+
+    if (m_pszPriority)
+    {
+        ThreadPriority priority{};
+
+        if (!CpuTopology::parsePriority(m_pszPriority, priority))
+            throw GLApplication::Error(std::wstring{L"Unknown thread priority: "} + m_pszPriority);
+
+        if (!CpuTopology::setCurrentThreadPriority(priority))
+            throw GLApplication::Error(L"CpuTopology::setCurrentThreadPriority() failed.");
+    }
+}
+
+int GLApplication::mainLoop()
+{
+    MSG msg{};
+    Stopwatch frameTimer;
+    
+    memset(&msg, 0, sizeof(msg));
+
+    for (Window &window : m_windows)
+    {
+        if (m_hidden)
+            continue;
+
+        ShowWindow(window.hWnd, SW_SHOWDEFAULT);
+        UpdateWindow(window.hWnd);
+    }
+
+    if (m_steadyStateFrame >= 0)
+        AllocationTracker::start(static_cast<std::uint64_t>(m_steadyStateFrame));
+
+    while (true)
+    {
+        // When only damaged windows are redrawn there's nothing to do until a message damages one,
+        // so the thread sleeps until a message arrives instead of spinning through empty frames.
+
+        if (!m_redrawEveryFrame && !anyWindowDamaged())
+            WaitMessage();
+
+        while (PeekMessage(&msg, 0, 0, 0, PM_REMOVE))
+        {
+            if (msg.message == WM_QUIT)
+                break;
+
+            TranslateMessage(&msg);
+            DispatchMessage(&msg);
+        }
+
+        if (msg.message == WM_QUIT)
+            break;
+
+        Stopwatch cpuTimer;
+        double gpuSeconds{};
+
+        if (m_pGpuTimer)
+        {
+            // Samples are only kept for a report, which needs a frame limit. The queries are still
+            // collected so that the timer doesn't fill up.
+
+            while (m_pGpuTimer->collect(gpuSeconds, m_pGpuTimer->full()))
+            {
+                if (m_frameLimit > 0)
+                    m_gpuSeconds.push_back(gpuSeconds);
+            }
+
+            m_pGpuTimer->begin();
+        }
+
+        update();
+
+        FrameVector<HDC> presentDCs{m_frameArena};
+        presentDCs.reserve(m_windows.size());
+
+        for (Window &window : m_windows)
+        {
+            if (!window.damaged && !m_redrawEveryFrame)
+                continue;
+
+            if (!m_pContext->wglMakeCurrent(window.hDC, m_hRC))
+                throw GLApplication::Error(L"GLContext::wglMakeCurrent() failed.");
+
+            render(window);
+            window.damaged = false;
+            presentDCs.push_back(window.hDC);
+        }
+
+        if (m_pGpuTimer)
+            m_pGpuTimer->end();
+
+        double cpuSeconds{cpuTimer.seconds()};
+
+        present(presentDCs);
+        AllocationTracker::endFrame();
+
+        if (m_frameLimit > 0)
+        {
+            m_frameSeconds.push_back(frameTimer.seconds());
+            m_cpuSeconds.push_back(cpuSeconds);
+            frameTimer.restart();
+
+            if (static_cast<int>(m_frameSeconds.size()) >= m_frameLimit)
+            {
+                AllocationTracker::stop();
+
+                while (m_pGpuTimer && m_pGpuTimer->collect(gpuSeconds, true))
+                    m_gpuSeconds.push_back(gpuSeconds);
+
+                writeFrameReport();
+
+                // Allocating in the steady state fails the run, so it can be used as a check.
+
+                if (m_steadyStateFrame >= 0 && AllocationTracker::stats().steadyStateAllocations > 0)
+                    return EXIT_FAILURE;
+
+                return EXIT_SUCCESS;
+            }
+        }
+    }
+
+    AllocationTracker::stop();
+    return static_cast<int>(msg.wParam);
+}
+
+void GLApplication::parseCommandLine(int argc, wchar_t *argv[])
+{
+    BenchmarkArguments args{argc, argv};
+
+    m_windowCount = std::max(1, std::min(args.intValue(L"-windows", 1), 64));
+    m_redrawEveryFrame = !args.has(L"-ondemand");
+    m_frameLimit = std::max(0, args.intValue(L"-frames", 0));
+    m_pszReportPath = args.value(L"-report");
+    m_pszLibrary = args.value(L"-library");
+    m_loaderReport = args.has(L"-loaderreport");
+    m_pszLoaderReportPath = args.value(L"-loaderreport");
+    m_pszPin = args.value(L"-pin");
+    m_pszPinNode = args.value(L"-pinnode");
+    m_pszPriority = args.value(L"-priority");
+    m_hidden = args.has(L"-hidden");
+    m_steadyStateFrame = args.has(L"-zeroalloc") ? std::max(0, args.intValue(L"-zeroalloc", 0)) : -1;
+
+    // -loaderreport may be given without a file, in which case the next argument is another option.
+
+    if (m_pszLoaderReportPath && m_pszLoaderReportPath[0] == L'-')
+        m_pszLoaderReportPath = nullptr;
+}
+
+void GLApplication::present(const FrameVector<HDC> &dcs)
+{
+    if (!dcs.empty() && !m_pContext->swapBuffers(static_cast<UINT>(dcs.size()), dcs.data()))
+        throw GLApplication::Error(L"GLContext::swapBuffers() failed.");
+
+    // The frame's transient data isn't needed after the swap. The arena is advanced even if
+    // nothing was drawn so that every frame is accounted for in the statistics.
+
+    const FrameArenaStats &stats{m_frameArena.frameStats()};
+
+    m_frameArenaTotals.allocations += stats.allocations;
+    m_frameArenaTotals.bytes += stats.bytes;
+    m_frameArenaTotals.heapBlocks += stats.heapBlocks;
+    m_frameArenaMaxBytes = std::max(m_frameArenaMaxBytes, stats.bytes);
+    m_frameArena.nextFrame();
+}
+
+void GLApplication::render(const Window &window) const
+{
+    // A minimised window has a 0x0 client area, which there's nothing to draw into.
+
+    if (window.width <= 0 || window.height <= 0)
+        return;
+
+    m_pScene->render(window.width, window.height, m_frameArena.frameIndex());
+}
+
+void GLApplication::shutdown()
+{
+    // The scene and timer own GL objects, so they're released while the context is still current.
+
+    m_pGpuTimer.reset();
+    m_pScene.reset();
+}
+
+void GLApplication::update()
+{
+}
+
+LRESULT CALLBACK GLApplication::windowProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
+{
+    GLApplication *pApplication{nullptr};
+
+    if (msg == WM_NCCREATE)
+    {
+        pApplication = reinterpret_cast<GLApplication *>((reinterpret_cast<LPCREATESTRUCT>(lParam))->lpCreateParams);
+        SetWindowLongPtr(hWnd, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(pApplication));
+    }
+    else
+    {
+        pApplication = reinterpret_cast<GLApplication *>(GetWindowLongPtr(hWnd, GWLP_USERDATA));
+    }
+
+    if (!pApplication)
+        return DefWindowProc(hWnd, msg, wParam, lParam);
+
+    return pApplication->windowProcImpl(hWnd, msg, wParam, lParam);
+}
+
+LRESULT GLApplication::windowProcImpl(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
+{
+    switch (msg)
+    {
+    case WM_DESTROY:
+        PostQuitMessage(0);
+	return 0;
+
+    case WM_PAINT:
+        if (Window *pWindow{findWindow(hWnd)})
+            pWindow->damaged = true;
+        break;
+
+    case WM_SIZE:
+        if (Window *pWindow{findWindow(hWnd)})
+        {
+            pWindow->width = static_cast<int>(LOWORD(lParam));
+            pWindow->height = static_cast<int>(HIWORD(lParam));
+            pWindow->damaged = true;
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return DefWindowProc(hWnd, msg, wParam, lParam);
+}
+
+void GLApplication::writeFrameReport() const
+{
+    BenchmarkReport report{"application"};
+
+    reportDriverProperties(report);
+    report.setProperty("windows", static_cast<double>(m_windows.size()));
+    report.setProperty("frames", static_cast<double>(m_frameSeconds.size()));
+    report.setProperty("topology", CpuTopology::instance().describe());
+    report.setProperty("pinnedProcessor", m_pinnedProcessor);
+    report.setProperty("threadPriority", GetThreadPriority(GetCurrentThread()));
+    report.setProperty("scene", m_pScene->name());
+    report.setProperty("seed", m_seed);
+    report.setProperty("gpuTimer", m_pGpuTimer ? "GL_TIME_ELAPSED" : "unavailable");
+
+    double count{static_cast<double>(m_frameSeconds.size())};
+    double totalSeconds{0.0};
+    double sumOfSquares{0.0};
+
+    for (double seconds : m_frameSeconds)
+        totalSeconds += seconds;
+
+    for (double seconds : m_frameSeconds)
+        sumOfSquares += (seconds - totalSeconds / count) * (seconds - totalSeconds / count);
+
+    report.beginResult();
+    report.set("frameMsMean", totalSeconds * 1e3 / count);
+    report.set("frameMsStdDev", std::sqrt(sumOfSquares / count) * 1e3);
+    report.set("frameMsP50", percentile(m_frameSeconds, 0.50) * 1e3);
+    report.set("frameMsP99", percentile(m_frameSeconds, 0.99) * 1e3);
+    report.set("frameMsMax", percentile(m_frameSeconds, 1.0) * 1e3);
+    report.set("cpuMsP50", percentile(m_cpuSeconds, 0.50) * 1e3);
+    report.set("cpuMsP99", percentile(m_cpuSeconds, 0.99) * 1e3);
+
+    if (!m_gpuSeconds.empty())
+    {
+        report.set("gpuMsP50", percentile(m_gpuSeconds, 0.50) * 1e3);
+        report.set("gpuMsP99", percentile(m_gpuSeconds, 0.99) * 1e3);
+        report.set("gpuMsMax", percentile(m_gpuSeconds, 1.0) * 1e3);
+    }
+    report.set("arenaAllocationsPerFrame", static_cast<double>(m_frameArenaTotals.allocations) / count);
+    report.set("arenaBytesPerFrame", static_cast<double>(m_frameArenaTotals.bytes) / count);
+    report.set("arenaBytesMax", static_cast<double>(m_frameArenaMaxBytes));
+    report.set("arenaHeapBlocks", static_cast<double>(m_frameArenaTotals.heapBlocks));
+
+    if (m_steadyStateFrame >= 0)
+    {
+        AllocationStats allocations{AllocationTracker::stats()};
+        std::vector<AllocationRecord> violations{AllocationTracker::violations()};
+
+        report.setProperty("steadyStateFrame", m_steadyStateFrame);
+
+        for (size_t i = 0; i < violations.size(); ++i)
+            report.setProperty(("steadyStateAllocation" + std::to_string(i)).c_str(), AllocationTracker::describe(violations[i]));
+
+        report.set("heapAllocationsPerFrame", static_cast<double>(allocations.allocations) / count);
+        report.set("heapAllocationsMaxPerFrame", static_cast<double>(allocations.maxFrameAllocations));
+        report.set("steadyStateAllocations", static_cast<double>(allocations.steadyStateAllocations));
+    }
+
+    if (!report.write(m_pszReportPath))
+        throw GLApplication::Error(L"Failed to write the frame time report.");
+}
+
+void GLApplication::writeLoaderReport() const
+{
+    std::string text{OpenGLContext::loaderReport(m_pszLibrary).describe()};
+    FILE *pFile{stdout};
+
+    if (m_pszLoaderReportPath && _wfopen_s(&pFile, m_pszLoaderReportPath, L"wb") != 0)
+        throw GLApplication::Error(L"Failed to write the loader report.");
+
+    std::fwrite(text.data(), 1, text.size(), pFile);
+
+    if (pFile != stdout)
+        std::fclose(pFile);
+    else
+        std::fflush(pFile);
+}
+
+int WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _In_ LPWSTR lpCmdLine, _In_ int nShowCmd)
+{
+    int status{};
+
+    if (runBenchmarkFromCommandLine(__argc, __wargv, status))
+        return status;
+
+    if (runResultsFromCommandLine(__argc, __wargv, status))
+        return status;
+
+    GLApplication app{L"OpenGL Application"};
+    return app.run();
 }
\ No newline at end of file
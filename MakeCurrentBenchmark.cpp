@@ -0,0 +1,152 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+module Benchmark;
+
+import HeadlessContext;
+import OpenGL;
+
+// Measures a context-switch-heavy frame with and without user-space current context tracking.
+//
+//     -benchmark makecurrent [-windows n] [-frames n] [-size n]
+//
+// Each frame renders to several drawables that share objects with a separate upload context.
+// Like typical helper code it makes a context current before every operation, whether or not
+// it already is, and checks wglGetCurrentContext() before issuing GL calls.
+
+namespace
+{
+	struct FrameResults
+	{
+		double seconds{};
+		OpenGLContext::CurrentTrackingStats stats{};
+	};
+
+	void ensureCurrent(HeadlessContext &context)
+	{
+		if (context.wgl().wglGetCurrentContext() != context.rc() || context.wgl().wglGetCurrentDC() != context.dc())
+			context.makeCurrent();
+	}
+
+	FrameResults runFrames(std::vector<std::unique_ptr<HeadlessContext>> &windows, HeadlessContext &upload, GLuint texture, int frames, int size)
+	{
+		std::vector<std::uint32_t> pixels(static_cast<size_t>(size) * size, 0xff808080u);
+
+		OpenGLContext::resetCurrentTrackingStats();
+		Stopwatch stopwatch;
+
+		for (int frame = 0; frame < frames; ++frame)
+		{
+			upload.makeCurrent();
+			ensureCurrent(upload);
+			glBindTexture(GL_TEXTURE_2D, texture);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size, size, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+			glFlush();
+
+			for (auto &pWindow : windows)
+			{
+				pWindow->makeCurrent();
+				ensureCurrent(*pWindow);
+				glViewport(0, 0, size, size);
+				pWindow->makeCurrent();
+				glClearColor(static_cast<float>(frame & 0xff) / 255.0f, 0.0f, 0.0f, 1.0f);
+				glClear(GL_COLOR_BUFFER_BIT);
+				ensureCurrent(*pWindow);
+				glBindTexture(GL_TEXTURE_2D, texture);
+				pWindow->wgl().SwapBuffers(pWindow->dc());
+			}
+		}
+
+		upload.makeCurrent();
+		glFinish();
+
+		return FrameResults{stopwatch.seconds(), OpenGLContext::currentTrackingStats()};
+	}
+}
+
+int runMakeCurrentBenchmark(const BenchmarkArguments &args, BenchmarkReport &report)
+{
+	int windowCount{std::max(1, args.intValue(L"-windows", 4))};
+	int frames{std::max(1, args.intValue(L"-frames", 500))};
+	int size{std::max(16, args.intValue(L"-size", 64))};
+
+	std::unique_ptr<HeadlessContext> pUpload{HeadlessContext::create(size, size)};
+
+	if (!pUpload || !pUpload->makeCurrent())
+		return EXIT_FAILURE;
+
+	reportDriverProperties(report);
+	report.setProperty("windows", windowCount);
+	report.setProperty("frames", frames);
+	report.setProperty("size", size);
+
+	GLuint texture{};
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+	std::vector<std::unique_ptr<HeadlessContext>> windows;
+
+	for (int i = 0; i < windowCount; ++i)
+	{
+		windows.push_back(HeadlessContext::create(size, size, pUpload->rc()));
+
+		if (!windows.back())
+			return EXIT_FAILURE;
+	}
+
+	// Warm up once before measuring each mode.
+
+	for (bool tracking : {false, true})
+	{
+		OpenGLContext::setCurrentTracking(tracking);
+		runFrames(windows, *pUpload, texture, std::min(frames, 10), size);
+
+		FrameResults results{runFrames(windows, *pUpload, texture, frames, size)};
+
+		report.beginResult();
+		report.set("tracking", tracking ? "on" : "off");
+		report.set("seconds", results.seconds);
+		report.set("framesPerSecond", frames / results.seconds);
+		report.set("usPerFrame", results.seconds * 1e6 / frames);
+		report.set("makeCurrentCalls", static_cast<double>(results.stats.makeCurrentCalls));
+		report.set("makeCurrentForwarded", static_cast<double>(results.stats.makeCurrentForwarded));
+		report.set("queries", static_cast<double>(results.stats.queries));
+		report.set("queriesForwarded", static_cast<double>(results.stats.queriesForwarded));
+	}
+
+	OpenGLContext::setCurrentTracking(true);
+
+	pUpload->makeCurrent();
+	glDeleteTextures(1, &texture);
+	windows.clear();
+
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,207 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+module Benchmark;
+
+import HeadlessContext;
+import OpenGL;
+
+// Measures a material-heavy frame with texture parameter shadowing off, on, and deduplicating the
+// parameters into sampler objects.
+//
+//     -benchmark materials [-materials n] [-textures n] [-frames n]
+//
+// Like typical material code, each material binds its texture and sets all of its sampling parameters
+// before drawing, whether or not the texture already has them. The textures are shared between
+// materials and use four distinct sets of parameters, one of them with 4x anisotropy where the driver
+// has it, so shadowing filters out almost every call and samplers mode needs only four sampler
+// objects. Samplers mode is skipped before GL 3.3 without ARB_sampler_objects. The draws have no
+// vertex arrays enabled, so the frame time is the cost of the calls. Fails if a texture is sampled with
+// the wrong parameters afterwards, as read back from the driver rather than from the loader.
+
+namespace
+{
+	struct SamplingParameters
+	{
+		GLint minFilter;
+		GLint magFilter;
+		GLint wrap;
+		GLfloat anisotropy;
+	};
+
+	constexpr SamplingParameters kParameterSets[]
+	{
+		{GL_LINEAR, GL_LINEAR, GL_REPEAT, 1.0f},
+		{GL_NEAREST, GL_NEAREST, GL_CLAMP_TO_EDGE, 1.0f},
+		{GL_LINEAR, GL_LINEAR, GL_CLAMP_TO_EDGE, 4.0f},
+		{GL_NEAREST, GL_LINEAR, GL_MIRRORED_REPEAT, 1.0f},
+	};
+
+	const SamplingParameters &parametersOf(unsigned texture)
+	{
+		return kParameterSets[texture % std::size(kParameterSets)];
+	}
+
+	void renderFrame(const std::vector<GLuint> &textures, int materials, bool anisotropy)
+	{
+		for (int material = 0; material < materials; ++material)
+		{
+			unsigned index{static_cast<unsigned>(material) % static_cast<unsigned>(textures.size())};
+			const SamplingParameters &parameters{parametersOf(index)};
+
+			glBindTexture(GL_TEXTURE_2D, textures[index]);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, parameters.minFilter);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, parameters.magFilter);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, parameters.wrap);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, parameters.wrap);
+
+			if (anisotropy)
+				glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY, parameters.anisotropy);
+
+			glDrawArrays(GL_TRIANGLES, 0, 3);
+		}
+	}
+
+	// The parameters are read from what the driver samples the texture with: the sampler object bound
+	// to the unit by the draw, or the texture itself if there's none. glGetTexParameteriv() would be
+	// answered from the loader's shadow while a sampler object stands in for the texture.
+
+	bool checkParameters(const std::vector<GLuint> &textures, PFNGLGETSAMPLERPARAMETERIVPROC pfnGetSamplerParameteriv)
+	{
+		bool ok{true};
+
+		for (unsigned index = 0; index < textures.size(); ++index)
+		{
+			GLint sampler{};
+			GLint minFilter{}, magFilter{}, wrap{};
+
+			glBindTexture(GL_TEXTURE_2D, textures[index]);
+			glDrawArrays(GL_TRIANGLES, 0, 3);
+
+			if (pfnGetSamplerParameteriv)
+				glGetIntegerv(GL_SAMPLER_BINDING, &sampler);
+
+			if (sampler != 0)
+			{
+				pfnGetSamplerParameteriv(sampler, GL_TEXTURE_MIN_FILTER, &minFilter);
+				pfnGetSamplerParameteriv(sampler, GL_TEXTURE_MAG_FILTER, &magFilter);
+				pfnGetSamplerParameteriv(sampler, GL_TEXTURE_WRAP_T, &wrap);
+			}
+			else
+			{
+				glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, &minFilter);
+				glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, &magFilter);
+				glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, &wrap);
+			}
+
+			const SamplingParameters &expected{parametersOf(index)};
+			ok = ok && minFilter == expected.minFilter && magFilter == expected.magFilter && wrap == expected.wrap;
+		}
+
+		return ok;
+	}
+}
+
+int runMaterialsBenchmark(const BenchmarkArguments &args, BenchmarkReport &report)
+{
+	int materials{std::max(1, args.intValue(L"-materials", 2000))};
+	int textureCount{std::max(1, args.intValue(L"-textures", 250))};
+	int frames{std::max(1, args.intValue(L"-frames", 200))};
+
+	report.setProperty("materials", materials);
+	report.setProperty("textures", textureCount);
+	report.setProperty("frames", frames);
+
+	const TextureCacheMode modes[]
+	{
+		{OpenGLContext::TextureCache::Off, "off"},
+		{OpenGLContext::TextureCache::Shadow, "shadow"},
+		{OpenGLContext::TextureCache::Samplers, "samplers"},
+	};
+
+	return runTextureCacheModes(modes, [&](const TextureCacheMode &mode, HeadlessContext &context)
+	{
+		const GLExtensions &extensions{context.wgl().extensions()};
+		bool anisotropy{extensions.version().atLeast(4, 6) || extensions.has<GLExtensions::EXT_texture_filter_anisotropic>()};
+		bool samplers{extensions.version().atLeast(3, 3) || extensions.has<GLExtensions::ARB_sampler_objects>()};
+
+		if (mode.mode == OpenGLContext::TextureCache::Off)
+		{
+			reportDriverProperties(report);
+			report.setProperty("anisotropy", anisotropy ? "yes" : "no");
+		}
+
+		if (mode.mode == OpenGLContext::TextureCache::Samplers && !samplers)
+			return true;
+
+		std::vector<GLuint> textures(textureCount);
+		const std::uint32_t texels[16]{};
+
+		glGenTextures(textureCount, textures.data());
+
+		for (GLuint texture : textures)
+		{
+			glBindTexture(GL_TEXTURE_2D, texture);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 4, 4, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels);
+		}
+
+		// The first frame gives every texture its parameters, so it isn't measured.
+
+		renderFrame(textures, materials, anisotropy);
+		glFinish();
+
+		std::uint64_t samplerObjects{OpenGLContext::textureCacheStats().samplerObjects};
+		OpenGLContext::resetTextureCacheStats();
+
+		Stopwatch stopwatch;
+
+		for (int frame = 0; frame < frames; ++frame)
+			renderFrame(textures, materials, anisotropy);
+
+		glFinish();
+
+		double seconds{stopwatch.seconds()};
+		OpenGLContext::TextureCacheStats stats{OpenGLContext::textureCacheStats()};
+		auto pfnGetSamplerParameteriv{samplers ? reinterpret_cast<PFNGLGETSAMPLERPARAMETERIVPROC>(context.wgl().wglGetProcAddress("glGetSamplerParameteriv")) : nullptr};
+		bool correct{checkParameters(textures, pfnGetSamplerParameteriv)};
+
+		report.beginResult();
+		report.set("mode", mode.pszName);
+		report.set("usPerFrame", seconds * 1e6 / frames);
+		report.set("parameterCallsPerFrame", static_cast<double>(stats.parameterCalls) / frames);
+		report.set("forwardedPerFrame", static_cast<double>(stats.parameterCallsForwarded) / frames);
+		report.set("filteredPerFrame", static_cast<double>(stats.parameterCalls - stats.parameterCallsForwarded) / frames);
+		report.set("samplerBindsPerFrame", static_cast<double>(stats.samplerBinds) / frames);
+		report.set("samplerObjects", static_cast<double>(samplerObjects));
+		report.set("correct", correct ? "yes" : "no");
+
+		glDeleteTextures(textureCount, textures.data());
+		return correct;
+	});
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+module Benchmark;
+
+import HeadlessContext;
+import OpenGL;
+
+// Measures the frame time of one rendering context drawing into 1 to n windows, presenting them
+// with a single batched OpenGLContext::swapBuffers() call or with one SwapBuffers() call per window.
+//
+//     -benchmark multiwindow [-maxwindows n] [-frames n] [-size n]
+
+namespace
+{
+	std::vector<double> runFrames(const std::vector<std::unique_ptr<HeadlessContext>> &windows, int windowCount, HGLRC hRC, bool batched, int frames)
+	{
+		OpenGLContext &wgl{windows.front()->wgl()};
+		std::vector<HDC> dcs;
+		std::vector<double> frameSeconds;
+
+		frameSeconds.reserve(frames);
+
+		for (int i = 0; i < windowCount; ++i)
+			dcs.push_back(windows[i]->dc());
+
+		for (int frame = 0; frame < frames; ++frame)
+		{
+			Stopwatch stopwatch;
+
+			for (int i = 0; i < windowCount; ++i)
+			{
+				wgl.wglMakeCurrent(windows[i]->dc(), hRC);
+				glViewport(0, 0, windows[i]->width(), windows[i]->height());
+				glClearColor(static_cast<float>(frame & 0xff) / 255.0f, 0.5f, 0.9f, 1.0f);
+				glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			}
+
+			if (batched)
+			{
+				wgl.swapBuffers(static_cast<UINT>(dcs.size()), dcs.data());
+			}
+			else
+			{
+				for (HDC hDC : dcs)
+					wgl.SwapBuffers(hDC);
+			}
+
+			frameSeconds.push_back(stopwatch.seconds());
+		}
+
+		glFinish();
+		return frameSeconds;
+	}
+}
+
+int runMultiWindowBenchmark(const BenchmarkArguments &args, BenchmarkReport &report)
+{
+	int maxWindows{std::clamp(args.intValue(L"-maxwindows", 16), 1, 64)};
+	int frames{std::max(1, args.intValue(L"-frames", 300))};
+	int size{std::max(16, args.intValue(L"-size", 256))};
+
+	std::vector<std::unique_ptr<HeadlessContext>> windows;
+
+	for (int i = 0; i < maxWindows; ++i)
+	{
+		windows.push_back(HeadlessContext::create(size, size));
+
+		if (!windows.back())
+			return EXIT_FAILURE;
+	}
+
+	// Every HeadlessContext uses the same pixel format, so the first one's rendering context can draw into all of them.
+
+	HGLRC hRC{windows.front()->rc()};
+
+	if (!windows.front()->makeCurrent())
+		return EXIT_FAILURE;
+
+	reportDriverProperties(report);
+	report.setProperty("frames", frames);
+	report.setProperty("size", size);
+
+	for (int windowCount = 1; windowCount <= maxWindows; ++windowCount)
+	{
+		for (bool batched : {false, true})
+		{
+			runFrames(windows, windowCount, hRC, batched, std::min(frames, 10));
+
+			std::vector<double> frameSeconds{runFrames(windows, windowCount, hRC, batched, frames)};
+			double totalSeconds{0.0};
+
+			for (double seconds : frameSeconds)
+				totalSeconds += seconds;
+
+			report.beginResult();
+			report.set("windows", windowCount);
+			report.set("present", batched ? "batched" : "loop");
+			report.set("frameMsMean", totalSeconds * 1e3 / frames);
+			report.set("frameMsP50", percentile(frameSeconds, 0.50) * 1e3);
+			report.set("frameMsP99", percentile(frameSeconds, 0.99) * 1e3);
+		}
+	}
+
+	windows.front()->wgl().wglMakeCurrent(nullptr, nullptr);
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -1,749 +1,3893 @@
-// Copyright (c) 2024 dhpoware. All Rights Reserved.
-//
-// Permission is hereby granted, free of charge, to any person obtaining a
-// copy of this software and associated documentation files (the "Software"),
-// to deal in the Software without restriction, including without limitation
-// the rights to use, copy, modify, merge, publish, distribute, sublicense,
-// and/or sell copies of the Software, and to permit persons to whom the
-// Software is furnished to do so, subject to the following conditions:
-//
-// The above copyright notice and this permission notice shall be included in
-// all copies or substantial portions of the Software.
-//
-// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
-// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
-// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
-// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
-// IN THE SOFTWARE.
-
-module;
-
-#include <windows.h>
-#include <GL/glcorearb.h>
-#include <cassert>
-#include <memory>
-
-module OpenGL;
-
-#define LOAD_ENTRYPOINT(name, var, type) \
-    if (!var) \
-    { \
-        var = reinterpret_cast<type>(Loader::instance().getProcAddress(name)); \
-        assert(var != nullptr); \
-    }
-
-//
-// Loader is a singleton class that loads the OpenGL library and retrieves function pointers to OpenGL functions.
-//
-
-class Loader
-{
-public:
-	static Loader &instance();
-
-	void *getProcAddress(const char *pszName) const;
-
-private:
-	Loader();
-	~Loader();
-
-	using PFNWGLGETPROCADDRESSPROC = void *(APIENTRY *)(const char *);
-
-	HMODULE m_hLibGL;
-	PFNWGLGETPROCADDRESSPROC m_pfnWglGetProcAddress;
-};
-
-Loader &Loader::instance()
-{
-	static Loader theInstance;
-	return theInstance;
-}
-
-Loader::Loader() : m_hLibGL(nullptr), m_pfnWglGetProcAddress(nullptr)
-{
-	m_hLibGL = LoadLibraryA("opengl32.dll");
-
-	if (m_hLibGL != nullptr)
-	{
-		m_pfnWglGetProcAddress = reinterpret_cast<PFNWGLGETPROCADDRESSPROC>(GetProcAddress(m_hLibGL, "wglGetProcAddress"));
-	}
-}
-
-Loader::~Loader()
-{
-	if (m_hLibGL != nullptr)
-	{
-		FreeLibrary(m_hLibGL);
-		m_hLibGL = nullptr;
-	}
-}
-
-void *Loader::getProcAddress(const char* pszName) const
-{
-	void *pfn{nullptr};
-
-	if (m_pfnWglGetProcAddress)
-	{
-		pfn = m_pfnWglGetProcAddress(pszName);
-		
-		if (!pfn || pfn == reinterpret_cast<void*>(1) || pfn == reinterpret_cast<void*>(2) || pfn == reinterpret_cast<void*>(3) || pfn == reinterpret_cast<void*>(-1))
-		{
-			pfn = GetProcAddress(m_hLibGL, pszName);
-		}
-	}
-
-	return pfn;
-}
-
-//
-// OpenGLContext methods
-//
-
-std::shared_ptr<OpenGLContext> OpenGLContext::createForWindow(HWND hWnd, PIXELFORMATDESCRIPTOR &pfd)
-{
-	std::shared_ptr<OpenGLContext> pContext{new OpenGLContext()};
-
-	HDC hDC{GetDC(hWnd)};
-
-	if (!hDC)
-		return std::shared_ptr<OpenGLContext>{};
-        
-	int pf{ChoosePixelFormat(hDC, &pfd)};
-
-    if (!SetPixelFormat(hDC, pf, &pfd))
-		return std::shared_ptr<OpenGLContext>{};
-		
-	return pContext;
-}
-
-BOOL OpenGLContext::wglCopyContext(HGLRC hglrcSource, HGLRC hglrcDest, UINT mask)
-{
-	LOAD_ENTRYPOINT("wglCopyContext", m_pfnWglCopyContext, PFNWGLCOPYCONTEXTPROC);
-	return m_pfnWglCopyContext(hglrcSource, hglrcDest, mask);
-}
-
-HGLRC OpenGLContext::wglCreateContext(HDC hdc)
-{
-	LOAD_ENTRYPOINT("wglCreateContext", m_pfnWglCreateContext, PFNWGLCREATECONTEXTPROC);
-	return m_pfnWglCreateContext(hdc);
-}
-
-HGLRC OpenGLContext::wglCreateLayerContext(HDC hdc, int iLayerPlane)
-{
-	LOAD_ENTRYPOINT("wglCreateLayerContext", m_pfnWglCreateLayerContext, PFNWGLCREATELAYERCONTEXTPROC);
-	return m_pfnWglCreateLayerContext(hdc, iLayerPlane);
-}
-
-BOOL OpenGLContext::wglDeleteContext(HGLRC hglrc)
-{
-	LOAD_ENTRYPOINT("wglDeleteContext", m_pfnWglDeleteContext, PFNWGLDELETECONTEXTPROC);
-	return m_pfnWglDeleteContext(hglrc);
-}
-
-BOOL OpenGLContext::wglDescribeLayerPlane(HDC hdc, int iPixelFormat, int iLayerPlane, UINT nBytes, LPLAYERPLANEDESCRIPTOR plpd)
-{
-	LOAD_ENTRYPOINT("wglDescribeLayerPlane", m_pfnWglDescribeLayerPlane, PFNWGLDESCRIBELAYERPLANEPROC);
-	return m_pfnWglDescribeLayerPlane(hdc, iPixelFormat, iLayerPlane, nBytes, plpd);
-}
-
-HGLRC OpenGLContext::wglGetCurrentContext()
-{
-	LOAD_ENTRYPOINT("wglGetCurrentContext", m_pfnWglGetCurrentContext, PFNWGLGETCURRENTCONTEXTPROC);
-	return m_pfnWglGetCurrentContext();
-}
-
-HDC OpenGLContext::wglGetCurrentDC()
-{
-	LOAD_ENTRYPOINT("wglGetCurrentDC", m_pfnWglGetCurrentDC, PFNWGLGETCURRENTDCPROC);
-	return m_pfnWglGetCurrentDC();
-}
-
-int OpenGLContext::wglGetLayerPaletteEntries(HDC hdc, int iLayerPlane, int iStart, int cEntries, const COLORREF *pcr)
-{
-	LOAD_ENTRYPOINT("wglGetLayerPaletteEntries", m_pfnWglGetLayerPaletteEntries, PFNWGLGETLAYERPALETTEENTRIESPROC);
-	return m_pfnWglGetLayerPaletteEntries(hdc, iLayerPlane, iStart, cEntries, pcr);
-}
-
-PROC OpenGLContext::wglGetProcAddress(LPCSTR lpszProc)
-{
-	return reinterpret_cast<PROC>(Loader::instance().getProcAddress(lpszProc));
-}
-
-BOOL OpenGLContext::wglMakeCurrent(HDC hdc, HGLRC hglrc)
-{
-	LOAD_ENTRYPOINT("wglMakeCurrent", m_pfnWglMakeCurrent, PFNWGLMAKECURRENTPROC);
-	return m_pfnWglMakeCurrent(hdc, hglrc);
-}
-
-BOOL OpenGLContext::wglRealizeLayerPalette(HDC hdc, int iLayerPlane, BOOL bRealize)
-{
-	LOAD_ENTRYPOINT("wglRealizeLayerPalette", m_pfnWglRealizeLayerPalette, PFNWGLREALIZELAYERPALETTEPROC);
-	return m_pfnWglRealizeLayerPalette(hdc, iLayerPlane, bRealize);
-}
-
-int OpenGLContext::wglSetLayerPaletteEntries(HDC hdc, int iLayerPlane, int iStart, int cEntries, const COLORREF *pcr)
-{
-	LOAD_ENTRYPOINT("wglSetLayerPaletteEntries", m_pfnWglSetLayerPaletteEntries, PFNWGLSETLAYERPALETTEENTRIESPROC);
-	return m_pfnWglSetLayerPaletteEntries(hdc, iLayerPlane, iStart, cEntries, pcr);
-}
-
-BOOL OpenGLContext::wglShareLists(HGLRC hglrc1, HGLRC hglrc2)
-{
-	LOAD_ENTRYPOINT("wglShareLists", m_pfnWglShareLists, PFNWGLSHARELISTSPROC);
-	return m_pfnWglShareLists(hglrc1, hglrc2);
-}
-
-BOOL OpenGLContext::SwapBuffers(HDC hdc)
-{
-	//LOAD_ENTRYPOINT("SwapBuffers", m_pfnSwapBuffers, PFNSWAPBUFFERSPROC);
-	//return m_pfnSwapBuffers(hdc);
-	
-	// WARNING
-	// The above code doesn't work because the SwapBuffers() function is not exported by OpenGL32.dll.
-	// Instead, it's exported by Gdi32.dll. Consequently, we have to use the SwapBuffers() function directly.
-	// This is not a problem because the SwapBuffers() function is a standard Windows function that is always available.
-	
-	return ::SwapBuffers(hdc);
-}
-
-BOOL OpenGLContext::wglSwapLayerBuffers(HDC hdc, UINT fuPlanes)
-{
-	LOAD_ENTRYPOINT("wglSwapLayerBuffers", m_pfnWglSwapLayerBuffers, PFNWGLSWAPLAYERBUFFERSPROC);
-	return m_pfnWglSwapLayerBuffers(hdc, fuPlanes);
-}
-
-DWORD OpenGLContext::wglSwapMultipleBuffers(UINT count, const WGLSWAP *toSwap)
-{
-	LOAD_ENTRYPOINT("wglSwapMultipleBuffers", m_pfnWglSwapMultipleBuffers, PFNWGLSWAPMULTIPLEBUFFERSPROC);
-	return m_pfnWglSwapMultipleBuffers(count, toSwap);
-}
-
-BOOL OpenGLContext::wglUseFontBitmapsA(HDC hdc, DWORD first, DWORD count, DWORD listBase)
-{
-	LOAD_ENTRYPOINT("wglUseFontBitmapsA", m_pfnWglUseFontBitmapsA, PFNWGLUSEFONTBITMAPSPROC);
-	return m_pfnWglUseFontBitmapsA(hdc, first, count, listBase);
-}
-
-BOOL OpenGLContext::wglUseFontBitmapsW(HDC hdc, DWORD first, DWORD count, DWORD listBase)
-{
-	LOAD_ENTRYPOINT("wglUseFontBitmapsW", m_pfnWglUseFontBitmapsW, PFNWGLUSEFONTBITMAPSPROC);
-	return m_pfnWglUseFontBitmapsW(hdc, first, count, listBase);
-}
-
-BOOL OpenGLContext::wglUseFontOutlinesA(HDC hdc, DWORD first, DWORD count, DWORD listBase, FLOAT deviation, FLOAT extrusion, int format, LPGLYPHMETRICSFLOAT lpgmf)
-{
-	LOAD_ENTRYPOINT("wglUseFontOutlinesA", m_pfnWglUseFontOutlinesA, PFNWGLUSEFONTOUTLINESPROC);
-	return m_pfnWglUseFontOutlinesA(hdc, first, count, listBase, deviation, extrusion, format, lpgmf);
-}
-
-BOOL OpenGLContext::wglUseFontOutlinesW(HDC hdc, DWORD first, DWORD count, DWORD listBase, FLOAT deviation, FLOAT extrusion, int format, LPGLYPHMETRICSFLOAT lpgmf)
-{
-	LOAD_ENTRYPOINT("wglUseFontOutlinesW", m_pfnWglUseFontOutlinesW, PFNWGLUSEFONTOUTLINESPROC);
-	return m_pfnWglUseFontOutlinesW(hdc, first, count, listBase, deviation, extrusion, format, lpgmf);
-}
-
-//
-// GL_VERSION_1_0
-//
-
-void glCullFace(GLenum mode)
-{
-	using PFNGLCULLFACEPROC = void(APIENTRY *)(GLenum mode);
-	static PFNGLCULLFACEPROC pfnCullFace{nullptr};
-	LOAD_ENTRYPOINT("glCullFace", pfnCullFace, PFNGLCULLFACEPROC);
-	pfnCullFace(mode);
-}
-
-void glFrontFace(GLenum mode)
-{
-	using PFNGLFRONTFACEPROC = void(APIENTRY *)(GLenum mode);
-	static PFNGLFRONTFACEPROC pfnFrontFace{nullptr};
-	LOAD_ENTRYPOINT("glFrontFace", pfnFrontFace, PFNGLFRONTFACEPROC);
-	pfnFrontFace(mode);
-}
-
-void glHint(GLenum target, GLenum mode)
-{
-	using PFNGLHINTPROC = void(APIENTRY *)(GLenum target, GLenum mode);
-	static PFNGLHINTPROC pfnHint{nullptr};
-	LOAD_ENTRYPOINT("glHint", pfnHint, PFNGLHINTPROC);
-	pfnHint(target, mode);
-}
-
-void glLineWidth(GLfloat width)
-{
-	using PFNGLLINEWIDTHPROC = void(APIENTRY *)(GLfloat width);
-	static PFNGLLINEWIDTHPROC pfnLineWidth{nullptr};
-	LOAD_ENTRYPOINT("glLineWidth", pfnLineWidth, PFNGLLINEWIDTHPROC);
-	pfnLineWidth(width);
-}
-
-void glPointSize(GLfloat size)
-{
-	using PFNGLPOINTSIZEPROC = void(APIENTRY *)(GLfloat size);
-	static PFNGLPOINTSIZEPROC pfnPointSize{nullptr};
-	LOAD_ENTRYPOINT("glPointSize", pfnPointSize, PFNGLPOINTSIZEPROC);
-	pfnPointSize(size);
-}
-
-void glPolygonMode(GLenum face, GLenum mode)
-{
-	using PFNGLPOLYGONMODEPROC = void(APIENTRY *)(GLenum face, GLenum mode);
-	static PFNGLPOLYGONMODEPROC pfnPolygonMode{nullptr};
-	LOAD_ENTRYPOINT("glPolygonMode", pfnPolygonMode, PFNGLPOLYGONMODEPROC);
-	pfnPolygonMode(face, mode);
-}
-
-void glScissor(GLint x, GLint y, GLsizei width, GLsizei height)
-{
-	using PFNGLSCISSORPROC = void(APIENTRY *)(GLint x, GLint y, GLsizei width, GLsizei height);
-	static PFNGLSCISSORPROC pfnScissor{nullptr};
-	LOAD_ENTRYPOINT("glScissor", pfnScissor, PFNGLSCISSORPROC);
-	pfnScissor(x, y, width, height);
-}
-
-void glTexParameterf(GLenum target, GLenum pname, GLfloat param)
-{
-	using PFNGLTEXPARAMETERFPROC = void(APIENTRY *)(GLenum target, GLenum pname, GLfloat param);
-	static PFNGLTEXPARAMETERFPROC pfnTexParameterf{nullptr};
-	LOAD_ENTRYPOINT("glTexParameterf", pfnTexParameterf, PFNGLTEXPARAMETERFPROC);
-	pfnTexParameterf(target, pname, param);
-}
-
-void glTexParameterfv(GLenum target, GLenum pname, const GLfloat* params)
-{
-	using PFNGLTEXPARAMETERFVPROC = void(APIENTRY *)(GLenum target, GLenum pname, const GLfloat* params);
-	static PFNGLTEXPARAMETERFVPROC pfnTexParameterfv{nullptr};
-	LOAD_ENTRYPOINT("glTexParameterfv", pfnTexParameterfv, PFNGLTEXPARAMETERFVPROC);
-	pfnTexParameterfv(target, pname, params);
-}
-
-void glTexParameteri(GLenum target, GLenum pname, GLint param)
-{
-	using PFNGLTEXPARAMETERIPROC = void(APIENTRY *)(GLenum target, GLenum pname, GLint param);
-	static PFNGLTEXPARAMETERIPROC pfnTexParameteri{nullptr};
-	LOAD_ENTRYPOINT("glTexParameteri", pfnTexParameteri, PFNGLTEXPARAMETERIPROC);
-	pfnTexParameteri(target, pname, param);
-}
-
-void glTexParameteriv(GLenum target, GLenum pname, const GLint* params)
-{
-	using PFNGLTEXPARAMETERIVPROC = void(APIENTRY *)(GLenum target, GLenum pname, const GLint* params);
-	static PFNGLTEXPARAMETERIVPROC pfnTexParameteriv{nullptr};
-	LOAD_ENTRYPOINT("glTexParameteriv", pfnTexParameteriv, PFNGLTEXPARAMETERIVPROC);
-	pfnTexParameteriv(target, pname, params);
-}
-
-void glTexImage1D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLint border, GLenum format, GLenum type, const void* pixels)
-{
-	using PFNGLTEXIMAGE1DPROC = void(APIENTRY *)(GLenum target, GLint level, GLint internalformat, GLsizei width, GLint border, GLenum format, GLenum type, const void* pixels);
-	static PFNGLTEXIMAGE1DPROC pfnTexImage1D{nullptr};
-	LOAD_ENTRYPOINT("glTexImage1D", pfnTexImage1D, PFNGLTEXIMAGE1DPROC);
-	pfnTexImage1D(target, level, internalformat, width, border, format, type, pixels);
-}
-
-void glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels)
-{
-	using PFNGLTEXIMAGE2DPROC = void(APIENTRY *)(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels);
-	static PFNGLTEXIMAGE2DPROC pfnTexImage2D{nullptr};
-	LOAD_ENTRYPOINT("glTexImage2D", pfnTexImage2D, PFNGLTEXIMAGE2DPROC);
-	pfnTexImage2D(target, level, internalformat, width, height, border, format, type, pixels);
-}
-
-void glDrawBuffer(GLenum buf)
-{
-	using PFNGLDRAWBUFFERPROC = void(APIENTRY *)(GLenum buf);
-	static PFNGLDRAWBUFFERPROC pfnDrawBuffer{nullptr};
-	LOAD_ENTRYPOINT("glDrawBuffer", pfnDrawBuffer, PFNGLDRAWBUFFERPROC);
-	pfnDrawBuffer(buf);
-}
-
-void glClear(GLbitfield mask)
-{
-	using PFNGLCLEARPROC = void(APIENTRY *)(GLbitfield mask);
-	static PFNGLCLEARPROC pfnClear{nullptr};
-	LOAD_ENTRYPOINT("glClear", pfnClear, PFNGLCLEARPROC);
-	pfnClear(mask);
-}
-
-void glClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
-{
-	using PFNGLCLEARCOLORPROC = void(APIENTRY *)(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
-	static PFNGLCLEARCOLORPROC pfnClearColor{nullptr};
-	LOAD_ENTRYPOINT("glClearColor", pfnClearColor, PFNGLCLEARCOLORPROC);
-	pfnClearColor(red, green, blue, alpha);
-}
-
-void glClearStencil(GLint s)
-{
-	using PFNGLCLEARSTENCILPROC = void(APIENTRY *)(GLint s);
-	static PFNGLCLEARSTENCILPROC pfnClearStencil{nullptr};
-	LOAD_ENTRYPOINT("glClearStencil", pfnClearStencil, PFNGLCLEARSTENCILPROC);
-	pfnClearStencil(s);
-}
-
-void glClearDepth(GLdouble depth)
-{
-	using PFNGLCLEARDEPTHPROC = void(APIENTRY *)(GLdouble depth);
-	static PFNGLCLEARDEPTHPROC pfnClearDepth{nullptr};
-	LOAD_ENTRYPOINT("glClearDepth", pfnClearDepth, PFNGLCLEARDEPTHPROC);
-	pfnClearDepth(depth);
-}
-
-void glStencilMask(GLuint mask)
-{
-	using PFNGLSTENCILMASKPROC = void(APIENTRY *)(GLuint mask);
-	static PFNGLSTENCILMASKPROC pfnStencilMask{nullptr};
-	LOAD_ENTRYPOINT("glStencilMask", pfnStencilMask, PFNGLSTENCILMASKPROC);
-	pfnStencilMask(mask);
-}
-
-void glColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
-{
-	using PFNGLCOLORMASKPROC = void(APIENTRY *)(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha);
-	static PFNGLCOLORMASKPROC pfnColorMask{nullptr};
-	LOAD_ENTRYPOINT("glColorMask", pfnColorMask, PFNGLCOLORMASKPROC);
-	pfnColorMask(red, green, blue, alpha);
-}
-
-void glDepthMask(GLboolean flag)
-{
-	using PFNGLDEPTHMASKPROC = void(APIENTRY *)(GLboolean flag);
-	static PFNGLDEPTHMASKPROC pfnDepthMask{nullptr};
-	LOAD_ENTRYPOINT("glDepthMask", pfnDepthMask, PFNGLDEPTHMASKPROC);
-	pfnDepthMask(flag);
-}
-
-void glDisable(GLenum cap)
-{
-	using PFNGLDISABLEPROC = void(APIENTRY *)(GLenum cap);
-	static PFNGLDISABLEPROC pfnDisable{nullptr};
-	LOAD_ENTRYPOINT("glDisable", pfnDisable, PFNGLDISABLEPROC);
-	pfnDisable(cap);
-}
-
-void glEnable(GLenum cap)
-{
-	using PFNGLENABLEPROC = void(APIENTRY *)(GLenum cap);
-	static PFNGLENABLEPROC pfnEnable{nullptr};
-	LOAD_ENTRYPOINT("glEnable", pfnEnable, PFNGLENABLEPROC);
-	pfnEnable(cap);
-}
-
-void glFinish(void)
-{
-	using PFNGLFINISHPROC = void(APIENTRY *)(void);
-	static PFNGLFINISHPROC pfnFinish{nullptr};
-	LOAD_ENTRYPOINT("glFinish", pfnFinish, PFNGLFINISHPROC);
-	pfnFinish();
-}
-
-void glFlush(void)
-{
-	using PFNGLFLUSHPROC = void(APIENTRY *)(void);
-	static PFNGLFLUSHPROC pfnFlush{nullptr};
-	LOAD_ENTRYPOINT("glFlush", pfnFlush, PFNGLFLUSHPROC);
-	pfnFlush();
-}
-
-void glBlendFunc(GLenum sfactor, GLenum dfactor)
-{
-	using PFNGLBLENDFUNCPROC = void(APIENTRY *)(GLenum sfactor, GLenum dfactor);
-	static PFNGLBLENDFUNCPROC pfnBlendFunc{nullptr};
-	LOAD_ENTRYPOINT("glBlendFunc", pfnBlendFunc, PFNGLBLENDFUNCPROC);
-	pfnBlendFunc(sfactor, dfactor);
-}
-
-void glLogicOp(GLenum opcode)
-{
-	using PFNGLLOGICOPPROC = void(APIENTRY *)(GLenum opcode);
-	static PFNGLLOGICOPPROC pfnLogicOp{nullptr};
-	LOAD_ENTRYPOINT("glLogicOp", pfnLogicOp, PFNGLLOGICOPPROC);
-	pfnLogicOp(opcode);
-}
-
-void glStencilFunc(GLenum func, GLint ref, GLuint mask)
-{
-	using PFNGLSTENCILFUNCPROC = void(APIENTRY *)(GLenum func, GLint ref, GLuint mask);
-	static PFNGLSTENCILFUNCPROC pfnStencilFunc{nullptr};
-	LOAD_ENTRYPOINT("glStencilFunc", pfnStencilFunc, PFNGLSTENCILFUNCPROC);
-	pfnStencilFunc(func, ref, mask);
-}
-
-void glStencilOp(GLenum fail, GLenum zfail, GLenum zpass)
-{
-	using PFNGLSTENCILOPPROC = void(APIENTRY *)(GLenum fail, GLenum zfail, GLenum zpass);
-	static PFNGLSTENCILOPPROC pfnStencilOp{nullptr};
-	LOAD_ENTRYPOINT("glStencilOp", pfnStencilOp, PFNGLSTENCILOPPROC);
-	pfnStencilOp(fail, zfail, zpass);
-}
-
-void glDepthFunc(GLenum func)
-{
-	using PFNGLDEPTHFUNCPROC = void(APIENTRY *)(GLenum func);
-	static PFNGLDEPTHFUNCPROC pfnDepthFunc{nullptr};
-	LOAD_ENTRYPOINT("glDepthFunc", pfnDepthFunc, PFNGLDEPTHFUNCPROC);
-	pfnDepthFunc(func);
-}
-
-void glPixelStoref(GLenum pname, GLfloat param)
-{
-	using PFNGLPIXELSTOREFPROC = void(APIENTRY *)(GLenum pname, GLfloat param);
-	static PFNGLPIXELSTOREFPROC pfnPixelStoref{nullptr};
-	LOAD_ENTRYPOINT("glPixelStoref", pfnPixelStoref, PFNGLPIXELSTOREFPROC);
-	pfnPixelStoref(pname, param);
-}
-
-void glPixelStorei(GLenum pname, GLint param)
-{
-	using PFNGLPIXELSTOREIPROC = void(APIENTRY *)(GLenum pname, GLint param);
-	static PFNGLPIXELSTOREIPROC pfnPixelStorei{nullptr};
-	LOAD_ENTRYPOINT("glPixelStorei", pfnPixelStorei, PFNGLPIXELSTOREIPROC);
-	pfnPixelStorei(pname, param);
-}
-
-void glReadBuffer(GLenum src)
-{
-	using PFNGLREADBUFFERPROC = void(APIENTRY *)(GLenum src);
-	static PFNGLREADBUFFERPROC pfnReadBuffer{nullptr};
-	LOAD_ENTRYPOINT("glReadBuffer", pfnReadBuffer, PFNGLREADBUFFERPROC);
-	pfnReadBuffer(src);
-}
-
-void glReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels)
-{
-	using PFNGLREADPIXELSPROC = void(APIENTRY *)(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels);
-	static PFNGLREADPIXELSPROC pfnReadPixels{nullptr};
-	LOAD_ENTRYPOINT("glReadPixels", pfnReadPixels, PFNGLREADPIXELSPROC);
-	pfnReadPixels(x, y, width, height, format, type, pixels);
-}
-
-void glGetBooleanv(GLenum pname, GLboolean* data)
-{
-	using PFNGLGETBOOLEANVPROC = void(APIENTRY *)(GLenum pname, GLboolean* data);
-	static PFNGLGETBOOLEANVPROC pfnGetBooleanv{nullptr};
-	LOAD_ENTRYPOINT("glGetBooleanv", pfnGetBooleanv, PFNGLGETBOOLEANVPROC);
-	pfnGetBooleanv(pname, data);
-}
-
-void glGetDoublev(GLenum pname, GLdouble* data)
-{
-	using PFNGLGETDOUBLEVPROC = void(APIENTRY *)(GLenum pname, GLdouble* data);
-	static PFNGLGETDOUBLEVPROC pfnGetDoublev{nullptr};
-	LOAD_ENTRYPOINT("glGetDoublev", pfnGetDoublev, PFNGLGETDOUBLEVPROC);
-	pfnGetDoublev(pname, data);
-}
-
-GLenum glGetError(void)
-{
-	using PFNGLGETERRORPROC = GLenum(APIENTRY *)(void);
-	static PFNGLGETERRORPROC pfnGetError{nullptr};
-	LOAD_ENTRYPOINT("glGetError", pfnGetError, PFNGLGETERRORPROC);
-	return pfnGetError();
-}
-
-void glGetFloatv(GLenum pname, GLfloat* data)
-{
-	using PFNGLGETFLOATVPROC = void(APIENTRY *)(GLenum pname, GLfloat* data);
-	static PFNGLGETFLOATVPROC pfnGetFloatv{nullptr};
-	LOAD_ENTRYPOINT("glGetFloatv", pfnGetFloatv, PFNGLGETFLOATVPROC);
-	pfnGetFloatv(pname, data);
-}
-
-void glGetIntegerv(GLenum pname, GLint* data)
-{
-	using PFNGLGETINTEGERVPROC = void(APIENTRY *)(GLenum pname, GLint* data);
-	static PFNGLGETINTEGERVPROC pfnGetIntegerv{nullptr};
-	LOAD_ENTRYPOINT("glGetIntegerv", pfnGetIntegerv, PFNGLGETINTEGERVPROC);
-	pfnGetIntegerv(pname, data);
-}
-
-const GLubyte* glGetString(GLenum name)
-{
-	using PFNGLGETSTRINGPROC = const GLubyte*(APIENTRY *)(GLenum name);
-	static PFNGLGETSTRINGPROC pfnGetString{nullptr};
-	LOAD_ENTRYPOINT("glGetString", pfnGetString, PFNGLGETSTRINGPROC);
-	return pfnGetString(name);
-}
-
-void glGetTexImage(GLenum target, GLint level, GLenum format, GLenum type, void* pixels)
-{
-	using PFNGLGETTEXIMAGEPROC = void(APIENTRY *)(GLenum target, GLint level, GLenum format, GLenum type, void* pixels);
-	static PFNGLGETTEXIMAGEPROC pfnGetTexImage{nullptr};
-	LOAD_ENTRYPOINT("glGetTexImage", pfnGetTexImage, PFNGLGETTEXIMAGEPROC);
-	pfnGetTexImage(target, level, format, type, pixels);
-}
-
-void glGetTexParameterfv(GLenum target, GLenum pname, GLfloat* params)
-{
-	using PFNGLGETTEXPARAMETERFVPROC = void(APIENTRY *)(GLenum target, GLenum pname, GLfloat* params);
-	static PFNGLGETTEXPARAMETERFVPROC pfnGetTexParameterfv{nullptr};
-	LOAD_ENTRYPOINT("glGetTexParameterfv", pfnGetTexParameterfv, PFNGLGETTEXPARAMETERFVPROC);
-	pfnGetTexParameterfv(target, pname, params);
-}
-
-void glGetTexParameteriv(GLenum target, GLenum pname, GLint* params)
-{
-	using PFNGLGETTEXPARAMETERIVPROC = void(APIENTRY *)(GLenum target, GLenum pname, GLint* params);
-	static PFNGLGETTEXPARAMETERIVPROC pfnGetTexParameteriv{nullptr};
-	LOAD_ENTRYPOINT("glGetTexParameteriv", pfnGetTexParameteriv, PFNGLGETTEXPARAMETERIVPROC);
-	pfnGetTexParameteriv(target, pname, params);
-}
-
-void glGetTexLevelParameterfv(GLenum target, GLint level, GLenum pname, GLfloat* params)
-{
-	using PFNGLGETTEXLEVELPARAMETERFVPROC = void(APIENTRY *)(GLenum target, GLint level, GLenum pname, GLfloat* params);
-	static PFNGLGETTEXLEVELPARAMETERFVPROC pfnGetTexLevelParameterfv{nullptr};
-	LOAD_ENTRYPOINT("glGetTexLevelParameterfv", pfnGetTexLevelParameterfv, PFNGLGETTEXLEVELPARAMETERFVPROC);
-	pfnGetTexLevelParameterfv(target, level, pname, params);
-}
-
-void glGetTexLevelParameteriv(GLenum target, GLint level, GLenum pname, GLint* params)
-{
-	using PFNGLGETTEXLEVELPARAMETERIVPROC = void(APIENTRY *)(GLenum target, GLint level, GLenum pname, GLint* params);
-	static PFNGLGETTEXLEVELPARAMETERIVPROC pfnGetTexLevelParameteriv{nullptr};
-	LOAD_ENTRYPOINT("glGetTexLevelParameteriv", pfnGetTexLevelParameteriv, PFNGLGETTEXLEVELPARAMETERIVPROC);
-	pfnGetTexLevelParameteriv(target, level, pname, params);
-}
-
-GLboolean glIsEnabled(GLenum cap)
-{
-	using PFNGLISENABLEDPROC = GLboolean(APIENTRY *)(GLenum cap);
-	static PFNGLISENABLEDPROC pfnIsEnabled{nullptr};
-	LOAD_ENTRYPOINT("glIsEnabled", pfnIsEnabled, PFNGLISENABLEDPROC);
-	return pfnIsEnabled(cap);
-}
-
-void glDepthRange(GLdouble n, GLdouble f)
-{
-	using PFNGLDEPTHRANGEPROC = void(APIENTRY *)(GLdouble n, GLdouble f);
-	static PFNGLDEPTHRANGEPROC pfnDepthRange{nullptr};
-	LOAD_ENTRYPOINT("glDepthRange", pfnDepthRange, PFNGLDEPTHRANGEPROC);
-	pfnDepthRange(n, f);
-}
-
-void glViewport(GLint x, GLint y, GLsizei width, GLsizei height)
-{
-	using PFNGLVIEWPORTPROC = void(APIENTRY *)(GLint x, GLint y, GLsizei width, GLsizei height);
-	static PFNGLVIEWPORTPROC pfnViewport{nullptr};
-	LOAD_ENTRYPOINT("glViewport", pfnViewport, PFNGLVIEWPORTPROC);
-	pfnViewport(x, y, width, height);
-}
-
-//
-// GL_VERSION_1_1
-//
-
-void glDrawArrays(GLenum mode, GLint first, GLsizei count)
-{
-	using PFNGLDRAWARRAYSPROC = void(APIENTRY *)(GLenum mode, GLint first, GLsizei count);
-	static PFNGLDRAWARRAYSPROC pfnDrawArrays{nullptr};
-	LOAD_ENTRYPOINT("glDrawArrays", pfnDrawArrays, PFNGLDRAWARRAYSPROC);
-	pfnDrawArrays(mode, first, count);
-}
-
-void glDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
-{
-	using PFNGLDRAWELEMENTSPROC = void(APIENTRY *)(GLenum mode, GLsizei count, GLenum type, const void* indices);
-	static PFNGLDRAWELEMENTSPROC pfnDrawElements{nullptr};
-	LOAD_ENTRYPOINT("glDrawElements", pfnDrawElements, PFNGLDRAWELEMENTSPROC);
-	pfnDrawElements(mode, count, type, indices);
-}
-
-void glGetPointerv(GLenum pname, void** params)
-{
-	using PFNGLGETPOINTERVPROC = void(APIENTRY *)(GLenum pname, void** params);
-	static PFNGLGETPOINTERVPROC pfnGetPointerv{nullptr};
-	LOAD_ENTRYPOINT("glGetPointerv", pfnGetPointerv, PFNGLGETPOINTERVPROC);
-	pfnGetPointerv(pname, params);
-}
-
-void glPolygonOffset(GLfloat factor, GLfloat units)
-{
-	using PFNGLPOLYGONOFFSETPROC = void(APIENTRY *)(GLfloat factor, GLfloat units);
-	static PFNGLPOLYGONOFFSETPROC pfnPolygonOffset{nullptr};
-	LOAD_ENTRYPOINT("glPolygonOffset", pfnPolygonOffset, PFNGLPOLYGONOFFSETPROC);
-	pfnPolygonOffset(factor, units);
-}
-
-void glCopyTexImage1D(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLint border)
-{
-	using PFNGLCOPYTEXIMAGE1DPROC = void(APIENTRY *)(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLint border);
-	static PFNGLCOPYTEXIMAGE1DPROC pfnCopyTexImage1D{nullptr};
-	LOAD_ENTRYPOINT("glCopyTexImage1D", pfnCopyTexImage1D, PFNGLCOPYTEXIMAGE1DPROC);
-	pfnCopyTexImage1D(target, level, internalformat, x, y, width, border);
-}
-
-void glCopyTexImage2D(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLsizei height, GLint border)
-{
-	using PFNGLCOPYTEXIMAGE2DPROC = void(APIENTRY *)(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLsizei height, GLint border);
-	static PFNGLCOPYTEXIMAGE2DPROC pfnCopyTexImage2D{nullptr};
-	LOAD_ENTRYPOINT("glCopyTexImage2D", pfnCopyTexImage2D, PFNGLCOPYTEXIMAGE2DPROC);
-	pfnCopyTexImage2D(target, level, internalformat, x, y, width, height, border);
-}
-
-void glCopyTexSubImage1D(GLenum target, GLint level, GLint xoffset, GLint x, GLint y, GLsizei width)
-{
-	using PFNGLCOPYTEXSUBIMAGE1DPROC = void(APIENTRY *)(GLenum target, GLint level, GLint xoffset, GLint x, GLint y, GLsizei width);
-	static PFNGLCOPYTEXSUBIMAGE1DPROC pfnCopyTexSubImage1D{nullptr};
-	LOAD_ENTRYPOINT("glCopyTexSubImage1D", pfnCopyTexSubImage1D, PFNGLCOPYTEXSUBIMAGE1DPROC);
-	pfnCopyTexSubImage1D(target, level, xoffset, x, y, width);
-}
-
-void glCopyTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height)
-{
-	using PFNGLCOPYTEXSUBIMAGE2DPROC = void(APIENTRY *)(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height);
-	static PFNGLCOPYTEXSUBIMAGE2DPROC pfnCopyTexSubImage2D{nullptr};
-	LOAD_ENTRYPOINT("glCopyTexSubImage2D", pfnCopyTexSubImage2D, PFNGLCOPYTEXSUBIMAGE2DPROC);
-	pfnCopyTexSubImage2D(target, level, xoffset, yoffset, x, y, width, height);
-}
-
-void glTexSubImage1D(GLenum target, GLint level, GLint xoffset, GLsizei width, GLenum format, GLenum type, const void* pixels)
-{
-	using PFNGLTEXSUBIMAGE1DPROC = void(APIENTRY *)(GLenum target, GLint level, GLint xoffset, GLsizei width, GLenum format, GLenum type, const void* pixels);
-	static PFNGLTEXSUBIMAGE1DPROC pfnTexSubImage1D{nullptr};
-	LOAD_ENTRYPOINT("glTexSubImage1D", pfnTexSubImage1D, PFNGLTEXSUBIMAGE1DPROC);
-	pfnTexSubImage1D(target, level, xoffset, width, format, type, pixels);
-}
-
-void glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels)
-{
-	using PFNGLTEXSUBIMAGE2DPROC = void(APIENTRY *)(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels);
-	static PFNGLTEXSUBIMAGE2DPROC pfnTexSubImage2D{nullptr};
-	LOAD_ENTRYPOINT("glTexSubImage2D", pfnTexSubImage2D, PFNGLTEXSUBIMAGE2DPROC);
-	pfnTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels);
-}
-
-void glBindTexture(GLenum target, GLuint texture)
-{
-	using PFNGLBINDTEXTUREPROC = void(APIENTRY *)(GLenum target, GLuint texture);
-	static PFNGLBINDTEXTUREPROC pfnBindTexture{nullptr};
-	LOAD_ENTRYPOINT("glBindTexture", pfnBindTexture, PFNGLBINDTEXTUREPROC);
-	pfnBindTexture(target, texture);
-}
-
-void glDeleteTextures(GLsizei n, const GLuint* textures)
-{
-	using PFNGLDELETETEXTURESPROC = void(APIENTRY *)(GLsizei n, const GLuint* textures);
-	static PFNGLDELETETEXTURESPROC pfnDeleteTextures{nullptr};
-	LOAD_ENTRYPOINT("glDeleteTextures", pfnDeleteTextures, PFNGLDELETETEXTURESPROC);
-	pfnDeleteTextures(n, textures);
-}
-
-void glGenTextures(GLsizei n, GLuint* textures)
-{
-	using PFNGLGENTEXTURESPROC = void(APIENTRY *)(GLsizei n, GLuint* textures);
-	static PFNGLGENTEXTURESPROC pfnGenTextures{nullptr};
-	LOAD_ENTRYPOINT("glGenTextures", pfnGenTextures, PFNGLGENTEXTURESPROC);
-	pfnGenTextures(n, textures);
-}
-
-GLboolean glIsTexture(GLuint texture)
-{
-	using PFNGLISTEXTUREPROC = GLboolean(APIENTRY *)(GLuint texture);
-	static PFNGLISTEXTUREPROC pfnIsTexture{nullptr};
-	LOAD_ENTRYPOINT("glIsTexture", pfnIsTexture, PFNGLISTEXTUREPROC);
-	return pfnIsTexture(texture);
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cwchar>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "GLEntryPoints.h"
+
+#ifdef GLLOADER_BAKED_DISPATCH_LAYOUT
+#include "GLDispatchLayout.h"
+#endif
+
+module OpenGL;
+
+import LoaderSymbols;
+import PerfectHash;
+
+// The WGL functions are resolved when the OpenGLContext is created, so a missing one only fails the call.
+
+#define REQUIRE_ENTRYPOINT(var) \
+    assert(var != nullptr); \
+    if (!var) \
+    { \
+        SetLastError(ERROR_PROC_NOT_FOUND); \
+        return {}; \
+    }
+
+#define TRACK_STATE(call) \
+    if (GLStateTracker *pTracker{GLStateTracker::current()}) \
+    { \
+        pTracker->call; \
+    }
+
+#define DISPATCH(name) \
+    reinterpret_cast<decltype(GLDispatch::name)>(dispatch().slots[slotOf(Entry::name)])
+
+namespace
+{
+	namespace Entry
+	{
+		enum : unsigned
+		{
+#define ENUMERATE_ENTRY_POINT(name) name,
+			GL_DISPATCH_ENTRY_POINTS(ENUMERATE_ENTRY_POINT)
+#undef ENUMERATE_ENTRY_POINT
+			Count
+		};
+	}
+
+	// Suffixed names that gl.xml declares as aliases of core entry points (the alias element of each
+	// <command>), most preferred first. Older drivers may only expose an entry point under one of these.
+	// Only true aliases are listed. glBindFramebufferEXT, for example, doesn't accept names that
+	// glGenFramebuffers() didn't return, so gl.xml doesn't make it an alias of glBindFramebuffer.
+
+	struct EntryPointAliases
+	{
+		std::string_view name;
+		std::string_view aliases[2];
+	};
+
+	constexpr EntryPointAliases kEntryPointAliases[]
+	{
+		{"glActiveTexture", {"glActiveTextureARB"}},
+		{"glAttachShader", {"glAttachObjectARB"}},
+		{"glBeginQuery", {"glBeginQueryARB"}},
+		{"glBindAttribLocation", {"glBindAttribLocationARB"}},
+		{"glBindBuffer", {"glBindBufferARB"}},
+		{"glBindBufferBase", {"glBindBufferBaseEXT", "glBindBufferBaseNV"}},
+		{"glBindBufferRange", {"glBindBufferRangeEXT", "glBindBufferRangeNV"}},
+		{"glBindFragDataLocation", {"glBindFragDataLocationEXT"}},
+		{"glBlendColor", {"glBlendColorEXT"}},
+		{"glBlendEquation", {"glBlendEquationEXT"}},
+		{"glBlendEquationSeparate", {"glBlendEquationSeparateEXT"}},
+		{"glBlendFuncSeparate", {"glBlendFuncSeparateEXT", "glBlendFuncSeparateINGR"}},
+		{"glBlitFramebuffer", {"glBlitFramebufferEXT"}},
+		{"glBufferData", {"glBufferDataARB"}},
+		{"glBufferSubData", {"glBufferSubDataARB"}},
+		{"glCheckFramebufferStatus", {"glCheckFramebufferStatusEXT"}},
+		{"glClampColor", {"glClampColorARB"}},
+		{"glClientActiveTexture", {"glClientActiveTextureARB"}},
+		{"glColorMaski", {"glColorMaskIndexedEXT"}},
+		{"glCompileShader", {"glCompileShaderARB"}},
+		{"glCompressedTexImage1D", {"glCompressedTexImage1DARB"}},
+		{"glCompressedTexImage2D", {"glCompressedTexImage2DARB"}},
+		{"glCompressedTexImage3D", {"glCompressedTexImage3DARB"}},
+		{"glCompressedTexSubImage1D", {"glCompressedTexSubImage1DARB"}},
+		{"glCompressedTexSubImage2D", {"glCompressedTexSubImage2DARB"}},
+		{"glCompressedTexSubImage3D", {"glCompressedTexSubImage3DARB"}},
+		{"glCopyTexSubImage3D", {"glCopyTexSubImage3DEXT"}},
+		{"glCreateProgram", {"glCreateProgramObjectARB"}},
+		{"glCreateShader", {"glCreateShaderObjectARB"}},
+		{"glDebugMessageCallback", {"glDebugMessageCallbackARB"}},
+		{"glDebugMessageControl", {"glDebugMessageControlARB"}},
+		{"glDebugMessageInsert", {"glDebugMessageInsertARB"}},
+		{"glDeleteBuffers", {"glDeleteBuffersARB"}},
+		{"glDeleteFramebuffers", {"glDeleteFramebuffersEXT"}},
+		{"glDeleteQueries", {"glDeleteQueriesARB"}},
+		{"glDeleteRenderbuffers", {"glDeleteRenderbuffersEXT"}},
+		{"glDetachShader", {"glDetachObjectARB"}},
+		{"glDisableVertexAttribArray", {"glDisableVertexAttribArrayARB"}},
+		{"glDisablei", {"glDisableIndexedEXT"}},
+		{"glDrawArraysInstanced", {"glDrawArraysInstancedARB", "glDrawArraysInstancedEXT"}},
+		{"glDrawBuffers", {"glDrawBuffersARB", "glDrawBuffersATI"}},
+		{"glDrawElementsInstanced", {"glDrawElementsInstancedARB", "glDrawElementsInstancedEXT"}},
+		{"glDrawRangeElements", {"glDrawRangeElementsEXT"}},
+		{"glEnableVertexAttribArray", {"glEnableVertexAttribArrayARB"}},
+		{"glEnablei", {"glEnableIndexedEXT"}},
+		{"glEndQuery", {"glEndQueryARB"}},
+		{"glFramebufferRenderbuffer", {"glFramebufferRenderbufferEXT"}},
+		{"glFramebufferTexture1D", {"glFramebufferTexture1DEXT"}},
+		{"glFramebufferTexture2D", {"glFramebufferTexture2DEXT"}},
+		{"glFramebufferTexture3D", {"glFramebufferTexture3DEXT"}},
+		{"glFramebufferTextureLayer", {"glFramebufferTextureLayerARB", "glFramebufferTextureLayerEXT"}},
+		{"glGenBuffers", {"glGenBuffersARB"}},
+		{"glGenFramebuffers", {"glGenFramebuffersEXT"}},
+		{"glGenQueries", {"glGenQueriesARB"}},
+		{"glGenRenderbuffers", {"glGenRenderbuffersEXT"}},
+		{"glGenerateMipmap", {"glGenerateMipmapEXT"}},
+		{"glGetAttribLocation", {"glGetAttribLocationARB"}},
+		{"glGetBufferParameteriv", {"glGetBufferParameterivARB"}},
+		{"glGetBufferPointerv", {"glGetBufferPointervARB"}},
+		{"glGetBufferSubData", {"glGetBufferSubDataARB"}},
+		{"glGetCompressedTexImage", {"glGetCompressedTexImageARB"}},
+		{"glGetDebugMessageLog", {"glGetDebugMessageLogARB"}},
+		{"glGetFramebufferAttachmentParameteriv", {"glGetFramebufferAttachmentParameterivEXT"}},
+		{"glGetQueryObjecti64v", {"glGetQueryObjecti64vEXT"}},
+		{"glGetQueryObjectiv", {"glGetQueryObjectivARB"}},
+		{"glGetQueryObjectui64v", {"glGetQueryObjectui64vEXT"}},
+		{"glGetQueryObjectuiv", {"glGetQueryObjectuivARB"}},
+		{"glGetQueryiv", {"glGetQueryivARB"}},
+		{"glGetRenderbufferParameteriv", {"glGetRenderbufferParameterivEXT"}},
+		{"glGetUniformLocation", {"glGetUniformLocationARB"}},
+		{"glIsBuffer", {"glIsBufferARB"}},
+		{"glIsFramebuffer", {"glIsFramebufferEXT"}},
+		{"glIsQuery", {"glIsQueryARB"}},
+		{"glIsRenderbuffer", {"glIsRenderbufferEXT"}},
+		{"glLinkProgram", {"glLinkProgramARB"}},
+		{"glMapBuffer", {"glMapBufferARB"}},
+		{"glMultiDrawArrays", {"glMultiDrawArraysEXT"}},
+		{"glMultiDrawArraysIndirect", {"glMultiDrawArraysIndirectAMD"}},
+		{"glMultiDrawElements", {"glMultiDrawElementsEXT"}},
+		{"glMultiDrawElementsIndirect", {"glMultiDrawElementsIndirectAMD"}},
+		{"glPointParameterf", {"glPointParameterfARB", "glPointParameterfEXT"}},
+		{"glPointParameterfv", {"glPointParameterfvARB", "glPointParameterfvEXT"}},
+		{"glRenderbufferStorage", {"glRenderbufferStorageEXT"}},
+		{"glRenderbufferStorageMultisample", {"glRenderbufferStorageMultisampleEXT"}},
+		{"glSampleCoverage", {"glSampleCoverageARB"}},
+		{"glShaderSource", {"glShaderSourceARB"}},
+		{"glTexBuffer", {"glTexBufferARB", "glTexBufferEXT"}},
+		{"glTexImage3D", {"glTexImage3DEXT"}},
+		{"glTexSubImage3D", {"glTexSubImage3DEXT"}},
+		{"glUniform1f", {"glUniform1fARB"}},
+		{"glUniform1i", {"glUniform1iARB"}},
+		{"glUniform2f", {"glUniform2fARB"}},
+		{"glUniform3f", {"glUniform3fARB"}},
+		{"glUniform4f", {"glUniform4fARB"}},
+		{"glUniform4fv", {"glUniform4fvARB"}},
+		{"glUniformMatrix4fv", {"glUniformMatrix4fvARB"}},
+		{"glUnmapBuffer", {"glUnmapBufferARB"}},
+		{"glUseProgram", {"glUseProgramObjectARB"}},
+		{"glValidateProgram", {"glValidateProgramARB"}},
+		{"glVertexAttribDivisor", {"glVertexAttribDivisorARB"}},
+		{"glVertexAttribIPointer", {"glVertexAttribIPointerEXT"}},
+		{"glVertexAttribPointer", {"glVertexAttribPointerARB"}},
+	};
+
+	constexpr auto aliasedName = [](std::size_t index) { return kEntryPointAliases[index].name; };
+
+	constexpr PerfectHash<std::size(kEntryPointAliases)> kAliasHash{aliasedName};
+
+	const EntryPointAliases *findAliases(std::string_view name)
+	{
+		std::size_t index{kAliasHash.find(name, aliasedName)};
+		return index < std::size(kEntryPointAliases) ? &kEntryPointAliases[index] : nullptr;
+	}
+
+	// Stands in for a GL function the driver doesn't provide, so that calling it does nothing instead of
+	// crashing on a null pointer. The loader report lists it as missing.
+
+	template <typename Pfn>
+	struct MissingEntryPoint;
+
+	template <typename R, typename... Args>
+	struct MissingEntryPoint<R(APIENTRY *)(Args...)>
+	{
+		static R APIENTRY call(Args...)
+		{
+			if constexpr (!std::is_void_v<R>)
+				return R{};
+		}
+	};
+
+	// The GL functions call through packed dispatch tables, whose slots are ordered so that the
+	// functions an application calls most share the fewest cache lines. slotOf() maps an entry to its
+	// slot. The order is the declaration order of GLDispatch until a usage profile is applied, or it's
+	// fixed at compile time by GLDispatchLayout.h when GLLOADER_BAKED_DISPATCH_LAYOUT is defined, in
+	// which case slotOf() is a constant and costs nothing.
+
+	static_assert(Entry::Count <= 256);
+
+	using Proc = void(APIENTRY *)();
+	using SlotTable = std::array<std::uint8_t, Entry::Count>;
+
+	constexpr SlotTable slotTable(const unsigned (&order)[Entry::Count])
+	{
+		SlotTable slots{};
+		bool placed[Entry::Count]{};
+
+		for (unsigned slot = 0; slot < Entry::Count; ++slot)
+		{
+			// A duplicate makes this fail to compile when it's evaluated at compile time.
+
+			if (placed[order[slot]])
+				throw "every entry point must appear in the layout once";
+
+			placed[order[slot]] = true;
+			slots[order[slot]] = static_cast<std::uint8_t>(slot);
+		}
+
+		return slots;
+	}
+
+#ifdef GLLOADER_BAKED_DISPATCH_LAYOUT
+	constexpr unsigned kBakedOrder[]
+	{
+#define ORDER_ENTRY_POINT(name) Entry::name,
+		GL_DISPATCH_LAYOUT(ORDER_ENTRY_POINT)
+#undef ORDER_ENTRY_POINT
+	};
+
+	static_assert(std::size(kBakedOrder) == Entry::Count, "GLDispatchLayout.h doesn't match GLEntryPoints.h, so it needs to be generated again");
+
+	constexpr SlotTable kSlotOf{slotTable(kBakedOrder)};
+
+	constexpr unsigned slotOf(unsigned entry)
+	{
+		return kSlotOf[entry];
+	}
+#else
+	constexpr SlotTable declarationOrder()
+	{
+		unsigned order[Entry::Count]{};
+
+		for (unsigned entry = 0; entry < Entry::Count; ++entry)
+			order[entry] = entry;
+
+		return slotTable(order);
+	}
+
+	alignas(64) constinit SlotTable g_slotOf{declarationOrder()};
+
+	unsigned slotOf(unsigned entry)
+	{
+		return g_slotOf[entry];
+	}
+#endif
+
+	// The order of the slots from a usage profile: the functions in the profile that were called, most
+	// called first, then the rest in declaration order.
+
+	void profileOrder(const std::vector<DispatchUsage> &profile, unsigned (&order)[Entry::Count])
+	{
+		std::uint64_t calls[Entry::Count]{};
+
+		for (const DispatchUsage &usage : profile)
+		{
+			unsigned symbol{findSymbol(usage.name)};
+
+			if (symbol < Entry::Count)
+				calls[symbol] += usage.calls;
+		}
+
+		for (unsigned entry = 0; entry < Entry::Count; ++entry)
+			order[entry] = entry;
+
+		std::stable_sort(std::begin(order), std::end(order), [&calls](unsigned a, unsigned b) { return calls[a] > calls[b]; });
+	}
+}
+
+// A GLDispatch table rearranged into slot order. It's aligned so that slot 0 starts a cache line.
+
+struct alignas(64) PackedDispatch
+{
+	Proc slots[Entry::Count]{};
+
+	void pack(const GLDispatch &table)
+	{
+#define PACK_ENTRY_POINT(name) \
+    slots[slotOf(Entry::name)] = reinterpret_cast<Proc>(table.name);
+
+		GL_DISPATCH_ENTRY_POINTS(PACK_ENTRY_POINT)
+
+#undef PACK_ENTRY_POINT
+	}
+};
+
+//
+// Loader loads an OpenGL library and retrieves function pointers to OpenGL functions. There's one
+// Loader per library. The default one is a singleton, and the others are created by forLibrary().
+//
+
+class Loader
+{
+public:
+	// The loader of the library named by the GLLOADER_LIBRARY environment variable, or of opengl32.dll.
+
+	static Loader &instance();
+
+	// The loader of the library at pszPath, or the default loader if pszPath is null or empty. Returns
+	// null if the library can't be loaded. Loaders other than the default one are never destroyed, since
+	// function pointers and dispatch tables taken from them may be used until the process exits.
+
+	static Loader *forLibrary(const wchar_t *pszPath);
+
+	void *getProcAddress(const char *pszName) const;
+	void *getProcAddress(unsigned symbol) const;
+
+	// The driver's entry points, used by contexts without interception layers, and the same entry
+	// points in slot order. repack() must be called after the slot order changes.
+
+	const GLDispatch &dispatch() const { return m_dispatch; }
+	const PackedDispatch &packed() const { return m_packed; }
+	void repack() { m_packed.pack(m_dispatch); }
+
+	// Calls f for every loader that has been created.
+
+	template <typename F>
+	static void forEach(F f);
+
+	// Whether this is the system opengl32.dll, which GDI's pixel format and SwapBuffers() functions call into.
+
+	bool system() const { return m_system; }
+
+	LoaderReport report() const;
+
+private:
+	explicit Loader(const wchar_t *pszPath);
+	~Loader();
+
+	// Looks up one name, first with wglGetProcAddress() and then with GetProcAddress() on the library.
+
+	void *resolve(const char *pszName, unsigned symbol) const;
+	void *lookUp(const char *pszName, SymbolSource &source, bool &invalidDriverResult) const;
+	void record(const char *pszName, unsigned symbol, const char *pszAlias, SymbolSource source, bool invalidDriverResult, double microseconds) const;
+
+	// How one of the loader's own symbols was last recorded, packed so that resolve() can tell without
+	// locking whether a lookup found it the same way: kRecorded, plus kInvalidResult if the driver ever
+	// returned an invalid pointer for it, plus its SymbolSource. Zero if it hasn't been recorded.
+
+	static constexpr std::uint8_t kRecorded{0x80};
+	static constexpr std::uint8_t kInvalidResult{0x40};
+
+	using PFNWGLGETPROCADDRESSPROC = void *(APIENTRY *)(const char *);
+
+	HMODULE m_hLibGL;
+	PFNWGLGETPROCADDRESSPROC m_pfnWglGetProcAddress;
+	GLDispatch m_dispatch;
+	PackedDispatch m_packed;
+	double m_loadMilliseconds;
+	bool m_system;
+	mutable std::mutex m_resolutionsMutex;
+	mutable std::vector<SymbolResolution> m_resolutions;
+
+	// Where each symbol is in m_resolutions. The loader's own symbols are indexed by symbol, and are -1
+	// if they haven't been looked up, and other names by name.
+
+	mutable std::array<std::int32_t, Symbol::Count> m_resolutionIndex;
+	mutable std::unordered_map<std::string, std::size_t> m_nameIndex;
+
+	// How each of the loader's own symbols was last recorded, and the lookups of it that were only
+	// counted. The report adds them to the symbol's lookups.
+
+	mutable std::array<std::atomic<std::uint8_t>, Symbol::Count> m_recorded{};
+	mutable std::array<std::atomic<std::uint32_t>, Symbol::Count> m_countedLookups{};
+};
+
+namespace
+{
+	std::mutex g_loadersMutex;
+	std::vector<Loader *> g_loaders;
+
+	// Reads the call counts from a usage profile, a JSON report whose results have "function" and
+	// "calls" members, like the interposer's report.
+
+	bool readUsageProfile(const wchar_t *pszPath, std::vector<DispatchUsage> &profile)
+	{
+		FILE *pFile{nullptr};
+
+		if (!pszPath || _wfopen_s(&pFile, pszPath, L"rb") != 0)
+			return false;
+
+		std::string text;
+		char buffer[4096];
+
+		for (size_t read; (read = std::fread(buffer, 1, sizeof(buffer), pFile)) > 0;)
+			text.append(buffer, read);
+
+		std::fclose(pFile);
+
+		for (size_t pos = text.find("\"function\""); pos != std::string::npos; pos = text.find("\"function\"", pos))
+		{
+			size_t nameStart{text.find('"', text.find(':', pos) + 1)};
+			size_t nameEnd{text.find('"', nameStart + 1)};
+			size_t objectEnd{text.find('}', pos)};
+			size_t calls{text.find("\"calls\"", pos)};
+
+			if (nameStart == std::string::npos || nameEnd == std::string::npos)
+				break;
+
+			if (calls < objectEnd)
+			{
+				// Older reports wrote large counts in exponent form, so the count is read as a double.
+
+				size_t value{text.find(':', calls) + 1};
+				double count{std::strtod(text.c_str() + value, nullptr)};
+
+				profile.push_back(DispatchUsage{text.substr(nameStart + 1, nameEnd - nameStart - 1), count > 0.0 ? static_cast<std::uint64_t>(count) : 0});
+			}
+
+			pos = nameEnd;
+		}
+
+		return !profile.empty();
+	}
+
+	// GLLOADER_DISPATCH_PROFILE names a usage profile to lay the dispatch tables out from. It's applied
+	// before the first loader packs its table.
+
+	void applyEnvironmentProfile()
+	{
+#ifndef GLLOADER_BAKED_DISPATCH_LAYOUT
+		static std::once_flag applied;
+
+		std::call_once(applied, []()
+		{
+			wchar_t path[MAX_PATH]{};
+			DWORD length{GetEnvironmentVariableW(L"GLLOADER_DISPATCH_PROFILE", path, MAX_PATH)};
+			std::vector<DispatchUsage> profile;
+			unsigned order[Entry::Count]{};
+
+			if (length > 0 && length < MAX_PATH && readUsageProfile(path, profile))
+			{
+				profileOrder(profile, order);
+				g_slotOf = slotTable(order);
+			}
+		});
+#endif
+	}
+
+	bool isSystemLibrary(HMODULE hLibGL)
+	{
+#ifdef GLLOADER_INTERPOSER
+		// The interposer only ever loads its renamed copy of the system library.
+
+		return hLibGL != nullptr;
+#else
+		wchar_t libraryPath[MAX_PATH]{};
+		wchar_t systemPath[MAX_PATH]{};
+		UINT length{GetSystemDirectoryW(systemPath, MAX_PATH)};
+
+		if (!hLibGL || !GetModuleFileNameW(hLibGL, libraryPath, MAX_PATH) || length == 0 || length >= MAX_PATH - 14)
+			return false;
+
+		wcscat_s(systemPath, L"\\opengl32.dll");
+		return _wcsicmp(libraryPath, systemPath) == 0;
+#endif
+	}
+}
+
+template <typename F>
+void Loader::forEach(F f)
+{
+	f(instance());
+
+	std::lock_guard<std::mutex> lock{g_loadersMutex};
+
+	for (Loader *pLoader : g_loaders)
+		f(*pLoader);
+}
+
+Loader &Loader::instance()
+{
+#ifdef GLLOADER_INTERPOSER
+	// The interposer is itself called opengl32.dll, so the system library is loaded from a renamed copy.
+	// Interposer.def forwards the functions the interposer doesn't profile to the same copy.
+
+	static Loader theInstance{L"opengl32sys.dll"};
+#else
+	static Loader theInstance{[]()
+	{
+		static wchar_t path[MAX_PATH]{};
+		DWORD length{GetEnvironmentVariableW(L"GLLOADER_LIBRARY", path, MAX_PATH)};
+
+		return (length > 0 && length < MAX_PATH) ? path : L"opengl32.dll";
+	}()};
+#endif
+
+	return theInstance;
+}
+
+Loader *Loader::forLibrary(const wchar_t *pszPath)
+{
+	Loader &defaultLoader{instance()};
+
+	if (!pszPath || !*pszPath)
+		return &defaultLoader;
+
+	std::lock_guard<std::mutex> lock{g_loadersMutex};
+
+	// Different spellings of a path that's already loaded resolve to the same module.
+
+	if (HMODULE hLoaded{GetModuleHandleW(pszPath)})
+	{
+		if (hLoaded == defaultLoader.m_hLibGL)
+			return &defaultLoader;
+
+		for (Loader *pLoader : g_loaders)
+		{
+			if (pLoader->m_hLibGL == hLoaded)
+				return pLoader;
+		}
+	}
+
+	Loader *pLoader{new Loader(pszPath)};
+
+	if (!pLoader->m_hLibGL)
+	{
+		delete pLoader;
+		return nullptr;
+	}
+
+	g_loaders.push_back(pLoader);
+	return pLoader;
+}
+
+Loader::Loader(const wchar_t *pszPath) : m_hLibGL(nullptr), m_pfnWglGetProcAddress(nullptr), m_dispatch{}, m_loadMilliseconds(0.0), m_system(false)
+{
+	m_resolutionIndex.fill(-1);
+
+	auto start{std::chrono::steady_clock::now()};
+
+	m_hLibGL = LoadLibraryW(pszPath);
+
+	if (m_hLibGL != nullptr)
+	{
+		m_pfnWglGetProcAddress = reinterpret_cast<PFNWGLGETPROCADDRESSPROC>(GetProcAddress(m_hLibGL, "wglGetProcAddress"));
+		m_system = isSystemLibrary(m_hLibGL);
+	}
+
+	m_loadMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+#define LOAD_DISPATCH_ENTRY_POINT(name) \
+    m_dispatch.name = reinterpret_cast<decltype(m_dispatch.name)>(getProcAddress(Symbol::name)); \
+    if (!m_dispatch.name) \
+        m_dispatch.name = MissingEntryPoint<decltype(m_dispatch.name)>::call;
+
+	GL_DISPATCH_ENTRY_POINTS(LOAD_DISPATCH_ENTRY_POINT)
+
+#undef LOAD_DISPATCH_ENTRY_POINT
+
+	applyEnvironmentProfile();
+	m_packed.pack(m_dispatch);
+}
+
+Loader::~Loader()
+{
+	if (m_hLibGL != nullptr)
+	{
+		FreeLibrary(m_hLibGL);
+		m_hLibGL = nullptr;
+	}
+}
+
+void *Loader::getProcAddress(const char* pszName) const
+{
+	return resolve(pszName, findSymbol(pszName));
+}
+
+void *Loader::getProcAddress(unsigned symbol) const
+{
+	return resolve(kSymbolNames.c_str(symbol), symbol);
+}
+
+void *Loader::resolve(const char *pszName, unsigned symbol) const
+{
+	// Only a symbol's first lookup is timed. After that the loader's own symbols, which are looked up
+	// on every call with a context the loader doesn't know, are only counted unless they're found a
+	// different way.
+
+	std::uint8_t recorded{symbol < Symbol::Count ? m_recorded[symbol].load(std::memory_order_acquire) : std::uint8_t{0}};
+	bool timed{recorded == 0};
+	auto start{timed ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{}};
+	bool invalidDriverResult{false};
+	SymbolSource source{SymbolSource::Missing};
+	void *pfn{lookUp(pszName, source, invalidDriverResult)};
+	const char *pszAlias{nullptr};
+
+	// Fall back to the aliases in order of preference.
+
+	if (!pfn)
+	{
+		if (const EntryPointAliases *pEntry{findAliases(pszName)})
+		{
+			for (std::string_view alias : pEntry->aliases)
+			{
+				if (!alias.empty() && (pfn = lookUp(alias.data(), source, invalidDriverResult)) != nullptr)
+				{
+					pszAlias = alias.data();
+					break;
+				}
+			}
+		}
+	}
+
+	if (!timed && recorded == (kRecorded | (invalidDriverResult ? kInvalidResult : (recorded & kInvalidResult)) | static_cast<std::uint8_t>(source)))
+	{
+		m_countedLookups[symbol].fetch_add(1, std::memory_order_relaxed);
+		return pfn;
+	}
+
+	record(pszName, symbol, pszAlias, source, invalidDriverResult, timed ? std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() : 0.0);
+	return pfn;
+}
+
+void *Loader::lookUp(const char *pszName, SymbolSource &source, bool &invalidDriverResult) const
+{
+	void *pfn{nullptr};
+
+	source = SymbolSource::Missing;
+
+	if (m_pfnWglGetProcAddress)
+	{
+		pfn = m_pfnWglGetProcAddress(pszName);
+
+		bool invalid{pfn == reinterpret_cast<void*>(1) || pfn == reinterpret_cast<void*>(2) || pfn == reinterpret_cast<void*>(3) || pfn == reinterpret_cast<void*>(-1)};
+
+		invalidDriverResult = invalidDriverResult || invalid;
+		source = SymbolSource::Driver;
+
+		if (!pfn || invalid)
+		{
+			pfn = GetProcAddress(m_hLibGL, pszName);
+			source = pfn ? SymbolSource::Library : SymbolSource::Missing;
+		}
+	}
+
+	return pfn;
+}
+
+void Loader::record(const char *pszName, unsigned symbol, const char *pszAlias, SymbolSource source, bool invalidDriverResult, double microseconds) const
+{
+	std::lock_guard<std::mutex> lock{m_resolutionsMutex};
+
+	// The loader's own symbols are indexed by symbol. Other names, such as extension functions an
+	// application asks for, are indexed by name.
+
+	auto it{m_resolutions.end()};
+
+	if (symbol < Symbol::Count)
+	{
+		if (m_resolutionIndex[symbol] >= 0)
+			it = m_resolutions.begin() + m_resolutionIndex[symbol];
+	}
+	else if (auto found{m_nameIndex.find(pszName)}; found != m_nameIndex.end())
+	{
+		it = m_resolutions.begin() + found->second;
+	}
+
+	if (it == m_resolutions.end())
+	{
+		if (symbol < Symbol::Count)
+			m_resolutionIndex[symbol] = static_cast<std::int32_t>(m_resolutions.size());
+		else
+			m_nameIndex.emplace(pszName, m_resolutions.size());
+
+		it = m_resolutions.insert(m_resolutions.end(), SymbolResolution{pszName});
+	}
+
+	// A symbol may be found later than it was first asked for, once a context is current, so the
+	// latest source is kept.
+
+	it->source = source;
+	it->alias = pszAlias ? pszAlias : "";
+	it->invalidDriverResult = it->invalidDriverResult || invalidDriverResult;
+	it->microseconds += microseconds;
+	++it->lookups;
+
+	if (symbol < Symbol::Count)
+		m_recorded[symbol].store(kRecorded | (it->invalidDriverResult ? kInvalidResult : 0) | static_cast<std::uint8_t>(source), std::memory_order_release);
+}
+
+LoaderReport Loader::report() const
+{
+	LoaderReport report;
+	char path[MAX_PATH]{};
+
+	if (m_hLibGL && GetModuleFileNameA(m_hLibGL, path, MAX_PATH) > 0)
+		report.library = path;
+
+	report.loadMilliseconds = m_loadMilliseconds;
+
+	std::lock_guard<std::mutex> lock{m_resolutionsMutex};
+
+	report.symbols = m_resolutions;
+
+	for (unsigned symbol = 0; symbol < Symbol::Count; ++symbol)
+	{
+		if (m_resolutionIndex[symbol] >= 0)
+			report.symbols[m_resolutionIndex[symbol]].lookups += m_countedLookups[symbol].load(std::memory_order_relaxed);
+	}
+
+	return report;
+}
+
+//
+// LoaderReport methods
+//
+
+std::vector<std::string> LoaderReport::missing() const
+{
+	std::vector<std::string> names;
+
+	for (const SymbolResolution &symbol : symbols)
+	{
+		if (symbol.source == SymbolSource::Missing)
+			names.push_back(symbol.name);
+	}
+
+	return names;
+}
+
+std::string LoaderReport::describe() const
+{
+	std::string text{"library: " + (library.empty() ? std::string{"(not loaded)"} : library) + "\n"};
+	char line[256]{};
+	std::uint32_t counts[3]{};
+	double microseconds[3]{};
+
+	std::snprintf(line, sizeof(line), "load: %.3f ms\n\n%-48s %-8s %8s %12s\n", loadMilliseconds, "symbol", "source", "lookups", "us");
+	text += line;
+
+	for (const SymbolResolution &symbol : symbols)
+	{
+		std::snprintf(line, sizeof(line), "%-48s %-8s %8u %12.3f", symbol.name.c_str(), sourceName(symbol.source), symbol.lookups, symbol.microseconds);
+		text += line;
+
+		if (!symbol.alias.empty())
+			text += "  as " + symbol.alias;
+
+		if (symbol.invalidDriverResult)
+			text += "  (invalid wglGetProcAddress result)";
+
+		text += "\n";
+
+		++counts[static_cast<int>(symbol.source)];
+		microseconds[static_cast<int>(symbol.source)] += symbol.microseconds;
+	}
+
+	text += "\n";
+
+	for (SymbolSource source : {SymbolSource::Driver, SymbolSource::Library, SymbolSource::Missing})
+	{
+		std::snprintf(line, sizeof(line), "%-8s %4u symbols %12.3f us\n", sourceName(source), counts[static_cast<int>(source)], microseconds[static_cast<int>(source)]);
+		text += line;
+	}
+
+	for (const std::string &name : missing())
+		text += "missing: " + name + "\n";
+
+	return text;
+}
+
+const char *LoaderReport::sourceName(SymbolSource source)
+{
+	switch (source)
+	{
+	case SymbolSource::Driver: return "driver";
+	case SymbolSource::Library: return "library";
+	default: return "missing";
+	}
+}
+
+namespace
+{
+	// The packed dispatch table of the calling thread's current context, or null if it comes from the
+	// default library and has no interception layers, and the loader of that context, or null for the
+	// default one.
+
+	thread_local const PackedDispatch *t_pDispatch{nullptr};
+	thread_local Loader *t_pLoader{nullptr};
+
+	const PackedDispatch &dispatch()
+	{
+		const PackedDispatch *pDispatch{t_pDispatch};
+		return pDispatch ? *pDispatch : Loader::instance().packed();
+	}
+
+	Loader &currentLoader()
+	{
+		Loader *pLoader{t_pLoader};
+		return pLoader ? *pLoader : Loader::instance();
+	}
+}
+
+//
+// GLExtensions methods
+//
+
+namespace
+{
+	constexpr std::string_view kExtensionNames[]
+	{
+		"GL_ARB_buffer_storage",
+		"GL_ARB_clip_control",
+		"GL_ARB_copy_buffer",
+		"GL_ARB_debug_output",
+		"GL_ARB_direct_state_access",
+		"GL_ARB_framebuffer_object",
+		"GL_ARB_internalformat_query2",
+		"GL_ARB_map_buffer_range",
+		"GL_ARB_multi_bind",
+		"GL_ARB_multi_draw_indirect",
+		"GL_ARB_pixel_buffer_object",
+		"GL_ARB_sampler_objects",
+		"GL_ARB_sync",
+		"GL_ARB_texture_compression_bptc",
+		"GL_ARB_texture_compression_rgtc",
+		"GL_ARB_texture_float",
+		"GL_ARB_texture_storage",
+		"GL_ARB_timer_query",
+		"GL_ARB_vertex_array_object",
+		"GL_EXT_bgra",
+		"GL_EXT_direct_state_access",
+		"GL_EXT_texture_compression_s3tc",
+		"GL_EXT_texture_filter_anisotropic",
+		"GL_KHR_debug",
+	};
+
+	static_assert(std::size(kExtensionNames) == GLExtensions::Count);
+	static_assert(std::is_sorted(std::begin(kExtensionNames), std::end(kExtensionNames)));
+
+	// Returns GLExtensions::Count if the name isn't one of the known extensions.
+
+	GLExtensions::Extension findExtension(std::string_view name)
+	{
+		if (name.substr(0, 3) != "GL_")
+			return GLExtensions::Count;
+
+		const std::string_view *pName{std::lower_bound(std::begin(kExtensionNames), std::end(kExtensionNames), name)};
+
+		if (pName == std::end(kExtensionNames) || *pName != name)
+			return GLExtensions::Count;
+
+		return static_cast<GLExtensions::Extension>(pName - std::begin(kExtensionNames));
+	}
+
+	GLVersion parseVersion(const char *pszVersion)
+	{
+		GLVersion version{};
+
+		if (!pszVersion)
+			return version;
+
+		std::string_view text{pszVersion};
+
+		if (text.substr(0, 9) == "OpenGL ES")
+		{
+			version.es = true;
+			text.remove_prefix(9);
+		}
+
+		size_t start{text.find_first_of("0123456789")};
+
+		if (start == std::string_view::npos)
+			return version;
+
+		auto number = [&text](size_t &pos)
+		{
+			int value{0};
+
+			for (; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; ++pos)
+				value = value * 10 + (text[pos] - '0');
+
+			return value;
+		};
+
+		version.major = number(start);
+
+		if (start < text.size() && text[start] == '.')
+			version.minor = number(++start);
+
+		return version;
+	}
+}
+
+GLExtensions GLExtensions::query()
+{
+	GLExtensions extensions;
+
+	extensions.m_version = parseVersion(reinterpret_cast<const char *>(glGetString(GL_VERSION)));
+
+	auto add = [&extensions](std::string_view name)
+	{
+		Extension extension{findExtension(name)};
+
+		if (extension < Count)
+			extensions.m_extensions.set(extension);
+
+		++extensions.m_advertised;
+	};
+
+	using PFNGLGETSTRINGIPROC = const GLubyte *(APIENTRY *)(GLenum name, GLuint index);
+	auto pfnGetStringi{reinterpret_cast<PFNGLGETSTRINGIPROC>(currentLoader().getProcAddress(Symbol::glGetStringi))};
+
+	if (extensions.m_version.major >= 3 && pfnGetStringi)
+	{
+		GLint count{0};
+
+		glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+		for (GLint i = 0; i < count; ++i)
+		{
+			if (const char *pszName{reinterpret_cast<const char *>(pfnGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)))})
+				add(pszName);
+		}
+	}
+	else if (const char *pszExtensions{reinterpret_cast<const char *>(glGetString(GL_EXTENSIONS))})
+	{
+		// Split on whitespace rather than searching, so that GL_EXT_foo can't match GL_EXT_foo_bar.
+
+		std::string_view remaining{pszExtensions};
+
+		while (!remaining.empty())
+		{
+			size_t start{remaining.find_first_not_of(' ')};
+
+			if (start == std::string_view::npos)
+				break;
+
+			remaining.remove_prefix(start);
+
+			size_t length{std::min(remaining.find(' '), remaining.size())};
+
+			add(remaining.substr(0, length));
+			remaining.remove_prefix(length);
+		}
+	}
+
+	return extensions;
+}
+
+bool GLExtensions::has(const char *pszName) const
+{
+	if (!pszName)
+		return false;
+
+	std::string_view name{pszName};
+	Extension extension{(name.substr(0, 3) == "GL_") ? findExtension(name) : findExtension(std::string{"GL_"}.append(name))};
+
+	return has(extension);
+}
+
+const char *GLExtensions::name(Extension extension)
+{
+	return extension < Count ? kExtensionNames[extension].data() : nullptr;
+}
+
+//
+// Texture shadowing
+//
+
+namespace
+{
+	// GL functions the loader calls itself that aren't in GLDispatch, since opengl32.dll doesn't export
+	// them. They're resolved for each rendering context, once it's current, and are null if the
+	// context's version and extensions don't provide them.
+
+	struct ContextFunctions
+	{
+		PFNGLACTIVETEXTUREPROC glActiveTexture{nullptr};
+		PFNGLBINDTEXTURESPROC glBindTextures{nullptr};
+		PFNGLBINDSAMPLERPROC glBindSampler{nullptr};
+		PFNGLGENSAMPLERSPROC glGenSamplers{nullptr};
+		PFNGLSAMPLERPARAMETERFPROC glSamplerParameterf{nullptr};
+		PFNGLSAMPLERPARAMETERIPROC glSamplerParameteri{nullptr};
+		PFNGLBINDBUFFERPROC glBindBuffer{nullptr};
+		PFNGLBUFFERSUBDATAPROC glBufferSubData{nullptr};
+		PFNGLDELETEBUFFERSPROC glDeleteBuffers{nullptr};
+		PFNGLCREATETEXTURESPROC glCreateTextures{nullptr};
+		PFNGLGETTEXTUREPARAMETERFVPROC glGetTextureParameterfv{nullptr};
+		PFNGLGETTEXTUREPARAMETERIVPROC glGetTextureParameteriv{nullptr};
+		PFNGLNAMEDBUFFERSUBDATAPROC glNamedBufferSubData{nullptr};
+		PFNGLTEXTUREPARAMETERFPROC glTextureParameterf{nullptr};
+		PFNGLTEXTUREPARAMETERFVPROC glTextureParameterfv{nullptr};
+		PFNGLTEXTUREPARAMETERIPROC glTextureParameteri{nullptr};
+		PFNGLTEXTUREPARAMETERIVPROC glTextureParameteriv{nullptr};
+		PFNGLTEXTURESUBIMAGE1DPROC glTextureSubImage1D{nullptr};
+		PFNGLTEXTURESUBIMAGE2DPROC glTextureSubImage2D{nullptr};
+
+		// Every direct state access function above was found, so none of them needs to be emulated.
+
+		bool directStateAccess{};
+
+		// The target buffers are bound to while glNamedBufferSubData() is emulated. GL_COPY_WRITE_BUFFER
+		// isn't used for anything else, so binding to it disturbs nothing.
+
+		GLenum bufferEditTarget{GL_ARRAY_BUFFER};
+	};
+
+	ContextFunctions loadContextFunctions(const Loader &loader, const GLExtensions &extensions)
+	{
+		ContextFunctions functions;
+		const GLVersion &version{extensions.version()};
+
+		if (version.atLeast(1, 3))
+			functions.glActiveTexture = reinterpret_cast<PFNGLACTIVETEXTUREPROC>(loader.getProcAddress(Symbol::glActiveTexture));
+
+		if (version.atLeast(4, 4) || extensions.has<GLExtensions::ARB_multi_bind>())
+			functions.glBindTextures = reinterpret_cast<PFNGLBINDTEXTURESPROC>(loader.getProcAddress(Symbol::glBindTextures));
+
+		if (version.atLeast(3, 3) || extensions.has<GLExtensions::ARB_sampler_objects>())
+		{
+			functions.glBindSampler = reinterpret_cast<PFNGLBINDSAMPLERPROC>(loader.getProcAddress(Symbol::glBindSampler));
+			functions.glGenSamplers = reinterpret_cast<PFNGLGENSAMPLERSPROC>(loader.getProcAddress(Symbol::glGenSamplers));
+			functions.glSamplerParameterf = reinterpret_cast<PFNGLSAMPLERPARAMETERFPROC>(loader.getProcAddress(Symbol::glSamplerParameterf));
+			functions.glSamplerParameteri = reinterpret_cast<PFNGLSAMPLERPARAMETERIPROC>(loader.getProcAddress(Symbol::glSamplerParameteri));
+		}
+
+		if (version.atLeast(1, 5))
+		{
+			functions.glBindBuffer = reinterpret_cast<PFNGLBINDBUFFERPROC>(loader.getProcAddress(Symbol::glBindBuffer));
+			functions.glBufferSubData = reinterpret_cast<PFNGLBUFFERSUBDATAPROC>(loader.getProcAddress(Symbol::glBufferSubData));
+			functions.glDeleteBuffers = reinterpret_cast<PFNGLDELETEBUFFERSPROC>(loader.getProcAddress(Symbol::glDeleteBuffers));
+		}
+
+		if (version.atLeast(3, 1) || extensions.has<GLExtensions::ARB_copy_buffer>())
+			functions.bufferEditTarget = GL_COPY_WRITE_BUFFER;
+
+		if (version.atLeast(4, 5) || extensions.has<GLExtensions::ARB_direct_state_access>())
+		{
+			functions.glCreateTextures = reinterpret_cast<PFNGLCREATETEXTURESPROC>(loader.getProcAddress(Symbol::glCreateTextures));
+			functions.glGetTextureParameterfv = reinterpret_cast<PFNGLGETTEXTUREPARAMETERFVPROC>(loader.getProcAddress(Symbol::glGetTextureParameterfv));
+			functions.glGetTextureParameteriv = reinterpret_cast<PFNGLGETTEXTUREPARAMETERIVPROC>(loader.getProcAddress(Symbol::glGetTextureParameteriv));
+			functions.glNamedBufferSubData = reinterpret_cast<PFNGLNAMEDBUFFERSUBDATAPROC>(loader.getProcAddress(Symbol::glNamedBufferSubData));
+			functions.glTextureParameterf = reinterpret_cast<PFNGLTEXTUREPARAMETERFPROC>(loader.getProcAddress(Symbol::glTextureParameterf));
+			functions.glTextureParameterfv = reinterpret_cast<PFNGLTEXTUREPARAMETERFVPROC>(loader.getProcAddress(Symbol::glTextureParameterfv));
+			functions.glTextureParameteri = reinterpret_cast<PFNGLTEXTUREPARAMETERIPROC>(loader.getProcAddress(Symbol::glTextureParameteri));
+			functions.glTextureParameteriv = reinterpret_cast<PFNGLTEXTUREPARAMETERIVPROC>(loader.getProcAddress(Symbol::glTextureParameteriv));
+			functions.glTextureSubImage1D = reinterpret_cast<PFNGLTEXTURESUBIMAGE1DPROC>(loader.getProcAddress(Symbol::glTextureSubImage1D));
+			functions.glTextureSubImage2D = reinterpret_cast<PFNGLTEXTURESUBIMAGE2DPROC>(loader.getProcAddress(Symbol::glTextureSubImage2D));
+
+			functions.directStateAccess = functions.glCreateTextures && functions.glGetTextureParameterfv && functions.glGetTextureParameteriv && functions.glNamedBufferSubData &&
+				functions.glTextureParameterf && functions.glTextureParameterfv && functions.glTextureParameteri && functions.glTextureParameteriv &&
+				functions.glTextureSubImage1D && functions.glTextureSubImage2D;
+		}
+
+		return functions;
+	}
+
+	// The texture parameters that are shadowed. With the border color, depth comparison and sRGB decode
+	// modes they make up the state a sampler object holds.
+
+	enum TextureParameter : unsigned
+	{
+		MinFilter,
+		MagFilter,
+		WrapS,
+		WrapT,
+		WrapR,
+		MinLod,
+		MaxLod,
+		LodBias,
+		MaxAnisotropy,
+		TextureParameterCount
+	};
+
+	constexpr GLenum kTextureParameterNames[TextureParameterCount]
+	{
+		GL_TEXTURE_MIN_FILTER,
+		GL_TEXTURE_MAG_FILTER,
+		GL_TEXTURE_WRAP_S,
+		GL_TEXTURE_WRAP_T,
+		GL_TEXTURE_WRAP_R,
+		GL_TEXTURE_MIN_LOD,
+		GL_TEXTURE_MAX_LOD,
+		GL_TEXTURE_LOD_BIAS,
+		GL_TEXTURE_MAX_ANISOTROPY,
+	};
+
+	constexpr bool kIntegerTextureParameter[TextureParameterCount]{true, true, true, true, true, false, false, false, false};
+
+	using SamplerValues = std::array<GLfloat, TextureParameterCount>;
+
+	constexpr SamplerValues kDefaultSamplerValues{GL_NEAREST_MIPMAP_LINEAR, GL_LINEAR, GL_REPEAT, GL_REPEAT, GL_REPEAT, -1000.0f, 1000.0f, 0.0f, 1.0f};
+
+	constexpr std::uint16_t kAllTextureParameters{(1u << TextureParameterCount) - 1};
+
+	// Returns TextureParameterCount if pname isn't shadowed.
+
+	unsigned textureParameter(GLenum pname)
+	{
+		const GLenum *pName{std::find(std::begin(kTextureParameterNames), std::end(kTextureParameterNames), pname)};
+		return static_cast<unsigned>(pName - std::begin(kTextureParameterNames));
+	}
+
+	bool unshadowedSamplerParameter(GLenum pname)
+	{
+		return pname == GL_TEXTURE_BORDER_COLOR || pname == GL_TEXTURE_COMPARE_MODE || pname == GL_TEXTURE_COMPARE_FUNC || pname == GL_TEXTURE_SRGB_DECODE_EXT;
+	}
+
+	// Every texture target's bindings are tracked, but rectangle, buffer and multisample textures have
+	// different defaults or no sampling parameters, so only the first kShadowedTextureTargetCount
+	// targets have their parameters shadowed.
+
+	constexpr GLenum kTextureTargets[]
+	{
+		GL_TEXTURE_1D,
+		GL_TEXTURE_2D,
+		GL_TEXTURE_3D,
+		GL_TEXTURE_1D_ARRAY,
+		GL_TEXTURE_2D_ARRAY,
+		GL_TEXTURE_CUBE_MAP,
+		GL_TEXTURE_CUBE_MAP_ARRAY,
+		GL_TEXTURE_RECTANGLE,
+		GL_TEXTURE_BUFFER,
+		GL_TEXTURE_2D_MULTISAMPLE,
+		GL_TEXTURE_2D_MULTISAMPLE_ARRAY,
+	};
+
+	constexpr unsigned kTextureTargetCount{static_cast<unsigned>(std::size(kTextureTargets))};
+	constexpr unsigned kShadowedTextureTargetCount{7};
+
+	static_assert(kTextureTargets[kShadowedTextureTargetCount - 1] == GL_TEXTURE_CUBE_MAP_ARRAY);
+
+	// Returns kTextureTargetCount if target isn't a texture target.
+
+	unsigned textureTarget(GLenum target)
+	{
+		const GLenum *pTarget{std::find(std::begin(kTextureTargets), std::end(kTextureTargets), target)};
+		return static_cast<unsigned>(pTarget - std::begin(kTextureTargets));
+	}
+
+	struct ShadowedTexture
+	{
+		// Generated through the GL functions, so the parameters will have their default values once the
+		// texture is first bound.
+
+		bool generated{};
+
+		// Bound by the driver at least once. glBindTextures() and the direct state access functions only
+		// accept textures that have been.
+
+		bool created{};
+
+		// The index of the target the texture was first bound to, or kTextureTargetCount if it hasn't been.
+
+		unsigned target{kTextureTargetCount};
+
+		// A border color, depth comparison or sRGB decode mode has been set, so no sampler object will do.
+
+		bool ownSampler{};
+
+		// The parameters whose values below the texture object itself doesn't have, because a sampler
+		// object has stood in for it since they were set.
+
+		std::uint16_t unwritten{};
+
+		std::uint16_t known{};
+		SamplerValues values{};
+
+		// The sampler object for values, or zero if one hasn't been looked up since they last changed.
+
+		GLuint sampler{};
+	};
+
+	// The textures bound to each target of a unit as the application sees them, and as the driver has
+	// them. They differ while binds are deferred, or while a texture is bound to stand in for a direct
+	// state access call.
+
+	struct TextureUnit
+	{
+		GLuint textures[kTextureTargetCount]{};
+		GLuint driverTextures[kTextureTargetCount]{};
+		GLuint sampler{};
+	};
+
+	std::atomic<unsigned> g_textureCache{0};
+	std::atomic<std::uint64_t> g_textureParameterCalls{0};
+	std::atomic<std::uint64_t> g_textureParameterCallsForwarded{0};
+	std::atomic<std::uint64_t> g_samplerObjects{0};
+	std::atomic<std::uint64_t> g_samplerBinds{0};
+	std::atomic<std::uint64_t> g_textureBindCalls{0};
+	std::atomic<std::uint64_t> g_textureBindsForwarded{0};
+	std::atomic<std::uint64_t> g_multiBinds{0};
+	std::atomic<std::uint64_t> g_activeTextureCalls{0};
+	std::atomic<std::uint64_t> g_activeTexturesForwarded{0};
+	std::atomic<std::uint64_t> g_directStateAccessCalls{0};
+	std::atomic<std::uint64_t> g_directStateAccessEmulated{0};
+	std::atomic<std::uint64_t> g_editBinds{0};
+
+	// The texture objects and bindings of one rendering context as the GL functions have seen them. Only
+	// the thread the context is current on uses it. With the texture cache off it only tracks the
+	// bindings, so that direct state access can be emulated on contexts without it.
+
+	class TextureShadow
+	{
+	public:
+		TextureShadow(const ContextFunctions &functions, OpenGLContext::TextureCache mode, unsigned units);
+
+		void generated(GLsizei n, const GLuint *pTextures);
+		void created(unsigned target, GLsizei n, const GLuint *pTextures, bool inDriver);
+
+		// Whether texture has a target, from glCreateTextures() or its first bind, and so is a texture.
+
+		bool hasTarget(GLuint texture) const
+		{
+			auto it{m_textures.find(texture)};
+			return it != m_textures.end() && it->second.target != kTextureTargetCount;
+		}
+		void deleted(GLsizei n, const GLuint *pTextures);
+
+		// These return false if the call wouldn't change anything, or if it has been deferred.
+
+		bool selectUnit(GLenum texture);
+		bool bind(GLenum target, GLuint texture);
+
+		// These return false if the call wouldn't change anything, or if a sampler object will apply the
+		// value instead. The first sets a parameter of the texture bound to target, the second one of the
+		// texture named, for the direct state access functions.
+
+		bool setParameter(GLenum target, GLenum pname, GLfloat value);
+		bool setTextureParameter(GLuint texture, GLenum pname, GLfloat value);
+
+		// These return false if the driver should be asked, because the texture object has the value itself.
+
+		bool getParameter(GLenum target, GLenum pname, GLfloat &value) const;
+		bool getTextureParameter(GLuint texture, GLenum pname, GLfloat &value) const;
+
+		// Make the driver's bindings and active unit match the application's before a call that uses them.
+
+		void flushBindings()
+		{
+			if (m_bindsPending)
+				bindDeferred();
+
+			restoreDriverUnit();
+		}
+
+		// Draws don't depend on the active unit, so it's left as it is.
+
+		void prepareDraw()
+		{
+			if (m_bindsPending)
+				bindDeferred();
+
+			if (m_samplersDirty)
+				bindSamplers();
+		}
+
+		// Bind texture to its target on the active unit, as the driver sees it, so that a bind-to-edit
+		// function can stand in for a direct state access one. Returns the target, or zero if the texture
+		// has never been bound, which the direct state access functions reject. The application's
+		// bindings don't change: endEdit() puts the driver's back, or defers that like any other bind.
+
+		GLenum beginEdit(GLuint texture);
+		void endEdit();
+
+		// The direct state access functions only accept textures the driver has created, which a deferred
+		// bind may not have done yet.
+
+		void prepareEdit(GLuint texture)
+		{
+			if (!m_bindsPending)
+				return;
+
+			if (auto it{m_textures.find(texture)}; it != m_textures.end() && !it->second.created)
+				bindDeferred();
+		}
+
+	private:
+		GLuint boundTexture(GLenum target) const;
+		bool setParameter(GLuint name, ShadowedTexture &texture, GLenum pname, GLfloat value);
+
+		void markPending(unsigned unit);
+		void bindDeferred();
+		void bindSamplers();
+		GLuint findSampler(const SamplerValues &values);
+		void writeBack(GLuint name, ShadowedTexture &texture, unsigned unit);
+		void setDriverUnit(unsigned unit);
+
+		void restoreDriverUnit()
+		{
+			if (m_driverUnit != m_activeUnit)
+				setDriverUnit(m_activeUnit);
+		}
+
+		const ContextFunctions &m_functions;
+		bool m_cache{};
+		bool m_samplers{};
+		bool m_samplersDirty{};
+
+		// The application's active texture unit, and the driver's. They differ while a unit change is
+		// deferred, or after deferred binds and sampler parameters have been made on other units.
+
+		unsigned m_activeUnit{0};
+		unsigned m_driverUnit{0};
+
+		// Units from m_usedUnits on have never had a texture bound.
+
+		std::vector<TextureUnit> m_units;
+		unsigned m_usedUnits{0};
+		std::unordered_map<GLuint, ShadowedTexture> m_textures;
+		std::vector<std::pair<SamplerValues, GLuint>> m_samplerObjects;
+
+		// The range of units with deferred binds.
+
+		bool m_bindsPending{};
+		unsigned m_firstPending{};
+		unsigned m_lastPending{};
+		std::vector<GLuint> m_multiBind;
+		std::vector<unsigned> m_multiBindTargets;
+
+		// The target beginEdit() bound a texture to.
+
+		unsigned m_editTarget{};
+	};
+
+	TextureShadow::TextureShadow(const ContextFunctions &functions, OpenGLContext::TextureCache mode, unsigned units) :
+		m_functions(functions), m_units(functions.glActiveTexture ? std::max(1u, units) : 1)
+	{
+		m_cache = mode != OpenGLContext::TextureCache::Off;
+		m_samplers = mode == OpenGLContext::TextureCache::Samplers && functions.glBindSampler && functions.glGenSamplers && functions.glSamplerParameterf && functions.glSamplerParameteri;
+	}
+
+	void TextureShadow::generated(GLsizei n, const GLuint *pTextures)
+	{
+		for (GLsizei i = 0; pTextures && i < n; ++i)
+			m_textures[pTextures[i]] = ShadowedTexture{true};
+	}
+
+	// Textures from glCreateTextures() have their target, and their parameters have the default values,
+	// from the start. Without direct state access the driver only creates them when they're first bound.
+
+	void TextureShadow::created(unsigned target, GLsizei n, const GLuint *pTextures, bool inDriver)
+	{
+		for (GLsizei i = 0; pTextures && i < n; ++i)
+		{
+			ShadowedTexture &texture{m_textures[pTextures[i]] = ShadowedTexture{}};
+
+			texture.created = inDriver;
+			texture.target = target;
+
+			if (target < kShadowedTextureTargetCount)
+			{
+				texture.known = kAllTextureParameters;
+				texture.values = kDefaultSamplerValues;
+			}
+		}
+	}
+
+	void TextureShadow::deleted(GLsizei n, const GLuint *pTextures)
+	{
+		// Deleting a bound texture binds zero in its place.
+
+		for (GLsizei i = 0; pTextures && i < n; ++i)
+		{
+			if (pTextures[i] == 0)
+				continue;
+
+			m_textures.erase(pTextures[i]);
+
+			for (TextureUnit &unit : m_units)
+			{
+				for (unsigned index = 0; index < kTextureTargetCount; ++index)
+				{
+					if (unit.textures[index] == pTextures[i])
+						unit.textures[index] = 0;
+
+					if (unit.driverTextures[index] == pTextures[i])
+						unit.driverTextures[index] = 0;
+				}
+			}
+		}
+
+		m_samplersDirty = m_samplers;
+	}
+
+	bool TextureShadow::selectUnit(GLenum texture)
+	{
+		// There's a unit for each of GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, so the driver rejects any other.
+
+		unsigned unit{texture - GL_TEXTURE0};
+
+		if (unit >= m_units.size())
+			return true;
+
+		m_activeUnit = unit;
+
+		if (m_cache)
+			return false;
+
+		m_driverUnit = unit;
+		return true;
+	}
+
+	bool TextureShadow::bind(GLenum target, GLuint texture)
+	{
+		unsigned index{textureTarget(target)};
+
+		if (index == kTextureTargetCount)
+		{
+			restoreDriverUnit();
+			return true;
+		}
+
+		TextureUnit &unit{m_units[m_activeUnit]};
+
+		if (m_cache && unit.textures[index] == texture)
+			return false;
+
+		unit.textures[index] = texture;
+		m_usedUnits = std::max(m_usedUnits, m_activeUnit + 1);
+		m_samplersDirty = m_samplers;
+
+		// A name that wasn't generated here may have been given parameters before shadowing started.
+
+		ShadowedTexture *pTexture{nullptr};
+
+		if (texture != 0)
+		{
+			pTexture = &m_textures[texture];
+
+			if (pTexture->target == kTextureTargetCount)
+				pTexture->target = index;
+
+			if (pTexture->generated)
+			{
+				pTexture->generated = false;
+
+				if (index < kShadowedTextureTargetCount)
+				{
+					pTexture->known = kAllTextureParameters;
+					pTexture->values = kDefaultSamplerValues;
+				}
+			}
+		}
+
+		// Without glBindTextures() there's nothing to gain by deferring.
+
+		if (!m_cache || !m_functions.glBindTextures)
+		{
+			unit.driverTextures[index] = texture;
+
+			if (pTexture)
+				pTexture->created = true;
+
+			restoreDriverUnit();
+			return true;
+		}
+
+		markPending(m_activeUnit);
+		return false;
+	}
+
+	GLuint TextureShadow::boundTexture(GLenum target) const
+	{
+		unsigned index{textureTarget(target)};
+		return index < kShadowedTextureTargetCount ? m_units[m_activeUnit].textures[index] : 0;
+	}
+
+	bool TextureShadow::setParameter(GLenum target, GLenum pname, GLfloat value)
+	{
+		GLuint texture{boundTexture(target)};
+
+		if (!m_cache || texture == 0)
+			return true;
+
+		auto it{m_textures.find(texture)};
+		return it == m_textures.end() || setParameter(texture, it->second, pname, value);
+	}
+
+	bool TextureShadow::setTextureParameter(GLuint texture, GLenum pname, GLfloat value)
+	{
+		auto it{m_textures.find(texture)};
+
+		if (!m_cache || it == m_textures.end() || it->second.target >= kShadowedTextureTargetCount)
+			return true;
+
+		return setParameter(texture, it->second, pname, value);
+	}
+
+	bool TextureShadow::setParameter(GLuint name, ShadowedTexture &texture, GLenum pname, GLfloat value)
+	{
+		unsigned parameter{textureParameter(pname)};
+
+		if (parameter == TextureParameterCount)
+		{
+			if (m_samplers && unshadowedSamplerParameter(pname) && !texture.ownSampler)
+			{
+				texture.ownSampler = true;
+				writeBack(name, texture, m_activeUnit);
+				m_samplersDirty = true;
+			}
+
+			return true;
+		}
+
+		std::uint16_t bit{static_cast<std::uint16_t>(1u << parameter)};
+
+		if ((texture.known & bit) && texture.values[parameter] == value)
+			return false;
+
+		texture.known |= bit;
+		texture.values[parameter] = value;
+		texture.sampler = 0;
+
+		if (!m_samplers)
+			return true;
+
+		m_samplersDirty = true;
+
+		// Until every parameter is known the texture keeps its own. Once it is it's never forwarded to again.
+
+		if (texture.known != kAllTextureParameters || texture.ownSampler)
+			return true;
+
+		texture.unwritten |= bit;
+		return false;
+	}
+
+	bool TextureShadow::getParameter(GLenum target, GLenum pname, GLfloat &value) const
+	{
+		GLuint texture{boundTexture(target)};
+		return texture != 0 && getTextureParameter(texture, pname, value);
+	}
+
+	bool TextureShadow::getTextureParameter(GLuint texture, GLenum pname, GLfloat &value) const
+	{
+		auto it{m_textures.find(texture)};
+		unsigned parameter{textureParameter(pname)};
+
+		if (it == m_textures.end() || parameter == TextureParameterCount || (it->second.unwritten & (1u << parameter)) == 0)
+			return false;
+
+		value = it->second.values[parameter];
+		return true;
+	}
+
+	GLenum TextureShadow::beginEdit(GLuint texture)
+	{
+		auto it{m_textures.find(texture)};
+
+		if (it == m_textures.end() || it->second.target == kTextureTargetCount)
+			return 0;
+
+		// Only the active unit's binding of the texture's target has to be right. Binds deferred on other
+		// units can stay deferred.
+
+		restoreDriverUnit();
+
+		unsigned index{it->second.target};
+		GLuint &driverTexture{m_units[m_activeUnit].driverTextures[index]};
+
+		if (driverTexture != texture)
+		{
+			DISPATCH(glBindTexture)(kTextureTargets[index], texture);
+			driverTexture = texture;
+			it->second.created = true;
+			g_editBinds.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		m_editTarget = index;
+		return kTextureTargets[index];
+	}
+
+	void TextureShadow::endEdit()
+	{
+		TextureUnit &unit{m_units[m_activeUnit]};
+		GLuint texture{unit.textures[m_editTarget]};
+
+		if (unit.driverTextures[m_editTarget] == texture)
+			return;
+
+		if (m_cache && m_functions.glBindTextures)
+		{
+			markPending(m_activeUnit);
+			return;
+		}
+
+		DISPATCH(glBindTexture)(kTextureTargets[m_editTarget], texture);
+		unit.driverTextures[m_editTarget] = texture;
+		g_editBinds.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void TextureShadow::markPending(unsigned unit)
+	{
+		if (!m_bindsPending)
+		{
+			m_bindsPending = true;
+			m_firstPending = unit;
+			m_lastPending = unit;
+		}
+		else
+		{
+			m_firstPending = std::min(m_firstPending, unit);
+			m_lastPending = std::max(m_lastPending, unit);
+		}
+	}
+
+	// The deferred binds are made with one glBindTextures() call over the range of units that have them.
+	// It binds each texture to its own target and zero unbinds every target, so a unit whose binds it
+	// can't express, such as two targets changing at once, is passed a texture it already has and is
+	// then bound one target at a time.
+
+	void TextureShadow::bindDeferred()
+	{
+		m_bindsPending = false;
+		m_multiBind.assign(m_lastPending - m_firstPending + 1, 0);
+		m_multiBindTargets.assign(m_multiBind.size(), kTextureTargetCount);
+
+		bool batched{false};
+
+		for (unsigned unit = m_firstPending; unit <= m_lastPending; ++unit)
+		{
+			TextureUnit &textureUnit{m_units[unit]};
+			GLuint &name{m_multiBind[unit - m_firstPending]};
+			unsigned changed{0};
+			unsigned changedIndex{0};
+			unsigned bound{0};
+
+			for (unsigned index = 0; index < kTextureTargetCount; ++index)
+			{
+				if (textureUnit.textures[index] != textureUnit.driverTextures[index])
+				{
+					++changed;
+					changedIndex = index;
+				}
+
+				if (textureUnit.driverTextures[index] != 0)
+				{
+					++bound;
+					name = textureUnit.driverTextures[index];
+				}
+			}
+
+			if (changed == 1)
+			{
+				GLuint texture{textureUnit.textures[changedIndex]};
+				auto it{m_textures.find(texture)};
+
+				if ((texture == 0 && bound == 1) || (it != m_textures.end() && it->second.created && it->second.target == changedIndex))
+				{
+					name = texture;
+					m_multiBindTargets[unit - m_firstPending] = changedIndex;
+					batched = true;
+				}
+			}
+		}
+
+		if (batched)
+		{
+			m_functions.glBindTextures(m_firstPending, static_cast<GLsizei>(m_multiBind.size()), m_multiBind.data());
+			g_multiBinds.fetch_add(1, std::memory_order_relaxed);
+
+			for (unsigned unit = m_firstPending; unit <= m_lastPending; ++unit)
+			{
+				unsigned index{m_multiBindTargets[unit - m_firstPending]};
+
+				if (index != kTextureTargetCount)
+					m_units[unit].driverTextures[index] = m_units[unit].textures[index];
+			}
+		}
+
+		for (unsigned unit = m_firstPending; unit <= m_lastPending; ++unit)
+		{
+			TextureUnit &textureUnit{m_units[unit]};
+
+			for (unsigned index = 0; index < kTextureTargetCount; ++index)
+			{
+				GLuint texture{textureUnit.textures[index]};
+
+				if (texture == textureUnit.driverTextures[index])
+					continue;
+
+				setDriverUnit(unit);
+				DISPATCH(glBindTexture)(kTextureTargets[index], texture);
+				textureUnit.driverTextures[index] = texture;
+				g_textureBindsForwarded.fetch_add(1, std::memory_order_relaxed);
+
+				if (texture != 0)
+					m_textures[texture].created = true;
+			}
+		}
+	}
+
+	// A unit gets the sampler object for the values of the textures bound to it, if they all have every
+	// parameter known and the same values. Otherwise the textures' own parameters are written back and
+	// the unit has no sampler.
+
+	void TextureShadow::bindSamplers()
+	{
+		m_samplersDirty = false;
+
+		for (unsigned unit = 0; unit < m_usedUnits; ++unit)
+		{
+			TextureUnit &textureUnit{m_units[unit]};
+			ShadowedTexture *pShared{nullptr};
+			bool shareable{true};
+
+			for (GLuint texture : textureUnit.textures)
+			{
+				if (texture == 0)
+					continue;
+
+				auto it{m_textures.find(texture)};
+
+				if (it == m_textures.end() || it->second.known != kAllTextureParameters || it->second.ownSampler)
+					shareable = false;
+				else if (pShared && pShared->values != it->second.values)
+					shareable = false;
+				else
+					pShared = &it->second;
+			}
+
+			GLuint sampler{0};
+
+			if (shareable && pShared)
+			{
+				if (!pShared->sampler)
+					pShared->sampler = findSampler(pShared->values);
+
+				sampler = pShared->sampler;
+			}
+			else
+			{
+				for (GLuint texture : textureUnit.textures)
+				{
+					auto it{m_textures.find(texture)};
+
+					if (it != m_textures.end())
+						writeBack(texture, it->second, unit);
+				}
+			}
+
+			if (sampler != textureUnit.sampler)
+			{
+				m_functions.glBindSampler(unit, sampler);
+				textureUnit.sampler = sampler;
+				g_samplerBinds.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	GLuint TextureShadow::findSampler(const SamplerValues &values)
+	{
+		for (const auto &[samplerValues, sampler] : m_samplerObjects)
+		{
+			if (samplerValues == values)
+				return sampler;
+		}
+
+		GLuint sampler{0};
+		m_functions.glGenSamplers(1, &sampler);
+
+		// Parameters left at their defaults aren't set, so that anisotropy isn't set on drivers without it.
+
+		for (unsigned parameter = 0; parameter < TextureParameterCount; ++parameter)
+		{
+			if (values[parameter] == kDefaultSamplerValues[parameter])
+				continue;
+
+			if (kIntegerTextureParameter[parameter])
+				m_functions.glSamplerParameteri(sampler, kTextureParameterNames[parameter], static_cast<GLint>(values[parameter]));
+			else
+				m_functions.glSamplerParameterf(sampler, kTextureParameterNames[parameter], values[parameter]);
+		}
+
+		m_samplerObjects.emplace_back(values, sampler);
+		g_samplerObjects.fetch_add(1, std::memory_order_relaxed);
+		return sampler;
+	}
+
+	// Only the parameters the application has set since a sampler object stood in for the texture are
+	// written, the way findSampler() leaves defaults alone, so anisotropy isn't set on drivers without it
+	// unless the application set it. Without direct state access the texture is written through unit,
+	// which must have it bound as the driver sees it, or it's bound to the active unit for the purpose.
+
+	void TextureShadow::writeBack(GLuint name, ShadowedTexture &texture, unsigned unit)
+	{
+		std::uint16_t unwritten{texture.unwritten};
+
+		if (unwritten == 0)
+			return;
+
+		texture.unwritten = 0;
+
+		if (m_functions.directStateAccess)
+		{
+			prepareEdit(name);
+
+			for (unsigned parameter = 0; parameter < TextureParameterCount; ++parameter)
+			{
+				if ((unwritten & (1u << parameter)) == 0)
+					continue;
+
+				if (kIntegerTextureParameter[parameter])
+					m_functions.glTextureParameteri(name, kTextureParameterNames[parameter], static_cast<GLint>(texture.values[parameter]));
+				else
+					m_functions.glTextureParameterf(name, kTextureParameterNames[parameter], texture.values[parameter]);
+			}
+
+			return;
+		}
+
+		GLenum target{kTextureTargets[texture.target]};
+		bool edit{m_units[unit].driverTextures[texture.target] != name};
+
+		if (edit)
+			beginEdit(name);
+		else
+			setDriverUnit(unit);
+
+		for (unsigned parameter = 0; parameter < TextureParameterCount; ++parameter)
+		{
+			if ((unwritten & (1u << parameter)) == 0)
+				continue;
+
+			if (kIntegerTextureParameter[parameter])
+				DISPATCH(glTexParameteri)(target, kTextureParameterNames[parameter], static_cast<GLint>(texture.values[parameter]));
+			else
+				DISPATCH(glTexParameterf)(target, kTextureParameterNames[parameter], texture.values[parameter]);
+		}
+
+		if (edit)
+			endEdit();
+	}
+
+	void TextureShadow::setDriverUnit(unsigned unit)
+	{
+		if (unit != m_driverUnit)
+		{
+			m_functions.glActiveTexture(GL_TEXTURE0 + unit);
+			m_driverUnit = unit;
+			g_activeTexturesForwarded.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	// The buffer bound to ContextFunctions::bufferEditTarget of a rendering context without direct state
+	// access, so that glNamedBufferSubData() can put it back after binding another buffer there. Only the
+	// thread the context is current on uses it.
+
+	struct BufferShadow
+	{
+		GLuint bound{};
+	};
+}
+
+//
+// OpenGLContext methods
+//
+
+namespace
+{
+	// The rendering context and device context that are current on this thread. Each is unknown until
+	// it's first queried, or until wglMakeCurrent() is called on the thread.
+
+	struct CurrentContext
+	{
+		bool known{false};
+		bool dcKnown{false};
+		HDC hDC{nullptr};
+		HGLRC hRC{nullptr};
+		const GLExtensions *pExtensions{nullptr};
+		const ContextFunctions *pFunctions{nullptr};
+
+		// The context's texture shadow, once texturesChecked is set. Null if it isn't shadowing textures.
+
+		TextureShadow *pTextures{nullptr};
+		bool texturesChecked{false};
+
+		// The context's buffer binding, once buffersChecked is set. Null if it has direct state access.
+
+		BufferShadow *pBuffers{nullptr};
+		bool buffersChecked{false};
+
+		// An error the loader raised in place of the driver, which glGetError() returns before the
+		// driver's. Like the driver, it keeps the first error until it's been read.
+
+		GLenum error{GL_NO_ERROR};
+	};
+
+	thread_local CurrentContext t_currentContext;
+
+	void raiseError(GLenum error)
+	{
+		if (t_currentContext.error == GL_NO_ERROR)
+			t_currentContext.error = error;
+	}
+
+	// Forget what was looked up for the previous context.
+
+	void contextChanged(CurrentContext &current)
+	{
+		current.pExtensions = nullptr;
+		current.pFunctions = nullptr;
+		current.pTextures = nullptr;
+		current.texturesChecked = false;
+		current.pBuffers = nullptr;
+		current.buffersChecked = false;
+		current.error = GL_NO_ERROR;
+	}
+
+	// A flattened chain of interception layers. pLevels[0] is the driver and pLevels[i] adds the i'th
+	// layer counting up from the driver. Each level keeps the functions its layer intercepts, and its
+	// table has a thunk for each of them that makes the level the calling thread's current one before
+	// calling the layer, so a layer's functions find their own level, and the one below, with next() and
+	// current(). The GL functions call through pPacked, the top level in slot order.
+
+	struct DispatchLevel
+	{
+		std::shared_ptr<GLLayer> pLayer;
+		GLDispatch intercepted{};
+		GLDispatch table{};
+	};
+
+	struct DispatchChain
+	{
+		std::size_t layerCount{0};
+		std::unique_ptr<DispatchLevel[]> pLevels;
+		std::unique_ptr<PackedDispatch> pPacked;
+	};
+
+	// The chain the calling thread's GL functions go through, if its current context has layers, and
+	// the level whose layer function is running.
+
+	thread_local const DispatchChain *t_pChain{nullptr};
+	thread_local const DispatchLevel *t_pLevel{nullptr};
+
+	struct LevelScope
+	{
+		explicit LevelScope(const DispatchLevel *pLevel) : pLevel(pLevel), pOuter(t_pLevel) { t_pLevel = pLevel; }
+		~LevelScope() { t_pLevel = pOuter; }
+
+		const DispatchLevel *pLevel;
+		const DispatchLevel *pOuter;
+	};
+
+	// One thunk per level and entry point, generated from the entry point's type in GLDispatch.
+
+	template <std::size_t Level, auto Member, typename Pfn>
+	struct LayerThunk;
+
+	template <std::size_t Level, auto Member, typename R, typename... Args>
+	struct LayerThunk<Level, Member, R(APIENTRY *)(Args...)>
+	{
+		static R APIENTRY call(Args... args)
+		{
+			LevelScope scope{&t_pChain->pLevels[Level]};
+			return (scope.pLevel->intercepted.*Member)(args...);
+		}
+	};
+
+	template <std::size_t Level>
+	GLDispatch levelThunks()
+	{
+		GLDispatch thunks{};
+
+#define THUNK_ENTRY_POINT(name) \
+    thunks.name = LayerThunk<Level, &GLDispatch::name, decltype(GLDispatch::name)>::call;
+
+		GL_DISPATCH_ENTRY_POINTS(THUNK_ENTRY_POINT)
+
+#undef THUNK_ENTRY_POINT
+
+		return thunks;
+	}
+
+	template <std::size_t... Levels>
+	std::array<GLDispatch, sizeof...(Levels)> makeThunks(std::index_sequence<Levels...>)
+	{
+		return {levelThunks<Levels>()...};
+	}
+
+	const GLDispatch &thunksFor(std::size_t level)
+	{
+		static const std::array<GLDispatch, OpenGLContext::kMaxLayers + 1> thunks{makeThunks(std::make_index_sequence<OpenGLContext::kMaxLayers + 1>{})};
+		return thunks[level];
+	}
+
+	// What the loader knows about each rendering context: its parsed extensions and functions, if
+	// they've been asked for, its texture and buffer shadows, and its interception layers and the chain
+	// built from them. Rendering context handles are process wide, so this is shared by every
+	// OpenGLContext, but they're only unique within a library, so a context is known by its handle and
+	// the loader of the library that created it, null for the default one.
+
+	struct ContextState
+	{
+		HGLRC hRC{nullptr};
+		Loader *pLoader{nullptr};
+		std::unique_ptr<GLExtensions> pExtensions;
+		std::unique_ptr<ContextFunctions> pFunctions;
+		std::unique_ptr<TextureShadow> pTextures;
+		std::unique_ptr<BufferShadow> pBuffers;
+		std::vector<std::shared_ptr<GLLayer>> layers;
+		std::unique_ptr<DispatchChain> pChain;
+	};
+
+	std::mutex g_contextStatesMutex;
+	std::vector<ContextState> g_contextStates;
+
+	// Other threads may still be calling through a context's old chain until they next make a context
+	// current or swap, so a replaced chain is retired rather than deleted. Every thread that calls
+	// through a chain publishes it in its ChainReader, and only switches chains between GL calls, so a
+	// retired chain is freed as soon as no reader has it published. Readers are guarded by
+	// g_contextStatesMutex.
+
+	struct ChainReader;
+
+	std::vector<ChainReader *> g_chainReaders;
+	std::vector<std::unique_ptr<DispatchChain>> g_retiredChains;
+
+	struct ChainReader
+	{
+		// Constructed by useChain(), which holds the lock.
+
+		ChainReader()
+		{
+			g_chainReaders.push_back(this);
+		}
+
+		~ChainReader()
+		{
+			std::lock_guard<std::mutex> lock{g_contextStatesMutex};
+			std::erase(g_chainReaders, this);
+		}
+
+		const DispatchChain *pChain{nullptr};
+	};
+
+	// Must be called with g_contextStatesMutex held.
+
+	void reclaimChains()
+	{
+		std::erase_if(g_retiredChains, [](const std::unique_ptr<DispatchChain> &pChain)
+		{
+			return std::none_of(g_chainReaders.begin(), g_chainReaders.end(), [&pChain](const ChainReader *pReader) { return pReader->pChain == pChain.get(); });
+		});
+	}
+
+	// Switch the calling thread to pChain. Must be called with g_contextStatesMutex held, and not from
+	// inside a GL call.
+
+	void useChain(const DispatchChain *pChain)
+	{
+		static thread_local ChainReader reader;
+
+		if (pChain == t_pChain)
+			return;
+
+		reader.pChain = pChain;
+		t_pChain = pChain;
+		reclaimChains();
+	}
+
+	// The number of contexts with layers. While it's zero making a context current doesn't look anything up.
+
+	std::atomic<unsigned> g_layeredContexts{0};
+
+	// Must be called with g_contextStatesMutex held. Returns null if nothing is known about the context,
+	// so queries about contexts that were never used, or have been deleted, don't leave entries behind.
+
+	ContextState *lookupContextState(Loader *pLoader, HGLRC hRC)
+	{
+		for (ContextState &state : g_contextStates)
+		{
+			if (state.hRC == hRC && state.pLoader == pLoader)
+				return &state;
+		}
+
+		return nullptr;
+	}
+
+	// As above, but adds an entry for a context that isn't known yet.
+
+	ContextState &findContextState(Loader *pLoader, HGLRC hRC)
+	{
+		if (ContextState *pState{lookupContextState(pLoader, hRC)})
+			return *pState;
+
+		g_contextStates.push_back(ContextState{hRC, pLoader});
+		return g_contextStates.back();
+	}
+
+	// The loader a library's contexts are known by, null for the default library. False if the library
+	// can't be loaded.
+
+	bool findContextLoader(const wchar_t *pszLibrary, Loader *&pLoader)
+	{
+		Loader *pFound{Loader::forLibrary(pszLibrary)};
+
+		pLoader = (pFound == &Loader::instance()) ? nullptr : pFound;
+		return pFound != nullptr;
+	}
+
+	// hRC must be current on the calling thread, in case its extensions haven't been parsed yet.
+
+	const GLExtensions *findContextExtensions(Loader *pLoader, HGLRC hRC)
+	{
+		std::lock_guard<std::mutex> lock{g_contextStatesMutex};
+		ContextState &state{findContextState(pLoader, hRC)};
+
+		if (!state.pExtensions)
+			state.pExtensions = std::make_unique<GLExtensions>(GLExtensions::query());
+
+		return state.pExtensions.get();
+	}
+
+	// Must be called with g_contextStatesMutex held, and with state's context current on the calling thread.
+
+	const ContextFunctions &contextFunctions(ContextState &state)
+	{
+		if (!state.pExtensions)
+			state.pExtensions = std::make_unique<GLExtensions>(GLExtensions::query());
+
+		if (!state.pFunctions)
+			state.pFunctions = std::make_unique<ContextFunctions>(loadContextFunctions(state.pLoader ? *state.pLoader : Loader::instance(), *state.pExtensions));
+
+		return *state.pFunctions;
+	}
+
+	// hRC must be current on the calling thread.
+
+	const ContextFunctions *findContextFunctions(Loader *pLoader, HGLRC hRC)
+	{
+		std::lock_guard<std::mutex> lock{g_contextStatesMutex};
+		return &contextFunctions(findContextState(pLoader, hRC));
+	}
+
+	// The functions of the calling thread's current context, or null if it isn't known.
+
+	const ContextFunctions *currentFunctions()
+	{
+		CurrentContext &current{t_currentContext};
+
+		if (!current.pFunctions && current.known && current.hRC)
+			current.pFunctions = findContextFunctions(t_pLoader, current.hRC);
+
+		return current.pFunctions;
+	}
+
+	// hRC must be current on the calling thread. Samplers mode needs GL 3.3 or ARB_sampler_objects, and
+	// every texture unit the context has is tracked from GL 2.0 on. With the cache off a context only
+	// has a shadow if it needs one to emulate direct state access.
+
+	TextureShadow *findContextTextures(Loader *pLoader, HGLRC hRC, OpenGLContext::TextureCache mode)
+	{
+		std::lock_guard<std::mutex> lock{g_contextStatesMutex};
+		ContextState &state{findContextState(pLoader, hRC)};
+		const ContextFunctions &functions{contextFunctions(state)};
+
+		if (!state.pTextures && (mode != OpenGLContext::TextureCache::Off || !functions.directStateAccess))
+		{
+			GLint units{1};
+
+			if (state.pExtensions->version().atLeast(2, 0))
+				DISPATCH(glGetIntegerv)(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &units);
+
+			state.pTextures = std::make_unique<TextureShadow>(functions, mode, static_cast<unsigned>(std::max(units, 1)));
+		}
+
+		return state.pTextures.get();
+	}
+
+	// The texture shadow of the calling thread's current context, or null if it isn't shadowing textures.
+
+	TextureShadow *currentTextures()
+	{
+		CurrentContext &current{t_currentContext};
+
+		if (!current.texturesChecked)
+		{
+			auto mode{static_cast<OpenGLContext::TextureCache>(g_textureCache.load(std::memory_order_relaxed))};
+
+			current.texturesChecked = true;
+			current.pTextures = (current.known && current.hRC) ? findContextTextures(t_pLoader, current.hRC, mode) : nullptr;
+		}
+
+		return current.pTextures;
+	}
+
+	// hRC must be current on the calling thread.
+
+	BufferShadow *findContextBuffers(Loader *pLoader, HGLRC hRC)
+	{
+		std::lock_guard<std::mutex> lock{g_contextStatesMutex};
+		ContextState &state{findContextState(pLoader, hRC)};
+
+		if (!state.pBuffers && !contextFunctions(state).directStateAccess)
+			state.pBuffers = std::make_unique<BufferShadow>();
+
+		return state.pBuffers.get();
+	}
+
+	// The buffer shadow of the calling thread's current context, or null if it has direct state access.
+
+	BufferShadow *currentBuffers()
+	{
+		CurrentContext &current{t_currentContext};
+
+		if (!current.buffersChecked)
+		{
+			current.buffersChecked = true;
+			current.pBuffers = (current.known && current.hRC) ? findContextBuffers(t_pLoader, current.hRC) : nullptr;
+		}
+
+		return current.pBuffers;
+	}
+
+	// Make hRC, from pLoader's library, the calling thread's current context: point its GL functions at
+	// hRC's chain, or at pLoader's entry points if hRC has no layers, and its loader at pLoader. Must be
+	// called between GL calls.
+
+	void selectDispatch(HGLRC hRC, Loader *pLoader)
+	{
+		const DispatchChain *pChain{nullptr};
+
+		if (!hRC)
+			pLoader = nullptr;
+
+		if (t_pChain || (hRC && g_layeredContexts.load(std::memory_order_relaxed) != 0))
+		{
+			std::lock_guard<std::mutex> lock{g_contextStatesMutex};
+
+			for (const ContextState &state : g_contextStates)
+			{
+				if (hRC && state.hRC == hRC && state.pLoader == pLoader)
+					pChain = state.pChain.get();
+			}
+
+			useChain(pChain);
+		}
+
+		t_pDispatch = pChain ? pChain->pPacked.get() : (pLoader ? &pLoader->packed() : nullptr);
+		t_pLoader = pLoader;
+	}
+
+	// Must be called with g_contextStatesMutex held.
+
+	void rebuildChain(ContextState &state)
+	{
+		if (state.pChain)
+			g_retiredChains.push_back(std::move(state.pChain));
+
+		std::size_t count{state.layers.size()};
+
+		if (count > 0)
+		{
+			std::unique_ptr<DispatchChain> pChain{std::make_unique<DispatchChain>()};
+
+			pChain->layerCount = count;
+			pChain->pLevels = std::make_unique<DispatchLevel[]>(count + 1);
+			pChain->pLevels[0].table = state.pLoader ? state.pLoader->dispatch() : Loader::instance().dispatch();
+
+			for (std::size_t level = 1; level <= count; ++level)
+			{
+				DispatchLevel &current{pChain->pLevels[level]};
+				const GLDispatch &thunks{thunksFor(level)};
+
+				current.pLayer = state.layers[count - level];
+				current.pLayer->intercept(current.intercepted);
+				current.table = pChain->pLevels[level - 1].table;
+
+#define MERGE_ENTRY_POINT(name) \
+    if (current.intercepted.name) \
+        current.table.name = thunks.name;
+
+				GL_DISPATCH_ENTRY_POINTS(MERGE_ENTRY_POINT)
+
+#undef MERGE_ENTRY_POINT
+			}
+
+			pChain->pPacked = std::make_unique<PackedDispatch>();
+			pChain->pPacked->pack(pChain->pLevels[count].table);
+			state.pChain = std::move(pChain);
+		}
+
+		reclaimChains();
+	}
+
+	void forgetContextState(Loader *pLoader, HGLRC hRC)
+	{
+		std::lock_guard<std::mutex> lock{g_contextStatesMutex};
+
+		std::erase_if(g_contextStates, [pLoader, hRC](ContextState &state)
+		{
+			if (state.hRC != hRC || state.pLoader != pLoader)
+				return false;
+
+			if (!state.layers.empty())
+				--g_layeredContexts;
+
+			if (state.pChain)
+				g_retiredChains.push_back(std::move(state.pChain));
+
+			return true;
+		});
+
+		reclaimChains();
+	}
+
+	std::atomic<bool> g_currentTracking{true};
+	std::atomic<std::uint64_t> g_makeCurrentCalls{0};
+	std::atomic<std::uint64_t> g_makeCurrentForwarded{0};
+	std::atomic<std::uint64_t> g_currentQueries{0};
+	std::atomic<std::uint64_t> g_currentQueriesForwarded{0};
+}
+
+const GLDispatch &GLLayer::next()
+{
+	return (t_pLevel - 1)->table;
+}
+
+GLLayer &GLLayer::current()
+{
+	return *t_pLevel->pLayer;
+}
+
+void OpenGLContext::setCurrentTracking(bool enabled)
+{
+	g_currentTracking = enabled;
+}
+
+bool OpenGLContext::currentTracking()
+{
+	return g_currentTracking.load(std::memory_order_relaxed);
+}
+
+OpenGLContext::CurrentTrackingStats OpenGLContext::currentTrackingStats()
+{
+	CurrentTrackingStats stats{};
+
+	stats.makeCurrentCalls = g_makeCurrentCalls.load();
+	stats.makeCurrentForwarded = g_makeCurrentForwarded.load();
+	stats.queries = g_currentQueries.load();
+	stats.queriesForwarded = g_currentQueriesForwarded.load();
+
+	return stats;
+}
+
+void OpenGLContext::resetCurrentTrackingStats()
+{
+	g_makeCurrentCalls = 0;
+	g_makeCurrentForwarded = 0;
+	g_currentQueries = 0;
+	g_currentQueriesForwarded = 0;
+}
+
+void OpenGLContext::setTextureCache(TextureCache mode)
+{
+	g_textureCache = static_cast<unsigned>(mode);
+}
+
+OpenGLContext::TextureCache OpenGLContext::textureCache()
+{
+	return static_cast<TextureCache>(g_textureCache.load(std::memory_order_relaxed));
+}
+
+OpenGLContext::TextureCacheStats OpenGLContext::textureCacheStats()
+{
+	TextureCacheStats stats{};
+
+	stats.parameterCalls = g_textureParameterCalls.load();
+	stats.parameterCallsForwarded = g_textureParameterCallsForwarded.load();
+	stats.samplerObjects = g_samplerObjects.load();
+	stats.samplerBinds = g_samplerBinds.load();
+	stats.bindCalls = g_textureBindCalls.load();
+	stats.bindsForwarded = g_textureBindsForwarded.load();
+	stats.multiBinds = g_multiBinds.load();
+	stats.activeTextureCalls = g_activeTextureCalls.load();
+	stats.activeTexturesForwarded = g_activeTexturesForwarded.load();
+
+	return stats;
+}
+
+void OpenGLContext::resetTextureCacheStats()
+{
+	g_textureParameterCalls = 0;
+	g_textureParameterCallsForwarded = 0;
+	g_samplerObjects = 0;
+	g_samplerBinds = 0;
+	g_textureBindCalls = 0;
+	g_textureBindsForwarded = 0;
+	g_multiBinds = 0;
+	g_activeTextureCalls = 0;
+	g_activeTexturesForwarded = 0;
+}
+
+void OpenGLContext::flushTextureCache()
+{
+	if (TextureShadow *pTextures{currentTextures()})
+	{
+		pTextures->prepareDraw();
+		pTextures->flushBindings();
+	}
+}
+
+OpenGLContext::DirectStateAccessStats OpenGLContext::directStateAccessStats()
+{
+	DirectStateAccessStats stats{};
+
+	stats.calls = g_directStateAccessCalls.load();
+	stats.emulated = g_directStateAccessEmulated.load();
+	stats.editBinds = g_editBinds.load();
+
+	return stats;
+}
+
+void OpenGLContext::resetDirectStateAccessStats()
+{
+	g_directStateAccessCalls = 0;
+	g_directStateAccessEmulated = 0;
+	g_editBinds = 0;
+}
+
+LoaderReport OpenGLContext::loaderReport(const wchar_t *pszLibrary)
+{
+	Loader *pLoader{Loader::forLibrary(pszLibrary)};
+	return pLoader ? pLoader->report() : LoaderReport{};
+}
+
+PROC OpenGLContext::getProcAddress(LPCSTR lpszProc, const wchar_t *pszLibrary)
+{
+	Loader *pLoader{lpszProc ? Loader::forLibrary(pszLibrary) : nullptr};
+	return pLoader ? reinterpret_cast<PROC>(pLoader->getProcAddress(lpszProc)) : nullptr;
+}
+
+bool OpenGLContext::setDispatchProfile(const std::vector<DispatchUsage> &profile)
+{
+#ifdef GLLOADER_BAKED_DISPATCH_LAYOUT
+	// The layout was fixed at compile time.
+
+	static_cast<void>(profile);
+	return false;
+#else
+	unsigned order[Entry::Count]{};
+
+	profileOrder(profile, order);
+
+	std::lock_guard<std::mutex> lock{g_contextStatesMutex};
+
+	g_slotOf = slotTable(order);
+	Loader::forEach([](Loader &loader) { loader.repack(); });
+
+	auto repackChain = [](DispatchChain &chain) { chain.pPacked->pack(chain.pLevels[chain.layerCount].table); };
+
+	for (ContextState &state : g_contextStates)
+	{
+		if (state.pChain)
+			repackChain(*state.pChain);
+	}
+
+	for (std::unique_ptr<DispatchChain> &pChain : g_retiredChains)
+		repackChain(*pChain);
+
+	return true;
+#endif
+}
+
+bool OpenGLContext::loadDispatchProfile(const wchar_t *pszPath)
+{
+	std::vector<DispatchUsage> profile;
+	return readUsageProfile(pszPath, profile) && setDispatchProfile(profile);
+}
+
+std::vector<std::string> OpenGLContext::dispatchLayout()
+{
+	std::vector<std::string> names(Entry::Count);
+
+	for (unsigned entry = 0; entry < Entry::Count; ++entry)
+		names[slotOf(entry)] = kSymbolNames[entry];
+
+	return names;
+}
+
+bool OpenGLContext::writeDispatchLayoutHeader(const wchar_t *pszPath)
+{
+	FILE *pFile{nullptr};
+
+	if (!pszPath || _wfopen_s(&pFile, pszPath, L"wb") != 0)
+		return false;
+
+	std::string text{"// Generated by glLoader from a dispatch usage profile. Build with GLLOADER_BAKED_DISPATCH_LAYOUT\n"
+		"// defined to bake this layout into the loader.\n\n#pragma once\n\n#define GL_DISPATCH_LAYOUT(X)"};
+
+	for (const std::string &name : dispatchLayout())
+		text += " \\\n    X(" + name + ")";
+
+	text += "\n";
+
+	bool ok{std::fwrite(text.data(), 1, text.size(), pFile) == text.size()};
+	return std::fclose(pFile) == 0 && ok;
+}
+
+const GLExtensions &OpenGLContext::extensions()
+{
+	static const GLExtensions noExtensions{};
+
+	if (!t_currentContext.pExtensions)
+	{
+		HGLRC hRC{wglGetCurrentContext()};
+
+		if (!hRC)
+			return noExtensions;
+
+		t_currentContext.pExtensions = findContextExtensions(m_pLoader, hRC);
+	}
+
+	return *t_currentContext.pExtensions;
+}
+
+bool OpenGLContext::insertLayer(HGLRC hglrc, std::shared_ptr<GLLayer> pLayer, std::size_t position, const wchar_t *pszLibrary)
+{
+	Loader *pLoader{nullptr};
+
+	if (!hglrc || !pLayer || !findContextLoader(pszLibrary, pLoader))
+		return false;
+
+	std::lock_guard<std::mutex> lock{g_contextStatesMutex};
+	ContextState &state{findContextState(pLoader, hglrc)};
+
+	if (state.layers.size() >= kMaxLayers)
+		return false;
+
+	if (state.layers.empty())
+		++g_layeredContexts;
+
+	state.layers.insert(state.layers.begin() + std::min(position, state.layers.size()), std::move(pLayer));
+	rebuildChain(state);
+
+	if (t_currentContext.known && t_currentContext.hRC == hglrc && t_pLoader == pLoader)
+	{
+		useChain(state.pChain.get());
+		t_pDispatch = state.pChain->pPacked.get();
+	}
+
+	return true;
+}
+
+bool OpenGLContext::removeLayer(HGLRC hglrc, const GLLayer *pLayer, const wchar_t *pszLibrary)
+{
+	Loader *pLoader{nullptr};
+
+	if (!findContextLoader(pszLibrary, pLoader))
+		return false;
+
+	std::lock_guard<std::mutex> lock{g_contextStatesMutex};
+	ContextState *pState{lookupContextState(pLoader, hglrc)};
+
+	if (!pState)
+		return false;
+
+	ContextState &state{*pState};
+	auto it{std::find_if(state.layers.begin(), state.layers.end(), [pLayer](const std::shared_ptr<GLLayer> &pEntry) { return pEntry.get() == pLayer; })};
+
+	if (it == state.layers.end())
+		return false;
+
+	state.layers.erase(it);
+	rebuildChain(state);
+
+	if (state.layers.empty())
+		--g_layeredContexts;
+
+	if (t_currentContext.known && t_currentContext.hRC == hglrc && t_pLoader == pLoader)
+	{
+		useChain(state.pChain.get());
+		t_pDispatch = state.pChain ? state.pChain->pPacked.get() : (pLoader ? &pLoader->packed() : nullptr);
+	}
+
+	return true;
+}
+
+std::vector<std::shared_ptr<GLLayer>> OpenGLContext::layers(HGLRC hglrc, const wchar_t *pszLibrary)
+{
+	Loader *pLoader{nullptr};
+
+	if (!findContextLoader(pszLibrary, pLoader))
+		return {};
+
+	std::lock_guard<std::mutex> lock{g_contextStatesMutex};
+	const ContextState *pState{lookupContextState(pLoader, hglrc)};
+
+	return pState ? pState->layers : std::vector<std::shared_ptr<GLLayer>>{};
+}
+
+OpenGLContext::OpenGLContext() : OpenGLContext(&Loader::instance())
+{
+}
+
+OpenGLContext::OpenGLContext(Loader *pLoader) : m_pLoader((pLoader == &Loader::instance()) ? nullptr : pLoader)
+{
+	// Every WGL function is resolved up front rather than on first use, since an OpenGLContext may be
+	// used by several threads at once, such as the render scheduler's workers.
+
+	const Loader &wglLoader{loader()};
+
+#define RESOLVE_ENTRYPOINT(name, var, type) var = reinterpret_cast<type>(wglLoader.getProcAddress(Symbol::name))
+	RESOLVE_ENTRYPOINT(wglChoosePixelFormat, m_pfnWglChoosePixelFormat, PFNWGLCHOOSEPIXELFORMATPROC);
+	RESOLVE_ENTRYPOINT(wglCopyContext, m_pfnWglCopyContext, PFNWGLCOPYCONTEXTPROC);
+	RESOLVE_ENTRYPOINT(wglCreateContext, m_pfnWglCreateContext, PFNWGLCREATECONTEXTPROC);
+	RESOLVE_ENTRYPOINT(wglCreateLayerContext, m_pfnWglCreateLayerContext, PFNWGLCREATELAYERCONTEXTPROC);
+	RESOLVE_ENTRYPOINT(wglDeleteContext, m_pfnWglDeleteContext, PFNWGLDELETECONTEXTPROC);
+	RESOLVE_ENTRYPOINT(wglDescribeLayerPlane, m_pfnWglDescribeLayerPlane, PFNWGLDESCRIBELAYERPLANEPROC);
+	RESOLVE_ENTRYPOINT(wglGetCurrentContext, m_pfnWglGetCurrentContext, PFNWGLGETCURRENTCONTEXTPROC);
+	RESOLVE_ENTRYPOINT(wglGetCurrentDC, m_pfnWglGetCurrentDC, PFNWGLGETCURRENTDCPROC);
+	RESOLVE_ENTRYPOINT(wglGetLayerPaletteEntries, m_pfnWglGetLayerPaletteEntries, PFNWGLGETLAYERPALETTEENTRIESPROC);
+	RESOLVE_ENTRYPOINT(wglMakeCurrent, m_pfnWglMakeCurrent, PFNWGLMAKECURRENTPROC);
+	RESOLVE_ENTRYPOINT(wglRealizeLayerPalette, m_pfnWglRealizeLayerPalette, PFNWGLREALIZELAYERPALETTEPROC);
+	RESOLVE_ENTRYPOINT(wglSetLayerPaletteEntries, m_pfnWglSetLayerPaletteEntries, PFNWGLSETLAYERPALETTEENTRIESPROC);
+	RESOLVE_ENTRYPOINT(wglSetPixelFormat, m_pfnWglSetPixelFormat, PFNWGLSETPIXELFORMATPROC);
+	RESOLVE_ENTRYPOINT(wglShareLists, m_pfnWglShareLists, PFNWGLSHARELISTSPROC);
+	RESOLVE_ENTRYPOINT(wglSwapBuffers, m_pfnWglSwapBuffers, PFNWGLSWAPBUFFERSPROC);
+	RESOLVE_ENTRYPOINT(wglSwapLayerBuffers, m_pfnWglSwapLayerBuffers, PFNWGLSWAPLAYERBUFFERSPROC);
+	RESOLVE_ENTRYPOINT(wglSwapMultipleBuffers, m_pfnWglSwapMultipleBuffers, PFNWGLSWAPMULTIPLEBUFFERSPROC);
+	RESOLVE_ENTRYPOINT(wglUseFontBitmapsA, m_pfnWglUseFontBitmapsA, PFNWGLUSEFONTBITMAPSPROC);
+	RESOLVE_ENTRYPOINT(wglUseFontBitmapsW, m_pfnWglUseFontBitmapsW, PFNWGLUSEFONTBITMAPSPROC);
+	RESOLVE_ENTRYPOINT(wglUseFontOutlinesA, m_pfnWglUseFontOutlinesA, PFNWGLUSEFONTOUTLINESPROC);
+	RESOLVE_ENTRYPOINT(wglUseFontOutlinesW, m_pfnWglUseFontOutlinesW, PFNWGLUSEFONTOUTLINESPROC);
+#undef RESOLVE_ENTRYPOINT
+}
+
+std::shared_ptr<OpenGLContext> OpenGLContext::createForWindow(HWND hWnd, PIXELFORMATDESCRIPTOR &pfd, const wchar_t *pszLibrary)
+{
+	Loader *pLoader{Loader::forLibrary(pszLibrary)};
+
+	if (!pLoader)
+		return std::shared_ptr<OpenGLContext>{};
+
+	std::shared_ptr<OpenGLContext> pContext{new OpenGLContext(pLoader)};
+
+	HDC hDC{GetDC(hWnd)};
+
+	if (!hDC)
+		return std::shared_ptr<OpenGLContext>{};
+
+	if (!pLoader->system())
+	{
+		if (!pContext->setPixelFormat(hDC, pfd))
+			return std::shared_ptr<OpenGLContext>{};
+
+		return pContext;
+	}
+        
+	int pf{ChoosePixelFormat(hDC, &pfd)};
+
+    if (!SetPixelFormat(hDC, pf, &pfd))
+		return std::shared_ptr<OpenGLContext>{};
+		
+	return pContext;
+}
+
+Loader &OpenGLContext::loader() const
+{
+	return m_pLoader ? *m_pLoader : Loader::instance();
+}
+
+BOOL OpenGLContext::setPixelFormat(HDC hdc, const PIXELFORMATDESCRIPTOR &pfd)
+{
+	// GDI's ChoosePixelFormat() and SetPixelFormat() call into the system opengl32.dll, which doesn't
+	// know about another library's pixel formats.
+
+	REQUIRE_ENTRYPOINT(m_pfnWglChoosePixelFormat);
+	REQUIRE_ENTRYPOINT(m_pfnWglSetPixelFormat);
+
+	int pf{m_pfnWglChoosePixelFormat(hdc, &pfd)};
+	return pf != 0 && m_pfnWglSetPixelFormat(hdc, pf, &pfd);
+}
+
+BOOL OpenGLContext::wglCopyContext(HGLRC hglrcSource, HGLRC hglrcDest, UINT mask)
+{
+	REQUIRE_ENTRYPOINT(m_pfnWglCopyContext);
+	return m_pfnWglCopyContext(hglrcSource, hglrcDest, mask);
+}
+
+HGLRC OpenGLContext::wglCreateContext(HDC hdc)
+{
+	REQUIRE_ENTRYPOINT(m_pfnWglCreateContext);
+
+	return m_pfnWglCreateContext(hdc);
+}
+
+HGLRC OpenGLContext::wglCreateLayerContext(HDC hdc, int iLayerPlane)
+{
+	REQUIRE_ENTRYPOINT(m_pfnWglCreateLayerContext);
+
+	return m_pfnWglCreateLayerContext(hdc, iLayerPlane);
+}
+
+BOOL OpenGLContext::wglDeleteContext(HGLRC hglrc)
+{
+	REQUIRE_ENTRYPOINT(m_pfnWglDeleteContext);
+
+	// Deleting the calling thread's current context makes it not current.
+
+	if (t_currentContext.known && t_currentContext.hRC == hglrc && t_pLoader == m_pLoader)
+	{
+		t_currentContext = CurrentContext{true, nullptr, nullptr};
+		selectDispatch(nullptr, nullptr);
+	}
+
+	forgetContextState(m_pLoader, hglrc);
+	return m_pfnWglDeleteContext(hglrc);
+}
+
+BOOL OpenGLContext::wglDescribeLayerPlane(HDC hdc, int iPixelFormat, int iLayerPlane, UINT nBytes, LPLAYERPLANEDESCRIPTOR plpd)
+{
+	REQUIRE_ENTRYPOINT(m_pfnWglDescribeLayerPlane);
+	return m_pfnWglDescribeLayerPlane(hdc, iPixelFormat, iLayerPlane, nBytes, plpd);
+}
+
+HGLRC OpenGLContext::wglGetCurrentContext()
+{
+	g_currentQueries.fetch_add(1, std::memory_order_relaxed);
+
+	// A context that's tracked as current belongs to the library that made it current.
+
+	if (currentTracking() && t_currentContext.known && (!t_currentContext.hRC || t_pLoader == m_pLoader))
+		return t_currentContext.hRC;
+
+	REQUIRE_ENTRYPOINT(m_pfnWglGetCurrentContext);
+	g_currentQueriesForwarded.fetch_add(1, std::memory_order_relaxed);
+
+	HGLRC hRC{m_pfnWglGetCurrentContext()};
+
+	// The device context can't be assumed to be the same once the rendering context has changed.
+
+	if (hRC != t_currentContext.hRC || (hRC && t_pLoader != m_pLoader))
+	{
+		contextChanged(t_currentContext);
+		t_currentContext.dcKnown = false;
+		selectDispatch(hRC, m_pLoader);
+	}
+
+	t_currentContext.hRC = hRC;
+	t_currentContext.known = true;
+
+	return t_currentContext.hRC;
+}
+
+HDC OpenGLContext::wglGetCurrentDC()
+{
+	g_currentQueries.fetch_add(1, std::memory_order_relaxed);
+
+	if (currentTracking() && t_currentContext.dcKnown)
+		return t_currentContext.hDC;
+
+	REQUIRE_ENTRYPOINT(m_pfnWglGetCurrentDC);
+	g_currentQueriesForwarded.fetch_add(1, std::memory_order_relaxed);
+
+	t_currentContext.hDC = m_pfnWglGetCurrentDC();
+	t_currentContext.dcKnown = true;
+
+	return t_currentContext.hDC;
+}
+
+int OpenGLContext::wglGetLayerPaletteEntries(HDC hdc, int iLayerPlane, int iStart, int cEntries, const COLORREF *pcr)
+{
+	REQUIRE_ENTRYPOINT(m_pfnWglGetLayerPaletteEntries);
+	return m_pfnWglGetLayerPaletteEntries(hdc, iLayerPlane, iStart, cEntries, pcr);
+}
+
+PROC OpenGLContext::wglGetProcAddress(LPCSTR lpszProc)
+{
+	return reinterpret_cast<PROC>(loader().getProcAddress(lpszProc));
+}
+
+BOOL OpenGLContext::wglMakeCurrent(HDC hdc, HGLRC hglrc)
+{
+	// The device context is ignored when releasing the current context.
+
+	if (!hglrc)
+		hdc = nullptr;
+
+	g_makeCurrentCalls.fetch_add(1, std::memory_order_relaxed);
+
+	if (currentTracking() && t_currentContext.known && t_currentContext.dcKnown && t_currentContext.hRC == hglrc && t_currentContext.hDC == hdc && (!hglrc || t_pLoader == m_pLoader))
+		return TRUE;
+
+	REQUIRE_ENTRYPOINT(m_pfnWglMakeCurrent);
+	g_makeCurrentForwarded.fetch_add(1, std::memory_order_relaxed);
+
+	// Deferred texture binds are made before their context stops being current.
+
+	bool changed{t_currentContext.hRC != hglrc || t_pLoader != m_pLoader};
+
+	if (t_currentContext.pTextures && changed)
+		t_currentContext.pTextures->flushBindings();
+
+	BOOL result{m_pfnWglMakeCurrent(hdc, hglrc)};
+
+	// When wglMakeCurrent() fails the thread is left without a current context.
+
+	HGLRC hRC{result ? hglrc : nullptr};
+
+	if (hRC != t_currentContext.hRC || changed)
+		contextChanged(t_currentContext);
+
+	t_currentContext.known = true;
+	t_currentContext.dcKnown = true;
+	t_currentContext.hRC = hRC;
+	t_currentContext.hDC = result ? hdc : nullptr;
+	selectDispatch(hRC, m_pLoader);
+
+	return result;
+}
+
+BOOL OpenGLContext::wglRealizeLayerPalette(HDC hdc, int iLayerPlane, BOOL bRealize)
+{
+	REQUIRE_ENTRYPOINT(m_pfnWglRealizeLayerPalette);
+	return m_pfnWglRealizeLayerPalette(hdc, iLayerPlane, bRealize);
+}
+
+int OpenGLContext::wglSetLayerPaletteEntries(HDC hdc, int iLayerPlane, int iStart, int cEntries, const COLORREF *pcr)
+{
+	REQUIRE_ENTRYPOINT(m_pfnWglSetLayerPaletteEntries);
+	return m_pfnWglSetLayerPaletteEntries(hdc, iLayerPlane, iStart, cEntries, pcr);
+}
+
+BOOL OpenGLContext::wglShareLists(HGLRC hglrc1, HGLRC hglrc2)
+{
+	REQUIRE_ENTRYPOINT(m_pfnWglShareLists);
+	return m_pfnWglShareLists(hglrc1, hglrc2);
+}
+
+BOOL OpenGLContext::SwapBuffers(HDC hdc)
+{
+	// The end of a frame is when layer changes made on other threads take effect on this one.
+
+	if (t_currentContext.known)
+		selectDispatch(t_currentContext.hRC, t_pLoader);
+
+	// Another library presents its own drawables, so GDI's SwapBuffers() can't be used for them.
+
+	if (!loader().system())
+	{
+		REQUIRE_ENTRYPOINT(m_pfnWglSwapBuffers);
+		return m_pfnWglSwapBuffers(hdc);
+	}
+
+	//LOAD_ENTRYPOINT(SwapBuffers, m_pfnSwapBuffers, PFNSWAPBUFFERSPROC);
+	//return m_pfnSwapBuffers(hdc);
+	
+	// WARNING
+	// The above code doesn't work because the SwapBuffers() function is not exported by OpenGL32.dll.
+	// Instead, it's exported by Gdi32.dll. Consequently, we have to use the SwapBuffers() function directly.
+	// This is not a problem because the SwapBuffers() function is a standard Windows function that is always available.
+	
+	return ::SwapBuffers(hdc);
+}
+
+BOOL OpenGLContext::wglSwapLayerBuffers(HDC hdc, UINT fuPlanes)
+{
+	REQUIRE_ENTRYPOINT(m_pfnWglSwapLayerBuffers);
+	return m_pfnWglSwapLayerBuffers(hdc, fuPlanes);
+}
+
+DWORD OpenGLContext::wglSwapMultipleBuffers(UINT count, const WGLSWAP *toSwap)
+{
+	REQUIRE_ENTRYPOINT(m_pfnWglSwapMultipleBuffers);
+	return m_pfnWglSwapMultipleBuffers(count, toSwap);
+}
+
+BOOL OpenGLContext::swapBuffers(UINT count, const HDC *phdc)
+{
+	BOOL result{TRUE};
+
+	if (t_currentContext.known)
+		selectDispatch(t_currentContext.hRC, t_pLoader);
+
+	for (UINT first = 0; first < count; first += WGL_SWAPMULTIPLE_MAX)
+	{
+		UINT batch{std::min<UINT>(count - first, WGL_SWAPMULTIPLE_MAX)};
+		WGLSWAP toSwap[WGL_SWAPMULTIPLE_MAX]{};
+
+		for (UINT i = 0; i < batch; ++i)
+		{
+			toSwap[i].hdc = phdc[first + i];
+			toSwap[i].uiFlags = WGL_SWAP_MAIN_PLANE;
+		}
+
+		// wglSwapMultipleBuffers() sets bit i of its result for each device context that was swapped.
+		// Only the ones it didn't swap are retried, so none of them is presented twice.
+
+		DWORD swapped{batch > 1 ? wglSwapMultipleBuffers(batch, toSwap) : 0};
+
+		for (UINT i = 0; i < batch; ++i)
+		{
+			if ((swapped & (1u << i)) == 0 && !SwapBuffers(toSwap[i].hdc))
+				result = FALSE;
+		}
+	}
+
+	return result;
+}
+
+BOOL OpenGLContext::wglUseFontBitmapsA(HDC hdc, DWORD first, DWORD count, DWORD listBase)
+{
+	REQUIRE_ENTRYPOINT(m_pfnWglUseFontBitmapsA);
+	return m_pfnWglUseFontBitmapsA(hdc, first, count, listBase);
+}
+
+BOOL OpenGLContext::wglUseFontBitmapsW(HDC hdc, DWORD first, DWORD count, DWORD listBase)
+{
+	REQUIRE_ENTRYPOINT(m_pfnWglUseFontBitmapsW);
+	return m_pfnWglUseFontBitmapsW(hdc, first, count, listBase);
+}
+
+BOOL OpenGLContext::wglUseFontOutlinesA(HDC hdc, DWORD first, DWORD count, DWORD listBase, FLOAT deviation, FLOAT extrusion, int format, LPGLYPHMETRICSFLOAT lpgmf)
+{
+	REQUIRE_ENTRYPOINT(m_pfnWglUseFontOutlinesA);
+	return m_pfnWglUseFontOutlinesA(hdc, first, count, listBase, deviation, extrusion, format, lpgmf);
+}
+
+BOOL OpenGLContext::wglUseFontOutlinesW(HDC hdc, DWORD first, DWORD count, DWORD listBase, FLOAT deviation, FLOAT extrusion, int format, LPGLYPHMETRICSFLOAT lpgmf)
+{
+	REQUIRE_ENTRYPOINT(m_pfnWglUseFontOutlinesW);
+	return m_pfnWglUseFontOutlinesW(hdc, first, count, listBase, deviation, extrusion, format, lpgmf);
+}
+
+//
+// GLStateTracker methods
+//
+
+namespace
+{
+	thread_local GLStateTracker *t_pCurrentStateTracker{nullptr};
+}
+
+GLStateTracker *GLStateTracker::current()
+{
+	return t_pCurrentStateTracker;
+}
+
+void GLStateTracker::makeCurrent(GLStateTracker *pTracker)
+{
+	t_pCurrentStateTracker = pTracker;
+}
+
+void GLStateTracker::touchEnum(std::vector<GLenum> &touched, GLenum value)
+{
+	if (std::find(touched.begin(), touched.end(), value) == touched.end())
+		touched.push_back(value);
+}
+
+void GLStateTracker::touchTextureBinding(GLenum target)
+{
+	std::pair<GLenum, GLenum> binding{m_activeTexture, target};
+
+	if (std::find(m_textureBindings.begin(), m_textureBindings.end(), binding) == m_textureBindings.end())
+		m_textureBindings.push_back(binding);
+}
+
+void GLStateTracker::touchActiveTexture(GLenum texture)
+{
+	m_activeTexture = texture;
+	m_dirty |= ActiveTexture;
+}
+
+bool GLStateTracker::dirty() const
+{
+	return m_dirty != 0 || !m_capabilities.empty() || !m_hints.empty() || !m_pixelStore.empty() || !m_textureBindings.empty();
+}
+
+unsigned GLStateTracker::resetToDefaults(GLsizei drawableWidth, GLsizei drawableHeight)
+{
+	unsigned calls{0};
+	auto reset = [&](State state) { return (m_dirty & state) ? (++calls, true) : false; };
+
+	// The GL functions called below report back to this tracker, so suspend it while resetting.
+
+	GLStateTracker *pPrevious{current()};
+	makeCurrent(nullptr);
+
+	if (reset(Viewport)) glViewport(0, 0, drawableWidth, drawableHeight);
+	if (reset(Scissor)) glScissor(0, 0, drawableWidth, drawableHeight);
+	if (reset(ClearColor)) glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	if (reset(ClearDepth)) glClearDepth(1.0);
+	if (reset(ClearStencil)) glClearStencil(0);
+	if (reset(ColorMask)) glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	if (reset(DepthMask)) glDepthMask(GL_TRUE);
+	if (reset(StencilMask)) glStencilMask(~0u);
+	if (reset(BlendFunc)) glBlendFunc(GL_ONE, GL_ZERO);
+	if (reset(DepthFunc)) glDepthFunc(GL_LESS);
+	if (reset(DepthRange)) glDepthRange(0.0, 1.0);
+	if (reset(StencilFunc)) glStencilFunc(GL_ALWAYS, 0, ~0u);
+	if (reset(StencilOp)) glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+	if (reset(CullFace)) glCullFace(GL_BACK);
+	if (reset(FrontFace)) glFrontFace(GL_CCW);
+	if (reset(PolygonMode)) glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+	if (reset(PolygonOffset)) glPolygonOffset(0.0f, 0.0f);
+	if (reset(LineWidth)) glLineWidth(1.0f);
+	if (reset(PointSize)) glPointSize(1.0f);
+	if (reset(LogicOp)) glLogicOp(GL_COPY);
+	if (reset(DrawBuffer)) glDrawBuffer(GL_BACK);
+	if (reset(ReadBuffer)) glReadBuffer(GL_BACK);
+
+	// GL_DITHER and GL_MULTISAMPLE are the only capabilities that are enabled by default.
+
+	for (GLenum cap : m_capabilities)
+	{
+		if (cap == GL_DITHER || cap == GL_MULTISAMPLE)
+			glEnable(cap);
+		else
+			glDisable(cap);
+	}
+
+	for (GLenum target : m_hints)
+		glHint(target, GL_DONT_CARE);
+
+	for (GLenum pname : m_pixelStore)
+		glPixelStorei(pname, (pname == GL_PACK_ALIGNMENT || pname == GL_UNPACK_ALIGNMENT) ? 4 : 0);
+
+	calls += static_cast<unsigned>(m_capabilities.size() + m_hints.size() + m_pixelStore.size() + m_textureBindings.size());
+
+	// Bindings are reset a unit at a time, and the active unit is left at GL_TEXTURE0.
+
+	std::sort(m_textureBindings.begin(), m_textureBindings.end());
+
+	GLenum activeTexture{m_activeTexture};
+
+	for (auto [unit, target] : m_textureBindings)
+	{
+		if (unit != activeTexture)
+		{
+			glActiveTexture(unit);
+			activeTexture = unit;
+			++calls;
+		}
+
+		glBindTexture(target, 0);
+	}
+
+	if (activeTexture != GL_TEXTURE0)
+	{
+		glActiveTexture(GL_TEXTURE0);
+		++calls;
+	}
+
+	m_dirty = 0;
+	m_capabilities.clear();
+	m_hints.clear();
+	m_pixelStore.clear();
+	m_textureBindings.clear();
+	m_activeTexture = GL_TEXTURE0;
+
+	makeCurrent(pPrevious);
+	return calls;
+}
+
+namespace
+{
+	// Counts a glTexParameter*() call and returns false if the texture shadow drops it.
+
+	bool forwardTexParameter(GLenum target, GLenum pname, GLfloat param)
+	{
+		g_textureParameterCalls.fetch_add(1, std::memory_order_relaxed);
+
+		TextureShadow *pTextures{currentTextures()};
+
+		if (pTextures && !pTextures->setParameter(target, pname, param))
+			return false;
+
+		if (pTextures)
+			pTextures->flushBindings();
+
+		g_textureParameterCallsForwarded.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	// Make any deferred texture binds and unit change before a call that uses the bindings or the active
+	// unit, such as glTexImage2D() or glEnable(GL_TEXTURE_2D). They're only deferred once the current
+	// context's texture shadow has been looked up, and they're made before it stops being current, so
+	// this doesn't look anything up.
+
+	void flushTextureBindings()
+	{
+		if (TextureShadow *pTextures{t_currentContext.pTextures})
+			pTextures->flushBindings();
+	}
+
+	void prepareDraw()
+	{
+		if (TextureShadow *pTextures{currentTextures()})
+			pTextures->prepareDraw();
+	}
+
+	// Counts a direct state access call and returns the current context's functions if it has them, or
+	// null if the call has to be emulated or forwarded with untrackedFunction().
+
+	const ContextFunctions *directStateAccess()
+	{
+		g_directStateAccessCalls.fetch_add(1, std::memory_order_relaxed);
+
+		const ContextFunctions *pFunctions{currentFunctions()};
+
+		if (pFunctions && pFunctions->directStateAccess)
+			return pFunctions;
+
+		return nullptr;
+	}
+
+	// As above, for a call on a texture. A deferred bind may not have created it in the driver yet.
+
+	const ContextFunctions *directStateAccess(GLuint texture)
+	{
+		const ContextFunctions *pFunctions{directStateAccess()};
+
+		if (TextureShadow *pTextures{t_currentContext.pTextures}; pFunctions && pTextures)
+			pTextures->prepareEdit(texture);
+
+		return pFunctions;
+	}
+
+	// Counts a glTextureParameter*() call and returns false if the texture shadow drops it.
+
+	bool forwardTextureParameter(GLuint texture, GLenum pname, GLfloat param)
+	{
+		g_textureParameterCalls.fetch_add(1, std::memory_order_relaxed);
+
+		if (TextureShadow *pTextures{currentTextures()}; pTextures && !pTextures->setTextureParameter(texture, pname, param))
+			return false;
+
+		g_textureParameterCallsForwarded.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	// A function of a context made current behind the loader's back, looked up on every call as
+	// glActiveTexture() does. Null if the current context is known or the driver doesn't export it.
+
+	template <typename Function>
+	Function untrackedFunction(unsigned symbol)
+	{
+		if (t_currentContext.known)
+			return nullptr;
+
+		return reinterpret_cast<Function>(currentLoader().getProcAddress(symbol));
+	}
+
+	// Binds a texture to its target on the active unit while a bind-to-edit function stands in for a
+	// direct state access one, and puts the driver's binding back afterwards. target is zero if the
+	// texture's target isn't known, because it has never been bound or the current context isn't known,
+	// and GL_INVALID_OPERATION has been raised instead.
+
+	struct TextureEdit
+	{
+		explicit TextureEdit(GLuint texture) : pTextures{currentTextures()}
+		{
+			g_directStateAccessEmulated.fetch_add(1, std::memory_order_relaxed);
+			target = pTextures ? pTextures->beginEdit(texture) : 0;
+
+			if (!target)
+				raiseError(GL_INVALID_OPERATION);
+		}
+
+		~TextureEdit()
+		{
+			if (target)
+				pTextures->endEdit();
+		}
+
+		TextureEdit(const TextureEdit &) = delete;
+		TextureEdit &operator=(const TextureEdit &) = delete;
+
+		TextureShadow *pTextures;
+		GLenum target{};
+	};
+}
+
+//
+// GL_VERSION_1_0
+//
+
+void glCullFace(GLenum mode)
+{
+	TRACK_STATE(touch(GLStateTracker::CullFace));
+	DISPATCH(glCullFace)(mode);
+}
+
+void glFrontFace(GLenum mode)
+{
+	TRACK_STATE(touch(GLStateTracker::FrontFace));
+	DISPATCH(glFrontFace)(mode);
+}
+
+void glHint(GLenum target, GLenum mode)
+{
+	TRACK_STATE(touchHint(target));
+	DISPATCH(glHint)(target, mode);
+}
+
+void glLineWidth(GLfloat width)
+{
+	TRACK_STATE(touch(GLStateTracker::LineWidth));
+	DISPATCH(glLineWidth)(width);
+}
+
+void glPointSize(GLfloat size)
+{
+	TRACK_STATE(touch(GLStateTracker::PointSize));
+	DISPATCH(glPointSize)(size);
+}
+
+void glPolygonMode(GLenum face, GLenum mode)
+{
+	TRACK_STATE(touch(GLStateTracker::PolygonMode));
+	DISPATCH(glPolygonMode)(face, mode);
+}
+
+void glScissor(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	TRACK_STATE(touch(GLStateTracker::Scissor));
+	DISPATCH(glScissor)(x, y, width, height);
+}
+
+void glTexParameterf(GLenum target, GLenum pname, GLfloat param)
+{
+	if (forwardTexParameter(target, pname, param))
+		DISPATCH(glTexParameterf)(target, pname, param);
+}
+
+void glTexParameterfv(GLenum target, GLenum pname, const GLfloat* params)
+{
+	if (!params || forwardTexParameter(target, pname, params[0]))
+		DISPATCH(glTexParameterfv)(target, pname, params);
+}
+
+void glTexParameteri(GLenum target, GLenum pname, GLint param)
+{
+	if (forwardTexParameter(target, pname, static_cast<GLfloat>(param)))
+		DISPATCH(glTexParameteri)(target, pname, param);
+}
+
+void glTexParameteriv(GLenum target, GLenum pname, const GLint* params)
+{
+	if (!params || forwardTexParameter(target, pname, static_cast<GLfloat>(params[0])))
+		DISPATCH(glTexParameteriv)(target, pname, params);
+}
+
+void glTexImage1D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLint border, GLenum format, GLenum type, const void* pixels)
+{
+	flushTextureBindings();
+	DISPATCH(glTexImage1D)(target, level, internalformat, width, border, format, type, pixels);
+}
+
+void glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels)
+{
+	flushTextureBindings();
+	DISPATCH(glTexImage2D)(target, level, internalformat, width, height, border, format, type, pixels);
+}
+
+void glDrawBuffer(GLenum buf)
+{
+	TRACK_STATE(touch(GLStateTracker::DrawBuffer));
+	DISPATCH(glDrawBuffer)(buf);
+}
+
+void glClear(GLbitfield mask)
+{
+	DISPATCH(glClear)(mask);
+}
+
+void glClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+	TRACK_STATE(touch(GLStateTracker::ClearColor));
+	DISPATCH(glClearColor)(red, green, blue, alpha);
+}
+
+void glClearStencil(GLint s)
+{
+	TRACK_STATE(touch(GLStateTracker::ClearStencil));
+	DISPATCH(glClearStencil)(s);
+}
+
+void glClearDepth(GLdouble depth)
+{
+	TRACK_STATE(touch(GLStateTracker::ClearDepth));
+	DISPATCH(glClearDepth)(depth);
+}
+
+void glStencilMask(GLuint mask)
+{
+	TRACK_STATE(touch(GLStateTracker::StencilMask));
+	DISPATCH(glStencilMask)(mask);
+}
+
+void glColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
+{
+	TRACK_STATE(touch(GLStateTracker::ColorMask));
+	DISPATCH(glColorMask)(red, green, blue, alpha);
+}
+
+void glDepthMask(GLboolean flag)
+{
+	TRACK_STATE(touch(GLStateTracker::DepthMask));
+	DISPATCH(glDepthMask)(flag);
+}
+
+void glDisable(GLenum cap)
+{
+	flushTextureBindings();
+	TRACK_STATE(touchCapability(cap));
+	DISPATCH(glDisable)(cap);
+}
+
+void glEnable(GLenum cap)
+{
+	flushTextureBindings();
+	TRACK_STATE(touchCapability(cap));
+	DISPATCH(glEnable)(cap);
+}
+
+void glFinish(void)
+{
+	DISPATCH(glFinish)();
+}
+
+void glFlush(void)
+{
+	DISPATCH(glFlush)();
+}
+
+void glBlendFunc(GLenum sfactor, GLenum dfactor)
+{
+	TRACK_STATE(touch(GLStateTracker::BlendFunc));
+	DISPATCH(glBlendFunc)(sfactor, dfactor);
+}
+
+void glLogicOp(GLenum opcode)
+{
+	TRACK_STATE(touch(GLStateTracker::LogicOp));
+	DISPATCH(glLogicOp)(opcode);
+}
+
+void glStencilFunc(GLenum func, GLint ref, GLuint mask)
+{
+	TRACK_STATE(touch(GLStateTracker::StencilFunc));
+	DISPATCH(glStencilFunc)(func, ref, mask);
+}
+
+void glStencilOp(GLenum fail, GLenum zfail, GLenum zpass)
+{
+	TRACK_STATE(touch(GLStateTracker::StencilOp));
+	DISPATCH(glStencilOp)(fail, zfail, zpass);
+}
+
+void glDepthFunc(GLenum func)
+{
+	TRACK_STATE(touch(GLStateTracker::DepthFunc));
+	DISPATCH(glDepthFunc)(func);
+}
+
+void glPixelStoref(GLenum pname, GLfloat param)
+{
+	TRACK_STATE(touchPixelStore(pname));
+	DISPATCH(glPixelStoref)(pname, param);
+}
+
+void glPixelStorei(GLenum pname, GLint param)
+{
+	TRACK_STATE(touchPixelStore(pname));
+	DISPATCH(glPixelStorei)(pname, param);
+}
+
+void glReadBuffer(GLenum src)
+{
+	TRACK_STATE(touch(GLStateTracker::ReadBuffer));
+	DISPATCH(glReadBuffer)(src);
+}
+
+void glReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels)
+{
+	DISPATCH(glReadPixels)(x, y, width, height, format, type, pixels);
+}
+
+void glGetBooleanv(GLenum pname, GLboolean* data)
+{
+	flushTextureBindings();
+	DISPATCH(glGetBooleanv)(pname, data);
+}
+
+void glGetDoublev(GLenum pname, GLdouble* data)
+{
+	flushTextureBindings();
+	DISPATCH(glGetDoublev)(pname, data);
+}
+
+GLenum glGetError(void)
+{
+	if (GLenum error{t_currentContext.error}; error != GL_NO_ERROR)
+	{
+		t_currentContext.error = GL_NO_ERROR;
+		return error;
+	}
+
+	return DISPATCH(glGetError)();
+}
+
+void glGetFloatv(GLenum pname, GLfloat* data)
+{
+	flushTextureBindings();
+	DISPATCH(glGetFloatv)(pname, data);
+}
+
+void glGetIntegerv(GLenum pname, GLint* data)
+{
+	flushTextureBindings();
+	DISPATCH(glGetIntegerv)(pname, data);
+}
+
+const GLubyte* glGetString(GLenum name)
+{
+	return DISPATCH(glGetString)(name);
+}
+
+void glGetTexImage(GLenum target, GLint level, GLenum format, GLenum type, void* pixels)
+{
+	flushTextureBindings();
+	DISPATCH(glGetTexImage)(target, level, format, type, pixels);
+}
+
+void glGetTexParameterfv(GLenum target, GLenum pname, GLfloat* params)
+{
+	// A texture that a sampler object stands in for doesn't have its parameters itself.
+
+	GLfloat value{};
+
+	if (TextureShadow *pTextures{currentTextures()}; params && pTextures && pTextures->getParameter(target, pname, value))
+	{
+		params[0] = value;
+	}
+	else
+	{
+		flushTextureBindings();
+		DISPATCH(glGetTexParameterfv)(target, pname, params);
+	}
+}
+
+void glGetTexParameteriv(GLenum target, GLenum pname, GLint* params)
+{
+	GLfloat value{};
+
+	if (TextureShadow *pTextures{currentTextures()}; params && pTextures && pTextures->getParameter(target, pname, value))
+	{
+		params[0] = static_cast<GLint>(std::lround(value));
+	}
+	else
+	{
+		flushTextureBindings();
+		DISPATCH(glGetTexParameteriv)(target, pname, params);
+	}
+}
+
+void glGetTexLevelParameterfv(GLenum target, GLint level, GLenum pname, GLfloat* params)
+{
+	flushTextureBindings();
+	DISPATCH(glGetTexLevelParameterfv)(target, level, pname, params);
+}
+
+void glGetTexLevelParameteriv(GLenum target, GLint level, GLenum pname, GLint* params)
+{
+	flushTextureBindings();
+	DISPATCH(glGetTexLevelParameteriv)(target, level, pname, params);
+}
+
+GLboolean glIsEnabled(GLenum cap)
+{
+	flushTextureBindings();
+	return DISPATCH(glIsEnabled)(cap);
+}
+
+void glDepthRange(GLdouble n, GLdouble f)
+{
+	TRACK_STATE(touch(GLStateTracker::DepthRange));
+	DISPATCH(glDepthRange)(n, f);
+}
+
+void glViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	TRACK_STATE(touch(GLStateTracker::Viewport));
+	DISPATCH(glViewport)(x, y, width, height);
+}
+
+//
+// GL_VERSION_1_1
+//
+
+void glDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+	prepareDraw();
+	DISPATCH(glDrawArrays)(mode, first, count);
+}
+
+void glDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+	prepareDraw();
+	DISPATCH(glDrawElements)(mode, count, type, indices);
+}
+
+void glGetPointerv(GLenum pname, void** params)
+{
+	DISPATCH(glGetPointerv)(pname, params);
+}
+
+void glPolygonOffset(GLfloat factor, GLfloat units)
+{
+	TRACK_STATE(touch(GLStateTracker::PolygonOffset));
+	DISPATCH(glPolygonOffset)(factor, units);
+}
+
+void glCopyTexImage1D(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLint border)
+{
+	flushTextureBindings();
+	DISPATCH(glCopyTexImage1D)(target, level, internalformat, x, y, width, border);
+}
+
+void glCopyTexImage2D(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLsizei height, GLint border)
+{
+	flushTextureBindings();
+	DISPATCH(glCopyTexImage2D)(target, level, internalformat, x, y, width, height, border);
+}
+
+void glCopyTexSubImage1D(GLenum target, GLint level, GLint xoffset, GLint x, GLint y, GLsizei width)
+{
+	flushTextureBindings();
+	DISPATCH(glCopyTexSubImage1D)(target, level, xoffset, x, y, width);
+}
+
+void glCopyTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	flushTextureBindings();
+	DISPATCH(glCopyTexSubImage2D)(target, level, xoffset, yoffset, x, y, width, height);
+}
+
+void glTexSubImage1D(GLenum target, GLint level, GLint xoffset, GLsizei width, GLenum format, GLenum type, const void* pixels)
+{
+	flushTextureBindings();
+	DISPATCH(glTexSubImage1D)(target, level, xoffset, width, format, type, pixels);
+}
+
+void glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels)
+{
+	flushTextureBindings();
+	DISPATCH(glTexSubImage2D)(target, level, xoffset, yoffset, width, height, format, type, pixels);
+}
+
+void glBindTexture(GLenum target, GLuint texture)
+{
+	TRACK_STATE(touchTextureBinding(target));
+	g_textureBindCalls.fetch_add(1, std::memory_order_relaxed);
+
+	if (TextureShadow *pTextures{currentTextures()}; pTextures && !pTextures->bind(target, texture))
+		return;
+
+	g_textureBindsForwarded.fetch_add(1, std::memory_order_relaxed);
+	DISPATCH(glBindTexture)(target, texture);
+}
+
+void glDeleteTextures(GLsizei n, const GLuint* textures)
+{
+	flushTextureBindings();
+	DISPATCH(glDeleteTextures)(n, textures);
+
+	if (TextureShadow *pTextures{currentTextures()})
+		pTextures->deleted(n, textures);
+}
+
+void glGenTextures(GLsizei n, GLuint* textures)
+{
+	DISPATCH(glGenTextures)(n, textures);
+
+	if (TextureShadow *pTextures{currentTextures()})
+		pTextures->generated(n, textures);
+}
+
+GLboolean glIsTexture(GLuint texture)
+{
+	// A generated name isn't a texture until it's first bound, but an emulated glCreateTextures() one
+	// is straight away.
+
+	if (TextureShadow *pTextures{currentTextures()}; pTextures && pTextures->hasTarget(texture))
+		return GL_TRUE;
+
+	flushTextureBindings();
+	return DISPATCH(glIsTexture)(texture);
+}
+
+//
+// GL_VERSION_1_3
+//
+
+void glActiveTexture(GLenum texture)
+{
+	TRACK_STATE(touchActiveTexture(texture));
+	g_activeTextureCalls.fetch_add(1, std::memory_order_relaxed);
+
+	if (TextureShadow *pTextures{currentTextures()}; pTextures && !pTextures->selectUnit(texture))
+		return;
+
+	// opengl32.dll doesn't export it, so it's looked up with the current context. If the context isn't
+	// known it's looked up on every call.
+
+	const ContextFunctions *pFunctions{currentFunctions()};
+	PFNGLACTIVETEXTUREPROC pfnActiveTexture{pFunctions ? pFunctions->glActiveTexture : nullptr};
+
+	if (!t_currentContext.known)
+		pfnActiveTexture = reinterpret_cast<PFNGLACTIVETEXTUREPROC>(currentLoader().getProcAddress(Symbol::glActiveTexture));
+
+	if (pfnActiveTexture)
+	{
+		g_activeTexturesForwarded.fetch_add(1, std::memory_order_relaxed);
+		pfnActiveTexture(texture);
+	}
+}
+
+//
+// GL_VERSION_1_5
+//
+
+// These are only exported so that the buffer bound to the target glNamedBufferSubData() is emulated
+// with is known. Like glActiveTexture() they're looked up with the current context, or on every call
+// if it isn't known.
+
+void glBindBuffer(GLenum target, GLuint buffer)
+{
+	const ContextFunctions *pFunctions{currentFunctions()};
+	PFNGLBINDBUFFERPROC pfnBindBuffer{pFunctions ? pFunctions->glBindBuffer : nullptr};
+
+	if (!t_currentContext.known)
+		pfnBindBuffer = reinterpret_cast<PFNGLBINDBUFFERPROC>(currentLoader().getProcAddress(Symbol::glBindBuffer));
+
+	if (BufferShadow *pBuffers{currentBuffers()}; pBuffers && pFunctions && target == pFunctions->bufferEditTarget)
+		pBuffers->bound = buffer;
+
+	if (pfnBindBuffer)
+		pfnBindBuffer(target, buffer);
+}
+
+void glDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+	const ContextFunctions *pFunctions{currentFunctions()};
+	PFNGLDELETEBUFFERSPROC pfnDeleteBuffers{pFunctions ? pFunctions->glDeleteBuffers : nullptr};
+
+	if (!t_currentContext.known)
+		pfnDeleteBuffers = reinterpret_cast<PFNGLDELETEBUFFERSPROC>(currentLoader().getProcAddress(Symbol::glDeleteBuffers));
+
+	// Deleting a bound buffer binds zero in its place.
+
+	if (BufferShadow *pBuffers{currentBuffers()})
+	{
+		for (GLsizei i = 0; buffers && i < n; ++i)
+		{
+			if (buffers[i] == pBuffers->bound)
+				pBuffers->bound = 0;
+		}
+	}
+
+	if (pfnDeleteBuffers)
+		pfnDeleteBuffers(n, buffers);
+}
+
+//
+// GL_VERSION_4_5
+//
+
+// Without direct state access these bind the object they're given, make the bind-to-edit call, and
+// put the binding back from the shadowed state.
+
+void glTextureParameterf(GLuint texture, GLenum pname, GLfloat param)
+{
+	if (!forwardTextureParameter(texture, pname, param))
+		return;
+
+	if (const ContextFunctions *pFunctions{directStateAccess(texture)})
+		pFunctions->glTextureParameterf(texture, pname, param);
+	else if (auto pfnTextureParameterf{untrackedFunction<PFNGLTEXTUREPARAMETERFPROC>(Symbol::glTextureParameterf)})
+		pfnTextureParameterf(texture, pname, param);
+	else if (TextureEdit edit{texture}; edit.target)
+		DISPATCH(glTexParameterf)(edit.target, pname, param);
+}
+
+void glTextureParameterfv(GLuint texture, GLenum pname, const GLfloat* params)
+{
+	if (params && !forwardTextureParameter(texture, pname, params[0]))
+		return;
+
+	if (const ContextFunctions *pFunctions{directStateAccess(texture)})
+		pFunctions->glTextureParameterfv(texture, pname, params);
+	else if (auto pfnTextureParameterfv{untrackedFunction<PFNGLTEXTUREPARAMETERFVPROC>(Symbol::glTextureParameterfv)})
+		pfnTextureParameterfv(texture, pname, params);
+	else if (TextureEdit edit{texture}; edit.target)
+		DISPATCH(glTexParameterfv)(edit.target, pname, params);
+}
+
+void glTextureParameteri(GLuint texture, GLenum pname, GLint param)
+{
+	if (!forwardTextureParameter(texture, pname, static_cast<GLfloat>(param)))
+		return;
+
+	if (const ContextFunctions *pFunctions{directStateAccess(texture)})
+		pFunctions->glTextureParameteri(texture, pname, param);
+	else if (auto pfnTextureParameteri{untrackedFunction<PFNGLTEXTUREPARAMETERIPROC>(Symbol::glTextureParameteri)})
+		pfnTextureParameteri(texture, pname, param);
+	else if (TextureEdit edit{texture}; edit.target)
+		DISPATCH(glTexParameteri)(edit.target, pname, param);
+}
+
+void glTextureParameteriv(GLuint texture, GLenum pname, const GLint* params)
+{
+	if (params && !forwardTextureParameter(texture, pname, static_cast<GLfloat>(params[0])))
+		return;
+
+	if (const ContextFunctions *pFunctions{directStateAccess(texture)})
+		pFunctions->glTextureParameteriv(texture, pname, params);
+	else if (auto pfnTextureParameteriv{untrackedFunction<PFNGLTEXTUREPARAMETERIVPROC>(Symbol::glTextureParameteriv)})
+		pfnTextureParameteriv(texture, pname, params);
+	else if (TextureEdit edit{texture}; edit.target)
+		DISPATCH(glTexParameteriv)(edit.target, pname, params);
+}
+
+void glCreateTextures(GLenum target, GLsizei n, GLuint* textures)
+{
+	unsigned index{textureTarget(target)};
+	TextureShadow *pTextures{currentTextures()};
+	const ContextFunctions *pFunctions{directStateAccess()};
+
+	if (pFunctions)
+	{
+		pFunctions->glCreateTextures(target, n, textures);
+	}
+	else if (auto pfnCreateTextures{untrackedFunction<PFNGLCREATETEXTURESPROC>(Symbol::glCreateTextures)})
+	{
+		pfnCreateTextures(target, n, textures);
+	}
+	else if (!pTextures)
+	{
+		raiseError(GL_INVALID_OPERATION);
+		return;
+	}
+	else if (index == kTextureTargetCount || n < 0)
+	{
+		raiseError(index == kTextureTargetCount ? GL_INVALID_ENUM : GL_INVALID_VALUE);
+		return;
+	}
+	else
+	{
+		// The names are generated now, and the driver creates the textures when they're first bound.
+
+		g_directStateAccessEmulated.fetch_add(1, std::memory_order_relaxed);
+		DISPATCH(glGenTextures)(n, textures);
+	}
+
+	// The driver rejects an unknown target without generating anything.
+
+	if (pTextures && index != kTextureTargetCount)
+		pTextures->created(index, n, textures, pFunctions != nullptr);
+}
+
+void glGetTextureParameterfv(GLuint texture, GLenum pname, GLfloat* params)
+{
+	GLfloat value{};
+
+	if (TextureShadow *pTextures{currentTextures()}; params && pTextures && pTextures->getTextureParameter(texture, pname, value))
+		params[0] = value;
+	else if (const ContextFunctions *pFunctions{directStateAccess(texture)})
+		pFunctions->glGetTextureParameterfv(texture, pname, params);
+	else if (auto pfnGetTextureParameterfv{untrackedFunction<PFNGLGETTEXTUREPARAMETERFVPROC>(Symbol::glGetTextureParameterfv)})
+		pfnGetTextureParameterfv(texture, pname, params);
+	else if (TextureEdit edit{texture}; edit.target)
+		DISPATCH(glGetTexParameterfv)(edit.target, pname, params);
+}
+
+void glGetTextureParameteriv(GLuint texture, GLenum pname, GLint* params)
+{
+	GLfloat value{};
+
+	if (TextureShadow *pTextures{currentTextures()}; params && pTextures && pTextures->getTextureParameter(texture, pname, value))
+		params[0] = static_cast<GLint>(std::lround(value));
+	else if (const ContextFunctions *pFunctions{directStateAccess(texture)})
+		pFunctions->glGetTextureParameteriv(texture, pname, params);
+	else if (auto pfnGetTextureParameteriv{untrackedFunction<PFNGLGETTEXTUREPARAMETERIVPROC>(Symbol::glGetTextureParameteriv)})
+		pfnGetTextureParameteriv(texture, pname, params);
+	else if (TextureEdit edit{texture}; edit.target)
+		DISPATCH(glGetTexParameteriv)(edit.target, pname, params);
+}
+
+void glTextureSubImage1D(GLuint texture, GLint level, GLint xoffset, GLsizei width, GLenum format, GLenum type, const void* pixels)
+{
+	if (const ContextFunctions *pFunctions{directStateAccess(texture)})
+		pFunctions->glTextureSubImage1D(texture, level, xoffset, width, format, type, pixels);
+	else if (auto pfnTextureSubImage1D{untrackedFunction<PFNGLTEXTURESUBIMAGE1DPROC>(Symbol::glTextureSubImage1D)})
+		pfnTextureSubImage1D(texture, level, xoffset, width, format, type, pixels);
+	else if (TextureEdit edit{texture}; edit.target)
+		DISPATCH(glTexSubImage1D)(edit.target, level, xoffset, width, format, type, pixels);
+}
+
+void glTextureSubImage2D(GLuint texture, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels)
+{
+	if (const ContextFunctions *pFunctions{directStateAccess(texture)})
+		pFunctions->glTextureSubImage2D(texture, level, xoffset, yoffset, width, height, format, type, pixels);
+	else if (auto pfnTextureSubImage2D{untrackedFunction<PFNGLTEXTURESUBIMAGE2DPROC>(Symbol::glTextureSubImage2D)})
+		pfnTextureSubImage2D(texture, level, xoffset, yoffset, width, height, format, type, pixels);
+	else if (TextureEdit edit{texture}; edit.target)
+		DISPATCH(glTexSubImage2D)(edit.target, level, xoffset, yoffset, width, height, format, type, pixels);
+}
+
+void glNamedBufferSubData(GLuint buffer, GLintptr offset, GLsizeiptr size, const void* data)
+{
+	if (const ContextFunctions *pFunctions{directStateAccess()})
+	{
+		pFunctions->glNamedBufferSubData(buffer, offset, size, data);
+		return;
+	}
+
+	if (auto pfnNamedBufferSubData{untrackedFunction<PFNGLNAMEDBUFFERSUBDATAPROC>(Symbol::glNamedBufferSubData)})
+	{
+		pfnNamedBufferSubData(buffer, offset, size, data);
+		return;
+	}
+
+	// Buffers are bound and restored straight away. Unlike textures, nothing else would make the restore.
+
+	g_directStateAccessEmulated.fetch_add(1, std::memory_order_relaxed);
+
+	const ContextFunctions *pFunctions{currentFunctions()};
+	BufferShadow *pBuffers{currentBuffers()};
+
+	if (!pFunctions || !pBuffers || !pFunctions->glBindBuffer || !pFunctions->glBufferSubData)
+	{
+		raiseError(GL_INVALID_OPERATION);
+		return;
+	}
+
+	if (pBuffers->bound != buffer)
+	{
+		pFunctions->glBindBuffer(pFunctions->bufferEditTarget, buffer);
+		g_editBinds.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	pFunctions->glBufferSubData(pFunctions->bufferEditTarget, offset, size, data);
+
+	if (pBuffers->bound != buffer)
+	{
+		pFunctions->glBindBuffer(pFunctions->bufferEditTarget, pBuffers->bound);
+		g_editBinds.fetch_add(1, std::memory_order_relaxed);
+	}
 }
\ No newline at end of file
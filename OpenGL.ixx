@@ -1,179 +1,736 @@
-// Copyright (c) 2024 dhpoware. All Rights Reserved.
-//
-// Permission is hereby granted, free of charge, to any person obtaining a
-// copy of this software and associated documentation files (the "Software"),
-// to deal in the Software without restriction, including without limitation
-// the rights to use, copy, modify, merge, publish, distribute, sublicense,
-// and/or sell copies of the Software, and to permit persons to whom the
-// Software is furnished to do so, subject to the following conditions:
-//
-// The above copyright notice and this permission notice shall be included in
-// all copies or substantial portions of the Software.
-//
-// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
-// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
-// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
-// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
-// IN THE SOFTWARE.
-
-module;
-
-#include <windows.h>
-#include <GL/glcorearb.h>
-#include <memory>
-
-export module OpenGL;
-
-// The OpenGLContext class is a wrapper around the WGL API in opengl32.dll.
-// It provides a way to create an OpenGL rendering context for a window.
-// The class contains replacements for all the WGL functions in opengl32.dll.
-// These methods have the same signatures as the WGL functions as defined in wingdi.h.
-// They even have the same spelling as the WGL functions.
-// These methods forward the calls to the real WGL functions in opengl32.dll at runtime.
-// This means that the OpenGLContext class can be used as a drop-in replacement for the WGL API.
-// Since the real WGL functions are loaded dynamically at runtime, there is no need to statically link to opengl32.lib.
-
-export class OpenGLContext
-{
-public:
-	// Create an OpenGL rendering context for a window.	
-	
-	static std::shared_ptr<OpenGLContext> createForWindow(HWND hWnd, PIXELFORMATDESCRIPTOR &pfd);
-
-	// The following methods are replacements for the WGL functions in opengl32.dll:
-
-	BOOL wglCopyContext(HGLRC hglrcSource, HGLRC hglrcDest, UINT mask);
-	HGLRC wglCreateContext(HDC hdc);
-	HGLRC wglCreateLayerContext(HDC hdc, int iLayerPlane);
-	BOOL wglDeleteContext(HGLRC hglrc);
-	BOOL wglDescribeLayerPlane(HDC hdc, int iPixelFormat, int iLayerPlane, UINT nBytes, LPLAYERPLANEDESCRIPTOR plpd);
-	HGLRC wglGetCurrentContext();
-	HDC wglGetCurrentDC();
-	int wglGetLayerPaletteEntries(HDC hdc, int iLayerPlane, int iStart, int cEntries, const COLORREF *pcr);
-	PROC wglGetProcAddress(LPCSTR lpszProc);
-	BOOL wglMakeCurrent(HDC hdc, HGLRC hglrc);
-	BOOL wglRealizeLayerPalette(HDC hdc, int iLayerPlane, BOOL bRealize);
-	int wglSetLayerPaletteEntries(HDC hdc, int iLayerPlane, int iStart, int cEntries, const COLORREF *pcr);
-	BOOL wglShareLists(HGLRC hglrc1, HGLRC hglrc2);
-	BOOL SwapBuffers(HDC hdc);
-	BOOL wglSwapLayerBuffers(HDC hdc, UINT fuPlanes);
-	DWORD wglSwapMultipleBuffers(UINT count, const WGLSWAP *toSwap);
-	BOOL wglUseFontBitmapsA(HDC hdc, DWORD first, DWORD count, DWORD listBase);
-	BOOL wglUseFontBitmapsW(HDC hdc, DWORD first, DWORD count, DWORD listBase);
-	BOOL wglUseFontOutlinesA(HDC hdc, DWORD first, DWORD count, DWORD listBase, FLOAT deviation, FLOAT extrusion, int format, LPGLYPHMETRICSFLOAT lpgmf);
-	BOOL wglUseFontOutlinesW(HDC hdc, DWORD first, DWORD count, DWORD listBase, FLOAT deviation, FLOAT extrusion, int format, LPGLYPHMETRICSFLOAT lpgmf);
-
-private:
-	using PFNWGLCOPYCONTEXTPROC = BOOL(WINAPI*)(HGLRC hglrcSource, HGLRC hglrcDest, UINT mask);
-	using PFNWGLCREATECONTEXTPROC = HGLRC(WINAPI*)(HDC hdc);
-	using PFNWGLCREATELAYERCONTEXTPROC = HGLRC(WINAPI*)(HDC hdc, int iLayerPlane);
-	using PFNWGLDELETECONTEXTPROC = BOOL(WINAPI*)(HGLRC hglrc);
-	using PFNWGLDESCRIBELAYERPLANEPROC = BOOL(WINAPI*)(HDC hdc, int iPixelFormat, int iLayerPlane, UINT nBytes, LPLAYERPLANEDESCRIPTOR plpd);
-	using PFNWGLGETCURRENTCONTEXTPROC = HGLRC(WINAPI*)(VOID);
-	using PFNWGLGETCURRENTDCPROC = HDC(WINAPI*)(VOID);
-	using PFNWGLGETLAYERPALETTEENTRIESPROC = int(WINAPI*)(HDC hdc, int iLayerPlane, int iStart, int cEntries, const COLORREF* pcr);
-	using PFNWGLMAKECURRENTPROC = BOOL(WINAPI*)(HDC hdc, HGLRC hglrc);
-	using PFNWGLREALIZELAYERPALETTEPROC = BOOL(WINAPI*)(HDC hdc, int iLayerPlane, BOOL bRealize);
-	using PFNWGLSETLAYERPALETTEENTRIESPROC = int(WINAPI*)(HDC hdc, int iLayerPlane, int iStart, int cEntries, const COLORREF* pcr);
-	using PFNWGLSHARELISTSPROC = BOOL(WINAPI*)(HGLRC hglrc1, HGLRC hglrc2);
-	using PFNWGLSWAPLAYERBUFFERSPROC = BOOL(WINAPI*)(HDC hdc, UINT fuPlanes);
-	using PFNWGLSWAPMULTIPLEBUFFERSPROC = DWORD(WINAPI*)(UINT count, const WGLSWAP* toSwap);
-	using PFNWGLUSEFONTBITMAPSPROC = BOOL(WINAPI*)(HDC hdc, DWORD first, DWORD count, DWORD listBase);
-	using PFNWGLUSEFONTOUTLINESPROC = BOOL(WINAPI*)(HDC hdc, DWORD first, DWORD count, DWORD listBase, FLOAT deviation, FLOAT extrusion, int format, LPGLYPHMETRICSFLOAT lpgmf);
-
-	PFNWGLCOPYCONTEXTPROC m_pfnWglCopyContext{nullptr};
-	PFNWGLCREATECONTEXTPROC m_pfnWglCreateContext{nullptr};
-	PFNWGLCREATELAYERCONTEXTPROC m_pfnWglCreateLayerContext{nullptr};
-	PFNWGLDELETECONTEXTPROC m_pfnWglDeleteContext{nullptr};
-	PFNWGLDESCRIBELAYERPLANEPROC m_pfnWglDescribeLayerPlane{nullptr};
-	PFNWGLGETCURRENTCONTEXTPROC m_pfnWglGetCurrentContext{nullptr};
-	PFNWGLGETCURRENTDCPROC m_pfnWglGetCurrentDC{nullptr};
-	PFNWGLGETLAYERPALETTEENTRIESPROC m_pfnWglGetLayerPaletteEntries{nullptr};
-	PFNWGLMAKECURRENTPROC m_pfnWglMakeCurrent{nullptr};
-	PFNWGLREALIZELAYERPALETTEPROC m_pfnWglRealizeLayerPalette{nullptr};
-	PFNWGLSETLAYERPALETTEENTRIESPROC m_pfnWglSetLayerPaletteEntries{nullptr};
-	PFNWGLSHARELISTSPROC m_pfnWglShareLists{nullptr};
-	PFNWGLSWAPLAYERBUFFERSPROC m_pfnWglSwapLayerBuffers{nullptr};
-	PFNWGLSWAPMULTIPLEBUFFERSPROC m_pfnWglSwapMultipleBuffers{nullptr};
-	PFNWGLUSEFONTBITMAPSPROC m_pfnWglUseFontBitmapsA{nullptr};
-	PFNWGLUSEFONTBITMAPSPROC m_pfnWglUseFontBitmapsW{nullptr};
-	PFNWGLUSEFONTOUTLINESPROC m_pfnWglUseFontOutlinesA{nullptr};
-	PFNWGLUSEFONTOUTLINESPROC m_pfnWglUseFontOutlinesW{nullptr};
-};
-
-extern "C"
-{
-	//
-	// GL_VERSION_1_0
-	//
-
-	export void glBlendFunc(GLenum sfactor, GLenum dfactor);
-	export void glClear(GLbitfield mask);
-	export void glClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
-	export void glClearDepth(GLdouble depth);
-	export void glClearStencil(GLint s);
-	export void glColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha);
-	export void glCullFace(GLenum mode);
-	export void glDepthFunc(GLenum func);
-	export void glDepthMask(GLboolean flag);
-	export void glDepthRange(GLdouble n, GLdouble f);
-	export void glDisable(GLenum cap);
-	export void glDrawBuffer(GLenum buf);
-	export void glEnable(GLenum cap);
-	export void glFinish(void);
-	export void glFlush(void);
-	export void glFrontFace(GLenum mode);
-	export void glGetBooleanv(GLenum pname, GLboolean* data);
-	export void glGetDoublev(GLenum pname, GLdouble* data);
-	export GLenum glGetError(void);
-	export void glGetFloatv(GLenum pname, GLfloat* data);
-	export void glGetIntegerv(GLenum pname, GLint* data);
-	export const GLubyte* glGetString(GLenum name);
-	export void glGetTexImage(GLenum target, GLint level, GLenum format, GLenum type, void* pixels);
-	export void glGetTexLevelParameterfv(GLenum target, GLint level, GLenum pname, GLfloat* params);
-	export void glGetTexLevelParameteriv(GLenum target, GLint level, GLenum pname, GLint* params);
-	export void glGetTexParameterfv(GLenum target, GLenum pname, GLfloat* params);
-	export void glGetTexParameteriv(GLenum target, GLenum pname, GLint* params);
-	export void glHint(GLenum target, GLenum mode);
-	export GLboolean glIsEnabled(GLenum cap);
-	export void glLineWidth(GLfloat width);
-	export void glLogicOp(GLenum opcode);
-	export void glPixelStoref(GLenum pname, GLfloat param);
-	export void glPixelStorei(GLenum pname, GLint param);
-	export void glPointSize(GLfloat size);
-	export void glPolygonMode(GLenum face, GLenum mode);
-	export void glReadBuffer(GLenum src);
-	export void glReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels);
-	export void glScissor(GLint x, GLint y, GLsizei width, GLsizei height);
-	export void glStencilFunc(GLenum func, GLint ref, GLuint mask);
-	export void glStencilMask(GLuint mask);
-	export void glStencilOp(GLenum fail, GLenum zfail, GLenum zpass);
-	export void glTexImage1D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLint border, GLenum format, GLenum type, const void* pixels);
-	export void glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels);
-	export void glTexParameterf(GLenum target, GLenum pname, GLfloat param);
-	export void glTexParameterfv(GLenum target, GLenum pname, const GLfloat* params);
-	export void glTexParameteri(GLenum target, GLenum pname, GLint param);
-	export void glTexParameteriv(GLenum target, GLenum pname, const GLint* params);
-	export void glViewport(GLint x, GLint y, GLsizei width, GLsizei height);
-
-	//
-	// GL_VERSION_1_1
-	//
-
-	export void glBindTexture(GLenum target, GLuint texture);
-	export void glCopyTexImage1D(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLint border);
-	export void glCopyTexImage2D(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLsizei height, GLint border);
-	export void glCopyTexSubImage1D(GLenum target, GLint level, GLint xoffset, GLint x, GLint y, GLsizei width);
-	export void glCopyTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height);
-	export void glDeleteTextures(GLsizei n, const GLuint* textures);
-	export void glDrawArrays(GLenum mode, GLint first, GLsizei count);
-	export void glDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices);
-	export void glGenTextures(GLsizei n, GLuint* textures);
-	export void glGetPointerv(GLenum pname, void** params);
-	export GLboolean glIsTexture(GLuint texture);
-	export void glPolygonOffset(GLfloat factor, GLfloat units);
-	export void glTexSubImage1D(GLenum target, GLint level, GLint xoffset, GLsizei width, GLenum format, GLenum type, const void* pixels);
-	export void glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels);
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+export module OpenGL;
+
+// GLVersion is the version parsed from a context's GL_VERSION string, for example "4.6.0 NVIDIA 551.23"
+// or "OpenGL ES 3.2 Mesa 24.0.1".
+
+export struct GLVersion
+{
+	int major{};
+	int minor{};
+	bool es{};
+
+	bool atLeast(int requiredMajor, int requiredMinor) const
+	{
+		return major > requiredMajor || (major == requiredMajor && minor >= requiredMinor);
+	}
+};
+
+// The GLExtensions class holds the version of a rendering context and the extensions it supports that
+// the loader knows about. The extensions are parsed once into a bitset indexed by the Extension IDs
+// below, so checking for one is a single bit test rather than a search of the GL_EXTENSIONS string.
+// Extensions that aren't listed here are counted but not kept.
+
+export class GLExtensions
+{
+public:
+	// Keep these in alphabetical order. They index the table of names in OpenGL.cpp.
+
+	enum Extension : unsigned
+	{
+		ARB_buffer_storage,
+		ARB_clip_control,
+		ARB_copy_buffer,
+		ARB_debug_output,
+		ARB_direct_state_access,
+		ARB_framebuffer_object,
+		ARB_internalformat_query2,
+		ARB_map_buffer_range,
+		ARB_multi_bind,
+		ARB_multi_draw_indirect,
+		ARB_pixel_buffer_object,
+		ARB_sampler_objects,
+		ARB_sync,
+		ARB_texture_compression_bptc,
+		ARB_texture_compression_rgtc,
+		ARB_texture_float,
+		ARB_texture_storage,
+		ARB_timer_query,
+		ARB_vertex_array_object,
+		EXT_bgra,
+		EXT_direct_state_access,
+		EXT_texture_compression_s3tc,
+		EXT_texture_filter_anisotropic,
+		KHR_debug,
+		Count
+	};
+
+	// Parse the version and extensions of the calling thread's current context. On GL 3.0 and later the
+	// extensions are read one at a time with glGetStringi(), since core profile contexts don't support
+	// glGetString(GL_EXTENSIONS).
+
+	static GLExtensions query();
+
+	template <Extension extension>
+	bool has() const
+	{
+		static_assert(extension < Count);
+		return m_extensions[extension];
+	}
+
+	bool has(Extension extension) const { return extension < Count && m_extensions[extension]; }
+
+	// Look an extension up by name, with or without the GL_ prefix. Unknown names return false.
+
+	bool has(const char *pszName) const;
+
+	const GLVersion &version() const { return m_version; }
+
+	// The number of extensions the driver advertised, including the ones that aren't listed above.
+
+	unsigned advertised() const { return m_advertised; }
+
+	static const char *name(Extension extension);
+
+private:
+	std::bitset<Count> m_extensions;
+	GLVersion m_version{};
+	unsigned m_advertised{};
+};
+
+// GLDispatch has an entry for every GL 1.0 and 1.1 function the loader exports, in the order they're
+// declared below. opengl32.dll exports these, so they can be resolved before any context is current.
+// A rendering context's calls go through one of these tables: the driver's entry points, or a table
+// flattened from the interception layers installed on the context.
+
+export struct GLDispatch
+{
+	//
+	// GL_VERSION_1_0
+	//
+
+	void(APIENTRY *glBlendFunc)(GLenum sfactor, GLenum dfactor){nullptr};
+	void(APIENTRY *glClear)(GLbitfield mask){nullptr};
+	void(APIENTRY *glClearColor)(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha){nullptr};
+	void(APIENTRY *glClearDepth)(GLdouble depth){nullptr};
+	void(APIENTRY *glClearStencil)(GLint s){nullptr};
+	void(APIENTRY *glColorMask)(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha){nullptr};
+	void(APIENTRY *glCullFace)(GLenum mode){nullptr};
+	void(APIENTRY *glDepthFunc)(GLenum func){nullptr};
+	void(APIENTRY *glDepthMask)(GLboolean flag){nullptr};
+	void(APIENTRY *glDepthRange)(GLdouble n, GLdouble f){nullptr};
+	void(APIENTRY *glDisable)(GLenum cap){nullptr};
+	void(APIENTRY *glDrawBuffer)(GLenum buf){nullptr};
+	void(APIENTRY *glEnable)(GLenum cap){nullptr};
+	void(APIENTRY *glFinish)(void){nullptr};
+	void(APIENTRY *glFlush)(void){nullptr};
+	void(APIENTRY *glFrontFace)(GLenum mode){nullptr};
+	void(APIENTRY *glGetBooleanv)(GLenum pname, GLboolean* data){nullptr};
+	void(APIENTRY *glGetDoublev)(GLenum pname, GLdouble* data){nullptr};
+	GLenum(APIENTRY *glGetError)(void){nullptr};
+	void(APIENTRY *glGetFloatv)(GLenum pname, GLfloat* data){nullptr};
+	void(APIENTRY *glGetIntegerv)(GLenum pname, GLint* data){nullptr};
+	const GLubyte*(APIENTRY *glGetString)(GLenum name){nullptr};
+	void(APIENTRY *glGetTexImage)(GLenum target, GLint level, GLenum format, GLenum type, void* pixels){nullptr};
+	void(APIENTRY *glGetTexLevelParameterfv)(GLenum target, GLint level, GLenum pname, GLfloat* params){nullptr};
+	void(APIENTRY *glGetTexLevelParameteriv)(GLenum target, GLint level, GLenum pname, GLint* params){nullptr};
+	void(APIENTRY *glGetTexParameterfv)(GLenum target, GLenum pname, GLfloat* params){nullptr};
+	void(APIENTRY *glGetTexParameteriv)(GLenum target, GLenum pname, GLint* params){nullptr};
+	void(APIENTRY *glHint)(GLenum target, GLenum mode){nullptr};
+	GLboolean(APIENTRY *glIsEnabled)(GLenum cap){nullptr};
+	void(APIENTRY *glLineWidth)(GLfloat width){nullptr};
+	void(APIENTRY *glLogicOp)(GLenum opcode){nullptr};
+	void(APIENTRY *glPixelStoref)(GLenum pname, GLfloat param){nullptr};
+	void(APIENTRY *glPixelStorei)(GLenum pname, GLint param){nullptr};
+	void(APIENTRY *glPointSize)(GLfloat size){nullptr};
+	void(APIENTRY *glPolygonMode)(GLenum face, GLenum mode){nullptr};
+	void(APIENTRY *glReadBuffer)(GLenum src){nullptr};
+	void(APIENTRY *glReadPixels)(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels){nullptr};
+	void(APIENTRY *glScissor)(GLint x, GLint y, GLsizei width, GLsizei height){nullptr};
+	void(APIENTRY *glStencilFunc)(GLenum func, GLint ref, GLuint mask){nullptr};
+	void(APIENTRY *glStencilMask)(GLuint mask){nullptr};
+	void(APIENTRY *glStencilOp)(GLenum fail, GLenum zfail, GLenum zpass){nullptr};
+	void(APIENTRY *glTexImage1D)(GLenum target, GLint level, GLint internalformat, GLsizei width, GLint border, GLenum format, GLenum type, const void* pixels){nullptr};
+	void(APIENTRY *glTexImage2D)(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels){nullptr};
+	void(APIENTRY *glTexParameterf)(GLenum target, GLenum pname, GLfloat param){nullptr};
+	void(APIENTRY *glTexParameterfv)(GLenum target, GLenum pname, const GLfloat* params){nullptr};
+	void(APIENTRY *glTexParameteri)(GLenum target, GLenum pname, GLint param){nullptr};
+	void(APIENTRY *glTexParameteriv)(GLenum target, GLenum pname, const GLint* params){nullptr};
+	void(APIENTRY *glViewport)(GLint x, GLint y, GLsizei width, GLsizei height){nullptr};
+
+	//
+	// GL_VERSION_1_1
+	//
+
+	void(APIENTRY *glBindTexture)(GLenum target, GLuint texture){nullptr};
+	void(APIENTRY *glCopyTexImage1D)(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLint border){nullptr};
+	void(APIENTRY *glCopyTexImage2D)(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLsizei height, GLint border){nullptr};
+	void(APIENTRY *glCopyTexSubImage1D)(GLenum target, GLint level, GLint xoffset, GLint x, GLint y, GLsizei width){nullptr};
+	void(APIENTRY *glCopyTexSubImage2D)(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height){nullptr};
+	void(APIENTRY *glDeleteTextures)(GLsizei n, const GLuint* textures){nullptr};
+	void(APIENTRY *glDrawArrays)(GLenum mode, GLint first, GLsizei count){nullptr};
+	void(APIENTRY *glDrawElements)(GLenum mode, GLsizei count, GLenum type, const void* indices){nullptr};
+	void(APIENTRY *glGenTextures)(GLsizei n, GLuint* textures){nullptr};
+	void(APIENTRY *glGetPointerv)(GLenum pname, void** params){nullptr};
+	GLboolean(APIENTRY *glIsTexture)(GLuint texture){nullptr};
+	void(APIENTRY *glPolygonOffset)(GLfloat factor, GLfloat units){nullptr};
+	void(APIENTRY *glTexSubImage1D)(GLenum target, GLint level, GLint xoffset, GLsizei width, GLenum format, GLenum type, const void* pixels){nullptr};
+	void(APIENTRY *glTexSubImage2D)(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels){nullptr};
+};
+
+// A GLLayer intercepts some of the GL functions called with a rendering context, for validation,
+// tracing, state caching or metrics. Layers are installed with OpenGLContext::insertLayer(). The same
+// layer may be installed on several contexts, and several layers of the same type on one context.
+
+export class GLLayer
+{
+public:
+	virtual ~GLLayer() = default;
+
+	virtual const char *name() const = 0;
+
+	// Set the entries of table for the functions this layer intercepts and leave the others null. It's
+	// called each time a chain the layer is in is rebuilt, with the loader's layer lock held, so it
+	// mustn't insert or remove layers.
+
+	virtual void intercept(GLDispatch &table) = 0;
+
+	// Only valid inside one of a layer's functions. next() is the table of everything below the layer
+	// in the calling thread's chain, ending with the driver, and a call is carried on by calling through
+	// it. self() is the layer whose function was called.
+
+	static const GLDispatch &next();
+	static GLLayer &current();
+
+	template <typename T>
+	static T &self() { return static_cast<T &>(current()); }
+};
+
+// LoaderReport describes how the loader resolved GL and WGL symbols: the library it loaded and, for
+// every symbol it has been asked for, where it was found and how long looking it up took. Only the
+// first lookup of each of the loader's own symbols is timed, and later ones are just counted. Symbols are
+// looked up with wglGetProcAddress() first and GetProcAddress() on the library second. Some drivers
+// return 1, 2, 3 or -1 instead of null from wglGetProcAddress(), and those symbols are flagged. If a
+// core GL function isn't found under its own name the ARB, EXT and vendor aliases gl.xml gives for it
+// are tried in turn, and alias is the name that was found.
+//
+// A missing GL function is replaced by a stub that does nothing and returns zero. A missing WGL
+// function makes its OpenGLContext method fail with ERROR_PROC_NOT_FOUND.
+
+export enum class SymbolSource
+{
+	Driver,
+	Library,
+	Missing,
+};
+
+export struct SymbolResolution
+{
+	std::string name;
+	SymbolSource source{};
+	std::string alias;
+	std::uint32_t lookups{};
+	double microseconds{};
+	bool invalidDriverResult{};
+};
+
+export struct LoaderReport
+{
+	std::string library;
+	double loadMilliseconds{};
+	std::vector<SymbolResolution> symbols;
+
+	std::vector<std::string> missing() const;
+
+	// A table of every symbol in lookup order, followed by a summary of each source and the missing symbols.
+
+	std::string describe() const;
+
+	static const char *sourceName(SymbolSource source);
+};
+
+// DispatchUsage is one function's call count from a usage profile. See OpenGLContext::setDispatchProfile().
+
+export struct DispatchUsage
+{
+	std::string name;
+	std::uint64_t calls{};
+};
+
+// Loader loads an OpenGL library and resolves its entry points, and PackedDispatch is a GLDispatch
+// table in the order the GL functions call through it. They're defined in OpenGL.cpp.
+
+class Loader;
+struct PackedDispatch;
+
+// The OpenGLContext class is a wrapper around the WGL API in opengl32.dll.
+// It provides a way to create an OpenGL rendering context for a window.
+// The class contains replacements for all the WGL functions in opengl32.dll.
+// These methods have the same signatures as the WGL functions as defined in wingdi.h.
+// They even have the same spelling as the WGL functions.
+// These methods forward the calls to the real WGL functions in opengl32.dll at runtime.
+// This means that the OpenGLContext class can be used as a drop-in replacement for the WGL API.
+// Since the real WGL functions are loaded dynamically at runtime, there is no need to statically link to opengl32.lib.
+
+export class OpenGLContext
+{
+public:
+	// Forward to the default library. The WGL functions are resolved here, so an OpenGLContext can be
+	// shared by threads.
+
+	OpenGLContext();
+
+	// Create an OpenGL rendering context for a window.	
+	//
+	// pszLibrary selects the OpenGL implementation by library path, for example a Mesa opengl32.dll
+	// (llvmpipe) or a null driver, so the same binary can be compared against several of them. Each
+	// library is loaded once and kept loaded until the process exits. When it's null the library named
+	// by the GLLOADER_LIBRARY environment variable is used, or opengl32.dll if that isn't set. Returns
+	// an empty pointer if the library can't be loaded.
+	//
+	// Rendering contexts belong to the library of the OpenGLContext that makes them current, and the GL
+	// functions go to that library while one of its contexts is current. Libraries number their contexts
+	// independently, so the loader tells them apart by library as well as by handle. A library other than the
+	// system opengl32.dll chooses and sets pixel formats and swaps buffers itself rather than through
+	// GDI. Each library has its own idea of the current context, so release a context before making one
+	// from another library current on the same thread.
+
+	static std::shared_ptr<OpenGLContext> createForWindow(HWND hWnd, PIXELFORMATDESCRIPTOR &pfd, const wchar_t *pszLibrary = nullptr);
+
+	// The current context and device context of each thread are tracked in user space.
+	// wglGetCurrentContext() and wglGetCurrentDC() only call into opengl32.dll the first time they're
+	// used on a thread, and wglMakeCurrent() isn't forwarded when the requested context and device
+	// context are already current. Tracking assumes that every wglMakeCurrent() call on the thread goes
+	// through an OpenGLContext. It's enabled by default and may be disabled for comparison.
+
+	struct CurrentTrackingStats
+	{
+		std::uint64_t makeCurrentCalls{};
+		std::uint64_t makeCurrentForwarded{};
+		std::uint64_t queries{};
+		std::uint64_t queriesForwarded{};
+	};
+
+	static void setCurrentTracking(bool enabled);
+	static bool currentTracking();
+	static CurrentTrackingStats currentTrackingStats();
+	static void resetCurrentTrackingStats();
+
+	// Texture parameter shadowing. With it on, the GL functions record the sampling parameters of each
+	// texture object (the minification and magnification filters, wrap modes, LOD range and bias, and
+	// maximum anisotropy) as they're set on the texture bound to each target, and drop glTexParameter*()
+	// calls that wouldn't change them. In Samplers mode on GL 3.3 and later, or with ARB_sampler_objects,
+	// those parameters aren't set on the textures at all. Every distinct set of them becomes one sampler
+	// object shared by all the textures that use it, and glDrawArrays() and glDrawElements() bind the
+	// sampler for the texture on each unit first. A texture that also has a border color, depth
+	// comparison or sRGB decode mode set keeps its own parameters.
+	//
+	// Shadowing assumes that textures are generated, bound and have their parameters set only through
+	// these functions, and only by the context that uses them. Each rendering context takes the mode the
+	// first time a texture function is called while it's current and keeps it, so set the mode before
+	// creating the contexts it's for. It's off by default.
+	//
+	// Texture bindings are cached too, for every unit glActiveTexture() can select. Binds that wouldn't
+	// change anything are dropped, and a unit change only reaches the driver when a call that depends on
+	// the active unit, such as glTexImage2D(), is made. On GL 4.4 and later, or with ARB_multi_bind,
+	// glBindTexture() calls are deferred until a draw or another call that uses the bindings, and then
+	// made with a single glBindTextures() call for the range of units they're for. A deferred bind's
+	// errors are reported by the call that makes it. Units must be selected with the glActiveTexture()
+	// exported here rather than one from wglGetProcAddress(). Other functions the loader doesn't export,
+	// such as glDrawElementsInstanced(), don't see deferred binds or sampler objects, so call
+	// flushTextureCache() before them.
+
+	enum class TextureCache
+	{
+		Off,
+		Shadow,
+		Samplers,
+	};
+
+	struct TextureCacheStats
+	{
+		std::uint64_t parameterCalls{};
+		std::uint64_t parameterCallsForwarded{};
+		std::uint64_t samplerObjects{};
+		std::uint64_t samplerBinds{};
+		std::uint64_t bindCalls{};
+		std::uint64_t bindsForwarded{};
+		std::uint64_t multiBinds{};
+		std::uint64_t activeTextureCalls{};
+		std::uint64_t activeTexturesForwarded{};
+	};
+
+	static void setTextureCache(TextureCache mode);
+	static TextureCache textureCache();
+	static TextureCacheStats textureCacheStats();
+	static void resetTextureCacheStats();
+
+	// Make the deferred texture binds and bind the sampler objects of the calling thread's current context.
+
+	static void flushTextureCache();
+
+	// Direct state access. glCreateTextures(), glTextureParameter*(), glGetTextureParameter*(),
+	// glTextureSubImage1D(), glTextureSubImage2D() and glNamedBufferSubData() work on the object they're
+	// given without disturbing any binding. On GL 4.5 and later, or with ARB_direct_state_access, they
+	// call the driver's functions. Otherwise they're emulated: the object is bound, the bind-to-edit
+	// function is called, and the application's binding is put back from the bindings the loader tracks
+	// rather than queried with glGet*(). With the texture cache on and glBindTextures() available the
+	// texture's binding is put back with the next deferred binds.
+	//
+	// Bindings are tracked on every known context that emulates direct state access, so make the context
+	// current or query it through an OpenGLContext first. A texture is edited through the target it was
+	// created with by glCreateTextures(), or first bound to with glBindTexture(). If the target isn't
+	// known, because the texture has never been bound or the context isn't known, the call raises
+	// GL_INVALID_OPERATION, as the driver's would for a name that was never bound, and glGetError()
+	// returns it. The buffer bound to GL_COPY_WRITE_BUFFER, or GL_ARRAY_BUFFER before GL 3.1 without
+	// ARB_copy_buffer, is only known if it's bound with the glBindBuffer() exported here rather than one
+	// from wglGetProcAddress(). On a context made current behind the loader's back the driver's direct
+	// state access functions are looked up on every call.
+
+	struct DirectStateAccessStats
+	{
+		std::uint64_t calls{};
+		std::uint64_t emulated{};
+		std::uint64_t editBinds{};
+	};
+
+	static DirectStateAccessStats directStateAccessStats();
+	static void resetDirectStateAccessStats();
+
+	// How the loader of a library has resolved symbols so far, loading the library if it isn't already.
+	// pszLibrary is interpreted as it is by createForWindow(). See LoaderReport.
+
+	static LoaderReport loaderReport(const wchar_t *pszLibrary = nullptr);
+
+	// Looks a symbol up with the loader of a library, loading the library if it isn't already, the way
+	// wglGetProcAddress() does but without needing a context. The lookup is recorded in the loader report.
+
+	static PROC getProcAddress(LPCSTR lpszProc, const wchar_t *pszLibrary = nullptr);
+
+	// The GL functions call through dispatch tables packed in declaration order by default. A usage
+	// profile, the call counts of a previous run such as the interposer's report, moves the most called
+	// functions to the front, so the ones an application calls every frame share as few cache lines as
+	// possible. The GLLOADER_DISPATCH_PROFILE environment variable names a profile file to apply at
+	// startup. Changing the layout repacks every table, so it mustn't happen while another thread is
+	// making GL calls. An empty profile restores the declaration order.
+	//
+	// writeDispatchLayoutHeader() writes the current layout as GLDispatchLayout.h. Building with
+	// GLLOADER_BAKED_DISPATCH_LAYOUT defined compiles that layout in, which saves looking the slots up
+	// at run time, and setDispatchProfile() and loadDispatchProfile() then return false.
+
+	static bool setDispatchProfile(const std::vector<DispatchUsage> &profile);
+	static bool loadDispatchProfile(const wchar_t *pszPath);
+	static std::vector<std::string> dispatchLayout();
+	static bool writeDispatchLayoutHeader(const wchar_t *pszPath);
+
+	// The version and extensions of the calling thread's current context. They're parsed the first time
+	// they're asked for while each rendering context is current and kept until the context is deleted.
+	// Returns an empty set when no context is current.
+
+	const GLExtensions &extensions();
+
+	// Interception layers for a rendering context. The layer at position 0 sees each call first, and
+	// calls that no layer intercepts go straight to the driver. Inserting or removing a layer rebuilds
+	// the context's flattened dispatch chain. The new chain is used at once on the calling thread if the
+	// context is current on it, and on other threads from their next wglMakeCurrent() or SwapBuffers(),
+	// so layers should be changed between frames. The GL functions themselves take no locks, and a
+	// replaced chain is freed once no thread is still using it. A context can have up to kMaxLayers
+	// layers, and insertLayer() returns false when it's full. pszLibrary is the library the context comes
+	// from, as given to createForWindow(). Asking for the layers of, or removing a layer from, a context
+	// the loader knows nothing about returns an empty list or false without starting to track it.
+
+	static constexpr std::size_t kMaxLayers{16};
+
+	static bool insertLayer(HGLRC hglrc, std::shared_ptr<GLLayer> pLayer, std::size_t position = SIZE_MAX, const wchar_t *pszLibrary = nullptr);
+	static bool removeLayer(HGLRC hglrc, const GLLayer *pLayer, const wchar_t *pszLibrary = nullptr);
+	static std::vector<std::shared_ptr<GLLayer>> layers(HGLRC hglrc, const wchar_t *pszLibrary = nullptr);
+
+	// The following methods are replacements for the WGL functions in opengl32.dll:
+
+	BOOL wglCopyContext(HGLRC hglrcSource, HGLRC hglrcDest, UINT mask);
+	HGLRC wglCreateContext(HDC hdc);
+	HGLRC wglCreateLayerContext(HDC hdc, int iLayerPlane);
+	BOOL wglDeleteContext(HGLRC hglrc);
+	BOOL wglDescribeLayerPlane(HDC hdc, int iPixelFormat, int iLayerPlane, UINT nBytes, LPLAYERPLANEDESCRIPTOR plpd);
+	HGLRC wglGetCurrentContext();
+	HDC wglGetCurrentDC();
+	int wglGetLayerPaletteEntries(HDC hdc, int iLayerPlane, int iStart, int cEntries, const COLORREF *pcr);
+	PROC wglGetProcAddress(LPCSTR lpszProc);
+	BOOL wglMakeCurrent(HDC hdc, HGLRC hglrc);
+	BOOL wglRealizeLayerPalette(HDC hdc, int iLayerPlane, BOOL bRealize);
+	int wglSetLayerPaletteEntries(HDC hdc, int iLayerPlane, int iStart, int cEntries, const COLORREF *pcr);
+	BOOL wglShareLists(HGLRC hglrc1, HGLRC hglrc2);
+	BOOL SwapBuffers(HDC hdc);
+	BOOL wglSwapLayerBuffers(HDC hdc, UINT fuPlanes);
+	DWORD wglSwapMultipleBuffers(UINT count, const WGLSWAP *toSwap);
+	BOOL wglUseFontBitmapsA(HDC hdc, DWORD first, DWORD count, DWORD listBase);
+	BOOL wglUseFontBitmapsW(HDC hdc, DWORD first, DWORD count, DWORD listBase);
+	BOOL wglUseFontOutlinesA(HDC hdc, DWORD first, DWORD count, DWORD listBase, FLOAT deviation, FLOAT extrusion, int format, LPGLYPHMETRICSFLOAT lpgmf);
+	BOOL wglUseFontOutlinesW(HDC hdc, DWORD first, DWORD count, DWORD listBase, FLOAT deviation, FLOAT extrusion, int format, LPGLYPHMETRICSFLOAT lpgmf);
+
+	// Present the main plane of several device contexts with as few wglSwapMultipleBuffers() calls as
+	// possible. Batches are limited to WGL_SWAPMULTIPLE_MAX device contexts. Any device context that a
+	// batched swap didn't present is swapped on its own instead.
+
+	BOOL swapBuffers(UINT count, const HDC *phdc);
+
+private:
+	explicit OpenGLContext(Loader *pLoader);
+
+	// The library this context's functions come from.
+
+	Loader &loader() const;
+
+	// Used instead of ChoosePixelFormat() and SetPixelFormat() for libraries other than the system one.
+
+	BOOL setPixelFormat(HDC hdc, const PIXELFORMATDESCRIPTOR &pfd);
+
+	using PFNWGLCHOOSEPIXELFORMATPROC = int(WINAPI*)(HDC hdc, const PIXELFORMATDESCRIPTOR *ppfd);
+	using PFNWGLCOPYCONTEXTPROC = BOOL(WINAPI*)(HGLRC hglrcSource, HGLRC hglrcDest, UINT mask);
+	using PFNWGLCREATECONTEXTPROC = HGLRC(WINAPI*)(HDC hdc);
+	using PFNWGLCREATELAYERCONTEXTPROC = HGLRC(WINAPI*)(HDC hdc, int iLayerPlane);
+	using PFNWGLDELETECONTEXTPROC = BOOL(WINAPI*)(HGLRC hglrc);
+	using PFNWGLDESCRIBELAYERPLANEPROC = BOOL(WINAPI*)(HDC hdc, int iPixelFormat, int iLayerPlane, UINT nBytes, LPLAYERPLANEDESCRIPTOR plpd);
+	using PFNWGLGETCURRENTCONTEXTPROC = HGLRC(WINAPI*)(VOID);
+	using PFNWGLGETCURRENTDCPROC = HDC(WINAPI*)(VOID);
+	using PFNWGLGETLAYERPALETTEENTRIESPROC = int(WINAPI*)(HDC hdc, int iLayerPlane, int iStart, int cEntries, const COLORREF* pcr);
+	using PFNWGLMAKECURRENTPROC = BOOL(WINAPI*)(HDC hdc, HGLRC hglrc);
+	using PFNWGLREALIZELAYERPALETTEPROC = BOOL(WINAPI*)(HDC hdc, int iLayerPlane, BOOL bRealize);
+	using PFNWGLSETLAYERPALETTEENTRIESPROC = int(WINAPI*)(HDC hdc, int iLayerPlane, int iStart, int cEntries, const COLORREF* pcr);
+	using PFNWGLSETPIXELFORMATPROC = BOOL(WINAPI*)(HDC hdc, int format, const PIXELFORMATDESCRIPTOR *ppfd);
+	using PFNWGLSHARELISTSPROC = BOOL(WINAPI*)(HGLRC hglrc1, HGLRC hglrc2);
+	using PFNWGLSWAPBUFFERSPROC = BOOL(WINAPI*)(HDC hdc);
+	using PFNWGLSWAPLAYERBUFFERSPROC = BOOL(WINAPI*)(HDC hdc, UINT fuPlanes);
+	using PFNWGLSWAPMULTIPLEBUFFERSPROC = DWORD(WINAPI*)(UINT count, const WGLSWAP* toSwap);
+	using PFNWGLUSEFONTBITMAPSPROC = BOOL(WINAPI*)(HDC hdc, DWORD first, DWORD count, DWORD listBase);
+	using PFNWGLUSEFONTOUTLINESPROC = BOOL(WINAPI*)(HDC hdc, DWORD first, DWORD count, DWORD listBase, FLOAT deviation, FLOAT extrusion, int format, LPGLYPHMETRICSFLOAT lpgmf);
+
+	// Null for the default library.
+
+	Loader *m_pLoader{nullptr};
+
+	PFNWGLCHOOSEPIXELFORMATPROC m_pfnWglChoosePixelFormat{nullptr};
+	PFNWGLCOPYCONTEXTPROC m_pfnWglCopyContext{nullptr};
+	PFNWGLCREATECONTEXTPROC m_pfnWglCreateContext{nullptr};
+	PFNWGLCREATELAYERCONTEXTPROC m_pfnWglCreateLayerContext{nullptr};
+	PFNWGLDELETECONTEXTPROC m_pfnWglDeleteContext{nullptr};
+	PFNWGLDESCRIBELAYERPLANEPROC m_pfnWglDescribeLayerPlane{nullptr};
+	PFNWGLGETCURRENTCONTEXTPROC m_pfnWglGetCurrentContext{nullptr};
+	PFNWGLGETCURRENTDCPROC m_pfnWglGetCurrentDC{nullptr};
+	PFNWGLGETLAYERPALETTEENTRIESPROC m_pfnWglGetLayerPaletteEntries{nullptr};
+	PFNWGLMAKECURRENTPROC m_pfnWglMakeCurrent{nullptr};
+	PFNWGLREALIZELAYERPALETTEPROC m_pfnWglRealizeLayerPalette{nullptr};
+	PFNWGLSETLAYERPALETTEENTRIESPROC m_pfnWglSetLayerPaletteEntries{nullptr};
+	PFNWGLSETPIXELFORMATPROC m_pfnWglSetPixelFormat{nullptr};
+	PFNWGLSHARELISTSPROC m_pfnWglShareLists{nullptr};
+	PFNWGLSWAPBUFFERSPROC m_pfnWglSwapBuffers{nullptr};
+	PFNWGLSWAPLAYERBUFFERSPROC m_pfnWglSwapLayerBuffers{nullptr};
+	PFNWGLSWAPMULTIPLEBUFFERSPROC m_pfnWglSwapMultipleBuffers{nullptr};
+	PFNWGLUSEFONTBITMAPSPROC m_pfnWglUseFontBitmapsA{nullptr};
+	PFNWGLUSEFONTBITMAPSPROC m_pfnWglUseFontBitmapsW{nullptr};
+	PFNWGLUSEFONTOUTLINESPROC m_pfnWglUseFontOutlinesA{nullptr};
+	PFNWGLUSEFONTOUTLINESPROC m_pfnWglUseFontOutlinesW{nullptr};
+};
+
+// Check the current context for an extension, for example hasExtension<GLExtensions::ARB_buffer_storage>(context).
+
+export template <GLExtensions::Extension extension>
+bool hasExtension(OpenGLContext &context)
+{
+	return context.extensions().has<extension>();
+}
+
+// The GLStateTracker class records which pieces of fixed-function state have been changed since the
+// last reset. When a tracker is current on the calling thread the state-setting GL functions below
+// mark the state they modify as dirty. resetToDefaults() then restores only the dirty state to the
+// values defined by the OpenGL specification, so a context can be returned to a known state without
+// any glGet round-trips to the driver.
+
+export class GLStateTracker
+{
+public:
+	enum State : std::uint32_t
+	{
+		Viewport = 1u << 0,
+		Scissor = 1u << 1,
+		ClearColor = 1u << 2,
+		ClearDepth = 1u << 3,
+		ClearStencil = 1u << 4,
+		ColorMask = 1u << 5,
+		DepthMask = 1u << 6,
+		StencilMask = 1u << 7,
+		BlendFunc = 1u << 8,
+		DepthFunc = 1u << 9,
+		DepthRange = 1u << 10,
+		StencilFunc = 1u << 11,
+		StencilOp = 1u << 12,
+		CullFace = 1u << 13,
+		FrontFace = 1u << 14,
+		PolygonMode = 1u << 15,
+		PolygonOffset = 1u << 16,
+		LineWidth = 1u << 17,
+		PointSize = 1u << 18,
+		LogicOp = 1u << 19,
+		DrawBuffer = 1u << 20,
+		ReadBuffer = 1u << 21,
+		ActiveTexture = 1u << 22,
+	};
+
+	// The tracker that the GL functions report to on the calling thread. May be null.
+
+	static GLStateTracker *current();
+	static void makeCurrent(GLStateTracker *pTracker);
+
+	void touch(State state) { m_dirty |= state; }
+	void touchCapability(GLenum cap) { touchEnum(m_capabilities, cap); }
+	void touchHint(GLenum target) { touchEnum(m_hints, target); }
+	void touchPixelStore(GLenum pname) { touchEnum(m_pixelStore, pname); }
+	void touchTextureBinding(GLenum target);
+	void touchActiveTexture(GLenum texture);
+
+	bool dirty() const;
+
+	// Restore all dirty state to its default value. The viewport and scissor box default to the
+	// size of the drawable. Texture bindings are reset on every unit they were changed on, and the
+	// active texture unit goes back to GL_TEXTURE0. Must be called with the tracked context current.
+	// Returns the number of GL calls that were issued.
+
+	unsigned resetToDefaults(GLsizei drawableWidth, GLsizei drawableHeight);
+
+private:
+	static void touchEnum(std::vector<GLenum> &touched, GLenum value);
+
+	std::uint32_t m_dirty{};
+	std::vector<GLenum> m_capabilities;
+	std::vector<GLenum> m_hints;
+	std::vector<GLenum> m_pixelStore;
+
+	// The unit and target of each texture binding that was changed, and the unit bindings are made on.
+
+	std::vector<std::pair<GLenum, GLenum>> m_textureBindings;
+	GLenum m_activeTexture{GL_TEXTURE0};
+};
+
+extern "C"
+{
+	//
+	// GL_VERSION_1_0
+	//
+
+	export void glBlendFunc(GLenum sfactor, GLenum dfactor);
+	export void glClear(GLbitfield mask);
+	export void glClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+	export void glClearDepth(GLdouble depth);
+	export void glClearStencil(GLint s);
+	export void glColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha);
+	export void glCullFace(GLenum mode);
+	export void glDepthFunc(GLenum func);
+	export void glDepthMask(GLboolean flag);
+	export void glDepthRange(GLdouble n, GLdouble f);
+	export void glDisable(GLenum cap);
+	export void glDrawBuffer(GLenum buf);
+	export void glEnable(GLenum cap);
+	export void glFinish(void);
+	export void glFlush(void);
+	export void glFrontFace(GLenum mode);
+	export void glGetBooleanv(GLenum pname, GLboolean* data);
+	export void glGetDoublev(GLenum pname, GLdouble* data);
+	export GLenum glGetError(void);
+	export void glGetFloatv(GLenum pname, GLfloat* data);
+	export void glGetIntegerv(GLenum pname, GLint* data);
+	export const GLubyte* glGetString(GLenum name);
+	export void glGetTexImage(GLenum target, GLint level, GLenum format, GLenum type, void* pixels);
+	export void glGetTexLevelParameterfv(GLenum target, GLint level, GLenum pname, GLfloat* params);
+	export void glGetTexLevelParameteriv(GLenum target, GLint level, GLenum pname, GLint* params);
+	export void glGetTexParameterfv(GLenum target, GLenum pname, GLfloat* params);
+	export void glGetTexParameteriv(GLenum target, GLenum pname, GLint* params);
+	export void glHint(GLenum target, GLenum mode);
+	export GLboolean glIsEnabled(GLenum cap);
+	export void glLineWidth(GLfloat width);
+	export void glLogicOp(GLenum opcode);
+	export void glPixelStoref(GLenum pname, GLfloat param);
+	export void glPixelStorei(GLenum pname, GLint param);
+	export void glPointSize(GLfloat size);
+	export void glPolygonMode(GLenum face, GLenum mode);
+	export void glReadBuffer(GLenum src);
+	export void glReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels);
+	export void glScissor(GLint x, GLint y, GLsizei width, GLsizei height);
+	export void glStencilFunc(GLenum func, GLint ref, GLuint mask);
+	export void glStencilMask(GLuint mask);
+	export void glStencilOp(GLenum fail, GLenum zfail, GLenum zpass);
+	export void glTexImage1D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLint border, GLenum format, GLenum type, const void* pixels);
+	export void glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels);
+	export void glTexParameterf(GLenum target, GLenum pname, GLfloat param);
+	export void glTexParameterfv(GLenum target, GLenum pname, const GLfloat* params);
+	export void glTexParameteri(GLenum target, GLenum pname, GLint param);
+	export void glTexParameteriv(GLenum target, GLenum pname, const GLint* params);
+	export void glViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+	//
+	// GL_VERSION_1_1
+	//
+
+	export void glBindTexture(GLenum target, GLuint texture);
+	export void glCopyTexImage1D(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLint border);
+	export void glCopyTexImage2D(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLsizei height, GLint border);
+	export void glCopyTexSubImage1D(GLenum target, GLint level, GLint xoffset, GLint x, GLint y, GLsizei width);
+	export void glCopyTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height);
+	export void glDeleteTextures(GLsizei n, const GLuint* textures);
+	export void glDrawArrays(GLenum mode, GLint first, GLsizei count);
+	export void glDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices);
+	export void glGenTextures(GLsizei n, GLuint* textures);
+	export void glGetPointerv(GLenum pname, void** params);
+	export GLboolean glIsTexture(GLuint texture);
+	export void glPolygonOffset(GLfloat factor, GLfloat units);
+	export void glTexSubImage1D(GLenum target, GLint level, GLint xoffset, GLsizei width, GLenum format, GLenum type, const void* pixels);
+	export void glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels);
+
+	//
+	// GL_VERSION_1_3
+	//
+
+	export void glActiveTexture(GLenum texture);
+
+	//
+	// GL_VERSION_1_5
+	//
+
+	export void glBindBuffer(GLenum target, GLuint buffer);
+	export void glDeleteBuffers(GLsizei n, const GLuint* buffers);
+
+	//
+	// GL_VERSION_4_5
+	//
+
+	export void glCreateTextures(GLenum target, GLsizei n, GLuint* textures);
+	export void glGetTextureParameterfv(GLuint texture, GLenum pname, GLfloat* params);
+	export void glGetTextureParameteriv(GLuint texture, GLenum pname, GLint* params);
+	export void glNamedBufferSubData(GLuint buffer, GLintptr offset, GLsizeiptr size, const void* data);
+	export void glTextureParameterf(GLuint texture, GLenum pname, GLfloat param);
+	export void glTextureParameterfv(GLuint texture, GLenum pname, const GLfloat* params);
+	export void glTextureParameteri(GLuint texture, GLenum pname, GLint param);
+	export void glTextureParameteriv(GLuint texture, GLenum pname, const GLint* params);
+	export void glTextureSubImage1D(GLuint texture, GLint level, GLint xoffset, GLsizei width, GLenum format, GLenum type, const void* pixels);
+	export void glTextureSubImage2D(GLuint texture, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels);
 }
\ No newline at end of file
@@ -0,0 +1,337 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cwchar>
+#include <memory>
+#include <string>
+#include <vector>
+
+module Benchmark;
+
+import FastPaths;
+import HeadlessContext;
+import OpenGL;
+
+// Checks and times every tier of FastPaths that the driver supports.
+//
+//     -benchmark paths [-draws n] [-iterations n] [-size n] [-library path] [-versions a;b;...]
+//
+// Each tier gets a FastPaths capped at that tier, skipping tiers that select the same paths as the one below. A texture is
+// uploaded through it and read back, the same is done with blocks of its compressed format if there is
+// one, and a grid of quads that exactly covers the viewport is streamed and drawn through it, one quad
+// per draw, and the framebuffer checked for holes. Then all three are timed. The run fails if any path
+// draws or uploads the wrong thing.
+//
+// -versions runs the check once per version instead, each in a child process with
+// MESA_GL_VERSION_OVERRIDE set to it, so a Mesa library given with -library (or GLLOADER_LIBRARY) is
+// tested at every version it can report. It fails if any version fails.
+
+namespace
+{
+	const GLenum kVertexArray{0x8074};
+
+	using PFNGLVERTEXPOINTERPROC = void(APIENTRY *)(GLint size, GLenum type, GLsizei stride, const void *pointer);
+	using PFNGLENABLECLIENTSTATEPROC = void(APIENTRY *)(GLenum array);
+
+	struct Grid
+	{
+		std::vector<GLfloat> vertices;
+		std::vector<GLint> first;
+		std::vector<GLsizei> count;
+	};
+
+	// side x side quads, each two triangles, tiling clip space from -1 to 1.
+
+	Grid makeGrid(int side)
+	{
+		Grid grid;
+
+		for (int row = 0; row < side; ++row)
+		{
+			for (int column = 0; column < side; ++column)
+			{
+				GLfloat x0{-1.0f + 2.0f * column / side}, x1{-1.0f + 2.0f * (column + 1) / side};
+				GLfloat y0{-1.0f + 2.0f * row / side}, y1{-1.0f + 2.0f * (row + 1) / side};
+				GLfloat quad[]{x0, y0, x1, y0, x1, y1, x0, y0, x1, y1, x0, y1};
+
+				grid.first.push_back(static_cast<GLint>(grid.vertices.size() / 2));
+				grid.count.push_back(6);
+				grid.vertices.insert(grid.vertices.end(), std::begin(quad), std::end(quad));
+			}
+		}
+
+		return grid;
+	}
+
+	void drawGrid(FastPaths &paths, const Grid &grid, PFNGLVERTEXPOINTERPROC pfnVertexPointer)
+	{
+		const void *pVertices{paths.stream(grid.vertices.data(), grid.vertices.size() * sizeof(GLfloat))};
+
+		pfnVertexPointer(2, GL_FLOAT, 0, pVertices);
+		paths.multiDrawArrays(GL_TRIANGLES, grid.first.data(), grid.count.data(), static_cast<GLsizei>(grid.first.size()));
+	}
+
+	// Runs the paths benchmark once per version in pszVersions, separated by semicolons, with the same
+	// options. Each child's report is kept in the temporary folder.
+
+	int runVersionMatrix(const BenchmarkArguments &args, const wchar_t *pszVersions, BenchmarkReport &report)
+	{
+		const wchar_t *const kVariable{L"MESA_GL_VERSION_OVERRIDE"};
+		std::wstring options;
+		std::wstring list{pszVersions};
+		wchar_t tempPath[MAX_PATH]{};
+		wchar_t previous[256]{};
+		bool hadPrevious{GetEnvironmentVariableW(kVariable, previous, 256) > 0};
+		bool passed{true};
+
+		if (GetTempPathW(MAX_PATH, tempPath) == 0)
+			return EXIT_FAILURE;
+
+		for (const wchar_t *pszOption : {L"-draws", L"-iterations", L"-size", L"-library"})
+		{
+			if (const wchar_t *pszValue{args.value(pszOption)})
+				options += std::wstring{L" "} + pszOption + L" \"" + pszValue + L"\"";
+		}
+
+		report.setProperty("library", narrow(args.value(L"-library", L"default")));
+
+		for (size_t start = 0; start < list.size();)
+		{
+			size_t end{std::min(list.find(L';', start), list.size())};
+			std::wstring version{list.substr(start, end - start)};
+			wchar_t reportPath[MAX_PATH]{};
+
+			start = end + 1;
+
+			if (version.empty())
+				continue;
+
+			if (GetTempFileNameW(tempPath, L"glp", 0, reportPath) == 0)
+				return EXIT_FAILURE;
+
+			SetEnvironmentVariableW(kVariable, version.c_str());
+
+			int exitCode{runChildProcess(L"-benchmark paths" + options + L" -report \"" + reportPath + L"\"")};
+
+			if (exitCode != EXIT_SUCCESS)
+			{
+				std::fwprintf(stderr, L"The paths check failed with %ls=%ls (exit code %d).\n", kVariable, version.c_str(), exitCode);
+				passed = false;
+			}
+
+			report.beginResult();
+			report.set("versionOverride", narrow(version.c_str()));
+			report.set("exitCode", exitCode);
+			report.set("result", exitCode == EXIT_SUCCESS ? "pass" : "fail");
+			report.set("report", narrow(reportPath));
+		}
+
+		SetEnvironmentVariableW(kVariable, hadPrevious ? previous : nullptr);
+		return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+}
+
+int runPathsBenchmark(const BenchmarkArguments &args, BenchmarkReport &report)
+{
+	int side{std::max(1, static_cast<int>(std::sqrt(std::max(1, args.intValue(L"-draws", 4096)))))};
+	int iterations{std::max(1, args.intValue(L"-iterations", 200))};
+	int size{std::max(16, args.intValue(L"-size", 256))};
+
+	if (const wchar_t *pszVersions{args.value(L"-versions")})
+		return runVersionMatrix(args, pszVersions, report);
+
+	std::unique_ptr<HeadlessContext> pContext{HeadlessContext::create(size, size, nullptr, args.value(L"-library"))};
+
+	if (!pContext || !pContext->makeCurrent())
+		return EXIT_FAILURE;
+
+	OpenGLContext &context{pContext->wgl()};
+	auto pfnVertexPointer{reinterpret_cast<PFNGLVERTEXPOINTERPROC>(context.wglGetProcAddress("glVertexPointer"))};
+	auto pfnEnableClientState{reinterpret_cast<PFNGLENABLECLIENTSTATEPROC>(context.wglGetProcAddress("glEnableClientState"))};
+	auto pfnDisableClientState{reinterpret_cast<PFNGLENABLECLIENTSTATEPROC>(context.wglGetProcAddress("glDisableClientState"))};
+	auto pfnCompressedTexImage2D{reinterpret_cast<PFNGLCOMPRESSEDTEXIMAGE2DPROC>(context.wglGetProcAddress("glCompressedTexImage2D"))};
+	auto pfnGetCompressedTexImage{reinterpret_cast<PFNGLGETCOMPRESSEDTEXIMAGEPROC>(context.wglGetProcAddress("glGetCompressedTexImage"))};
+
+	if (!pfnVertexPointer || !pfnEnableClientState || !pfnDisableClientState)
+		return EXIT_FAILURE;
+
+	CapabilityProfile profile{CapabilityProfile::detect(context)};
+
+	reportDriverProperties(report);
+	report.setProperty("glVersion", std::to_string(profile.version.major) + "." + std::to_string(profile.version.minor));
+	report.setProperty("tier", CapabilityProfile::tierName(profile.tier));
+	report.setProperty("multiDraw", profile.multiDraw ? "yes" : "no");
+	report.setProperty("mapBufferRange", profile.mapBufferRange ? "yes" : "no");
+	report.setProperty("directStateAccess", profile.directStateAccess ? "yes" : "no");
+	report.setProperty("bufferStorage", profile.bufferStorage ? "yes" : "no");
+	report.setProperty("multiDrawIndirect", profile.multiDrawIndirect ? "yes" : "no");
+	report.setProperty("compressionS3tc", profile.compressionS3tc ? "yes" : "no");
+	report.setProperty("compressionRgtc", profile.compressionRgtc ? "yes" : "no");
+	report.setProperty("compressionBptc", profile.compressionBptc ? "yes" : "no");
+	report.setProperty("draws", side * side);
+	report.setProperty("iterations", iterations);
+	report.setProperty("size", size);
+
+	Grid grid{makeGrid(side)};
+	std::vector<std::uint32_t> texels(static_cast<size_t>(size) * size);
+	std::vector<std::uint32_t> readback(texels.size());
+	bool failed{false};
+
+	for (size_t i = 0; i < texels.size(); ++i)
+		texels[i] = static_cast<std::uint32_t>(i * 2654435761u) | 0xff000000u;
+
+	// Compressed textures are a whole number of 4x4 blocks of 16 bytes. Drivers keep uploaded blocks as
+	// they are, so they read back unchanged whatever they decode to.
+
+	GLsizei compressedSize{size / 4 * 4};
+	std::vector<unsigned char> blocks(static_cast<size_t>(compressedSize / 4) * (compressedSize / 4) * 16);
+	std::vector<unsigned char> blocksReadback(blocks.size());
+
+	for (size_t i = 0; i < blocks.size(); ++i)
+		blocks[i] = static_cast<unsigned char>((i * 2654435761u) >> 24);
+
+	GLuint texture{};
+
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glViewport(0, 0, size, size);
+	pfnEnableClientState(kVertexArray);
+
+	std::string previousPaths;
+
+	for (CapabilityTier tier : {CapabilityTier::Legacy, CapabilityTier::Buffers, CapabilityTier::Modern})
+	{
+		std::unique_ptr<FastPaths> pPaths{FastPaths::create(context, tier, grid.vertices.size() * sizeof(GLfloat) * 8)};
+
+		if (!pPaths)
+			return EXIT_FAILURE;
+
+		std::string paths{std::string{pPaths->uploadPath()} + "/" + pPaths->compressedUploadPath() + "/" + pPaths->streamPath() + "/" + pPaths->drawPath()};
+
+		if (paths == previousPaths)
+			continue;
+
+		previousPaths = paths;
+
+		// Correctness: the texture reads back as uploaded, and the grid leaves no pixel uncovered.
+
+		std::fill(readback.begin(), readback.end(), 0u);
+		pPaths->uploadTexture(texture, 0, 0, size, size, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, readback.data());
+
+		bool uploadCorrect{readback == texels};
+		GLenum compressedFormat{pfnCompressedTexImage2D && pfnGetCompressedTexImage ? pPaths->compressedFormat() : 0};
+		GLuint compressedTexture{};
+
+		if (compressedFormat)
+		{
+			std::fill(blocksReadback.begin(), blocksReadback.end(), static_cast<unsigned char>(0));
+			glGenTextures(1, &compressedTexture);
+			glBindTexture(GL_TEXTURE_2D, compressedTexture);
+			pfnCompressedTexImage2D(GL_TEXTURE_2D, 0, compressedFormat, compressedSize, compressedSize, 0, static_cast<GLsizei>(blocks.size()), nullptr);
+			pPaths->uploadCompressedTexture(compressedTexture, 0, 0, compressedSize, compressedSize, static_cast<GLsizei>(blocks.size()), blocks.data());
+			glBindTexture(GL_TEXTURE_2D, compressedTexture);
+			pfnGetCompressedTexImage(GL_TEXTURE_2D, 0, blocksReadback.data());
+			uploadCorrect = uploadCorrect && blocksReadback == blocks;
+		}
+
+		glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		drawGrid(*pPaths, grid, pfnVertexPointer);
+		glReadPixels(0, 0, size, size, GL_RGBA, GL_UNSIGNED_BYTE, readback.data());
+
+		bool drawCorrect{std::all_of(readback.begin(), readback.end(), [](std::uint32_t pixel) { return (pixel & 0x00ffffffu) == 0x00ffffffu; })};
+
+		if (!uploadCorrect || !drawCorrect)
+		{
+			std::fwprintf(stderr, L"The %hs tier (%hs) %ls.\n", CapabilityProfile::tierName(tier), paths.c_str(),
+				uploadCorrect ? L"drew the wrong pixels" : L"uploaded the wrong texels");
+			failed = true;
+		}
+
+		// Throughput.
+
+		Stopwatch uploadTimer;
+
+		for (int i = 0; i < iterations; ++i)
+			pPaths->uploadTexture(texture, 0, 0, size, size, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+
+		glFinish();
+
+		double uploadSeconds{uploadTimer.seconds()};
+		Stopwatch compressedTimer;
+
+		if (compressedFormat)
+		{
+			for (int i = 0; i < iterations; ++i)
+				pPaths->uploadCompressedTexture(compressedTexture, 0, 0, compressedSize, compressedSize, static_cast<GLsizei>(blocks.size()), blocks.data());
+
+			glFinish();
+		}
+
+		double compressedSeconds{compressedTimer.seconds()};
+		Stopwatch drawTimer;
+
+		for (int i = 0; i < iterations; ++i)
+			drawGrid(*pPaths, grid, pfnVertexPointer);
+
+		glFinish();
+
+		double drawSeconds{drawTimer.seconds()};
+
+		report.beginResult();
+		report.set("tier", CapabilityProfile::tierName(tier));
+		report.set("upload", pPaths->uploadPath());
+		report.set("compressedUpload", pPaths->compressedUploadPath());
+		report.set("stream", pPaths->streamPath());
+		report.set("draw", pPaths->drawPath());
+		report.set("uploadCorrect", uploadCorrect ? "yes" : "no");
+		report.set("drawCorrect", drawCorrect ? "yes" : "no");
+		report.set("uploadGBps", static_cast<double>(texels.size()) * sizeof(std::uint32_t) * iterations / uploadSeconds * 1e-9);
+
+		if (compressedFormat)
+		{
+			report.set("compressedFormat", compressedFormat == GL_COMPRESSED_RGBA_BPTC_UNORM ? "BPTC" : "DXT5");
+			report.set("compressedUploadGBps", static_cast<double>(blocks.size()) * iterations / compressedSeconds * 1e-9);
+			glDeleteTextures(1, &compressedTexture);
+		}
+
+		report.set("drawsPerSecond", static_cast<double>(grid.first.size()) * iterations / drawSeconds);
+		report.set("streamGBps", static_cast<double>(grid.vertices.size()) * sizeof(GLfloat) * iterations / drawSeconds * 1e-9);
+	}
+
+	pfnDisableClientState(kVertexArray);
+	glDeleteTextures(1, &texture);
+
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
\ No newline at end of file
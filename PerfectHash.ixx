@@ -0,0 +1,209 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+export module PerfectHash;
+
+// StringPool packs N names into one block of characters, each terminated by '\0', and finds them by
+// offset. It's built at compile time from a string literal such as "glClear\0glFlush\0".
+
+export template <std::size_t N>
+class StringPool
+{
+public:
+	consteval explicit StringPool(const char *pszPool) : m_pszPool(pszPool)
+	{
+		std::size_t offset{0};
+
+		for (std::size_t i = 0; i < N; ++i)
+		{
+			m_offsets[i] = static_cast<std::uint32_t>(offset);
+
+			while (pszPool[offset] != '\0')
+				++offset;
+
+			++offset;
+		}
+
+		m_offsets[N] = static_cast<std::uint32_t>(offset);
+	}
+
+	constexpr std::string_view operator[](std::size_t index) const
+	{
+		return std::string_view{m_pszPool + m_offsets[index], m_offsets[index + 1] - m_offsets[index] - 1};
+	}
+
+	constexpr const char *c_str(std::size_t index) const { return m_pszPool + m_offsets[index]; }
+
+	constexpr std::size_t bytes() const { return m_offsets[N] + sizeof(m_offsets); }
+
+	static constexpr std::size_t size() { return N; }
+
+private:
+	const char *m_pszPool;
+	std::uint32_t m_offsets[N + 1]{};
+};
+
+// PerfectHash maps each of N distinct names to its index with one hash of the name and one comparison,
+// and returns N for any other name. It's generated at compile time with hash and displace: the names
+// are split into buckets by their hash, and each bucket, largest first, is given the first displacement
+// that moves all of its names into free slots of a table of at least 2N slots. The names themselves
+// aren't stored. nameOf(index) returns them, both when building and to verify a lookup.
+
+export template <std::size_t N>
+class PerfectHash
+{
+public:
+	static constexpr std::size_t kSlots{std::bit_ceil(N * 2)};
+	static constexpr std::size_t kBuckets{N / 2 + 1};
+
+	static_assert(N < UINT16_MAX);
+
+	template <typename NameOf>
+	consteval explicit PerfectHash(NameOf nameOf)
+	{
+		std::uint64_t hashes[N]{};
+		std::size_t bucketSizes[kBuckets]{};
+		bool used[kSlots]{};
+
+		for (std::size_t i = 0; i < N; ++i)
+		{
+			hashes[i] = hash(nameOf(i));
+			++bucketSizes[bucketOf(hashes[i])];
+
+			for (std::size_t j = 0; j < i; ++j)
+			{
+				// Equal hashes can never be separated. A failure here stops compilation.
+
+				if (hashes[j] == hashes[i])
+					throw "names must be distinct";
+			}
+		}
+
+		for (std::size_t slot = 0; slot < kSlots; ++slot)
+			m_slots[slot] = static_cast<std::uint16_t>(N);
+
+		for (std::size_t size = N; size > 0; --size)
+		{
+			for (std::size_t bucket = 0; bucket < kBuckets; ++bucket)
+			{
+				if (bucketSizes[bucket] == size)
+					place(bucket, hashes, used);
+			}
+		}
+	}
+
+	// Returns the index of name, or N if it isn't one of the names.
+
+	template <typename NameOf>
+	constexpr std::size_t find(std::string_view name, NameOf nameOf) const
+	{
+		std::uint64_t h{hash(name)};
+		std::size_t index{m_slots[slotOf(h, m_displacements[bucketOf(h)])]};
+
+		return (index < N && nameOf(index) == name) ? index : N;
+	}
+
+	static constexpr std::size_t bytes() { return sizeof(PerfectHash); }
+
+private:
+	// FNV-1a.
+
+	static constexpr std::uint64_t hash(std::string_view name)
+	{
+		std::uint64_t h{0xcbf29ce484222325ull};
+
+		for (char c : name)
+			h = (h ^ static_cast<unsigned char>(c)) * 0x100000001b3ull;
+
+		return h;
+	}
+
+	static constexpr std::size_t bucketOf(std::uint64_t h)
+	{
+		return static_cast<std::size_t>((h >> 32) % kBuckets);
+	}
+
+	// The finalizer of SplitMix64, so that each displacement gives an unrelated slot.
+
+	static constexpr std::size_t slotOf(std::uint64_t h, std::uint16_t displacement)
+	{
+		std::uint64_t x{h + displacement * 0x9e3779b97f4a7c15ull};
+
+		x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+		x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+		x ^= x >> 31;
+
+		return static_cast<std::size_t>(x & (kSlots - 1));
+	}
+
+	constexpr void place(std::size_t bucket, const std::uint64_t (&hashes)[N], bool (&used)[kSlots])
+	{
+		for (std::uint32_t displacement = 0; displacement <= UINT16_MAX; ++displacement)
+		{
+			std::size_t slots[N]{};
+			std::size_t count{0};
+			bool fits{true};
+
+			for (std::size_t i = 0; i < N && fits; ++i)
+			{
+				if (bucketOf(hashes[i]) != bucket)
+					continue;
+
+				std::size_t slot{slotOf(hashes[i], static_cast<std::uint16_t>(displacement))};
+
+				fits = !used[slot];
+
+				for (std::size_t j = 0; j < count && fits; ++j)
+					fits = slots[j] != slot;
+
+				slots[count++] = slot;
+			}
+
+			if (!fits)
+				continue;
+
+			count = 0;
+
+			for (std::size_t i = 0; i < N; ++i)
+			{
+				if (bucketOf(hashes[i]) == bucket)
+				{
+					used[slots[count]] = true;
+					m_slots[slots[count++]] = static_cast<std::uint16_t>(i);
+				}
+			}
+
+			m_displacements[bucket] = static_cast<std::uint16_t>(displacement);
+			return;
+		}
+
+		throw "no displacement places the bucket";
+	}
+
+	std::uint16_t m_displacements[kBuckets]{};
+	std::uint16_t m_slots[kSlots]{};
+};
\ No newline at end of file
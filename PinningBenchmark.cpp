@@ -0,0 +1,226 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+module Benchmark;
+
+import HeadlessContext;
+import OpenGL;
+import Scene;
+import Topology;
+
+// Measures how much pinning the GL thread steadies its frame times.
+//
+//     -benchmark pinning [-scene name] [-frames n] [-size n] [-seed n]
+//
+// The same scene is rendered on a fresh thread three times: left to the scheduler, restricted to the
+// NUMA node of the processor CpuTopology::placement() picks, and pinned to that processor. Each row
+// gives the frame time variance and tail, and how often the thread moved between processors.
+
+namespace
+{
+	const int kWarmUpFrames{10};
+
+	enum class Pinning
+	{
+		None,
+		Node,
+		Processor,
+	};
+
+	struct PinningRun
+	{
+		bool ok{false};
+		const char *pszScene{""};
+		std::vector<double> frameSeconds;
+		unsigned migrations{0};
+		unsigned processorsUsed{0};
+	};
+
+	// The index of the logical processor the calling thread is running on.
+
+	unsigned currentProcessor(const CpuTopology &topology)
+	{
+		PROCESSOR_NUMBER number{};
+
+		GetCurrentProcessorNumberEx(&number);
+
+		for (const LogicalProcessor &processor : topology.processors())
+		{
+			if (processor.group == number.Group && processor.number == number.Number)
+				return processor.index;
+		}
+
+		return 0;
+	}
+
+	// The rendering context is created on a thread of its own so that every run starts with the
+	// process's default affinity, and the thread is pinned after the context exists, as GLApplication
+	// does, so that driver threads created with the context don't inherit the restriction.
+
+	PinningRun renderFrames(Pinning pinning, unsigned processor, const wchar_t *pszScene, std::uint32_t seed, int frames, int size, BenchmarkReport *pReport)
+	{
+		PinningRun run;
+
+		std::thread thread([&]()
+		{
+			const CpuTopology &topology{CpuTopology::instance()};
+			std::unique_ptr<HeadlessContext> pContext{HeadlessContext::create(size, size)};
+
+			if (!pContext || !pContext->makeCurrent())
+				return;
+
+			if (pinning == Pinning::Node && !topology.pinCurrentThreadToNode(topology.processors()[processor].numaNode))
+				return;
+
+			if (pinning == Pinning::Processor && !topology.pinCurrentThread(processor))
+				return;
+
+			std::unique_ptr<Scene> pScene{Scene::create(pszScene, seed, pContext->wgl(), pContext->dc())};
+
+			if (!pScene)
+				return;
+
+			if (pReport)
+				reportDriverProperties(*pReport);
+
+			for (int frame = 0; frame < kWarmUpFrames; ++frame)
+				pScene->render(size, size, static_cast<std::uint64_t>(frame));
+
+			glFinish();
+
+			std::vector<bool> used(topology.processors().size(), false);
+			unsigned previous{currentProcessor(topology)};
+
+			run.frameSeconds.reserve(static_cast<size_t>(frames));
+
+			for (int frame = 0; frame < frames; ++frame)
+			{
+				Stopwatch stopwatch;
+
+				pScene->render(size, size, static_cast<std::uint64_t>(kWarmUpFrames + frame));
+				glFinish();
+				run.frameSeconds.push_back(stopwatch.seconds());
+
+				unsigned current{currentProcessor(topology)};
+
+				if (current != previous)
+					++run.migrations;
+
+				if (current < used.size() && !used[current])
+				{
+					used[current] = true;
+					++run.processorsUsed;
+				}
+
+				previous = current;
+			}
+
+			run.pszScene = pScene->name();
+			run.ok = true;
+		});
+
+		thread.join();
+		return run;
+	}
+}
+
+int runPinningBenchmark(const BenchmarkArguments &args, BenchmarkReport &report)
+{
+	const wchar_t *pszScene{args.value(L"-scene", L"statechurn")};
+	int frames{std::max(10, args.intValue(L"-frames", 1000))};
+	int size{std::max(16, args.intValue(L"-size", 256))};
+	std::uint32_t seed{static_cast<std::uint32_t>(args.intValue(L"-seed", 1))};
+	const CpuTopology &topology{CpuTopology::instance()};
+	unsigned processor{topology.placement(1).front()};
+
+	report.setProperty("topology", topology.describe());
+	report.setProperty("frames", frames);
+	report.setProperty("size", size);
+	report.setProperty("seed", seed);
+	report.setProperty("processor", processor);
+	report.setProperty("numaNode", topology.processors()[processor].numaNode);
+
+	struct Mode
+	{
+		const char *pszName;
+		Pinning pinning;
+	};
+
+	const Mode modes[]
+	{
+		{"none", Pinning::None},
+		{"node", Pinning::Node},
+		{"processor", Pinning::Processor},
+	};
+
+	double unpinnedVariance{0.0};
+
+	for (const Mode &mode : modes)
+	{
+		PinningRun run{renderFrames(mode.pinning, processor, pszScene, seed, frames, size, mode.pinning == Pinning::None ? &report : nullptr)};
+
+		if (!run.ok)
+			return EXIT_FAILURE;
+
+		double count{static_cast<double>(run.frameSeconds.size())};
+		double mean{0.0};
+		double sumOfSquares{0.0};
+
+		for (double seconds : run.frameSeconds)
+			mean += seconds / count;
+
+		for (double seconds : run.frameSeconds)
+			sumOfSquares += (seconds - mean) * (seconds - mean);
+
+		double variance{sumOfSquares / count * 1e6};
+
+		if (mode.pinning == Pinning::None)
+		{
+			unpinnedVariance = variance;
+			report.setProperty("scene", run.pszScene);
+		}
+
+		report.beginResult();
+		report.set("pinning", mode.pszName);
+		report.set("frameMsMean", mean * 1e3);
+		report.set("frameMsStdDev", std::sqrt(variance));
+		report.set("frameMsVariance", variance);
+		report.set("frameMsP50", percentile(run.frameSeconds, 0.50) * 1e3);
+		report.set("frameMsP99", percentile(run.frameSeconds, 0.99) * 1e3);
+		report.set("frameMsMax", percentile(run.frameSeconds, 1.0) * 1e3);
+		report.set("varianceVsUnpinned", unpinnedVariance > 0.0 ? variance / unpinnedVariance : 0.0);
+		report.set("migrations", run.migrations);
+		report.set("processorsUsed", run.processorsUsed);
+	}
+
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
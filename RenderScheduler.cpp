@@ -0,0 +1,370 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+module RenderScheduler;
+
+import OpenGL;
+import Topology;
+
+namespace
+{
+	std::int64_t nowNanoseconds()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+}
+
+struct RenderScheduler::WorkerState
+{
+	unsigned index{};
+	int width{};
+	int height{};
+	int processor{-1};
+	std::thread thread;
+	std::mutex queueMutex;
+	std::deque<Job> jobs;
+	std::deque<Job> pinnedJobs;
+	std::atomic<std::uint64_t> pinnedQueued{0};
+	std::atomic<std::uint64_t> jobsExecuted{0};
+	std::atomic<std::uint64_t> jobsStolen{0};
+	std::atomic<std::uint64_t> cacheHits{0};
+	std::atomic<std::uint64_t> cacheMisses{0};
+	std::atomic<std::int64_t> busyNanoseconds{0};
+	std::atomic<std::int64_t> statsStartNanoseconds{0};
+};
+
+//
+// RenderScheduler methods
+//
+
+std::unique_ptr<RenderScheduler> RenderScheduler::create(unsigned workerCount, int width, int height, bool pinThreads)
+{
+	std::unique_ptr<RenderScheduler> pScheduler{new RenderScheduler()};
+
+	if (workerCount == 0)
+		workerCount = 1;
+
+	// Workers are spread across NUMA nodes and physical cores before SMT siblings are used.
+
+	std::vector<unsigned> placement{CpuTopology::instance().placement(workerCount)};
+
+	for (unsigned i = 0; i < workerCount; ++i)
+	{
+		std::unique_ptr<WorkerState> pState{new WorkerState()};
+
+		pState->index = i;
+		pState->width = width;
+		pState->height = height;
+		pState->processor = (pinThreads && i < placement.size()) ? static_cast<int>(placement[i]) : -1;
+		pState->statsStartNanoseconds = nowNanoseconds();
+		pScheduler->m_workers.push_back(std::move(pState));
+	}
+
+	// The worker states must all exist before any thread starts because idle workers steal from each other.
+
+	for (auto &pState : pScheduler->m_workers)
+	{
+		WorkerState &state{*pState};
+		state.thread = std::thread([pRaw = pScheduler.get(), &state]() { pRaw->workerMain(state); });
+	}
+
+	std::unique_lock<std::mutex> lock{pScheduler->m_mutex};
+	pScheduler->m_done.wait(lock, [&]() { return pScheduler->m_started == workerCount; });
+
+	if (pScheduler->m_startFailed)
+		return std::unique_ptr<RenderScheduler>{};
+
+	return pScheduler;
+}
+
+RenderScheduler::~RenderScheduler()
+{
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		m_stopping = true;
+	}
+
+	m_wake.notify_all();
+
+	for (auto &pState : m_workers)
+	{
+		if (pState->thread.joinable())
+			pState->thread.join();
+	}
+}
+
+void RenderScheduler::submit(Job job)
+{
+	submit(m_nextWorker.fetch_add(1, std::memory_order_relaxed) % workerCount(), std::move(job));
+}
+
+void RenderScheduler::submit(unsigned worker, Job job)
+{
+	push(worker, std::move(job), false);
+}
+
+void RenderScheduler::submitPinned(unsigned worker, Job job)
+{
+	push(worker, std::move(job), true);
+}
+
+void RenderScheduler::push(unsigned worker, Job job, bool pinned)
+{
+	WorkerState &state{*m_workers[worker % workerCount()]};
+
+	// The counts only go up once the job is queued, and under the queue mutex, so a failed push leaves
+	// them alone and no worker can take the job before they count it.
+
+	{
+		std::lock_guard<std::mutex> lock{state.queueMutex};
+		(pinned ? state.pinnedJobs : state.jobs).push_back(std::move(job));
+		m_outstanding.fetch_add(1);
+		(pinned ? state.pinnedQueued : m_queued).fetch_add(1);
+	}
+
+	// Acquire the wake mutex before notifying so a worker that has just found the queues empty
+	// can't miss the notification between testing its wait predicate and going to sleep.
+
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+	}
+
+	m_wake.notify_all();
+}
+
+void RenderScheduler::wait()
+{
+	std::unique_lock<std::mutex> lock{m_mutex};
+	m_done.wait(lock, [this]() { return m_outstanding.load() == 0; });
+}
+
+void RenderScheduler::resetStats()
+{
+	std::int64_t now{nowNanoseconds()};
+
+	for (auto &pState : m_workers)
+	{
+		pState->jobsExecuted = 0;
+		pState->jobsStolen = 0;
+		pState->cacheHits = 0;
+		pState->cacheMisses = 0;
+		pState->busyNanoseconds = 0;
+		pState->statsStartNanoseconds = now;
+	}
+}
+
+std::vector<RenderWorkerStats> RenderScheduler::stats() const
+{
+	std::vector<RenderWorkerStats> result;
+	std::int64_t now{nowNanoseconds()};
+
+	for (const auto &pState : m_workers)
+	{
+		RenderWorkerStats stats{};
+
+		stats.index = pState->index;
+		stats.processor = pState->processor;
+		stats.jobsExecuted = pState->jobsExecuted.load();
+		stats.jobsStolen = pState->jobsStolen.load();
+		stats.cacheHits = pState->cacheHits.load();
+		stats.cacheMisses = pState->cacheMisses.load();
+		stats.busySeconds = static_cast<double>(pState->busyNanoseconds.load()) * 1e-9;
+		stats.elapsedSeconds = static_cast<double>(now - pState->statsStartNanoseconds.load()) * 1e-9;
+		result.push_back(stats);
+	}
+
+	return result;
+}
+
+void RenderScheduler::workerMain(WorkerState &state)
+{
+	if (state.processor >= 0)
+		CpuTopology::instance().pinCurrentThread(static_cast<unsigned>(state.processor));
+
+	std::unique_ptr<HeadlessContext> pContext{HeadlessContext::create(state.width, state.height)};
+	bool ok{pContext && pContext->makeCurrent()};
+
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		++m_started;
+
+		if (!ok)
+			m_startFailed = true;
+	}
+
+	m_done.notify_all();
+
+	if (!ok)
+		return;
+
+	RenderWorker worker{state, std::move(pContext)};
+	Job job;
+	bool stolen{false};
+
+	while (true)
+	{
+		if (!popJob(state.index, job, stolen))
+		{
+			std::unique_lock<std::mutex> lock{m_mutex};
+			m_wake.wait(lock, [this, &state]() { return m_stopping || m_queued.load() > 0 || state.pinnedQueued.load() > 0; });
+
+			if (m_stopping && m_queued.load() == 0 && state.pinnedQueued.load() == 0)
+				break;
+
+			continue;
+		}
+
+		std::int64_t start{nowNanoseconds()};
+		job(worker);
+		state.busyNanoseconds.fetch_add(nowNanoseconds() - start, std::memory_order_relaxed);
+		state.jobsExecuted.fetch_add(1, std::memory_order_relaxed);
+
+		if (stolen)
+			state.jobsStolen.fetch_add(1, std::memory_order_relaxed);
+
+		job = nullptr;
+
+		if (m_outstanding.fetch_sub(1) == 1)
+		{
+			std::lock_guard<std::mutex> lock{m_mutex};
+			m_done.notify_all();
+		}
+	}
+}
+
+bool RenderScheduler::popJob(unsigned index, Job &job, bool &stolen)
+{
+	unsigned count{workerCount()};
+
+	// Take the oldest job from our own queues first, pinned jobs before the rest, then steal the newest
+	// unpinned job from the other workers.
+
+	for (unsigned i = 0; i < count; ++i)
+	{
+		WorkerState &victim{*m_workers[(index + i) % count]};
+		std::lock_guard<std::mutex> lock{victim.queueMutex};
+
+		if (i == 0 && !victim.pinnedJobs.empty())
+		{
+			job = std::move(victim.pinnedJobs.front());
+			victim.pinnedJobs.pop_front();
+			victim.pinnedQueued.fetch_sub(1);
+			stolen = false;
+			return true;
+		}
+		else if (victim.jobs.empty())
+		{
+			continue;
+		}
+		else if (i == 0)
+		{
+			job = std::move(victim.jobs.front());
+			victim.jobs.pop_front();
+		}
+		else
+		{
+			job = std::move(victim.jobs.back());
+			victim.jobs.pop_back();
+		}
+
+		stolen = i != 0;
+		m_queued.fetch_sub(1);
+		return true;
+	}
+
+	return false;
+}
+
+//
+// RenderWorker methods
+//
+
+RenderWorker::RenderWorker(RenderScheduler::WorkerState &state, std::unique_ptr<HeadlessContext> pContext)
+	: m_state(state), m_index(state.index), m_pContext(std::move(pContext))
+{
+}
+
+RenderWorker::~RenderWorker()
+{
+	for (const auto &entry : m_textures)
+		glDeleteTextures(1, &entry.second);
+
+	m_textures.clear();
+
+	// Programs need GL 2.0, so a worker only has them if its context does.
+
+	if (!m_programs.empty())
+	{
+		auto pfnDeleteProgram{reinterpret_cast<PFNGLDELETEPROGRAMPROC>(m_pContext->wgl().wglGetProcAddress("glDeleteProgram"))};
+
+		if (pfnDeleteProgram)
+		{
+			for (const auto &entry : m_programs)
+				pfnDeleteProgram(entry.second);
+		}
+
+		m_programs.clear();
+	}
+	m_pContext->doneCurrent();
+}
+
+GLuint RenderWorker::cachedTexture(std::uint64_t key, const std::function<GLuint()> &create)
+{
+	auto it{m_textures.find(key)};
+
+	if (it != m_textures.end())
+	{
+		m_state.cacheHits.fetch_add(1, std::memory_order_relaxed);
+		return it->second;
+	}
+
+	m_state.cacheMisses.fetch_add(1, std::memory_order_relaxed);
+	return m_textures[key] = create();
+}
+
+GLuint RenderWorker::cachedProgram(std::uint64_t key, const std::function<GLuint()> &create)
+{
+	auto it{m_programs.find(key)};
+
+	if (it != m_programs.end())
+	{
+		m_state.cacheHits.fetch_add(1, std::memory_order_relaxed);
+		return it->second;
+	}
+
+	m_state.cacheMisses.fetch_add(1, std::memory_order_relaxed);
+	return m_programs[key] = create();
+}
\ No newline at end of file
@@ -0,0 +1,149 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+export module RenderScheduler;
+
+import HeadlessContext;
+
+// The RenderScheduler class owns a pool of worker threads. Each worker creates its own HeadlessContext
+// on startup and keeps it current for the lifetime of the thread, so software rasterizers such as
+// Mesa llvmpipe, which only scale across cores when many independent contexts render concurrently,
+// can be kept busy. Submitted jobs are distributed round-robin over per-worker queues. Idle workers
+// steal from the back of other workers' queues so that uneven jobs don't leave cores idle. Jobs that
+// must run on a particular worker, such as ones that warm its cache, are pinned to it and never stolen.
+
+export class RenderWorker;
+
+export struct RenderWorkerStats
+{
+	unsigned index{};
+	int processor{-1};
+	std::uint64_t jobsExecuted{};
+	std::uint64_t jobsStolen{};
+	std::uint64_t cacheHits{};
+	std::uint64_t cacheMisses{};
+	double busySeconds{};
+	double elapsedSeconds{};
+
+	double utilisation() const { return elapsedSeconds > 0.0 ? busySeconds / elapsedSeconds : 0.0; }
+};
+
+export class RenderScheduler
+{
+public:
+	using Job = std::function<void(RenderWorker &)>;
+
+	// Create a scheduler with workerCount worker threads. When pinThreads is true each worker is
+	// restricted to a single logical processor chosen by CpuTopology::placement(), so workers are
+	// spread evenly across NUMA nodes. Returns null if any worker failed to create its context.
+
+	static std::unique_ptr<RenderScheduler> create(unsigned workerCount, int width, int height, bool pinThreads = true);
+
+	~RenderScheduler();
+
+	RenderScheduler(const RenderScheduler &) = delete;
+	RenderScheduler &operator=(const RenderScheduler &) = delete;
+
+	void submit(Job job);
+	void submit(unsigned worker, Job job);
+	void submitPinned(unsigned worker, Job job);
+	void wait();
+
+	void resetStats();
+	std::vector<RenderWorkerStats> stats() const;
+	unsigned workerCount() const { return static_cast<unsigned>(m_workers.size()); }
+
+private:
+	friend class RenderWorker;
+
+	struct WorkerState;
+
+	RenderScheduler() = default;
+
+	void workerMain(WorkerState &state);
+	void push(unsigned worker, Job job, bool pinned);
+	bool popJob(unsigned index, Job &job, bool &stolen);
+
+	std::vector<std::unique_ptr<WorkerState>> m_workers;
+
+	// Unpinned jobs waiting in any queue. Each worker counts its own pinned jobs.
+
+	std::atomic<std::uint64_t> m_queued{0};
+	std::atomic<std::uint64_t> m_outstanding{0};
+	std::atomic<unsigned> m_nextWorker{0};
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_done;
+	unsigned m_started{0};
+	bool m_startFailed{false};
+	bool m_stopping{false};
+};
+
+// A RenderWorker is passed to every job. It provides access to the worker's current context and to a
+// per-context cache of GL objects that persist between jobs, so jobs that reuse the same textures and
+// programs don't pay to recreate them on every run. Textures and programs have their own keys, and
+// both count towards the worker's cache hits and misses. Cached objects are deleted when the worker
+// shuts down.
+
+export class RenderWorker
+{
+public:
+	unsigned index() const { return m_index; }
+	HeadlessContext &context() const { return *m_pContext; }
+
+	// Return the texture cached under key, calling create to make it on first use.
+
+	GLuint cachedTexture(std::uint64_t key, const std::function<GLuint()> &create);
+
+	// Return the program cached under key, calling create to compile and link it on first use.
+
+	GLuint cachedProgram(std::uint64_t key, const std::function<GLuint()> &create);
+
+	~RenderWorker();
+
+	RenderWorker(const RenderWorker &) = delete;
+	RenderWorker &operator=(const RenderWorker &) = delete;
+
+private:
+	friend class RenderScheduler;
+
+	RenderWorker(RenderScheduler::WorkerState &state, std::unique_ptr<HeadlessContext> pContext);
+
+	RenderScheduler::WorkerState &m_state;
+	unsigned m_index{};
+	std::unique_ptr<HeadlessContext> m_pContext;
+	std::unordered_map<std::uint64_t, GLuint> m_textures;
+	std::unordered_map<std::uint64_t, GLuint> m_programs;
+};
\ No newline at end of file
@@ -0,0 +1,1020 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+module;
+
+#include <windows.h>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+module Results;
+
+import Benchmark;
+
+namespace
+{
+	// Just enough JSON to read back what BenchmarkReport writes.
+
+	struct JsonValue
+	{
+		enum class Type { Null, Boolean, Number, String, Array, Object };
+
+		Type type{Type::Null};
+		bool boolean{};
+		double number{};
+		std::string string;
+		std::vector<JsonValue> elements;
+		std::vector<std::string> keys;
+
+		const JsonValue *find(const char *pszKey) const
+		{
+			for (size_t i = 0; i < keys.size(); ++i)
+			{
+				if (keys[i] == pszKey)
+					return &elements[i];
+			}
+
+			return nullptr;
+		}
+	};
+
+	class JsonParser
+	{
+	public:
+		explicit JsonParser(const std::string &text) : m_text(text) {}
+
+		bool parse(JsonValue &value)
+		{
+			if (!parseValue(value, 0))
+				return false;
+
+			skipSpace();
+			return m_position == m_text.size();
+		}
+
+	private:
+		static const int kMaxDepth{64};
+
+		void skipSpace()
+		{
+			while (m_position < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_position])))
+				++m_position;
+		}
+
+		bool consume(const char *pszToken)
+		{
+			size_t length{std::strlen(pszToken)};
+
+			if (m_text.compare(m_position, length, pszToken) != 0)
+				return false;
+
+			m_position += length;
+			return true;
+		}
+
+		bool parseValue(JsonValue &value, int depth)
+		{
+			skipSpace();
+
+			if (depth > kMaxDepth || m_position >= m_text.size())
+				return false;
+
+			char c{m_text[m_position]};
+
+			if (c == '{')
+				return parseObject(value, depth);
+
+			if (c == '[')
+				return parseArray(value, depth);
+
+			if (c == '"')
+			{
+				value.type = JsonValue::Type::String;
+				return parseString(value.string);
+			}
+
+			if (consume("true") || consume("false"))
+			{
+				value.type = JsonValue::Type::Boolean;
+				value.boolean = m_text[m_position - 4] == 't';
+				return true;
+			}
+
+			if (consume("null"))
+			{
+				value.type = JsonValue::Type::Null;
+				return true;
+			}
+
+			const char *pszStart{m_text.c_str() + m_position};
+			char *pszEnd{nullptr};
+
+			value.type = JsonValue::Type::Number;
+			value.number = std::strtod(pszStart, &pszEnd);
+
+			if (pszEnd == pszStart)
+				return false;
+
+			m_position += static_cast<size_t>(pszEnd - pszStart);
+			return true;
+		}
+
+		bool parseObject(JsonValue &value, int depth)
+		{
+			value.type = JsonValue::Type::Object;
+			++m_position;
+			skipSpace();
+
+			if (consume("}"))
+				return true;
+
+			while (true)
+			{
+				std::string key;
+				JsonValue element;
+
+				skipSpace();
+
+				if (m_position >= m_text.size() || m_text[m_position] != '"' || !parseString(key))
+					return false;
+
+				skipSpace();
+
+				if (!consume(":") || !parseValue(element, depth + 1))
+					return false;
+
+				value.keys.push_back(key);
+				value.elements.push_back(element);
+				skipSpace();
+
+				if (consume("}"))
+					return true;
+
+				if (!consume(","))
+					return false;
+			}
+		}
+
+		bool parseArray(JsonValue &value, int depth)
+		{
+			value.type = JsonValue::Type::Array;
+			++m_position;
+			skipSpace();
+
+			if (consume("]"))
+				return true;
+
+			while (true)
+			{
+				JsonValue element;
+
+				if (!parseValue(element, depth + 1))
+					return false;
+
+				value.elements.push_back(element);
+				skipSpace();
+
+				if (consume("]"))
+					return true;
+
+				if (!consume(","))
+					return false;
+			}
+		}
+
+		bool parseString(std::string &result)
+		{
+			++m_position;
+
+			while (m_position < m_text.size())
+			{
+				char c{m_text[m_position++]};
+
+				if (c == '"')
+					return true;
+
+				if (c != '\\')
+				{
+					result += c;
+					continue;
+				}
+
+				if (m_position >= m_text.size())
+					return false;
+
+				switch (m_text[m_position++])
+				{
+				case '"': result += '"'; break;
+				case '\\': result += '\\'; break;
+				case '/': result += '/'; break;
+				case 'b': result += '\b'; break;
+				case 'f': result += '\f'; break;
+				case 'n': result += '\n'; break;
+				case 'r': result += '\r'; break;
+				case 't': result += '\t'; break;
+				case 'u':
+				{
+					// BenchmarkReport only escapes control characters, so anything outside ASCII is replaced.
+
+					if (m_position + 4 > m_text.size())
+						return false;
+
+					unsigned long code{std::strtoul(m_text.substr(m_position, 4).c_str(), nullptr, 16)};
+
+					result += code < 0x80 ? static_cast<char>(code) : '?';
+					m_position += 4;
+					break;
+				}
+				default:
+					return false;
+				}
+			}
+
+			return false;
+		}
+
+		const std::string &m_text;
+		size_t m_position{};
+	};
+
+	// Write a value back out on a single line for the JSON Lines database.
+
+	std::string toJson(const JsonValue &value)
+	{
+		switch (value.type)
+		{
+		case JsonValue::Type::Boolean:
+			return value.boolean ? "true" : "false";
+
+		case JsonValue::Type::Number:
+		{
+			char buffer[32]{};
+			std::snprintf(buffer, sizeof(buffer), "%.17g", value.number);
+			return buffer;
+		}
+
+		case JsonValue::Type::String:
+			return BenchmarkReport::quote(value.string);
+
+		case JsonValue::Type::Array:
+		case JsonValue::Type::Object:
+		{
+			bool object{value.type == JsonValue::Type::Object};
+			std::string json{object ? "{" : "["};
+
+			for (size_t i = 0; i < value.elements.size(); ++i)
+			{
+				if (i)
+					json += ",";
+
+				if (object)
+					json += BenchmarkReport::quote(value.keys[i]) + ":";
+
+				json += toJson(value.elements[i]);
+			}
+
+			return json + (object ? "}" : "]");
+		}
+
+		default:
+			return "null";
+		}
+	}
+
+	bool readFile(const wchar_t *pszPath, std::string &contents)
+	{
+		FILE *pFile{nullptr};
+
+		if (!pszPath || _wfopen_s(&pFile, pszPath, L"rb") != 0)
+			return false;
+
+		char buffer[4096];
+		size_t count{0};
+
+		contents.clear();
+
+		while ((count = std::fread(buffer, 1, sizeof(buffer), pFile)) > 0)
+			contents.append(buffer, count);
+
+		std::fclose(pFile);
+		return true;
+	}
+
+	struct StoredRun
+	{
+		std::string label;
+		std::string stored;
+		JsonValue report;
+	};
+
+	bool readDatabase(const wchar_t *pszPath, std::vector<StoredRun> &runs)
+	{
+		std::string contents;
+
+		if (!readFile(pszPath, contents))
+			return false;
+
+		size_t start{0};
+		unsigned lineNumber{0};
+
+		while (start < contents.size())
+		{
+			size_t end{contents.find('\n', start)};
+			std::string line{contents.substr(start, end == std::string::npos ? std::string::npos : end - start)};
+
+			start = end == std::string::npos ? contents.size() : end + 1;
+			++lineNumber;
+
+			if (line.find_first_not_of(" \t\r") == std::string::npos)
+				continue;
+
+			JsonValue entry;
+			const JsonValue *pLabel{nullptr};
+			const JsonValue *pReport{nullptr};
+
+			if (!JsonParser{line}.parse(entry) || !(pLabel = entry.find("label")) || !(pReport = entry.find("report")))
+			{
+				std::fwprintf(stderr, L"%ls(%u): not a stored benchmark report\n", pszPath, lineNumber);
+				return false;
+			}
+
+			const JsonValue *pStored{entry.find("stored")};
+
+			runs.push_back(StoredRun{pLabel->string, pStored ? pStored->string : std::string{}, *pReport});
+		}
+
+		return true;
+	}
+
+	int storeReport(const BenchmarkArguments &args)
+	{
+		const wchar_t *pszDatabase{args.value(L"-db")};
+		const wchar_t *pszLabel{args.value(L"-label")};
+		const wchar_t *pszInput{args.value(L"-input")};
+		std::string text;
+		JsonValue report;
+
+		if (!pszDatabase || !pszLabel || !pszInput)
+		{
+			std::fwprintf(stderr, L"Usage: -results store -db <file> -label <name> -input <report>\n");
+			return EXIT_FAILURE;
+		}
+
+		if (!readFile(pszInput, text) || !JsonParser{text}.parse(report) || !report.find("benchmark") || !report.find("results"))
+		{
+			std::fwprintf(stderr, L"%ls: not a benchmark report\n", pszInput);
+			return EXIT_FAILURE;
+		}
+
+		SYSTEMTIME time{};
+		char stored[32]{};
+		char computer[MAX_COMPUTERNAME_LENGTH + 1]{};
+		DWORD computerLength{sizeof(computer)};
+
+		GetSystemTime(&time);
+		std::snprintf(stored, sizeof(stored), "%04u-%02u-%02uT%02u:%02u:%02uZ", time.wYear, time.wMonth, time.wDay, time.wHour, time.wMinute, time.wSecond);
+		GetComputerNameA(computer, &computerLength);
+
+		std::string line{"{\"label\":" + BenchmarkReport::quote(narrow(pszLabel)) + ",\"stored\":" + BenchmarkReport::quote(stored) + ",\"computer\":" + BenchmarkReport::quote(computer) + ",\"report\":" + toJson(report) + "}\n"};
+		FILE *pFile{nullptr};
+
+		if (_wfopen_s(&pFile, pszDatabase, L"ab") != 0)
+			return EXIT_FAILURE;
+
+		bool ok{std::fwrite(line.data(), 1, line.size(), pFile) == line.size()};
+
+		return (std::fclose(pFile) == 0 && ok) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	int listRuns(const BenchmarkArguments &args, BenchmarkReport &report)
+	{
+		std::vector<StoredRun> runs;
+
+		if (!readDatabase(args.value(L"-db"), runs))
+			return EXIT_FAILURE;
+
+		// One row per label and benchmark, in the order they were first stored.
+
+		std::vector<std::pair<std::string, std::string>> keys;
+		std::map<std::pair<std::string, std::string>, std::vector<const StoredRun *>> groups;
+
+		for (const StoredRun &run : runs)
+		{
+			const JsonValue *pBenchmark{run.report.find("benchmark")};
+			std::pair<std::string, std::string> key{run.label, pBenchmark ? pBenchmark->string : std::string{}};
+
+			if (groups[key].empty())
+				keys.push_back(key);
+
+			groups[key].push_back(&run);
+		}
+
+		for (const auto &key : keys)
+		{
+			const std::vector<const StoredRun *> &group{groups[key]};
+
+			report.beginResult();
+			report.set("label", key.first);
+			report.set("benchmark", key.second);
+			report.set("runs", static_cast<double>(group.size()));
+			report.set("firstStored", group.front()->stored);
+			report.set("lastStored", group.back()->stored);
+		}
+
+		return EXIT_SUCCESS;
+	}
+
+	// Which way each metric improves. Parameters and identifiers, such as a thread count or a worker
+	// index, and counts of calls the workload itself makes aren't measurements, so they're not compared.
+	// A metric that isn't listed is reported as unclassified rather than guessed at, so a benchmark
+	// that adds a metric should add it here too. The table is sorted by name.
+
+	enum class Direction
+	{
+		Higher,
+		Lower,
+		None,
+	};
+
+	struct MetricDirection
+	{
+		const char *pszMetric;
+		Direction direction;
+	};
+
+	const MetricDirection kMetricDirections[]
+	{
+		{"acquireMsMax", Direction::Lower},
+		{"acquireMsP50", Direction::Lower},
+		{"acquireMsP99", Direction::Lower},
+		{"activeTextureCallsPerFrame", Direction::None},
+		{"activeTexturesForwardedPerFrame", Direction::Lower},
+		{"actual", Direction::None},
+		{"alignment", Direction::None},
+		{"arenaAllocationsPerFrame", Direction::Lower},
+		{"arenaBytesMax", Direction::Lower},
+		{"arenaBytesPerFrame", Direction::Lower},
+		{"arenaCapacity", Direction::None},
+		{"arenaHeapBlocks", Direction::Lower},
+		{"bindCallsPerFrame", Direction::None},
+		{"bindsForwardedPerFrame", Direction::Lower},
+		{"busySeconds", Direction::Lower},
+		{"bytesPerFrame", Direction::None},
+		{"cacheHits", Direction::Higher},
+		{"cacheMisses", Direction::Lower},
+		{"calls", Direction::None},
+		{"callsPerFrame", Direction::None},
+		{"compressedUploadGBps", Direction::Higher},
+		{"costRelativeToDraw", Direction::Lower},
+		{"cpuMsP50", Direction::Lower},
+		{"cpuMsP99", Direction::Lower},
+		{"drawsPerSecond", Direction::Higher},
+		{"dsaCallsPerFrame", Direction::None},
+		{"editBindsPerFrame", Direction::Lower},
+		{"efficiency", Direction::Higher},
+		{"emulatedPerFrame", Direction::Lower},
+		{"exitCode", Direction::None},
+		{"expected", Direction::None},
+		{"filteredPerFrame", Direction::Higher},
+		{"forwardedPerFrame", Direction::Lower},
+		{"frameMsMax", Direction::Lower},
+		{"frameMsMean", Direction::Lower},
+		{"frameMsP50", Direction::Lower},
+		{"frameMsP99", Direction::Lower},
+		{"frameMsStdDev", Direction::Lower},
+		{"frameMsVariance", Direction::Lower},
+		{"frameUsMean", Direction::Lower},
+		{"frameUsP50", Direction::Lower},
+		{"frameUsP99", Direction::Lower},
+		{"framesPerSecond", Direction::Higher},
+		{"gigabytesPerSecond", Direction::Higher},
+		{"gpuMsMax", Direction::Lower},
+		{"gpuMsP50", Direction::Lower},
+		{"gpuMsP99", Direction::Lower},
+		{"heapAllocationsMaxPerFrame", Direction::Lower},
+		{"heapAllocationsPerFrame", Direction::Lower},
+		{"heapBlocks", Direction::Lower},
+		{"jobsExecuted", Direction::None},
+		{"jobsPerSecond", Direction::Higher},
+		{"jobsStolen", Direction::None},
+		{"layers", Direction::None},
+		{"linesTouched", Direction::Lower},
+		{"loadMs", Direction::Lower},
+		{"makeCurrentCalls", Direction::None},
+		{"makeCurrentForwarded", Direction::Lower},
+		{"makeCurrentUsP50", Direction::Lower},
+		{"makeCurrentUsP99", Direction::Lower},
+		{"meanUtilisation", Direction::Higher},
+		{"migrations", Direction::Lower},
+		{"minUtilisation", Direction::Higher},
+		{"missingSymbols", Direction::Lower},
+		{"msPerFrame", Direction::Lower},
+		{"multiBindsPerFrame", Direction::None},
+		{"naiveMegapixelsPerSecond", Direction::Higher},
+		{"nsAdded", Direction::Lower},
+		{"nsOverDriver", Direction::Lower},
+		{"nsPerAllocation", Direction::Lower},
+		{"nsPerCall", Direction::Lower},
+		{"nsPerChange", Direction::Lower},
+		{"nsPerDraw", Direction::Lower},
+		{"nsPerDrawWithChange", Direction::Lower},
+		{"nsPerFrame", Direction::Lower},
+		{"nsPerLookup", Direction::Lower},
+		{"parameterCallsPerFrame", Direction::None},
+		{"preferredMegapixelsPerSecond", Direction::Higher},
+		{"processor", Direction::None},
+		{"processorsUsed", Direction::Lower},
+		{"queries", Direction::None},
+		{"queriesForwarded", Direction::Lower},
+		{"rank", Direction::None},
+		{"rankInFormat", Direction::None},
+		{"readbackMBps", Direction::Higher},
+		{"relativeFramesPerSecond", Direction::Higher},
+		{"resetCallsPerTask", Direction::Lower},
+		{"runs", Direction::None},
+		{"samplerBindsPerFrame", Direction::Lower},
+		{"samplerObjects", Direction::None},
+		{"samples", Direction::None},
+		{"seconds", Direction::Lower},
+		{"size", Direction::None},
+		{"speedup", Direction::Higher},
+		{"steadyStateAllocations", Direction::Lower},
+		{"streamGBps", Direction::Higher},
+		{"tableBytes", Direction::Lower},
+		{"tasks", Direction::None},
+		{"tasksPerSecond", Direction::Higher},
+		{"threads", Direction::None},
+		{"unitsPerSecond", Direction::Higher},
+		{"uploadGBps", Direction::Higher},
+		{"usMax", Direction::Lower},
+		{"usMean", Direction::Lower},
+		{"usP50", Direction::Lower},
+		{"usP99", Direction::Lower},
+		{"usPerFrame", Direction::Lower},
+		{"utilisation", Direction::Higher},
+		{"varianceVsUnpinned", Direction::Lower},
+		{"vertices", Direction::None},
+		{"verticesPerSecond", Direction::Higher},
+		{"waits", Direction::None},
+		{"windows", Direction::None},
+		{"worker", Direction::None},
+		{"workers", Direction::None},
+	};
+
+	// Returns false if the metric isn't in the table.
+
+	bool metricDirection(const std::string &metric, Direction &direction)
+	{
+		auto found{std::lower_bound(std::begin(kMetricDirections), std::end(kMetricDirections), metric,
+			[](const MetricDirection &entry, const std::string &name) { return name.compare(entry.pszMetric) > 0; })};
+
+		if (found == std::end(kMetricDirections) || metric != found->pszMetric)
+			return false;
+
+		direction = found->direction;
+		return true;
+	}
+
+	double median(const std::vector<double> &samples)
+	{
+		return percentile(samples, 0.5);
+	}
+
+	// Samples of every numeric metric, keyed by benchmark, result row and metric name. Rows are
+	// identified by their string-valued fields, numbered when several rows have the same ones, so a
+	// benchmark whose rows are sorted by a measurement should give each row a descriptive string.
+
+	struct MetricSamples
+	{
+		std::string benchmark;
+		std::string row;
+		std::string metric;
+		std::vector<double> baseline;
+		std::vector<double> candidate;
+	};
+
+	void collectSamples(const StoredRun &run, bool baseline, std::vector<MetricSamples> &metrics, std::map<std::string, size_t> &index)
+	{
+		const JsonValue *pBenchmark{run.report.find("benchmark")};
+		const JsonValue *pResults{run.report.find("results")};
+
+		if (!pBenchmark || !pResults)
+			return;
+
+		std::map<std::string, unsigned> occurrences;
+
+		for (const JsonValue &result : pResults->elements)
+		{
+			std::string row;
+
+			for (size_t field = 0; field < result.keys.size(); ++field)
+			{
+				if (result.elements[field].type == JsonValue::Type::String)
+					row += (row.empty() ? "" : " ") + result.keys[field] + "=" + result.elements[field].string;
+			}
+
+			row += " #" + std::to_string(occurrences[row]++);
+
+			for (size_t field = 0; field < result.keys.size(); ++field)
+			{
+				if (result.elements[field].type != JsonValue::Type::Number)
+					continue;
+
+				std::string key{pBenchmark->string + "\n" + row + "\n" + result.keys[field]};
+				auto found{index.find(key)};
+
+				if (found == index.end())
+				{
+					found = index.emplace(key, metrics.size()).first;
+					metrics.push_back(MetricSamples{pBenchmark->string, row, result.keys[field]});
+				}
+
+				(baseline ? metrics[found->second].baseline : metrics[found->second].candidate).push_back(result.elements[field].number);
+			}
+		}
+	}
+
+	int compareRuns(const BenchmarkArguments &args, BenchmarkReport &report)
+	{
+		const wchar_t *pszBaseline{args.value(L"-baseline")};
+		const wchar_t *pszCandidate{args.value(L"-candidate")};
+		const wchar_t *pszAlpha{args.value(L"-alpha")};
+		const wchar_t *pszThreshold{args.value(L"-threshold")};
+		double alpha{pszAlpha ? _wtof(pszAlpha) : 0.05};
+		double threshold{(pszThreshold ? _wtof(pszThreshold) : 1.0) / 100.0};
+		std::vector<StoredRun> runs;
+
+		if (!pszBaseline || !pszCandidate)
+		{
+			std::fwprintf(stderr, L"Usage: -results compare -db <file> -baseline <name> -candidate <name> [-alpha p] [-threshold percent]\n");
+			return EXIT_FAILURE;
+		}
+
+		if (!readDatabase(args.value(L"-db"), runs))
+			return EXIT_FAILURE;
+
+		std::string baseline{narrow(pszBaseline)};
+		std::string candidate{narrow(pszCandidate)};
+		std::vector<MetricSamples> metrics;
+		std::map<std::string, size_t> index;
+		unsigned baselineRuns{0};
+		unsigned candidateRuns{0};
+
+		for (const StoredRun &run : runs)
+		{
+			if (run.label == baseline)
+			{
+				collectSamples(run, true, metrics, index);
+				++baselineRuns;
+			}
+			else if (run.label == candidate)
+			{
+				collectSamples(run, false, metrics, index);
+				++candidateRuns;
+			}
+		}
+
+		if (!baselineRuns || !candidateRuns)
+		{
+			std::fwprintf(stderr, L"No stored runs for %ls\n", baselineRuns ? pszCandidate : pszBaseline);
+			return EXIT_FAILURE;
+		}
+
+		report.setProperty("baseline", baseline);
+		report.setProperty("candidate", candidate);
+		report.setProperty("baselineRuns", baselineRuns);
+		report.setProperty("candidateRuns", candidateRuns);
+		report.setProperty("alpha", alpha);
+		report.setProperty("thresholdPercent", threshold * 100.0);
+
+		unsigned regressions{0};
+
+		for (const MetricSamples &samples : metrics)
+		{
+			Direction direction{Direction::None};
+			bool classified{metricDirection(samples.metric, direction)};
+
+			if (samples.baseline.empty() || samples.candidate.empty() || (classified && direction == Direction::None))
+				continue;
+
+			// Parameters such as a window or thread count are the same in every run and aren't worth reporting.
+
+			auto [baseMin, baseMax]{std::minmax_element(samples.baseline.begin(), samples.baseline.end())};
+			auto [candMin, candMax]{std::minmax_element(samples.candidate.begin(), samples.candidate.end())};
+
+			if (*baseMin == *baseMax && *candMin == *candMax && *baseMin == *candMin)
+				continue;
+
+			double baseMedian{median(samples.baseline)};
+			double candMedian{median(samples.candidate)};
+			double change{(candMedian - baseMedian) / std::fabs(baseMedian)};
+			double pValue{mannWhitneyPValue(samples.baseline, samples.candidate)};
+			ConfidenceInterval interval{bootstrapMedianChange(samples.baseline, samples.candidate, 1.0 - alpha)};
+			bool significant{pValue < alpha && (interval.low > 0.0 || interval.high < 0.0) && std::fabs(change) >= threshold};
+			const char *pszVerdict{"unchanged"};
+
+			if (samples.baseline.size() < 2 || samples.candidate.size() < 2)
+				pszVerdict = "insufficient";
+			else if (!classified)
+				pszVerdict = "unclassified";
+			else if (significant)
+				pszVerdict = ((change > 0.0) == (direction == Direction::Higher)) ? "improvement" : "regression";
+
+			if (std::strcmp(pszVerdict, "regression") == 0)
+				++regressions;
+
+			report.beginResult();
+			report.set("benchmark", samples.benchmark);
+			report.set("row", samples.row);
+			report.set("metric", samples.metric);
+			report.set("baselineMedian", baseMedian);
+			report.set("candidateMedian", candMedian);
+			report.set("changePercent", change * 100.0);
+			report.set("ciLowPercent", interval.low * 100.0);
+			report.set("ciHighPercent", interval.high * 100.0);
+			report.set("pValue", pValue);
+			report.set("verdict", pszVerdict);
+		}
+
+		report.setProperty("regressions", regressions);
+		return regressions ? 2 : EXIT_SUCCESS;
+	}
+
+	// Known-answer checks of the statistics compare relies on. The exact p-values are counted by hand
+	// from the rank sums, and the large-sample one from the normal approximation without ties.
+
+	int checkStatistics(BenchmarkReport &report)
+	{
+		unsigned failures{0};
+
+		// The tolerance is relative to the expected value, so an expected zero has to be exact.
+
+		auto check = [&](const char *pszCase, double expected, double actual, double tolerance)
+		{
+			bool passed{std::fabs(actual - expected) <= tolerance * std::fabs(expected)};
+
+			if (!passed)
+				++failures;
+
+			report.beginResult();
+			report.set("case", pszCase);
+			report.set("expected", expected);
+			report.set("actual", actual);
+			report.set("result", passed ? "pass" : "fail");
+		};
+
+		const std::vector<double> kLow{1.0, 2.0, 3.0, 4.0, 5.0};
+		const std::vector<double> kHigh{6.0, 7.0, 8.0, 9.0, 10.0};
+		std::vector<double> lowLarge;
+		std::vector<double> highLarge;
+
+		for (int i = 1; i <= 30; ++i)
+		{
+			lowLarge.push_back(i);
+			highLarge.push_back(i + 30);
+		}
+
+		check("mannWhitney identical", 1.0, mannWhitneyPValue(kLow, kLow), 1e-12);
+		check("mannWhitney separated 5v5", 2.0 / 252.0, mannWhitneyPValue(kLow, kHigh), 1e-12);
+		check("mannWhitney symmetric", mannWhitneyPValue(kLow, kHigh), mannWhitneyPValue(kHigh, kLow), 1e-12);
+		check("mannWhitney ties 3v3", 0.3, mannWhitneyPValue({1.0, 2.0, 2.0}, {2.0, 3.0, 4.0}), 1e-12);
+		check("mannWhitney empty", 1.0, mannWhitneyPValue({}, kLow), 0.0);
+		check("mannWhitney normal 30v30", 3.019859359162151e-11, mannWhitneyPValue(lowLarge, highLarge), 1e-6);
+
+		// A constant sample has no spread, so every resample gives the same change.
+
+		ConfidenceInterval same{bootstrapMedianChange({10.0, 10.0, 10.0}, {10.0, 10.0, 10.0})};
+		ConfidenceInterval tenPercent{bootstrapMedianChange({10.0, 10.0, 10.0}, {11.0, 11.0, 11.0})};
+		ConfidenceInterval shifted{bootstrapMedianChange(lowLarge, highLarge)};
+		ConfidenceInterval repeated{bootstrapMedianChange(lowLarge, highLarge)};
+		ConfidenceInterval empty{bootstrapMedianChange({}, kLow)};
+
+		check("bootstrap unchanged low", 0.0, same.low, 1e-12);
+		check("bootstrap unchanged high", 0.0, same.high, 1e-12);
+		check("bootstrap constant change low", 0.1, tenPercent.low, 1e-12);
+		check("bootstrap constant change high", 0.1, tenPercent.high, 1e-12);
+		check("bootstrap shifted excludes zero", 1.0, shifted.low > 0.0 ? 1.0 : 0.0, 0.0);
+		check("bootstrap shifted contains change", 1.0, shifted.low <= 30.0 / 15.5 && shifted.high >= 30.0 / 15.5 ? 1.0 : 0.0, 0.0);
+		check("bootstrap deterministic low", shifted.low, repeated.low, 0.0);
+		check("bootstrap deterministic high", shifted.high, repeated.high, 0.0);
+		check("bootstrap empty", 0.0, empty.low + empty.high, 0.0);
+
+		report.setProperty("failures", failures);
+		return failures ? 2 : EXIT_SUCCESS;
+	}
+}
+
+bool runResultsFromCommandLine(int argc, wchar_t *argv[], int &status)
+{
+	BenchmarkArguments args{argc, argv};
+	const wchar_t *pszCommand{args.value(L"-results")};
+
+	if (!pszCommand)
+		return false;
+
+	if (_wcsicmp(pszCommand, L"store") == 0)
+	{
+		status = storeReport(args);
+		return true;
+	}
+
+	BenchmarkReport report{"results"};
+
+	if (_wcsicmp(pszCommand, L"list") == 0)
+	{
+		status = listRuns(args, report);
+	}
+	else if (_wcsicmp(pszCommand, L"compare") == 0)
+	{
+		status = compareRuns(args, report);
+	}
+	else if (_wcsicmp(pszCommand, L"check") == 0)
+	{
+		status = checkStatistics(report);
+	}
+	else
+	{
+		std::fwprintf(stderr, L"Unknown results command: %ls\n", pszCommand);
+		status = EXIT_FAILURE;
+		return true;
+	}
+
+	if (status != EXIT_FAILURE && !report.write(args.value(L"-report")))
+		status = EXIT_FAILURE;
+
+	return true;
+}
+
+double mannWhitneyPValue(const std::vector<double> &a, const std::vector<double> &b)
+{
+	if (a.empty() || b.empty())
+		return 1.0;
+
+	// Rank the pooled samples, giving tied values the average of their ranks.
+
+	struct Sample
+	{
+		double value;
+		bool fromA;
+	};
+
+	std::vector<Sample> pooled;
+
+	for (double value : a)
+		pooled.push_back(Sample{value, true});
+
+	for (double value : b)
+		pooled.push_back(Sample{value, false});
+
+	std::sort(pooled.begin(), pooled.end(), [](const Sample &lhs, const Sample &rhs) { return lhs.value < rhs.value; });
+
+	size_t n{pooled.size()};
+	double na{static_cast<double>(a.size())};
+	double nb{static_cast<double>(b.size())};
+	std::vector<double> ranks(n);
+	double tieCorrection{0.0};
+
+	for (size_t i = 0; i < n;)
+	{
+		size_t j{i};
+
+		while (j + 1 < n && pooled[j + 1].value == pooled[i].value)
+			++j;
+
+		double ties{static_cast<double>(j - i + 1)};
+
+		for (size_t k = i; k <= j; ++k)
+			ranks[k] = (static_cast<double>(i + j) / 2.0) + 1.0;
+
+		tieCorrection += ties * ties * ties - ties;
+		i = j + 1;
+	}
+
+	double rankSumA{0.0};
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		if (pooled[i].fromA)
+			rankSumA += ranks[i];
+	}
+
+	double mean{na * nb / 2.0};
+	double deviation{std::fabs(rankSumA - na * (na + 1.0) / 2.0 - mean)};
+
+	// For small samples count every way of choosing a's ranks from the pooled ranks.
+
+	double combinations{1.0};
+
+	for (size_t i = 0; i < a.size(); ++i)
+		combinations = combinations * static_cast<double>(n - i) / static_cast<double>(i + 1);
+
+	if (combinations <= 200000.0)
+	{
+		std::vector<size_t> chosen(a.size());
+		std::uint64_t extreme{0};
+		std::uint64_t total{0};
+
+		for (size_t i = 0; i < chosen.size(); ++i)
+			chosen[i] = i;
+
+		while (true)
+		{
+			double rankSum{0.0};
+
+			for (size_t i : chosen)
+				rankSum += ranks[i];
+
+			if (std::fabs(rankSum - na * (na + 1.0) / 2.0 - mean) >= deviation - 1e-9)
+				++extreme;
+
+			++total;
+
+			// Advance to the next combination in lexicographic order.
+
+			size_t k{chosen.size()};
+
+			while (k > 0 && chosen[k - 1] == n - chosen.size() + k - 1)
+				--k;
+
+			if (k == 0)
+				break;
+
+			++chosen[k - 1];
+
+			for (size_t i = k; i < chosen.size(); ++i)
+				chosen[i] = chosen[i - 1] + 1;
+		}
+
+		return static_cast<double>(extreme) / static_cast<double>(total);
+	}
+
+	double variance{na * nb / 12.0 * ((na + nb + 1.0) - tieCorrection / ((na + nb) * (na + nb - 1.0)))};
+
+	if (variance <= 0.0)
+		return 1.0;
+
+	double z{(deviation - 0.5) / std::sqrt(variance)};
+	return std::min(1.0, std::erfc(std::max(0.0, z) / std::sqrt(2.0)));
+}
+
+ConfidenceInterval bootstrapMedianChange(const std::vector<double> &baseline, const std::vector<double> &candidate,
+	double confidence, unsigned resamples, std::uint32_t seed)
+{
+	if (baseline.empty() || candidate.empty())
+		return ConfidenceInterval{};
+
+	std::mt19937 random{seed};
+	std::uniform_int_distribution<size_t> pickBaseline{0, baseline.size() - 1};
+	std::uniform_int_distribution<size_t> pickCandidate{0, candidate.size() - 1};
+	std::vector<double> resampledBaseline(baseline.size());
+	std::vector<double> resampledCandidate(candidate.size());
+	std::vector<double> changes;
+
+	changes.reserve(resamples);
+
+	for (unsigned i = 0; i < resamples; ++i)
+	{
+		for (double &value : resampledBaseline)
+			value = baseline[pickBaseline(random)];
+
+		for (double &value : resampledCandidate)
+			value = candidate[pickCandidate(random)];
+
+		double baseMedian{median(resampledBaseline)};
+		double change{(median(resampledCandidate) - baseMedian) / std::fabs(baseMedian)};
+
+		if (std::isfinite(change))
+			changes.push_back(change);
+	}
+
+	double tail{(1.0 - std::clamp(confidence, 0.0, 1.0)) / 2.0};
+	return ConfidenceInterval{percentile(changes, tail), percentile(changes, 1.0 - tail)};
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+module;
+
+#include <cstdint>
+#include <vector>
+
+export module Results;
+
+// A results database keeps benchmark reports from many runs in one JSON Lines file, one labelled
+// report per line, so that runs can be compared statistically instead of by eye:
+//
+//     glLoader.exe -results store -db <file> -label <name> -input <report>
+//     glLoader.exe -results list -db <file>
+//     glLoader.exe -results compare -db <file> -baseline <name> -candidate <name>
+//                  [-alpha p] [-threshold percent] [-report <file>]
+//     glLoader.exe -results check [-report <file>]
+//
+// Store each label several times (five or more runs is a reasonable minimum). compare pairs up every
+// numeric metric in the two labels' reports and tests whether they differ. A metric is flagged as a
+// regression or an improvement only if the Mann-Whitney test rejects "no difference" at the alpha
+// level (default 0.05), the bootstrap confidence interval for the change in the median excludes zero,
+// and the change is at least the threshold (default 1%). Whether a metric is better higher or lower
+// comes from a table of metric names. Parameters such as a thread count aren't compared, and a metric
+// missing from the table gets the verdict "unclassified".
+//
+// check runs known-answer tests of mannWhitneyPValue() and bootstrapMedianChange().
+//
+// compare and check write a JSON report like the benchmarks do. The exit code is 0 if nothing
+// regressed or failed, 2 if at least one metric regressed or check failed, and 1 if the command failed.
+
+export bool runResultsFromCommandLine(int argc, wchar_t *argv[], int &status);
+
+// Two-sided p-value of the Mann-Whitney U test that a and b come from the same distribution. Exact
+// for small samples, otherwise from the normal approximation with a tie correction. Returns 1 if
+// either sample is empty.
+
+export double mannWhitneyPValue(const std::vector<double> &a, const std::vector<double> &b);
+
+// Bootstrap percentile confidence interval for the relative change in the median from baseline to
+// candidate, (median(candidate) - median(baseline)) / |median(baseline)|. Resampling uses a fixed
+// seed so that the same inputs always give the same interval.
+
+export struct ConfidenceInterval
+{
+	double low{};
+	double high{};
+};
+
+export ConfidenceInterval bootstrapMedianChange(const std::vector<double> &baseline, const std::vector<double> &candidate,
+	double confidence = 0.95, unsigned resamples = 2000, std::uint32_t seed = 1);
\ No newline at end of file
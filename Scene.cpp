@@ -0,0 +1,418 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cwchar>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+module Scene;
+
+import FastPaths;
+import TextureFormats;
+
+namespace
+{
+	class ClearScene : public Scene
+	{
+	public:
+		const char *name() const override { return "clear"; }
+
+		void render(int width, int height, std::uint64_t) override
+		{
+			glViewport(0, 0, width, height);
+			glClearColor(0.3f, 0.5f, 0.9f, 0.0f);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+		}
+	};
+
+	class StateChurnScene : public Scene
+	{
+	public:
+		explicit StateChurnScene(std::uint32_t seed) : m_random{seed} {}
+
+		const char *name() const override { return "statechurn"; }
+
+		void render(int width, int height, std::uint64_t) override
+		{
+			const GLenum kCapabilities[]{GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE, GL_DITHER, GL_STENCIL_TEST};
+			const GLenum kBlendFactors[]{GL_ONE, GL_ZERO, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_DST_COLOR};
+			const GLenum kDepthFuncs[]{GL_LESS, GL_LEQUAL, GL_GREATER, GL_ALWAYS};
+
+			glViewport(0, 0, width, height);
+			glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			glEnable(GL_SCISSOR_TEST);
+
+			for (int i = 0; i < kChanges; ++i)
+			{
+				switch (m_random() % 5)
+				{
+				case 0:
+				{
+					GLenum cap{kCapabilities[m_random() % std::size(kCapabilities)]};
+
+					if (m_random() & 1)
+						glEnable(cap);
+					else
+						glDisable(cap);
+					break;
+				}
+
+				case 1:
+					glBlendFunc(kBlendFactors[m_random() % std::size(kBlendFactors)], kBlendFactors[m_random() % std::size(kBlendFactors)]);
+					break;
+
+				case 2:
+					glDepthFunc(kDepthFuncs[m_random() % std::size(kDepthFuncs)]);
+					break;
+
+				case 3:
+					glColorMask(static_cast<GLboolean>(m_random() & 1), static_cast<GLboolean>(m_random() & 1), static_cast<GLboolean>(m_random() & 1), GL_TRUE);
+					break;
+
+				default:
+					glCullFace((m_random() & 1) ? GL_FRONT : GL_BACK);
+					break;
+				}
+
+				// Clear a small tile so that every change is picked up by the driver.
+
+				glScissor(static_cast<GLint>(m_random() % static_cast<std::uint32_t>(width)), static_cast<GLint>(m_random() % static_cast<std::uint32_t>(height)), 16, 16);
+				glClearColor(static_cast<float>(i) / kChanges, 0.5f, 0.5f, 1.0f);
+				glClear(GL_COLOR_BUFFER_BIT);
+			}
+
+			glDisable(GL_SCISSOR_TEST);
+			glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+		}
+
+	private:
+		static const int kChanges{512};
+
+		std::mt19937 m_random;
+	};
+
+	// Small draws are made with client-side vertex arrays, whose compatibility profile functions aren't
+	// part of the core entry points. Each draw is an 8x8 pixel quad of its own colour.
+
+	class SmallDrawsScene : public Scene
+	{
+	public:
+		static std::unique_ptr<Scene> create(std::uint32_t seed, OpenGLContext &context)
+		{
+			std::unique_ptr<SmallDrawsScene> pScene{new SmallDrawsScene()};
+
+			pScene->m_pfnVertexPointer = reinterpret_cast<PFNGLVERTEXPOINTERPROC>(context.wglGetProcAddress("glVertexPointer"));
+			pScene->m_pfnColorPointer = reinterpret_cast<PFNGLCOLORPOINTERPROC>(context.wglGetProcAddress("glColorPointer"));
+			pScene->m_pfnEnableClientState = reinterpret_cast<PFNGLENABLECLIENTSTATEPROC>(context.wglGetProcAddress("glEnableClientState"));
+			pScene->m_pfnDisableClientState = reinterpret_cast<PFNGLENABLECLIENTSTATEPROC>(context.wglGetProcAddress("glDisableClientState"));
+
+			if (!pScene->m_pfnVertexPointer || !pScene->m_pfnColorPointer || !pScene->m_pfnEnableClientState || !pScene->m_pfnDisableClientState)
+				return std::unique_ptr<Scene>{};
+
+			// Each quad's corner is chosen once, as a fraction of the window, and its vertices are
+			// recomputed in pixels whenever the window size changes.
+
+			std::mt19937 random{seed};
+
+			pScene->m_corners.resize(static_cast<size_t>(kDraws) * 2);
+			pScene->m_vertices.resize(static_cast<size_t>(kDraws) * kVerticesPerDraw * 2);
+			pScene->m_colors.resize(static_cast<size_t>(kDraws) * kVerticesPerDraw);
+
+			for (float &corner : pScene->m_corners)
+				corner = static_cast<float>(random() % 1024) / 1024.0f;
+
+			for (int i = 0; i < kDraws; ++i)
+			{
+				std::uint32_t color{random() | 0xff000000u};
+
+				for (int vertex = 0; vertex < kVerticesPerDraw; ++vertex)
+					pScene->m_colors[static_cast<size_t>(i) * kVerticesPerDraw + vertex] = color;
+			}
+
+			return pScene;
+		}
+
+		const char *name() const override { return "smalldraws"; }
+
+		void render(int width, int height, std::uint64_t) override
+		{
+			if (width != m_width || height != m_height)
+				layOut(width, height);
+
+			glViewport(0, 0, width, height);
+			glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			m_pfnEnableClientState(kVertexArray);
+			m_pfnEnableClientState(kColorArray);
+			m_pfnVertexPointer(2, GL_FLOAT, 0, m_vertices.data());
+			m_pfnColorPointer(4, GL_UNSIGNED_BYTE, 0, m_colors.data());
+
+			for (int i = 0; i < kDraws; ++i)
+				glDrawArrays(GL_TRIANGLES, i * kVerticesPerDraw, kVerticesPerDraw);
+
+			m_pfnDisableClientState(kColorArray);
+			m_pfnDisableClientState(kVertexArray);
+		}
+
+	private:
+		using PFNGLVERTEXPOINTERPROC = void(APIENTRY *)(GLint size, GLenum type, GLsizei stride, const void *pointer);
+		using PFNGLCOLORPOINTERPROC = void(APIENTRY *)(GLint size, GLenum type, GLsizei stride, const void *pointer);
+		using PFNGLENABLECLIENTSTATEPROC = void(APIENTRY *)(GLenum array);
+
+		static const int kDraws{2000};
+		static const int kVerticesPerDraw{6};
+		static const int kQuadSize{8};
+		static const GLenum kVertexArray{0x8074};
+		static const GLenum kColorArray{0x8076};
+
+		SmallDrawsScene() = default;
+
+		// The vertices are in normalized device coordinates, as the matrices are left as the identity.
+
+		void layOut(int width, int height)
+		{
+			float sizeX{2.0f * kQuadSize / static_cast<float>(width)};
+			float sizeY{2.0f * kQuadSize / static_cast<float>(height)};
+
+			for (int i = 0; i < kDraws; ++i)
+			{
+				float x{m_corners[static_cast<size_t>(i) * 2] * 2.0f - 1.0f};
+				float y{m_corners[static_cast<size_t>(i) * 2 + 1] * 2.0f - 1.0f};
+				const float quad[kVerticesPerDraw * 2]{x, y, x + sizeX, y, x + sizeX, y + sizeY, x, y, x + sizeX, y + sizeY, x, y + sizeY};
+
+				std::copy(std::begin(quad), std::end(quad), m_vertices.begin() + static_cast<std::ptrdiff_t>(i) * kVerticesPerDraw * 2);
+			}
+
+			m_width = width;
+			m_height = height;
+		}
+
+		PFNGLVERTEXPOINTERPROC m_pfnVertexPointer{nullptr};
+		PFNGLCOLORPOINTERPROC m_pfnColorPointer{nullptr};
+		PFNGLENABLECLIENTSTATEPROC m_pfnEnableClientState{nullptr};
+		PFNGLENABLECLIENTSTATEPROC m_pfnDisableClientState{nullptr};
+		std::vector<float> m_corners;
+		std::vector<float> m_vertices;
+		std::vector<std::uint32_t> m_colors;
+		int m_width{};
+		int m_height{};
+	};
+
+	class UploadScene : public Scene
+	{
+	public:
+		// The pixels are random, so they can be uploaded in whichever 32-bit layout the driver prefers.
+
+		UploadScene(std::uint32_t seed, const PixelTransfer &transfer, std::unique_ptr<FastPaths> pPaths) : m_transfer{transfer}, m_pPaths{std::move(pPaths)}
+		{
+			std::mt19937 random{seed};
+
+			m_pixels.resize(static_cast<size_t>(kVariants) * kTileSize * kTileSize);
+
+			for (std::uint32_t &pixel : m_pixels)
+				pixel = random() | 0xff000000u;
+
+			glGenTextures(1, &m_texture);
+			glBindTexture(GL_TEXTURE_2D, m_texture);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, kTextureSize, kTextureSize, 0, m_transfer.format, m_transfer.type, nullptr);
+		}
+
+		~UploadScene() override
+		{
+			glDeleteTextures(1, &m_texture);
+		}
+
+		const char *name() const override { return "upload"; }
+
+		void render(int width, int height, std::uint64_t frame) override
+		{
+			glViewport(0, 0, width, height);
+			glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+			// Replace the whole texture every frame, one tile at a time, cycling through the source images.
+
+			for (int tile = 0; tile < kTilesPerFrame; ++tile)
+			{
+				size_t variant{static_cast<size_t>((frame + tile) % kVariants)};
+				int x{(tile % (kTextureSize / kTileSize)) * kTileSize};
+				int y{(tile / (kTextureSize / kTileSize)) * kTileSize};
+
+				m_pPaths->uploadTexture(m_texture, x, y, kTileSize, kTileSize, m_transfer.format, m_transfer.type, m_pixels.data() + variant * kTileSize * kTileSize);
+			}
+		}
+
+	private:
+		static const int kTextureSize{1024};
+		static const int kTileSize{256};
+		static const int kTilesPerFrame{(kTextureSize / kTileSize) * (kTextureSize / kTileSize)};
+		static const int kVariants{3};
+
+		PixelTransfer m_transfer;
+		std::unique_ptr<FastPaths> m_pPaths;
+		std::vector<std::uint32_t> m_pixels;
+		GLuint m_texture{};
+	};
+
+	class ReadbackScene : public Scene
+	{
+	public:
+		const char *name() const override { return "readback"; }
+
+		void render(int width, int height, std::uint64_t frame) override
+		{
+			m_pixels.resize(static_cast<size_t>(width) * height);
+
+			glViewport(0, 0, width, height);
+			glClearColor(static_cast<float>(frame & 0xff) / 255.0f, 0.5f, 0.5f, 1.0f);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			glPixelStorei(GL_PACK_ALIGNMENT, 4);
+			glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, m_pixels.data());
+		}
+
+	private:
+		std::vector<std::uint32_t> m_pixels;
+	};
+
+	// Text is drawn with wglUseFontBitmaps() display lists, which need a few compatibility profile
+	// functions that aren't part of the core entry points.
+
+	class TextScene : public Scene
+	{
+	public:
+		static std::unique_ptr<Scene> create(std::uint32_t seed, OpenGLContext &context, HDC hDC)
+		{
+			std::unique_ptr<TextScene> pScene{new TextScene()};
+
+			pScene->m_pfnGenLists = reinterpret_cast<PFNGLGENLISTSPROC>(context.wglGetProcAddress("glGenLists"));
+			pScene->m_pfnDeleteLists = reinterpret_cast<PFNGLDELETELISTSPROC>(context.wglGetProcAddress("glDeleteLists"));
+			pScene->m_pfnListBase = reinterpret_cast<PFNGLLISTBASEPROC>(context.wglGetProcAddress("glListBase"));
+			pScene->m_pfnCallLists = reinterpret_cast<PFNGLCALLLISTSPROC>(context.wglGetProcAddress("glCallLists"));
+			pScene->m_pfnRasterPos2f = reinterpret_cast<PFNGLRASTERPOS2FPROC>(context.wglGetProcAddress("glRasterPos2f"));
+
+			if (!pScene->m_pfnGenLists || !pScene->m_pfnDeleteLists || !pScene->m_pfnListBase || !pScene->m_pfnCallLists || !pScene->m_pfnRasterPos2f)
+				return std::unique_ptr<Scene>{};
+
+			SelectObject(hDC, GetStockObject(ANSI_FIXED_FONT));
+
+			if (!(pScene->m_listBase = pScene->m_pfnGenLists(256)) || !context.wglUseFontBitmapsA(hDC, 0, 256, pScene->m_listBase))
+				return std::unique_ptr<Scene>{};
+
+			TEXTMETRICA metrics{};
+
+			GetTextMetricsA(hDC, &metrics);
+			pScene->m_lineHeight = metrics.tmHeight > 0 ? metrics.tmHeight : 12;
+
+			// Twice as much text as a frame needs, so each frame can start at a different offset.
+
+			std::mt19937 random{seed};
+
+			pScene->m_text.resize(static_cast<size_t>(kLines) * kColumns * 2);
+
+			for (char &c : pScene->m_text)
+				c = static_cast<char>(' ' + random() % 95);
+
+			return pScene;
+		}
+
+		~TextScene() override
+		{
+			if (m_listBase)
+				m_pfnDeleteLists(m_listBase, 256);
+		}
+
+		const char *name() const override { return "text"; }
+
+		void render(int width, int height, std::uint64_t frame) override
+		{
+			glViewport(0, 0, width, height);
+			glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			m_pfnListBase(m_listBase);
+
+			size_t start{static_cast<size_t>(frame % (static_cast<std::uint64_t>(kLines) * kColumns))};
+			float lineHeight{2.0f * static_cast<float>(m_lineHeight) / static_cast<float>(height)};
+
+			for (int line = 0; line < kLines; ++line)
+			{
+				m_pfnRasterPos2f(-0.98f, 1.0f - (line + 1) * lineHeight);
+				m_pfnCallLists(kColumns, GL_UNSIGNED_BYTE, m_text.data() + start + static_cast<size_t>(line) * kColumns);
+			}
+		}
+
+	private:
+		using PFNGLGENLISTSPROC = GLuint(APIENTRY *)(GLsizei range);
+		using PFNGLDELETELISTSPROC = void(APIENTRY *)(GLuint list, GLsizei range);
+		using PFNGLLISTBASEPROC = void(APIENTRY *)(GLuint base);
+		using PFNGLCALLLISTSPROC = void(APIENTRY *)(GLsizei n, GLenum type, const void *lists);
+		using PFNGLRASTERPOS2FPROC = void(APIENTRY *)(GLfloat x, GLfloat y);
+
+		static const int kLines{48};
+		static const int kColumns{100};
+
+		TextScene() = default;
+
+		PFNGLGENLISTSPROC m_pfnGenLists{nullptr};
+		PFNGLDELETELISTSPROC m_pfnDeleteLists{nullptr};
+		PFNGLLISTBASEPROC m_pfnListBase{nullptr};
+		PFNGLCALLLISTSPROC m_pfnCallLists{nullptr};
+		PFNGLRASTERPOS2FPROC m_pfnRasterPos2f{nullptr};
+		GLuint m_listBase{};
+		int m_lineHeight{};
+		std::vector<char> m_text;
+	};
+}
+
+std::unique_ptr<Scene> Scene::create(const wchar_t *pszName, std::uint32_t seed, OpenGLContext &context, HDC hDC)
+{
+	if (!pszName || _wcsicmp(pszName, L"clear") == 0)
+		return std::make_unique<ClearScene>();
+
+	if (_wcsicmp(pszName, L"statechurn") == 0)
+		return std::make_unique<StateChurnScene>(seed);
+
+	if (_wcsicmp(pszName, L"smalldraws") == 0)
+		return SmallDrawsScene::create(seed, context);
+
+	if (_wcsicmp(pszName, L"upload") == 0)
+		return std::make_unique<UploadScene>(seed, FormatNegotiator::create(context)->preferred(GL_RGBA8), FastPaths::create(context));
+
+	if (_wcsicmp(pszName, L"readback") == 0)
+		return std::make_unique<ReadbackScene>();
+
+	if (_wcsicmp(pszName, L"text") == 0)
+		return TextScene::create(seed, context, hDC);
+
+	return std::unique_ptr<Scene>{};
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+module;
+
+#include <windows.h>
+#include <cstdint>
+#include <memory>
+
+export module Scene;
+
+import OpenGL;
+
+// A Scene is a fixed, repeatable rendering workload for measuring frame times. Every scene draws
+// the same sequence of frames for a given seed, so runs can be compared across drivers and releases.
+//
+//     clear       clears the window, nothing else
+//     statechurn  hundreds of random blend, depth, cull, colour mask and scissor changes per frame
+//     smalldraws  thousands of glDrawArrays() calls per frame, each a small quad from client-side
+//                 vertex arrays (needs a compatibility profile context)
+//     upload      several 256x256 texture uploads per frame, in the client format the driver prefers,
+//                 through the fastest upload path FastPaths finds
+//     readback    reads the whole framebuffer back every frame
+//     text        several thousand characters of bitmap font text per frame
+//
+// Scenes are created, rendered and destroyed with the rendering context current. init() and the
+// first render() of a given window size may allocate, later frames don't.
+
+export class Scene
+{
+public:
+	// Returns an empty pointer if the name isn't recognised or the context lacks what the scene needs.
+
+	static std::unique_ptr<Scene> create(const wchar_t *pszName, std::uint32_t seed, OpenGLContext &context, HDC hDC);
+
+	virtual ~Scene() = default;
+
+	virtual const char *name() const = 0;
+	virtual void render(int width, int height, std::uint64_t frame) = 0;
+};
\ No newline at end of file
@@ -0,0 +1,169 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+module Benchmark;
+
+import OpenGL;
+import RenderScheduler;
+import Topology;
+
+// Measures how RenderScheduler throughput scales with the number of worker threads.
+//
+//     -benchmark scheduler [-jobs n] [-maxworkers n] [-size n] [-nopin]
+//
+// Every job clears the worker's framebuffer, uploads a tile into one of a handful of cached
+// textures and reads a tile back, which is enough work to keep a software rasterizer busy.
+
+namespace
+{
+	const unsigned kCachedTextures{8};
+
+	void renderJob(RenderWorker &worker, unsigned job, int size)
+	{
+		GLuint texture{worker.cachedTexture(job % kCachedTextures, [size]()
+		{
+			GLuint name{};
+			glGenTextures(1, &name);
+			glBindTexture(GL_TEXTURE_2D, name);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+			return name;
+		})};
+
+		std::vector<std::uint32_t> tile(static_cast<size_t>(size) * size, 0xff000000u | job);
+
+		glViewport(0, 0, size, size);
+		glClearColor(static_cast<float>(job & 0xff) / 255.0f, 0.5f, 0.25f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size, size, GL_RGBA, GL_UNSIGNED_BYTE, tile.data());
+		glReadPixels(0, 0, size, size, GL_RGBA, GL_UNSIGNED_BYTE, tile.data());
+	}
+}
+
+int runSchedulerBenchmark(const BenchmarkArguments &args, BenchmarkReport &report)
+{
+	unsigned hardwareThreads{std::max(1u, std::thread::hardware_concurrency())};
+	unsigned jobCount{static_cast<unsigned>(std::max(1, args.intValue(L"-jobs", 2048)))};
+	unsigned maxWorkers{static_cast<unsigned>(std::max(1, args.intValue(L"-maxworkers", static_cast<int>(hardwareThreads))))};
+	int size{std::max(16, args.intValue(L"-size", 128))};
+	bool pinThreads{!args.has(L"-nopin")};
+
+	report.setProperty("hardwareThreads", hardwareThreads);
+	report.setProperty("topology", CpuTopology::instance().describe());
+	report.setProperty("jobs", jobCount);
+	report.setProperty("size", size);
+	report.setProperty("pinned", pinThreads ? 1.0 : 0.0);
+
+	std::vector<unsigned> workerCounts;
+
+	for (unsigned workers = 1; workers < maxWorkers; workers *= 2)
+		workerCounts.push_back(workers);
+
+	workerCounts.push_back(maxWorkers);
+
+	double baseline{0.0};
+
+	for (unsigned workers : workerCounts)
+	{
+		std::unique_ptr<RenderScheduler> pScheduler{RenderScheduler::create(workers, size, size, pinThreads)};
+
+		if (!pScheduler)
+			return EXIT_FAILURE;
+
+		if (workers == 1)
+			pScheduler->submit([&report](RenderWorker &) { reportDriverProperties(report); });
+
+		// Warm up every worker's cache so that texture creation isn't part of the measurement. The jobs
+		// are pinned, or an idle worker could steal another's and leave it cold.
+
+		for (unsigned worker = 0; worker < workers; ++worker)
+		{
+			for (unsigned i = 0; i < kCachedTextures; ++i)
+				pScheduler->submitPinned(worker, [i, size](RenderWorker &worker) { renderJob(worker, i, size); });
+		}
+
+		pScheduler->wait();
+		pScheduler->resetStats();
+
+		Stopwatch stopwatch;
+
+		for (unsigned i = 0; i < jobCount; ++i)
+			pScheduler->submit([i, size](RenderWorker &worker) { renderJob(worker, i, size); glFinish(); });
+
+		pScheduler->wait();
+
+		double seconds{stopwatch.seconds()};
+		double jobsPerSecond{static_cast<double>(jobCount) / seconds};
+		std::vector<RenderWorkerStats> stats{pScheduler->stats()};
+		double totalUtilisation{0.0};
+		double minUtilisation{1.0};
+		std::uint64_t stolen{0};
+
+		if (workers == 1)
+			baseline = jobsPerSecond;
+
+		for (const RenderWorkerStats &worker : stats)
+		{
+			totalUtilisation += worker.utilisation();
+			minUtilisation = std::min(minUtilisation, worker.utilisation());
+			stolen += worker.jobsStolen;
+		}
+
+		report.beginResult();
+		report.set("kind", "summary");
+		report.set("workers", workers);
+		report.set("seconds", seconds);
+		report.set("jobsPerSecond", jobsPerSecond);
+		report.set("speedup", baseline > 0.0 ? jobsPerSecond / baseline : 0.0);
+		report.set("meanUtilisation", totalUtilisation / stats.size());
+		report.set("minUtilisation", minUtilisation);
+		report.set("jobsStolen", static_cast<double>(stolen));
+
+		for (const RenderWorkerStats &worker : stats)
+		{
+			report.beginResult();
+			report.set("kind", "worker");
+			report.set("workers", workers);
+			report.set("worker", worker.index);
+			report.set("processor", worker.processor);
+			report.set("jobsExecuted", static_cast<double>(worker.jobsExecuted));
+			report.set("jobsStolen", static_cast<double>(worker.jobsStolen));
+			report.set("cacheHits", static_cast<double>(worker.cacheHits));
+			report.set("cacheMisses", static_cast<double>(worker.cacheMisses));
+			report.set("busySeconds", worker.busySeconds);
+			report.set("utilisation", worker.utilisation());
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+import <windows.h>;
+import <GL/glcorearb.h>;
+import <cstring>;
+
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+// Note:
+// VS2022 (v17.11.2) has an IntelliSense bug that causes it to report false errors
+// if this copyright notice is placed at the top of the file before import statements.
+
+// glStubDriver.vcxproj builds this file into glStubDriver.dll, a stand-in for an old driver that only
+// exposes some core functions under the suffixed names gl.xml gives as their aliases. -benchmark
+// aliases loads it as a library and checks that the loader falls back to those names. It can't render:
+// its GL functions do nothing and it has no contexts.
+//
+// wglGetProcAddress() returns the ARB functions, like a driver would, returns 1 instead of null for
+// glGenBuffers, like some old drivers do, and returns null for everything else. The other suffixed
+// functions are only found with GetProcAddress().
+
+namespace
+{
+	HMODULE g_hModule{nullptr};
+}
+
+extern "C"
+{
+	void APIENTRY stubActiveTextureARB(GLenum)
+	{
+	}
+
+	void APIENTRY stubBindBufferARB(GLenum, GLuint)
+	{
+	}
+
+	void APIENTRY stubBufferSubDataARB(GLenum, GLintptr, GLsizeiptr, const void *)
+	{
+	}
+
+	void APIENTRY stubGenBuffersARB(GLsizei n, GLuint *buffers)
+	{
+		for (GLsizei i = 0; buffers && i < n; ++i)
+			buffers[i] = static_cast<GLuint>(i + 1);
+	}
+
+	void APIENTRY stubBlendFuncSeparateINGR(GLenum, GLenum, GLenum, GLenum)
+	{
+	}
+
+	void APIENTRY stubDrawBuffersATI(GLsizei, const GLenum *)
+	{
+	}
+
+	PROC WINAPI stubWglGetProcAddress(LPCSTR lpszProc)
+	{
+		if (!lpszProc)
+			return nullptr;
+
+		if (std::strcmp(lpszProc, "glGenBuffers") == 0)
+			return reinterpret_cast<PROC>(1);
+
+		std::size_t length{std::strlen(lpszProc)};
+
+		if (length > 3 && std::strcmp(lpszProc + length - 3, "ARB") == 0)
+			return GetProcAddress(g_hModule, lpszProc);
+
+		return nullptr;
+	}
+}
+
+BOOL WINAPI DllMain(HINSTANCE hInstance, DWORD reason, LPVOID)
+{
+	if (reason == DLL_PROCESS_ATTACH)
+	{
+		g_hModule = hInstance;
+		DisableThreadLibraryCalls(hInstance);
+	}
+
+	return TRUE;
+}
\ No newline at end of file
@@ -0,0 +1,206 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "GLEntryPoints.h"
+
+module Benchmark;
+
+import LoaderSymbols;
+import PerfectHash;
+
+// Compares ways of mapping a GL function name to its index in the loader's symbol table.
+//
+//     -benchmark symbols [-lookups n] [-repeats n]
+//
+// The names are the ones the loader looks up itself, from GLEntryPoints.h, and the queries mix them
+// with names that aren't in the table, such as extension functions an application asks for. The
+// perfect hash and string pool are the loader's own, from LoaderSymbols. The string pool's size is
+// reported against an array of pointers to separate string literals, which is what the loader used
+// before, and each method's table size is reported alongside its lookup time.
+// Fails if any method maps a name differently from the others.
+
+namespace
+{
+	const char *const kSymbolLiterals[Symbol::Count]
+	{
+#define NAME_SYMBOL(name) #name,
+		GL_DISPATCH_ENTRY_POINTS(NAME_SYMBOL)
+		GL_LOADER_SYMBOLS(NAME_SYMBOL)
+#undef NAME_SYMBOL
+	};
+
+	// Names the loader doesn't look up itself. Any that it comes to look up are left out of the queries.
+
+	const char *const kUnknownNames[]
+	{
+		"glActiveTextureARB", "glBindBufferARB", "glBindFramebuffer", "glBindVertexArray", "glBufferData",
+		"glBufferSubDataARB", "glClearBufferfv", "glCompileShader", "glDebugMessageCallback",
+		"glDrawElementsInstanced", "glGenBuffers", "glGetProgramiv", "glMapBufferRange", "glUniform4fv",
+		"glUseProgram", "glVertexAttribPointer", "wglChoosePixelFormatARB", "wglCreateContextAttribsARB",
+		"wglGetExtensionsStringARB", "wglGetSwapIntervalEXT", "wglSwapIntervalEXT", "glClearColo", "glClearColorx",
+	};
+
+	volatile unsigned g_sink;
+
+	struct Method
+	{
+		const char *pszName;
+		std::size_t tableBytes;
+		double nsPerLookup;
+		std::vector<unsigned> results;
+	};
+
+	template <typename Find>
+	void measure(Method &method, const std::vector<std::string> &queries, int repeats, Find find)
+	{
+		method.results.clear();
+
+		for (const std::string &query : queries)
+			method.results.push_back(find(query));
+
+		std::vector<double> samples;
+
+		for (int repeat = 0; repeat < repeats; ++repeat)
+		{
+			Stopwatch stopwatch;
+
+			for (const std::string &query : queries)
+				g_sink = g_sink + find(query);
+
+			samples.push_back(stopwatch.seconds() * 1e9 / static_cast<double>(queries.size()));
+		}
+
+		method.nsPerLookup = percentile(samples, 0.50);
+	}
+}
+
+int runSymbolsBenchmark(const BenchmarkArguments &args, BenchmarkReport &report)
+{
+	int lookups{std::max(1, args.intValue(L"-lookups", 100000))};
+	int repeats{std::max(1, args.intValue(L"-repeats", 9))};
+
+	std::vector<const char *> unknownNames;
+
+	for (const char *pszName : kUnknownNames)
+	{
+		if (findSymbol(pszName) == Symbol::Count)
+			unknownNames.push_back(pszName);
+	}
+
+	// Three known names to every unknown one, in a fixed pseudo-random order.
+
+	std::vector<std::string> queries;
+	unsigned seed{12345};
+
+	for (int i = 0; i < lookups; ++i)
+	{
+		seed = seed * 1664525u + 1013904223u;
+
+		if ((seed >> 8) % 4 == 0 && !unknownNames.empty())
+			queries.push_back(unknownNames[(seed >> 12) % unknownNames.size()]);
+		else
+			queries.push_back(kSymbolLiterals[(seed >> 12) % Symbol::Count]);
+	}
+
+	std::size_t literalBytes{0};
+
+	for (const char *pszName : kSymbolLiterals)
+		literalBytes += std::char_traits<char>::length(pszName) + 1;
+
+	std::vector<std::pair<std::string_view, unsigned>> sorted;
+	std::unordered_map<std::string_view, unsigned> map;
+
+	for (unsigned symbol = 0; symbol < Symbol::Count; ++symbol)
+	{
+		sorted.emplace_back(kSymbolNames[symbol], symbol);
+		map.emplace(kSymbolNames[symbol], symbol);
+	}
+
+	std::sort(sorted.begin(), sorted.end());
+
+	report.setProperty("symbols", Symbol::Count);
+	report.setProperty("lookups", lookups);
+	report.setProperty("repeats", repeats);
+	report.setProperty("literalBytes", static_cast<double>(literalBytes + sizeof(kSymbolLiterals)));
+	report.setProperty("poolBytes", static_cast<double>(kSymbolNames.bytes()));
+
+	// The map's size counts its nodes and buckets, but not the allocator's overhead.
+
+	Method methods[]
+	{
+		{"perfecthash", kSymbolHash.bytes()},
+		{"linear", 0},
+		{"binarysearch", sorted.size() * sizeof(sorted[0])},
+		{"unorderedmap", map.size() * (sizeof(std::pair<const std::string_view, unsigned>) + 2 * sizeof(void *)) + map.bucket_count() * sizeof(void *)},
+	};
+
+	measure(methods[0], queries, repeats, [](std::string_view name)
+	{
+		return static_cast<unsigned>(kSymbolHash.find(name, symbolName));
+	});
+
+	measure(methods[1], queries, repeats, [](std::string_view name)
+	{
+		for (unsigned symbol = 0; symbol < Symbol::Count; ++symbol)
+		{
+			if (name == kSymbolLiterals[symbol])
+				return symbol;
+		}
+
+		return static_cast<unsigned>(Symbol::Count);
+	});
+
+	measure(methods[2], queries, repeats, [&sorted](std::string_view name)
+	{
+		auto it{std::lower_bound(sorted.begin(), sorted.end(), name, [](const auto &entry, std::string_view value) { return entry.first < value; })};
+		return it != sorted.end() && it->first == name ? it->second : static_cast<unsigned>(Symbol::Count);
+	});
+
+	measure(methods[3], queries, repeats, [&map](std::string_view name)
+	{
+		auto it{map.find(name)};
+		return it != map.end() ? it->second : static_cast<unsigned>(Symbol::Count);
+	});
+
+	bool agree{true};
+
+	for (const Method &method : methods)
+	{
+		agree = agree && method.results == methods[0].results;
+
+		report.beginResult();
+		report.set("method", method.pszName);
+		report.set("nsPerLookup", method.nsPerLookup);
+		report.set("tableBytes", static_cast<double>(method.tableBytes));
+		report.set("speedup", method.nsPerLookup > 0.0 ? methods[1].nsPerLookup / method.nsPerLookup : 0.0);
+	}
+
+	return agree ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
@@ -0,0 +1,173 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+module Benchmark;
+
+import HeadlessContext;
+import OpenGL;
+
+// Measures a material-heavy frame with the texture binding cache off and on.
+//
+//     -benchmark texturebinds [-materials n] [-units n] [-frames n]
+//
+// Like typical material code, each material selects every texture unit it uses and binds its texture
+// there before drawing, whether or not the unit already has it. Unit 0 gets a texture of the
+// material's own, and each unit after it a texture shared by four times as many materials as the one
+// before, so most of the binds are redundant. With the cache on the redundant binds and unit changes
+// are dropped, and on GL 4.4 and later the rest are made with one glBindTextures() call per draw, so
+// the rows show how many calls reach the driver as well as the frame time. -units is capped at the
+// driver's GL_MAX_TEXTURE_IMAGE_UNITS. Fails if a unit reports the wrong binding afterwards.
+
+namespace
+{
+	GLuint textureOf(const std::vector<std::vector<GLuint>> &textures, int material, int unit)
+	{
+		const std::vector<GLuint> &unitTextures{textures[unit]};
+		return unitTextures[(static_cast<unsigned>(material) >> (2 * unit)) % unitTextures.size()];
+	}
+
+	void renderFrame(const std::vector<std::vector<GLuint>> &textures, int materials)
+	{
+		int units{static_cast<int>(textures.size())};
+
+		for (int material = 0; material < materials; ++material)
+		{
+			for (int unit = 0; unit < units; ++unit)
+			{
+				glActiveTexture(GL_TEXTURE0 + unit);
+				glBindTexture(GL_TEXTURE_2D, textureOf(textures, material, unit));
+			}
+
+			glDrawArrays(GL_TRIANGLES, 0, 3);
+		}
+
+		glActiveTexture(GL_TEXTURE0);
+	}
+
+	bool checkBindings(const std::vector<std::vector<GLuint>> &textures, int materials)
+	{
+		int units{static_cast<int>(textures.size())};
+		bool ok{true};
+
+		for (int unit = 0; unit < units; ++unit)
+		{
+			GLint texture{};
+
+			glActiveTexture(GL_TEXTURE0 + unit);
+			glGetIntegerv(GL_TEXTURE_BINDING_2D, &texture);
+			ok = ok && static_cast<GLuint>(texture) == textureOf(textures, materials - 1, unit);
+		}
+
+		glActiveTexture(GL_TEXTURE0);
+		return ok;
+	}
+}
+
+int runTextureBindsBenchmark(const BenchmarkArguments &args, BenchmarkReport &report)
+{
+	int materials{std::max(1, args.intValue(L"-materials", 2000))};
+	int units{std::clamp(args.intValue(L"-units", 4), 1, 16)};
+	int frames{std::max(1, args.intValue(L"-frames", 200))};
+
+	report.setProperty("materials", materials);
+	report.setProperty("frames", frames);
+
+	const TextureCacheMode modes[]
+	{
+		{OpenGLContext::TextureCache::Off, "off"},
+		{OpenGLContext::TextureCache::Shadow, "cached"},
+	};
+
+	return runTextureCacheModes(modes, [&](const TextureCacheMode &mode, HeadlessContext &context)
+	{
+		const GLExtensions &extensions{context.wgl().extensions()};
+		GLint maxUnits{1};
+
+		if (extensions.version().atLeast(2, 0))
+			glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxUnits);
+
+		units = std::min(units, static_cast<int>(maxUnits));
+
+		if (mode.mode == OpenGLContext::TextureCache::Off)
+		{
+			reportDriverProperties(report);
+			report.setProperty("units", units);
+			report.setProperty("multiBind", extensions.version().atLeast(4, 4) || extensions.has<GLExtensions::ARB_multi_bind>() ? "yes" : "no");
+		}
+
+		// Unit u has a texture for every 4^u materials, up to one per material.
+
+		std::vector<std::vector<GLuint>> textures(units);
+		const std::uint32_t texels[16]{};
+
+		for (int unit = 0; unit < units; ++unit)
+		{
+			std::vector<GLuint> &unitTextures{textures[unit]};
+
+			unitTextures.resize(std::max(1, materials >> (2 * unit)));
+			glGenTextures(static_cast<GLsizei>(unitTextures.size()), unitTextures.data());
+
+			for (GLuint texture : unitTextures)
+			{
+				glBindTexture(GL_TEXTURE_2D, texture);
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 4, 4, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels);
+			}
+		}
+
+		renderFrame(textures, materials);
+		glFinish();
+		OpenGLContext::resetTextureCacheStats();
+
+		Stopwatch stopwatch;
+
+		for (int frame = 0; frame < frames; ++frame)
+			renderFrame(textures, materials);
+
+		glFinish();
+
+		double seconds{stopwatch.seconds()};
+		OpenGLContext::TextureCacheStats stats{OpenGLContext::textureCacheStats()};
+		bool correct{checkBindings(textures, materials)};
+
+		report.beginResult();
+		report.set("mode", mode.pszName);
+		report.set("usPerFrame", seconds * 1e6 / frames);
+		report.set("bindCallsPerFrame", static_cast<double>(stats.bindCalls) / frames);
+		report.set("bindsForwardedPerFrame", static_cast<double>(stats.bindsForwarded) / frames);
+		report.set("multiBindsPerFrame", static_cast<double>(stats.multiBinds) / frames);
+		report.set("activeTextureCallsPerFrame", static_cast<double>(stats.activeTextureCalls) / frames);
+		report.set("activeTexturesForwardedPerFrame", static_cast<double>(stats.activeTexturesForwarded) / frames);
+		report.set("correct", correct ? "yes" : "no");
+
+		for (std::vector<GLuint> &unitTextures : textures)
+			glDeleteTextures(static_cast<GLsizei>(unitTextures.size()), unitTextures.data());
+
+		return correct;
+	});
+}
\ No newline at end of file
@@ -0,0 +1,384 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+module TextureFormats;
+
+import BenchmarkReport;
+
+namespace
+{
+	struct Candidates
+	{
+		GLenum internalFormat;
+		std::vector<PixelTransfer> transfers;
+	};
+
+	PixelTransfer transfer(GLenum format, GLenum type)
+	{
+		return PixelTransfer{format, type, FormatNegotiator::bytesPerPixel(format, type)};
+	}
+
+	// The first candidate for each internal format is the naive choice.
+
+	const std::vector<Candidates> &candidates()
+	{
+		static const std::vector<Candidates> theCandidates
+		{
+			{GL_RGBA8, {transfer(GL_RGBA, GL_UNSIGNED_BYTE), transfer(GL_BGRA, GL_UNSIGNED_BYTE), transfer(GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV)}},
+			{GL_SRGB8_ALPHA8, {transfer(GL_RGBA, GL_UNSIGNED_BYTE), transfer(GL_BGRA, GL_UNSIGNED_BYTE), transfer(GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV)}},
+			{GL_RGB8, {transfer(GL_RGB, GL_UNSIGNED_BYTE), transfer(GL_BGR, GL_UNSIGNED_BYTE), transfer(GL_RGBA, GL_UNSIGNED_BYTE), transfer(GL_BGRA, GL_UNSIGNED_BYTE)}},
+			{GL_R8, {transfer(GL_RED, GL_UNSIGNED_BYTE)}},
+			{GL_RGBA16F, {transfer(GL_RGBA, GL_FLOAT), transfer(GL_RGBA, GL_HALF_FLOAT)}},
+		};
+
+		return theCandidates;
+	}
+
+	std::string driverString(GLenum name)
+	{
+		const char *pszValue{reinterpret_cast<const char *>(glGetString(name))};
+		std::string value{pszValue ? pszValue : ""};
+
+		for (char &c : value)
+		{
+			if (c == '\t' || c == '\n' || c == '\r')
+				c = ' ';
+		}
+
+		return value;
+	}
+}
+
+std::unique_ptr<FormatNegotiator> FormatNegotiator::create(OpenGLContext &context, const wchar_t *pszCachePath)
+{
+	std::unique_ptr<FormatNegotiator> pNegotiator{new FormatNegotiator()};
+
+	pNegotiator->m_identity = driverString(GL_VENDOR) + "|" + driverString(GL_RENDERER) + "|" + driverString(GL_VERSION);
+
+	for (const Candidates &entry : candidates())
+		pNegotiator->m_entries.push_back(Entry{entry.internalFormat, entry.internalFormat, entry.transfers.front(), entry.transfers.front()});
+
+	if (pszCachePath && pNegotiator->readCache(pszCachePath))
+		return pNegotiator;
+
+	auto pfnGetInternalformativ{reinterpret_cast<PFNGLGETINTERNALFORMATIVPROC>(context.wglGetProcAddress("glGetInternalformativ"))};
+	bool query{pfnGetInternalformativ && hasExtension<GLExtensions::ARB_internalformat_query2>(context)};
+
+	for (Entry &entry : pNegotiator->m_entries)
+	{
+		if (query)
+		{
+			GLint preferredInternalFormat{GL_NONE};
+			GLint supported{GL_FALSE};
+			GLint format{GL_NONE};
+			GLint type{GL_NONE};
+
+			// The transfer is negotiated for the internal format the driver would rather store this one as.
+
+			pfnGetInternalformativ(GL_TEXTURE_2D, entry.internalFormat, GL_INTERNALFORMAT_PREFERRED, 1, &preferredInternalFormat);
+
+			GLenum internalFormat{preferredInternalFormat != GL_NONE ? static_cast<GLenum>(preferredInternalFormat) : entry.internalFormat};
+
+			pfnGetInternalformativ(GL_TEXTURE_2D, internalFormat, GL_INTERNALFORMAT_SUPPORTED, 1, &supported);
+
+			if (supported == GL_TRUE)
+			{
+				pfnGetInternalformativ(GL_TEXTURE_2D, internalFormat, GL_TEXTURE_IMAGE_FORMAT, 1, &format);
+				pfnGetInternalformativ(GL_TEXTURE_2D, internalFormat, GL_TEXTURE_IMAGE_TYPE, 1, &type);
+			}
+
+			if (bytesPerPixel(static_cast<GLenum>(format), static_cast<GLenum>(type)) > 0)
+			{
+				entry.preferredInternalFormat = internalFormat;
+				entry.preferred = transfer(static_cast<GLenum>(format), static_cast<GLenum>(type));
+				entry.method = NegotiationMethod::Query;
+				continue;
+			}
+		}
+
+		// Time every candidate. A format the driver rejects keeps the naive choice.
+
+		const Candidates *pCandidates{nullptr};
+		double best{0.0};
+
+		for (const Candidates &c : candidates())
+		{
+			if (c.internalFormat == entry.internalFormat)
+				pCandidates = &c;
+		}
+
+		for (const PixelTransfer &candidate : pCandidates->transfers)
+		{
+			double rate{measureUploadRate(entry.internalFormat, candidate, 256, 16)};
+
+			if (rate > best)
+			{
+				best = rate;
+				entry.preferred = candidate;
+				entry.method = NegotiationMethod::Timed;
+			}
+		}
+	}
+
+	if (pszCachePath)
+		pNegotiator->writeCache(pszCachePath);
+
+	return pNegotiator;
+}
+
+const std::vector<GLenum> &FormatNegotiator::internalFormats()
+{
+	static const std::vector<GLenum> theFormats{GL_RGBA8, GL_SRGB8_ALPHA8, GL_RGB8, GL_R8, GL_RGBA16F};
+	return theFormats;
+}
+
+PixelTransfer FormatNegotiator::preferred(GLenum internalFormat) const
+{
+	const Entry *pEntry{find(internalFormat)};
+	return pEntry ? pEntry->preferred : PixelTransfer{};
+}
+
+PixelTransfer FormatNegotiator::naive(GLenum internalFormat) const
+{
+	const Entry *pEntry{find(internalFormat)};
+	return pEntry ? pEntry->naive : PixelTransfer{};
+}
+
+NegotiationMethod FormatNegotiator::method(GLenum internalFormat) const
+{
+	const Entry *pEntry{find(internalFormat)};
+	return pEntry ? pEntry->method : NegotiationMethod::Default;
+}
+
+GLenum FormatNegotiator::preferredInternalFormat(GLenum internalFormat) const
+{
+	const Entry *pEntry{find(internalFormat)};
+	return pEntry ? pEntry->preferredInternalFormat : internalFormat;
+}
+
+const char *FormatNegotiator::methodName(NegotiationMethod method)
+{
+	switch (method)
+	{
+	case NegotiationMethod::Query: return "query";
+	case NegotiationMethod::Timed: return "timed";
+	case NegotiationMethod::Cached: return "cached";
+	default: return "default";
+	}
+}
+
+const char *FormatNegotiator::enumName(GLenum value)
+{
+	switch (value)
+	{
+	case GL_RGBA8: return "GL_RGBA8";
+	case GL_SRGB8_ALPHA8: return "GL_SRGB8_ALPHA8";
+	case GL_RGB8: return "GL_RGB8";
+	case GL_R8: return "GL_R8";
+	case GL_RGBA16F: return "GL_RGBA16F";
+	case GL_SRGB8: return "GL_SRGB8";
+	case GL_RGBA16: return "GL_RGBA16";
+	case GL_RGBA32F: return "GL_RGBA32F";
+	case GL_RED: return "GL_RED";
+	case GL_RG: return "GL_RG";
+	case GL_RGB: return "GL_RGB";
+	case GL_BGR: return "GL_BGR";
+	case GL_RGBA: return "GL_RGBA";
+	case GL_BGRA: return "GL_BGRA";
+	case GL_UNSIGNED_BYTE: return "GL_UNSIGNED_BYTE";
+	case GL_UNSIGNED_SHORT: return "GL_UNSIGNED_SHORT";
+	case GL_UNSIGNED_INT: return "GL_UNSIGNED_INT";
+	case GL_HALF_FLOAT: return "GL_HALF_FLOAT";
+	case GL_FLOAT: return "GL_FLOAT";
+	case GL_UNSIGNED_INT_8_8_8_8: return "GL_UNSIGNED_INT_8_8_8_8";
+	case GL_UNSIGNED_INT_8_8_8_8_REV: return "GL_UNSIGNED_INT_8_8_8_8_REV";
+	case GL_UNSIGNED_INT_2_10_10_10_REV: return "GL_UNSIGNED_INT_2_10_10_10_REV";
+	default: return "unknown";
+	}
+}
+
+int FormatNegotiator::bytesPerPixel(GLenum format, GLenum type)
+{
+	int components{0};
+
+	switch (format)
+	{
+	case GL_RED: case GL_GREEN: case GL_BLUE: case GL_ALPHA: components = 1; break;
+	case GL_RG: components = 2; break;
+	case GL_RGB: case GL_BGR: components = 3; break;
+	case GL_RGBA: case GL_BGRA: components = 4; break;
+	default: return 0;
+	}
+
+	switch (type)
+	{
+	case GL_UNSIGNED_BYTE: case GL_BYTE: return components;
+	case GL_UNSIGNED_SHORT: case GL_SHORT: case GL_HALF_FLOAT: return components * 2;
+	case GL_UNSIGNED_INT: case GL_INT: case GL_FLOAT: return components * 4;
+	case GL_UNSIGNED_INT_8_8_8_8: case GL_UNSIGNED_INT_8_8_8_8_REV: case GL_UNSIGNED_INT_2_10_10_10_REV: return components == 4 ? 4 : 0;
+	default: return 0;
+	}
+}
+
+double FormatNegotiator::measureUploadRate(GLenum internalFormat, const PixelTransfer &transfer, int size, int iterations)
+{
+	std::vector<std::uint8_t> pixels(static_cast<size_t>(size) * size * transfer.bytesPerPixel, 0x3c);
+	GLuint texture{};
+	GLint previousTexture{};
+	GLint previousAlignment{4};
+
+	while (glGetError() != GL_NO_ERROR)
+		;
+
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &previousAlignment);
+
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(internalFormat), size, size, 0, transfer.format, transfer.type, nullptr);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	double rate{0.0};
+
+	if (glGetError() == GL_NO_ERROR)
+	{
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size, size, transfer.format, transfer.type, pixels.data());
+		glFinish();
+
+		Stopwatch stopwatch;
+
+		for (int i = 0; i < iterations; ++i)
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size, size, transfer.format, transfer.type, pixels.data());
+
+		glFinish();
+
+		double seconds{stopwatch.seconds()};
+
+		if (glGetError() == GL_NO_ERROR && seconds > 0.0)
+			rate = static_cast<double>(pixels.size()) * iterations / seconds / 1e9;
+	}
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, previousAlignment);
+	glDeleteTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(previousTexture));
+	return rate;
+}
+
+bool FormatNegotiator::readCache(const wchar_t *pszCachePath)
+{
+	FILE *pFile{nullptr};
+
+	if (_wfopen_s(&pFile, pszCachePath, L"rb") != 0)
+		return false;
+
+	char line[1024];
+	unsigned found{0};
+
+	while (std::fgets(line, sizeof(line), pFile))
+	{
+		// identity <tab> internal format <tab> format <tab> type <tab> preferred internal format. Files
+		// written before the last column was added lack it, and the internal format is used.
+
+		char *pszTab{std::strchr(line, '\t')};
+
+		if (!pszTab || m_identity.compare(0, std::string::npos, line, static_cast<size_t>(pszTab - line)) != 0)
+			continue;
+
+		char *pszNext{nullptr};
+		GLenum internalFormat{static_cast<GLenum>(std::strtoul(pszTab + 1, &pszNext, 0))};
+		GLenum format{static_cast<GLenum>(std::strtoul(pszNext, &pszNext, 0))};
+		GLenum type{static_cast<GLenum>(std::strtoul(pszNext, &pszNext, 0))};
+		GLenum preferredInternalFormat{static_cast<GLenum>(std::strtoul(pszNext, &pszNext, 0))};
+
+		for (Entry &entry : m_entries)
+		{
+			if (entry.internalFormat == internalFormat && bytesPerPixel(format, type) > 0)
+			{
+				entry.preferredInternalFormat = preferredInternalFormat ? preferredInternalFormat : internalFormat;
+				entry.preferred = transfer(format, type);
+				entry.method = NegotiationMethod::Cached;
+				++found;
+			}
+		}
+	}
+
+	std::fclose(pFile);
+	return found == m_entries.size();
+}
+
+bool FormatNegotiator::writeCache(const wchar_t *pszCachePath) const
+{
+	// Keep the entries for other drivers and replace this driver's.
+
+	std::string contents;
+	FILE *pFile{nullptr};
+
+	if (_wfopen_s(&pFile, pszCachePath, L"rb") == 0)
+	{
+		char line[1024];
+
+		while (std::fgets(line, sizeof(line), pFile))
+		{
+			const char *pszTab{std::strchr(line, '\t')};
+
+			if (pszTab && m_identity.compare(0, std::string::npos, line, static_cast<size_t>(pszTab - line)) != 0)
+				contents += line;
+		}
+
+		std::fclose(pFile);
+	}
+
+	for (const Entry &entry : m_entries)
+	{
+		char line[64]{};
+		std::snprintf(line, sizeof(line), "\t0x%04x\t0x%04x\t0x%04x\t0x%04x\n", entry.internalFormat, entry.preferred.format, entry.preferred.type, entry.preferredInternalFormat);
+		contents += m_identity + line;
+	}
+
+	if (_wfopen_s(&pFile, pszCachePath, L"wb") != 0)
+		return false;
+
+	bool ok{std::fwrite(contents.data(), 1, contents.size(), pFile) == contents.size()};
+	return std::fclose(pFile) == 0 && ok;
+}
+
+const FormatNegotiator::Entry *FormatNegotiator::find(GLenum internalFormat) const
+{
+	for (const Entry &entry : m_entries)
+	{
+		if (entry.internalFormat == internalFormat)
+			return &entry;
+	}
+
+	return nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+export module TextureFormats;
+
+import OpenGL;
+
+// The FormatNegotiator class chooses the client pixel format and type to upload each common texture
+// internal format with. Uploading data in a layout the driver doesn't store natively makes it convert
+// every texel on the CPU, so for example a driver that stores GL_RGBA8 as BGRA uploads GL_BGRA data
+// much faster than GL_RGBA data.
+//
+// The driver is asked with ARB_internalformat_query2 when it supports it: GL_INTERNALFORMAT_PREFERRED
+// gives the internal format it would rather store each one as, such as GL_RGBA8 for GL_RGB8, and
+// GL_TEXTURE_IMAGE_FORMAT and GL_TEXTURE_IMAGE_TYPE the transfer for that internal format. Otherwise
+// every candidate format and type is timed with a few small uploads and the fastest wins. Results can be cached in a file, keyed by the driver's vendor, renderer and
+// version strings, so the timing only happens the first time a driver is seen.
+
+export struct PixelTransfer
+{
+	GLenum format{GL_RGBA};
+	GLenum type{GL_UNSIGNED_BYTE};
+	int bytesPerPixel{4};
+};
+
+export enum class NegotiationMethod
+{
+	Default,
+	Query,
+	Timed,
+	Cached,
+};
+
+export class FormatNegotiator
+{
+public:
+	// Negotiate formats for the current context. If pszCachePath isn't null then results for this driver
+	// are read from the file, and written back to it if they had to be worked out.
+
+	static std::unique_ptr<FormatNegotiator> create(OpenGLContext &context, const wchar_t *pszCachePath = nullptr);
+
+	// The internal formats that are negotiated: GL_RGBA8, GL_SRGB8_ALPHA8, GL_RGB8, GL_R8 and GL_RGBA16F.
+
+	static const std::vector<GLenum> &internalFormats();
+
+	// The format and type upload code should use for an internal format, and the one it would naively
+	// use (GL_RGBA and GL_UNSIGNED_BYTE for GL_RGBA8, GL_FLOAT for GL_RGBA16F, and so on). Internal
+	// formats that aren't negotiated get GL_RGBA and GL_UNSIGNED_BYTE.
+
+	PixelTransfer preferred(GLenum internalFormat) const;
+	PixelTransfer naive(GLenum internalFormat) const;
+	NegotiationMethod method(GLenum internalFormat) const;
+
+	// The internal format textures of internalFormat should be created with, which preferred() is the
+	// transfer for. It's internalFormat itself unless the driver said it prefers another.
+
+	GLenum preferredInternalFormat(GLenum internalFormat) const;
+
+	const std::string &driverIdentity() const { return m_identity; }
+
+	static const char *methodName(NegotiationMethod method);
+	static const char *enumName(GLenum value);
+	static int bytesPerPixel(GLenum format, GLenum type);
+
+	// Upload throughput in GB/s of glTexSubImage2D() into a size x size texture. Returns zero if the
+	// driver rejects the combination. The GL_TEXTURE_2D binding and GL_UNPACK_ALIGNMENT are put back
+	// afterwards, but any pending GL errors are cleared.
+
+	static double measureUploadRate(GLenum internalFormat, const PixelTransfer &transfer, int size, int iterations);
+
+private:
+	struct Entry
+	{
+		GLenum internalFormat{};
+		GLenum preferredInternalFormat{};
+		PixelTransfer naive;
+		PixelTransfer preferred;
+		NegotiationMethod method{NegotiationMethod::Default};
+	};
+
+	FormatNegotiator() = default;
+
+	bool readCache(const wchar_t *pszCachePath);
+	bool writeCache(const wchar_t *pszCachePath) const;
+	const Entry *find(GLenum internalFormat) const;
+
+	std::string m_identity;
+	std::vector<Entry> m_entries;
+};
\ No newline at end of file
@@ -0,0 +1,336 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cwchar>
+#include <string>
+#include <utility>
+#include <vector>
+
+module Topology;
+
+namespace
+{
+	bool inMask(const GROUP_AFFINITY &affinity, const LogicalProcessor &processor)
+	{
+		return affinity.Group == processor.group && (affinity.Mask & (static_cast<KAFFINITY>(1) << processor.number)) != 0;
+	}
+
+	std::vector<unsigned char> queryInformation(LOGICAL_PROCESSOR_RELATIONSHIP relationship)
+	{
+		DWORD length{0};
+		std::vector<unsigned char> buffer;
+
+		GetLogicalProcessorInformationEx(relationship, nullptr, &length);
+
+		if (length > 0)
+		{
+			buffer.resize(length);
+
+			if (!GetLogicalProcessorInformationEx(relationship, reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer.data()), &length))
+				buffer.clear();
+		}
+
+		return buffer;
+	}
+
+	template <typename Visit>
+	void forEachRelationship(const std::vector<unsigned char> &buffer, LOGICAL_PROCESSOR_RELATIONSHIP relationship, Visit visit)
+	{
+		for (DWORD offset = 0; offset < buffer.size();)
+		{
+			const auto *pInfo{reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX *>(buffer.data() + offset)};
+
+			offset += pInfo->Size;
+
+			if (pInfo->Relationship == relationship)
+				visit(*pInfo);
+		}
+	}
+}
+
+const CpuTopology &CpuTopology::instance()
+{
+	static CpuTopology theInstance;
+	return theInstance;
+}
+
+CpuTopology::CpuTopology()
+{
+	std::vector<unsigned char> buffer{queryInformation(RelationAll)};
+
+	// Cores come first so that every logical processor exists before nodes and packages are assigned.
+
+	forEachRelationship(buffer, RelationProcessorCore, [this](const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX &info)
+	{
+		for (WORD i = 0; i < info.Processor.GroupCount; ++i)
+		{
+			const GROUP_AFFINITY &affinity{info.Processor.GroupMask[i]};
+
+			for (BYTE bit = 0; bit < sizeof(KAFFINITY) * 8; ++bit)
+			{
+				if (affinity.Mask & (static_cast<KAFFINITY>(1) << bit))
+				{
+					LogicalProcessor processor{};
+
+					processor.group = affinity.Group;
+					processor.number = bit;
+					processor.core = m_coreCount;
+					m_processors.push_back(processor);
+				}
+			}
+		}
+
+		++m_coreCount;
+	});
+
+	// Processors are numbered through each group in turn, so that an index is the number Windows
+	// gives the processor rather than its position in core order.
+
+	std::sort(m_processors.begin(), m_processors.end(), [](const LogicalProcessor &a, const LogicalProcessor &b)
+	{
+		return a.group != b.group ? a.group < b.group : a.number < b.number;
+	});
+
+	for (size_t i = 0; i < m_processors.size(); ++i)
+		m_processors[i].index = static_cast<unsigned>(i);
+
+	// Plain RelationNumaNode only reports each node's primary group. Asking for RelationNumaNodeEx
+	// returns the same records with every group a node spans, but older versions of Windows reject it.
+	// A GroupCount of zero comes from versions that predate the field and means the single GroupMask.
+
+	std::vector<unsigned char> nodes{queryInformation(RelationNumaNodeEx)};
+
+	if (nodes.empty())
+		nodes = buffer;
+
+	forEachRelationship(nodes, RelationNumaNode, [this](const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX &info)
+	{
+		NumaNode node{};
+
+		node.number = info.NumaNode.NodeNumber;
+		node.groups.assign(info.NumaNode.GroupMasks, info.NumaNode.GroupMasks + std::max<WORD>(info.NumaNode.GroupCount, 1));
+
+		for (LogicalProcessor &processor : m_processors)
+		{
+			for (const GROUP_AFFINITY &affinity : node.groups)
+			{
+				if (inMask(affinity, processor))
+					processor.numaNode = node.number;
+			}
+		}
+
+		m_numaNodes.push_back(std::move(node));
+	});
+
+	forEachRelationship(buffer, RelationProcessorPackage, [this](const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX &info)
+	{
+		for (WORD i = 0; i < info.Processor.GroupCount; ++i)
+		{
+			for (LogicalProcessor &processor : m_processors)
+			{
+				if (inMask(info.Processor.GroupMask[i], processor))
+					processor.package = m_packageCount;
+			}
+		}
+
+		++m_packageCount;
+	});
+
+	// If the query failed fall back to treating every processor in the current group as its own core.
+
+	if (m_processors.empty())
+	{
+		SYSTEM_INFO info{};
+		NumaNode node{};
+		GROUP_AFFINITY affinity{};
+
+		GetSystemInfo(&info);
+
+		for (BYTE bit = 0; bit < sizeof(KAFFINITY) * 8; ++bit)
+		{
+			if (info.dwActiveProcessorMask & (static_cast<KAFFINITY>(1) << bit))
+			{
+				LogicalProcessor processor{};
+
+				processor.index = static_cast<unsigned>(m_processors.size());
+				processor.number = bit;
+				processor.core = static_cast<unsigned>(m_processors.size());
+				m_processors.push_back(processor);
+				affinity.Mask |= static_cast<KAFFINITY>(1) << bit;
+			}
+		}
+
+		node.groups.push_back(affinity);
+		m_coreCount = static_cast<unsigned>(m_processors.size());
+		m_numaNodes.assign(1, node);
+	}
+
+	if (m_numaNodes.empty())
+		m_numaNodes.push_back(NumaNode{});
+
+	m_packageCount = m_packageCount ? m_packageCount : 1;
+}
+
+const CpuTopology::NumaNode *CpuTopology::findNode(unsigned number) const
+{
+	for (const NumaNode &node : m_numaNodes)
+	{
+		if (node.number == number)
+			return &node;
+	}
+
+	return nullptr;
+}
+
+std::vector<unsigned> CpuTopology::placement(unsigned count) const
+{
+	// Order each node's processors so that the first logical processor of every core comes before any
+	// SMT sibling, then interleave the nodes.
+
+	std::vector<std::vector<unsigned>> nodes(m_numaNodes.size());
+
+	for (int sibling = 0; sibling < 2; ++sibling)
+	{
+		std::vector<bool> coreSeen(m_coreCount, false);
+
+		for (const LogicalProcessor &processor : m_processors)
+		{
+			bool first{!coreSeen[processor.core]};
+
+			coreSeen[processor.core] = true;
+
+			const NumaNode *pNode{findNode(processor.numaNode)};
+
+			if (first == (sibling == 0))
+				nodes[pNode ? static_cast<size_t>(pNode - m_numaNodes.data()) : 0].push_back(processor.index);
+		}
+	}
+
+	std::vector<unsigned> order;
+
+	for (size_t i = 0; order.size() < m_processors.size(); ++i)
+	{
+		for (const std::vector<unsigned> &node : nodes)
+		{
+			if (i < node.size())
+				order.push_back(node[i]);
+		}
+	}
+
+	std::vector<unsigned> result;
+
+	for (unsigned i = 0; i < count && !order.empty(); ++i)
+		result.push_back(order[i % order.size()]);
+
+	return result;
+}
+
+bool CpuTopology::pinCurrentThread(unsigned processor) const
+{
+	if (processor >= m_processors.size())
+		return false;
+
+	GROUP_AFFINITY affinity{};
+
+	affinity.Group = m_processors[processor].group;
+	affinity.Mask = static_cast<KAFFINITY>(1) << m_processors[processor].number;
+
+	return SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != FALSE;
+}
+
+bool CpuTopology::pinCurrentThreadToNode(unsigned numaNode) const
+{
+	const NumaNode *pNode{findNode(numaNode)};
+
+	if (!pNode)
+		return false;
+
+	GROUP_AFFINITY affinity{};
+	int mostProcessors{0};
+
+	for (const GROUP_AFFINITY &group : pNode->groups)
+	{
+		int processors{std::popcount(static_cast<std::uint64_t>(group.Mask))};
+
+		if (processors > mostProcessors)
+		{
+			affinity = group;
+			mostProcessors = processors;
+		}
+	}
+
+	if (affinity.Mask == 0)
+		return false;
+
+	return SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != FALSE;
+}
+
+bool CpuTopology::setCurrentThreadPriority(ThreadPriority priority)
+{
+	int value{THREAD_PRIORITY_NORMAL};
+
+	switch (priority)
+	{
+	case ThreadPriority::Low: value = THREAD_PRIORITY_LOWEST; break;
+	case ThreadPriority::Normal: value = THREAD_PRIORITY_NORMAL; break;
+	case ThreadPriority::AboveNormal: value = THREAD_PRIORITY_ABOVE_NORMAL; break;
+	case ThreadPriority::High: value = THREAD_PRIORITY_HIGHEST; break;
+	case ThreadPriority::TimeCritical: value = THREAD_PRIORITY_TIME_CRITICAL; break;
+	}
+
+	return SetThreadPriority(GetCurrentThread(), value) != FALSE;
+}
+
+bool CpuTopology::parsePriority(const wchar_t *pszName, ThreadPriority &priority)
+{
+	struct Name { const wchar_t *pszName; ThreadPriority priority; };
+
+	const Name names[]
+	{
+		{L"low", ThreadPriority::Low},
+		{L"normal", ThreadPriority::Normal},
+		{L"above", ThreadPriority::AboveNormal},
+		{L"high", ThreadPriority::High},
+		{L"realtime", ThreadPriority::TimeCritical},
+	};
+
+	for (const Name &name : names)
+	{
+		if (pszName && _wcsicmp(pszName, name.pszName) == 0)
+		{
+			priority = name.priority;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+std::string CpuTopology::describe() const
+{
+	return std::to_string(m_packageCount) + " packages, " + std::to_string(m_numaNodes.size()) + " NUMA nodes, " +
+		std::to_string(m_coreCount) + " cores, " + std::to_string(m_processors.size()) + " logical processors";
+}
\ No newline at end of file
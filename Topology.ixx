@@ -0,0 +1,107 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <string>
+#include <vector>
+
+export module Topology;
+
+// The CpuTopology class describes the logical processors of the machine, which physical core,
+// NUMA node and package each of them belongs to, and lets threads be pinned to them. It's built
+// from GetLogicalProcessorInformationEx() so that machines with more than 64 logical processors,
+// which Windows splits into processor groups, are handled correctly.
+
+// A logical processor's index is its system-wide number, which counts through each processor group
+// in turn as Windows does, and numaNode is the node number Windows reports rather than an ordinal.
+
+export struct LogicalProcessor
+{
+	unsigned index{};
+	WORD group{};
+	BYTE number{};
+	unsigned core{};
+	unsigned numaNode{};
+	unsigned package{};
+};
+
+export enum class ThreadPriority
+{
+	Low,
+	Normal,
+	AboveNormal,
+	High,
+	TimeCritical,
+};
+
+export class CpuTopology
+{
+public:
+	// The topology is queried once, on first use.
+
+	static const CpuTopology &instance();
+
+	const std::vector<LogicalProcessor> &processors() const { return m_processors; }
+	unsigned coreCount() const { return m_coreCount; }
+	unsigned numaNodeCount() const { return static_cast<unsigned>(m_numaNodes.size()); }
+	unsigned packageCount() const { return m_packageCount; }
+
+	// Choose a logical processor for each of count threads. Threads are spread round-robin across
+	// NUMA nodes and each node's physical cores are used before their SMT siblings. If there are more
+	// threads than logical processors the placement wraps around.
+
+	std::vector<unsigned> placement(unsigned count) const;
+
+	// Restrict the calling thread to a single logical processor, or to every logical processor of a
+	// NUMA node. A thread's affinity can only cover one processor group, so a node that spans several
+	// groups is limited to the group holding most of its processors. These return false if there's no
+	// such processor or node, or the affinity couldn't be set.
+
+	bool pinCurrentThread(unsigned processor) const;
+	bool pinCurrentThreadToNode(unsigned numaNode) const;
+
+	static bool setCurrentThreadPriority(ThreadPriority priority);
+
+	// Parse a priority name (low, normal, above, high or realtime). Returns false if the name isn't recognised.
+
+	static bool parsePriority(const wchar_t *pszName, ThreadPriority &priority);
+
+	// One line summary of the topology, for example "2 packages, 2 NUMA nodes, 32 cores, 64 logical processors".
+
+	std::string describe() const;
+
+private:
+	struct NumaNode
+	{
+		unsigned number{};
+		std::vector<GROUP_AFFINITY> groups;
+	};
+
+	CpuTopology();
+
+	const NumaNode *findNode(unsigned number) const;
+
+	std::vector<LogicalProcessor> m_processors;
+	std::vector<NumaNode> m_numaNodes;
+	unsigned m_coreCount{};
+	unsigned m_packageCount{};
+};
\ No newline at end of file
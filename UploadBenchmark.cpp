@@ -0,0 +1,304 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+module;
+
+#include <windows.h>
+#include <GL/glcorearb.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+module Benchmark;
+
+import HeadlessContext;
+import OpenGL;
+
+// Measures texture upload throughput across pixel formats, sizes, row alignments, upload calls and
+// data sources, and ranks every combination by GB/s.
+//
+//     -benchmark upload [-maxsize n] [-megabytes n] [-nopbo]
+//
+// The upload calls are glTexImage2D() of the whole texture, glTexSubImage2D() of the whole texture,
+// and glTexSubImage2D() of the centre quarter of the texture taken from a full-size client image with
+// GL_UNPACK_ROW_LENGTH. The data comes from client memory, or from a pixel unpack buffer that's
+// orphaned and refilled with glBufferSubData() before every upload, which is the usual streaming
+// pattern. Sizes that aren't a multiple of 8 make GL_UNPACK_ALIGNMENT matter for the 1 and 3 byte
+// formats.
+
+namespace
+{
+	struct UploadFormat
+	{
+		const char *pszName;
+		GLint internalFormat;
+		GLenum format;
+		GLenum type;
+		int bytesPerPixel;
+	};
+
+	const UploadFormat kFormats[]
+	{
+		{"RGBA8", GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, 4},
+		{"BGRA8", GL_RGBA8, GL_BGRA, GL_UNSIGNED_BYTE, 4},
+		{"RGB8", GL_RGB8, GL_RGB, GL_UNSIGNED_BYTE, 3},
+		{"R8", GL_R8, GL_RED, GL_UNSIGNED_BYTE, 1},
+		{"RGBA16F", GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT, 8},
+	};
+
+	enum class UploadCall { Image, SubImage, SubRect };
+
+	struct UploadResult
+	{
+		const UploadFormat *pFormat;
+		int size;
+		int alignment;
+		UploadCall call;
+		bool buffer;
+		double gigabytesPerSecond;
+	};
+
+	// Buffer object entry points aren't part of OpenGL 1.1.
+
+	struct BufferFunctions
+	{
+		PFNGLGENBUFFERSPROC pfnGenBuffers{nullptr};
+		PFNGLDELETEBUFFERSPROC pfnDeleteBuffers{nullptr};
+		PFNGLBINDBUFFERPROC pfnBindBuffer{nullptr};
+		PFNGLBUFFERDATAPROC pfnBufferData{nullptr};
+		PFNGLBUFFERSUBDATAPROC pfnBufferSubData{nullptr};
+
+		bool load(OpenGLContext &context)
+		{
+			pfnGenBuffers = reinterpret_cast<PFNGLGENBUFFERSPROC>(context.wglGetProcAddress("glGenBuffers"));
+			pfnDeleteBuffers = reinterpret_cast<PFNGLDELETEBUFFERSPROC>(context.wglGetProcAddress("glDeleteBuffers"));
+			pfnBindBuffer = reinterpret_cast<PFNGLBINDBUFFERPROC>(context.wglGetProcAddress("glBindBuffer"));
+			pfnBufferData = reinterpret_cast<PFNGLBUFFERDATAPROC>(context.wglGetProcAddress("glBufferData"));
+			pfnBufferSubData = reinterpret_cast<PFNGLBUFFERSUBDATAPROC>(context.wglGetProcAddress("glBufferSubData"));
+			return pfnGenBuffers && pfnDeleteBuffers && pfnBindBuffer && pfnBufferData && pfnBufferSubData;
+		}
+	};
+
+	const char *callName(UploadCall call)
+	{
+		switch (call)
+		{
+		case UploadCall::Image: return "glTexImage2D";
+		case UploadCall::SubImage: return "glTexSubImage2D";
+		default: return "glTexSubImage2D-subrect";
+		}
+	}
+
+	size_t rowBytes(int width, int bytesPerPixel, int alignment)
+	{
+		size_t bytes{static_cast<size_t>(width) * bytesPerPixel};
+		return (bytes + alignment - 1) / alignment * alignment;
+	}
+
+	bool formatSupported(const UploadFormat &format)
+	{
+		GLuint texture{};
+
+		while (glGetError() != GL_NO_ERROR)
+			;
+
+		glGenTextures(1, &texture);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glTexImage2D(GL_TEXTURE_2D, 0, format.internalFormat, 4, 4, 0, format.format, format.type, nullptr);
+
+		bool supported{glGetError() == GL_NO_ERROR};
+
+		glDeleteTextures(1, &texture);
+		return supported;
+	}
+
+	// Returns the throughput in GB/s of uploading the same data repeatedly until about the given number
+	// of bytes have been transferred.
+
+	double measureUpload(const UploadFormat &format, int size, int alignment, UploadCall call, const BufferFunctions *pBuffers, size_t targetBytes)
+	{
+		int width{call == UploadCall::SubRect ? size / 2 : size};
+		int height{width};
+		size_t stride{rowBytes(size, format.bytesPerPixel, alignment)};
+		size_t imageBytes{stride * size};
+		size_t uploadBytes{static_cast<size_t>(width) * height * format.bytesPerPixel};
+		int offsetX{call == UploadCall::SubRect ? size / 4 : 0};
+		int offsetY{offsetX};
+		size_t sourceOffset{static_cast<size_t>(offsetY) * stride + static_cast<size_t>(offsetX) * format.bytesPerPixel};
+		std::vector<std::uint8_t> pixels(imageBytes, 0x3c);
+		GLuint texture{};
+		GLuint buffer{};
+
+		glGenTextures(1, &texture);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexImage2D(GL_TEXTURE_2D, 0, format.internalFormat, size, size, 0, format.format, format.type, nullptr);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, call == UploadCall::SubRect ? size : 0);
+
+		if (pBuffers)
+		{
+			pBuffers->pfnGenBuffers(1, &buffer);
+			pBuffers->pfnBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+		}
+
+		auto upload = [&]()
+		{
+			const std::uint8_t *pSource{pixels.data() + sourceOffset};
+
+			if (pBuffers)
+			{
+				pBuffers->pfnBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(imageBytes), nullptr, GL_STREAM_DRAW);
+				pBuffers->pfnBufferSubData(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(imageBytes), pixels.data());
+				pSource = reinterpret_cast<const std::uint8_t *>(sourceOffset);
+			}
+
+			if (call == UploadCall::Image)
+				glTexImage2D(GL_TEXTURE_2D, 0, format.internalFormat, width, height, 0, format.format, format.type, pSource);
+			else
+				glTexSubImage2D(GL_TEXTURE_2D, 0, offsetX, offsetY, width, height, format.format, format.type, pSource);
+		};
+
+		size_t iterations{std::max<size_t>(8, targetBytes / uploadBytes)};
+
+		upload();
+		upload();
+		glFinish();
+
+		Stopwatch stopwatch;
+
+		for (size_t i = 0; i < iterations; ++i)
+			upload();
+
+		glFinish();
+
+		double seconds{stopwatch.seconds()};
+
+		if (pBuffers)
+		{
+			pBuffers->pfnBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+			pBuffers->pfnDeleteBuffers(1, &buffer);
+		}
+
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+		glDeleteTextures(1, &texture);
+
+		return static_cast<double>(uploadBytes) * static_cast<double>(iterations) / seconds / 1e9;
+	}
+}
+
+int runUploadBenchmark(const BenchmarkArguments &args, BenchmarkReport &report)
+{
+	int maxSize{std::max(64, args.intValue(L"-maxsize", 2048))};
+	size_t targetBytes{static_cast<size_t>(std::max(1, args.intValue(L"-megabytes", 256))) << 20};
+	std::unique_ptr<HeadlessContext> pContext{HeadlessContext::create(64, 64)};
+
+	if (!pContext || !pContext->makeCurrent())
+		return EXIT_FAILURE;
+
+	BufferFunctions buffers;
+	bool useBuffers{!args.has(L"-nopbo") && buffers.load(pContext->wgl())};
+
+	reportDriverProperties(report);
+	report.setProperty("megabytesPerCase", static_cast<double>(targetBytes >> 20));
+	report.setProperty("pixelUnpackBuffers", useBuffers ? "yes" : "no");
+
+	std::vector<UploadResult> results;
+	std::string unsupported;
+
+	for (const UploadFormat &format : kFormats)
+	{
+		if (!formatSupported(format))
+		{
+			unsupported += unsupported.empty() ? format.pszName : std::string{", "} + format.pszName;
+			continue;
+		}
+
+		for (int size : {255, 256, 1023, 1024, 2048})
+		{
+			if (size > maxSize)
+				continue;
+
+			for (int alignment : {1, 4, 8})
+			{
+				for (UploadCall call : {UploadCall::Image, UploadCall::SubImage, UploadCall::SubRect})
+				{
+					for (bool buffer : {false, true})
+					{
+						if (buffer && !useBuffers)
+							continue;
+
+						double gigabytesPerSecond{measureUpload(format, size, alignment, call, buffer ? &buffers : nullptr, targetBytes)};
+						results.push_back(UploadResult{&format, size, alignment, call, buffer, gigabytesPerSecond});
+					}
+				}
+			}
+		}
+	}
+
+	report.setProperty("unsupportedFormats", unsupported);
+
+	// Rows are written fastest first. The ranking is a property of the run rather than a measurement,
+	// so the fastest case overall and in each format are reported as properties, and the rows are
+	// identified by their case alone so that runs can be compared row by row.
+
+	std::stable_sort(results.begin(), results.end(), [](const UploadResult &lhs, const UploadResult &rhs)
+	{
+		return lhs.gigabytesPerSecond > rhs.gigabytesPerSecond;
+	});
+
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const UploadResult &result{results[i]};
+		bool fastestInFormat{true};
+
+		for (size_t j = 0; j < i; ++j)
+		{
+			if (results[j].pFormat == result.pFormat)
+				fastestInFormat = false;
+		}
+
+		std::string name{std::string{result.pFormat->pszName} + " " + std::to_string(result.size) + " align " + std::to_string(result.alignment) +
+			" " + callName(result.call) + " " + (result.buffer ? "buffer" : "client")};
+
+		if (i == 0)
+			report.setProperty("fastest", name);
+
+		if (fastestInFormat)
+			report.setProperty((std::string{"fastest"} + result.pFormat->pszName).c_str(), name);
+
+		report.beginResult();
+		report.set("case", name);
+		report.set("format", result.pFormat->pszName);
+		report.set("size", result.size);
+		report.set("alignment", result.alignment);
+		report.set("call", callName(result.call));
+		report.set("source", result.buffer ? "buffer" : "client");
+		report.set("gigabytesPerSecond", result.gigabytesPerSecond);
+	}
+
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+// Copyright (c) 2024 dhpoware. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+module;
+
+#include <windows.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+module Benchmark;
+
+// Checks that GLApplication's frame loop makes no heap allocations once it has warmed up.
+//
+//     -benchmark zeroalloc [-scenes a;b;...] [-frames n] [-warmup n]
+//
+// Each scene is run by a hidden instance of this executable with -zeroalloc, so the whole of
+// mainLoop(), the loader and the dispatch tables are covered, not a copy of them. The benchmark fails
+// if any instance allocates after the warm-up frames, and keeps that instance's frame report, which
+// lists the call stacks of the allocations.
+
+namespace
+{
+	const wchar_t *const kDefaultScenes{L"clear;statechurn;smalldraws;upload;readback;text"};
+
+	std::vector<std::wstring> sceneList(const BenchmarkArguments &args)
+	{
+		std::wstring list{args.value(L"-scenes", kDefaultScenes)};
+		std::vector<std::wstring> scenes;
+
+		for (size_t start = 0; start < list.size();)
+		{
+			size_t end{std::min(list.find(L';', start), list.size())};
+
+			if (end > start)
+				scenes.push_back(list.substr(start, end - start));
+
+			start = end + 1;
+		}
+
+		return scenes;
+	}
+}
+
+int runZeroAllocBenchmark(const BenchmarkArguments &args, BenchmarkReport &report)
+{
+	std::vector<std::wstring> scenes{sceneList(args)};
+	int frames{std::max(1, args.intValue(L"-frames", 1000))};
+	int warmUp{std::max(0, args.intValue(L"-warmup", 10))};
+	wchar_t tempPath[MAX_PATH]{};
+	bool passed{true};
+
+	if (scenes.empty() || warmUp >= frames || GetTempPathW(MAX_PATH, tempPath) == 0)
+		return EXIT_FAILURE;
+
+	report.setProperty("frames", frames);
+	report.setProperty("steadyStateFrame", warmUp);
+
+	for (const std::wstring &scene : scenes)
+	{
+		wchar_t reportPath[MAX_PATH]{};
+
+		if (GetTempFileNameW(tempPath, L"gla", 0, reportPath) == 0)
+			return EXIT_FAILURE;
+
+		int exitCode{runChildProcess(L"-hidden -scene " + scene + L" -frames " + std::to_wstring(frames) + L" -zeroalloc " +
+			std::to_wstring(warmUp) + L" -report \"" + reportPath + L"\"")};
+
+		report.beginResult();
+		report.set("scene", narrow(scene.c_str()));
+		report.set("exitCode", exitCode);
+		report.set("result", exitCode == EXIT_SUCCESS ? "pass" : "fail");
+
+		// A failing run's report is kept for its allocation call stacks.
+
+		if (exitCode == EXIT_SUCCESS)
+		{
+			DeleteFileW(reportPath);
+		}
+		else
+		{
+			std::fwprintf(stderr, L"The %ls scene allocated after frame %d (exit code %d). Its frame report is %ls.\n", scene.c_str(), warmUp, exitCode, reportPath);
+			report.set("frameReport", narrow(reportPath));
+			passed = false;
+		}
+	}
+
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file